@@ -13,16 +13,23 @@
 #include <QCommandLineOption>
 #include <QCoreApplication>
 #include <QString>
+#include <QStringList>
 #include <QFile>
 
 #include <tuple>
+#include <stdexcept>
 
 #include <mainwindow.h>
+#include <layoutexporter.h>
+#include <yosys/coneextractor.h>
+#include <yosys/netlistsimplifier.h>
 #include <version/version.h>
 
 using namespace OpenNetlistView;
 
-std::tuple<QString, QString> commandLineParser(QApplication& app);
+std::tuple<QString, QString, QString, unsigned int, bool, QString, QStringList> commandLineParser(QApplication& app);
+int exportLayoutCLI(const QString& jsonFilename, const QString& skinFilename, bool foldSlices,
+    const QStringList& simplificationPasses, const QString& layoutFilename);
 
 // NOLINTBEGIN
 #ifdef __EMSCRIPTEN__
@@ -60,7 +67,14 @@ int main(int argc, char* argv[])
 
     const auto cmdArgs = commandLineParser(App);
 
-    MainWindow Window(std::get<0>(cmdArgs), std::get<1>(cmdArgs));
+    // the layout bundle is created without showing the window
+    if(!std::get<5>(cmdArgs).isEmpty())
+    {
+        return exportLayoutCLI(std::get<0>(cmdArgs), std::get<1>(cmdArgs), std::get<4>(cmdArgs), std::get<6>(cmdArgs), std::get<5>(cmdArgs));
+    }
+
+    MainWindow Window(std::get<0>(cmdArgs), std::get<1>(cmdArgs), std::get<2>(cmdArgs), std::get<3>(cmdArgs), std::get<4>(cmdArgs),
+        std::get<6>(cmdArgs));
 
     Window.setWindowIcon(QIcon(":/icons/OpenNetlistView.png"));
 
@@ -70,7 +84,7 @@ int main(int argc, char* argv[])
 #endif
 // NOLINTEND
 
-std::tuple<QString, QString> commandLineParser(QApplication& app)
+std::tuple<QString, QString, QString, unsigned int, bool, QString, QStringList> commandLineParser(QApplication& app)
 {
     // create a parser with a help
     QCommandLineParser parser;
@@ -86,8 +100,43 @@ std::tuple<QString, QString> commandLineParser(QApplication& app)
         QCoreApplication::translate("main", "skinfile"));
     parser.addOption(skinFileOption);
 
+    // add a --cone option
+    QCommandLineOption coneOption(QStringList() << "c"
+                                                << "cone",
+        QCoreApplication::translate("main", "Only show the fan-in and fan-out of a cell or net of the top module."),
+        QCoreApplication::translate("main", "name"));
+    parser.addOption(coneOption);
+
+    // add a --depth option
+    QCommandLineOption depthOption(QStringList() << "d"
+                                                 << "depth",
+        QCoreApplication::translate("main", "The number of levels of the cone."),
+        QCoreApplication::translate("main", "levels"),
+        QString::number(Yosys::ConeExtractor::defaultDepth));
+    parser.addOption(depthOption);
+
+    // add a --fold option
+    QCommandLineOption foldOption(QStringList() << "f"
+                                                << "fold",
+        QCoreApplication::translate("main", "Fold replicated per bit cells into arrayed nodes."));
+    parser.addOption(foldOption);
+
+    // add a --simplify option
+    QCommandLineOption simplifyOption(QStringList() << "simplify",
+        QCoreApplication::translate("main", "Simplify the netlist with a comma separated list of passes: %1.")
+            .arg(Yosys::NetlistSimplifier::getPassNames().join(", ")),
+        QCoreApplication::translate("main", "passes"));
+    parser.addOption(simplifyOption);
+
+    // add a --export-layout option
+    QCommandLineOption exportLayoutOption(QStringList() << "e"
+                                                        << "export-layout",
+        QCoreApplication::translate("main", "Route all modules and write them into a layout bundle without opening the window."),
+        QCoreApplication::translate("main", "bundlefile"));
+    parser.addOption(exportLayoutOption);
+
     // add a posiotional argument for the JSON file contianing the netlist
-    parser.addPositionalArgument("JSON-File", QCoreApplication::translate("main", "The JSON file containing the netlist."));
+    parser.addPositionalArgument("JSON-File", QCoreApplication::translate("main", "The JSON or RTLIL file containing the netlist."));
 
     parser.process(app);
 
@@ -121,5 +170,96 @@ std::tuple<QString, QString> commandLineParser(QApplication& app)
         }
     }
 
-    return {jsonFilename, skinFilename};
+    QString coneName = parser.value(coneOption);
+    unsigned int coneDepth = Yosys::ConeExtractor::defaultDepth;
+
+    if(parser.isSet(depthOption))
+    {
+        bool depthValid = false;
+        coneDepth = parser.value(depthOption).toUInt(&depthValid);
+
+        if(!depthValid)
+        {
+            qCritical() << "Invalid cone depth: " << parser.value(depthOption);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    QStringList simplificationPasses;
+
+    if(parser.isSet(simplifyOption))
+    {
+        simplificationPasses = parser.value(simplifyOption).split(',', Qt::SkipEmptyParts);
+
+        for(const auto& passName : simplificationPasses)
+        {
+            if(!Yosys::NetlistSimplifier::getPassNames().contains(passName))
+            {
+                qCritical() << "Unknown simplification pass: " << passName;
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    const QString layoutFilename = parser.value(exportLayoutOption);
+
+    if(!layoutFilename.isEmpty() && jsonFilename.isEmpty())
+    {
+        qCritical() << "A JSON File is required to export a layout bundle";
+        exit(EXIT_FAILURE);
+    }
+
+    return {jsonFilename, skinFilename, coneName, coneDepth, parser.isSet(foldOption), layoutFilename, simplificationPasses};
+}
+
+int exportLayoutCLI(const QString& jsonFilename, const QString& skinFilename, bool foldSlices,
+    const QStringList& simplificationPasses, const QString& layoutFilename)
+{
+    LayoutExporter exporter;
+    exporter.setFoldSlices(foldSlices);
+    exporter.setSimplificationPasses(simplificationPasses);
+
+    if(!skinFilename.isEmpty())
+    {
+        QFile skinFile(skinFilename);
+
+        if(!skinFile.open(QIODevice::ReadOnly))
+        {
+            qCritical() << "Could not open file: " << skinFilename;
+            return EXIT_FAILURE;
+        }
+
+        exporter.setSymbolData(skinFile.readAll());
+    }
+
+    QFile jsonFile(jsonFilename);
+
+    if(!jsonFile.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Could not open file: " << jsonFilename;
+        return EXIT_FAILURE;
+    }
+
+    QByteArray layoutData;
+
+    try
+    {
+        qInfo() << "Routing the modules of: " << jsonFilename;
+        layoutData = exporter.exportLayout(jsonFile.readAll());
+    }
+    catch(std::runtime_error& e)
+    {
+        qCritical() << e.what();
+        return EXIT_FAILURE;
+    }
+
+    QFile layoutFile(layoutFilename);
+
+    if(!layoutFile.open(QIODevice::WriteOnly) || layoutFile.write(layoutData) != layoutData.size())
+    {
+        qCritical() << "Could not write file: " << layoutFilename;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
 }
\ No newline at end of file
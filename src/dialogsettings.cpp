@@ -69,6 +69,7 @@ Routing::ColaRoutingParameters DialogSettings::getRoutingParameters()
     routingParameters.testTolerance = ui->dSpinTestToll->value();
     routingParameters.testMaxIterations = ui->spinTestMaxIt->value();
     routingParameters.defaultEdgeLength = ui->dSpinDefEdgeLen->value();
+    routingParameters.limitTopologyImprovement = ui->checkLimitTopology->isChecked();
 
     return routingParameters;
 }
@@ -86,6 +87,7 @@ void DialogSettings::setRoutingParameters(const Routing::ColaRoutingParameters&
     this->ui->dSpinTestToll->setValue(routingParameters.testTolerance);
     this->ui->spinTestMaxIt->setValue(routingParameters.testMaxIterations);
     this->ui->dSpinDefEdgeLen->setValue(routingParameters.defaultEdgeLength);
+    this->ui->checkLimitTopology->setChecked(routingParameters.limitTopologyImprovement);
 
     // only set the values for the routing parameters if the tab changed
     if(tabChanged)
@@ -143,6 +145,12 @@ void DialogSettings::resetRoutingParameters()
     ui->dSpinTestToll->setValue(loadedRoutingParameters.testTolerance);
     ui->spinTestMaxIt->setValue(loadedRoutingParameters.testMaxIterations);
     ui->dSpinDefEdgeLen->setValue(loadedRoutingParameters.defaultEdgeLength);
+    ui->checkLimitTopology->setChecked(loadedRoutingParameters.limitTopologyImprovement);
+}
+
+Routing::ColaRoutingParameters DialogSettings::getDefaultRoutingParameters()
+{
+    return {defaultXConstraint, defaultYConstraint, defaultTestTolerance, defaultTestMaxIterations, defaultEdgeLength, defaultLimitTopologyImprovement};
 }
 
 void DialogSettings::setDefaultRoutingParameters()
@@ -152,6 +160,7 @@ void DialogSettings::setDefaultRoutingParameters()
     ui->dSpinTestToll->setValue(defaultTestTolerance);
     ui->spinTestMaxIt->setValue(defaultTestMaxIterations);
     ui->dSpinDefEdgeLen->setValue(defaultEdgeLength);
+    ui->checkLimitTopology->setChecked(defaultLimitTopologyImprovement);
 }
 
 } // namespace OpenNetlistView
\ No newline at end of file
@@ -57,6 +57,8 @@ private:
 
     constexpr const static double defaultEdgeLength{10.0F}; ///< The default edge length.
 
+    constexpr const static bool defaultLimitTopologyImprovement{false}; ///< The default topology improvement mode.
+
 public:
     /**
      * @brief Constructor for DialogSettings.
@@ -81,6 +83,13 @@ public:
      */
     static QByteArray getDefaultSymbolData();
 
+    /**
+     * @brief Gets the default routing parameters.
+     *
+     * @return The routing parameters the dialog starts with.
+     */
+    static Routing::ColaRoutingParameters getDefaultRoutingParameters();
+
     /**
      * @brief Gets the routing parameters.
      *
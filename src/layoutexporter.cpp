@@ -0,0 +1,156 @@
+#include <QByteArray>
+#include <QString>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDomDocument>
+#include <QDebug>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+
+#include <routing/router.h>
+#include <symbol/symbol_parser.h>
+#include <yosys/parser.h>
+#include <yosys/diagram.h>
+#include <yosys/module.h>
+#include <yosys/layoutbundle.h>
+#include <yosys/rtlilreader.h>
+
+#include "dialogsettings.h"
+#include "qnetlisttabwidget.h"
+
+#include "layoutexporter.h"
+
+namespace OpenNetlistView {
+
+LayoutExporter::LayoutExporter()
+    : symbolData(DialogSettings::getDefaultSymbolData())
+    , routingParameters(DialogSettings::getDefaultRoutingParameters())
+{
+}
+
+LayoutExporter::~LayoutExporter() = default;
+
+void LayoutExporter::setSymbolData(const QByteArray& symbolData)
+{
+    this->symbolData = symbolData;
+}
+
+void LayoutExporter::setRoutingParameters(const Routing::ColaRoutingParameters& routingParameters)
+{
+    this->routingParameters = routingParameters;
+}
+
+void LayoutExporter::setFoldSlices(bool foldSlices)
+{
+    this->foldSlices = foldSlices;
+}
+
+void LayoutExporter::setSimplificationPasses(const QStringList& simplificationPasses)
+{
+    this->simplificationPasses = simplificationPasses;
+}
+
+QByteArray LayoutExporter::exportLayout(const QByteArray& jsonData) const
+{
+    QJsonObject netlist;
+
+    // the bundle embeds the netlist as json so rtlil netlists are converted
+    if(Yosys::RtlilReader::isRtlil(jsonData))
+    {
+        netlist = Yosys::RtlilReader::read(jsonData);
+    }
+    else
+    {
+        const QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData);
+
+        if(!jsonDoc.isObject())
+        {
+            throw std::runtime_error("Invalid JSON file");
+        }
+
+        netlist = jsonDoc.object();
+    }
+
+    // every router works on a copy of the parsed symbols
+    QDomDocument symbolDoc;
+    symbolDoc.setContent(symbolData);
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolDoc.documentElement());
+    symbolParser.parse();
+
+    const auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+
+    Yosys::Parser parser;
+    parser.setSliceFolding(foldSlices);
+    parser.setSimplificationPasses(simplificationPasses);
+    parser.setYosysJsonObject(netlist);
+    parser.parse();
+
+    const auto diagram = parser.getDiagram();
+    const auto topModule = diagram->getTopModule();
+
+    if(topModule == nullptr)
+    {
+        throw std::runtime_error("The design has no module with the \"top\" attribute");
+    }
+
+    // the top module is written first so the viewer can show it
+    // before the other modules are read
+    std::vector<std::shared_ptr<Yosys::Module>> modules{topModule};
+
+    const auto diagramModules = diagram->getModules();
+
+    for(const auto& module : *diagramModules)
+    {
+        if(module != topModule)
+        {
+            modules.push_back(module);
+        }
+    }
+
+    std::vector<QByteArray> moduleLines(modules.size());
+
+    const auto errors = Routing::Router::routeModules(
+        modules,
+        symbols,
+        [this](const std::shared_ptr<Yosys::Module>& module) { return QNetlistTabWidget::scaleRoutingParameters(module, routingParameters); },
+        [&modules, &moduleLines](size_t moduleIdx) {
+            // the line is written while the router still holds the routing data
+            if(modules[moduleIdx]->getIsRouted())
+            {
+                moduleLines[moduleIdx] = Yosys::LayoutBundle::writeModule(modules[moduleIdx]);
+            }
+        });
+
+    for(size_t moduleIdx = 0; moduleIdx < modules.size(); moduleIdx++)
+    {
+        if(!errors[moduleIdx].empty())
+        {
+            qWarning() << "Could not route" << modules[moduleIdx]->getType() << ":" << errors[moduleIdx].c_str();
+        }
+    }
+
+    qsizetype moduleCount = 0;
+    QByteArray moduleData;
+
+    for(const auto& moduleLine : moduleLines)
+    {
+        if(!moduleLine.isEmpty())
+        {
+            moduleData += moduleLine;
+            moduleCount++;
+        }
+    }
+
+    return Yosys::LayoutBundle::writeHeader(topModule->getType(), moduleCount, foldSlices, simplificationPasses) +
+           Yosys::LayoutBundle::writeNetlist(netlist) +
+           moduleData;
+}
+
+} // namespace OpenNetlistView
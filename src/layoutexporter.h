@@ -0,0 +1,95 @@
+/**
+ * @file layoutexporter.h
+ * @brief Header file for the LayoutExporter class.
+ *
+ * This file contains the declaration of the LayoutExporter class, which routes
+ * all modules of a netlist without a GUI and writes them into a layout bundle
+ * that the viewer can display without routing.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __LAYOUTEXPORTER_H__
+#define __LAYOUTEXPORTER_H__
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <routing/cola_router.h>
+
+namespace OpenNetlistView {
+
+/**
+ * @class LayoutExporter
+ * @brief Routes the modules of a netlist in parallel and creates a layout bundle.
+ *
+ * Every module is routed by its own router on a worker of a thread pool, the
+ * modules do not share any routing data. The line of a module is written by the
+ * worker while its router still holds the routing data. A module that fails to
+ * route is left out of the bundle, the viewer routes it when it is opened.
+ */
+class LayoutExporter
+{
+public:
+    /**
+     * @brief Construct a new LayoutExporter object
+     *
+     */
+    LayoutExporter();
+
+    /**
+     * @brief Destroy the LayoutExporter object
+     *
+     */
+    ~LayoutExporter();
+
+    /**
+     * @brief Set the svg data of the symbols to route with
+     *
+     * The viewer has to use the same symbols to display the bundle.
+     *
+     * @param symbolData The content of the skin file.
+     */
+    void setSymbolData(const QByteArray& symbolData);
+
+    /**
+     * @brief Set the routing parameters that are scaled to every module
+     *
+     * @param routingParameters The base routing parameters.
+     */
+    void setRoutingParameters(const Routing::ColaRoutingParameters& routingParameters);
+
+    /**
+     * @brief Set if replicated cells are folded before routing
+     *
+     * @param foldSlices true to fold the slices.
+     */
+    void setFoldSlices(bool foldSlices);
+
+    /**
+     * @brief Set the netlist simplification passes run before routing
+     *
+     * @param simplificationPasses The names of the passes.
+     */
+    void setSimplificationPasses(const QStringList& simplificationPasses);
+
+    /**
+     * @brief Routes all modules of a netlist and creates the layout bundle
+     *
+     * @param jsonData The yosys netlist as JSON or RTLIL.
+     * @throw std::runtime_error if the netlist or the symbols can not be parsed
+     * @return QByteArray The layout bundle.
+     */
+    QByteArray exportLayout(const QByteArray& jsonData) const;
+
+private:
+    QByteArray symbolData;                            ///< The content of the skin file.
+    Routing::ColaRoutingParameters routingParameters; ///< The base routing parameters.
+    bool foldSlices = false;                          ///< If replicated cells are folded.
+    QStringList simplificationPasses;                 ///< The enabled netlist simplification passes.
+};
+
+} // namespace OpenNetlistView
+
+#endif // __LAYOUTEXPORTER_H__
@@ -19,6 +19,9 @@
 #include <QtGlobal>
 #include <QStandardItem>
 #include <QStandardItemModel>
+#include <QJsonObject>
+#include <QTimer>
+#include <QAction>
 
 #include <stdexcept>
 #include <memory>
@@ -30,12 +33,17 @@
 #include <emscripten.h>
 #endif // EMSCRIPTEN
 
-#include <yosys/parser.h>
+#include <yosys/designloader.h>
 #include <symbol/symbol_parser.h>
 #include <yosys/module.h>
+#include <yosys/layoutbundle.h>
+#include <yosys/netlistsimplifier.h>
+#include <yosys/rtlilreader.h>
 
 #include "qtreeview.h"
 #include "qnetlisttabwidget.h"
+#include "qnetlistminimap.h"
+#include "qnetlistloader.h"
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "dialogabout.h"
@@ -44,17 +52,22 @@
 
 namespace OpenNetlistView {
 
-MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename, QWidget* parent)
+MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename, const QString& coneName,
+    unsigned int coneDepth, bool foldSlices, const QStringList& simplificationPasses, QWidget* parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , netlistLoader(new QNetlistLoader(this))
     , dialogAbout(new DialogAbout(this))
     , dialogSettings(new DialogSettings(this))
     , dialogSearch(new DialogSearch(this))
     , askRemoveDialog(new QMessageBox(this))
     , longRoutingMessage(new QMessageBox(this))
+    , splitSheetsButton(nullptr)
     , diagram(nullptr)
     , currentModule(nullptr)
     , errorMessage(nullptr)
+    , startConeName(coneName)
+    , startConeDepth(coneDepth)
 {
 
     ui->setupUi(this);
@@ -91,6 +104,7 @@ MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename,
         // create the dialog that shows the routing progress
         longRoutingMessage->setText(tr("You are about open a large module. Routing this may take a while. \nDo you want to proceed?"));
         longRoutingMessage->setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+        splitSheetsButton = longRoutingMessage->addButton(tr("Split into Sheets"), QMessageBox::AcceptRole);
         longRoutingMessage->setModal(true);
         longRoutingMessage->setIcon(QMessageBox::Icon::Question);
         connect(longRoutingMessage, &QMessageBox::finished, this, &MainWindow::closeRoutingProgressDialog);
@@ -125,6 +139,26 @@ MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename,
     connect(ui->aToogleNames, &QAction::triggered, ui->tabNetlists, &QNetlistTabWidget::toggleNames);
     connect(ui->pToggleNames, &QPushButton::clicked, ui->tabNetlists, &QNetlistTabWidget::toggleNames);
 
+    // TileRendering
+    connect(ui->aTileRendering, &QAction::toggled, ui->tabNetlists, &QNetlistTabWidget::setTileRendering);
+
+    // FoldSlices
+    connect(ui->aFoldSlices, &QAction::toggled, this, &MainWindow::setSliceFolding);
+    ui->aFoldSlices->setChecked(foldSlices);
+
+    // SimplifyNetlist
+    ui->aSimplifyBufferChains->setData(Yosys::NetlistSimplifier::bufferChains);
+    ui->aSimplifyDoubleInverters->setData(Yosys::NetlistSimplifier::doubleInverters);
+    ui->aSimplifyDeadLogic->setData(Yosys::NetlistSimplifier::deadLogic);
+
+    for(auto* action : ui->menuSimplify->actions())
+    {
+        action->setChecked(simplificationPasses.contains(action->data().toString()));
+        connect(action, &QAction::toggled, this, &MainWindow::setSimplificationPasses);
+    }
+
+    setSimplificationPasses();
+
     // ClearHighlight
     connect(ui->actionClearHighlight, &QAction::triggered, ui->tabNetlists, &QNetlistTabWidget::clearAllHighlightColors);
 
@@ -150,6 +184,11 @@ MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename,
     // start json parsing
     connect(this, &MainWindow::startJsonParsing, this, &MainWindow::parseJson);
 
+    // show the progress of the loading that runs in the background
+    connect(ui->aCancelLoading, &QAction::triggered, this, &MainWindow::cancelLoading);
+    connect(netlistLoader, &QNetlistLoader::stageStarted, this, &MainWindow::showLoadProgress);
+    connect(netlistLoader, &QNetlistLoader::loadFailed, this, &MainWindow::showLoadError);
+
     // create the hierarchy tree
     connect(ui->treeHierarchy, &QTreeView::doubleClicked, this, &MainWindow::clickedOnHierarchyTree);
 
@@ -159,6 +198,17 @@ MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename,
     // handle the larger diagrams
     connect(ui->tabNetlists, &QNetlistTabWidget::displayLargeModuleQuestion, this, &MainWindow::showRoutingProgressDialog);
     connect(this, &MainWindow::continueLargeRouting, ui->tabNetlists, &QNetlistTabWidget::largeModuleAccepted);
+    connect(this, &MainWindow::splitLargeModule, ui->tabNetlists, &QNetlistTabWidget::largeModuleSplit);
+
+    // show the progress of the routing that runs in the event loop
+    connect(ui->tabNetlists, &QNetlistTabWidget::routingProgress, this, &MainWindow::showRoutingProgress);
+    connect(ui->tabNetlists, &QNetlistTabWidget::routingIdle, this, &MainWindow::clearRoutingProgress);
+
+    // minimap follows the active tab and is rendered again after routing
+    ui->menuView->addAction(ui->dockMinimap->toggleViewAction());
+    ui->dockMinimap->setVisible(false);
+    connect(ui->tabNetlists, &QNetlistTabWidget::currentViewChanged, ui->minimap, &QNetlistMinimap::setView);
+    connect(ui->tabNetlists, &QNetlistTabWidget::displayUpgraded, ui->minimap, &QNetlistMinimap::invalidateCache);
 
     ui->treeHierarchy->setVisible(false);
 
@@ -172,23 +222,13 @@ MainWindow::MainWindow(const QString& jsonFilename, const QString& skinFilename,
     ui->aExit->setVisible(false);
 #endif // EMSCRIPTEN
 
-    QByteArray jsonFile;
-    // load the json file if it is not empty
+    // load the json file if it is not empty, the
+    // file is read by the loading in the background
     if(!jsonFilename.isEmpty())
     {
-        try
-        {
-            jsonFile = loadFileCLI(jsonFilename);
-        }
-        catch(std::runtime_error& e)
-        {
-            showError(e.what());
-            return;
-        }
-        this->fileContent = jsonFile;
+        this->fileContent.clear();
         this->fileName = jsonFilename;
         qInfo() << "Parsing and routing the JSON file: " << jsonFilename;
-        qInfo() << "With larger designs this may take a while...";
         emit startJsonParsing();
     }
 }
@@ -221,7 +261,7 @@ void MainWindow::openFile()
         }
     };
 
-    QFileDialog::getOpenFileContent(tr("JSON Files (*.json)"), fileContentReady);
+    QFileDialog::getOpenFileContent(tr("Netlist Files (*.json *.%1 *.%2)").arg(Yosys::RtlilReader::fileSuffix).arg(Yosys::LayoutBundle::fileSuffix), fileContentReady);
 }
 
 void MainWindow::showError(const QString& error)
@@ -339,15 +379,6 @@ void MainWindow::exportSelectedToSvg()
 
 void MainWindow::parseJson()
 {
-
-    const QJsonDocument jsonDoc = QJsonDocument::fromJson(fileContent);
-
-    if(jsonDoc.isNull())
-    {
-        showError("Invalid JSON file");
-        return;
-    }
-
     // ask if the user wants to remove the loaded diagram if one is loaded
     if(diagramLoaded)
     {
@@ -355,36 +386,60 @@ void MainWindow::parseJson()
         return;
     }
 
-    // reset and then parse the diagram
-    parser.clearDiagram();
-    parser.setYosysJsonObject(jsonDoc.object());
+    startLoading();
+}
 
-    // parse the data
-    try
+void MainWindow::startLoading()
+{
+    ui->aCancelLoading->setEnabled(true);
+
+    netlistLoader->load(fileName, fileContent, designLoader, [this](Yosys::DesignLoader::Result& result) {
+        finishLoading(result);
+    });
+}
+
+void MainWindow::finishLoading(Yosys::DesignLoader::Result& result)
+{
+    ui->aCancelLoading->setEnabled(false);
+    ui->statusbar->clearMessage();
+
+    // the old diagram is only removed once the new one is complete
+    if(diagramLoaded)
     {
-        parser.parse();
-        diagram = std::move(parser.getDiagram());
+        this->ui->tabNetlists->reset();
+        hierarchyModel.clear();
+        diagramLoaded = false;
     }
-    catch(std::runtime_error& e)
+
+    layoutBundle = std::move(result.layoutBundle);
+    layoutModulesRead = 0;
+
+    // show the settings a layout bundle was parsed with
+    if(layoutBundle != nullptr)
     {
-        showError(e.what());
+        ui->aFoldSlices->setChecked(result.foldSlices);
+
+        for(auto* action : ui->menuSimplify->actions())
+        {
+            action->setChecked(result.simplificationPasses.contains(action->data().toString()));
+        }
     }
 
-    if(diagram == nullptr)
+    diagram = std::move(result.diagram);
+    diagramLoaded = true;
+
+    size_t simplifiedCells = 0;
+
+    for(const auto& [passName, removedCells] : result.simplificationStatistics)
     {
-        return;
+        simplifiedCells += removedCells;
     }
 
-    // if no top module is found, show an error message and aboort
-    if(diagram->getTopModule() == nullptr)
+    if(!result.simplificationPasses.isEmpty())
     {
-        showError("The design has no module with the \"top\" attribute.\nYou need to synthesise the design with the \"hierarchy -auto-top\" command");
-        return;
+        ui->statusbar->showMessage(tr("Simplification removed %1 cells").arg(simplifiedCells), statusMessageTimeout);
     }
 
-    diagramLoaded = true;
-
-    diagram->linkSubModules(diagram->getTopModule());
     createHierarchyTree(diagram->getTopModule());
 
     // set the window title to the file name
@@ -397,8 +452,99 @@ void MainWindow::parseJson()
     this->setWindowTitle("OpenNetlistView - " + fileName);
 #endif // EMSCRIPTEN
 
+    // the top module is the first module of the bundle, it is displayed
+    // without routing and the other modules are read afterwards
+    if(layoutBundle != nullptr)
+    {
+        layoutBundle->setModules(*diagram->getModules());
+
+        if(!readLayoutModule())
+        {
+            layoutBundle.reset();
+        }
+    }
+
     // route the diagram and display it
     setNetlisttabDiagramm();
+
+    if(layoutBundle != nullptr)
+    {
+        QTimer::singleShot(0, this, &MainWindow::readNextLayoutModule);
+    }
+}
+
+void MainWindow::cancelLoading()
+{
+    if(!netlistLoader->isLoading())
+    {
+        return;
+    }
+
+    netlistLoader->cancel();
+
+    ui->aCancelLoading->setEnabled(false);
+    ui->statusbar->showMessage(tr("Loading canceled"), statusMessageTimeout);
+}
+
+void MainWindow::showLoadProgress(Yosys::DesignLoader::EStage stage)
+{
+    const int stageNumber = static_cast<int>(stage) + 1;
+
+    ui->statusbar->showMessage(tr("Loading... %1 (%2/%3)")
+                                   .arg(Yosys::DesignLoader::getStageName(stage))
+                                   .arg(stageNumber)
+                                   .arg(Yosys::DesignLoader::stageCount));
+}
+
+void MainWindow::showLoadError(const QString& error)
+{
+    ui->aCancelLoading->setEnabled(false);
+    ui->statusbar->clearMessage();
+
+    showError(error);
+}
+
+void MainWindow::readNextLayoutModule()
+{
+    if(layoutBundle == nullptr)
+    {
+        return;
+    }
+
+    if(!readLayoutModule())
+    {
+        layoutBundle.reset();
+        ui->statusbar->clearMessage();
+        return;
+    }
+
+    ui->statusbar->showMessage(tr("Loading layout... %1/%2").arg(layoutModulesRead).arg(layoutBundle->getModuleCount()));
+
+    // one module per event loop turn keeps the displayed module responsive
+    QTimer::singleShot(0, this, &MainWindow::readNextLayoutModule);
+}
+
+bool MainWindow::readLayoutModule()
+{
+    if(layoutBundle->atEnd())
+    {
+        return false;
+    }
+
+    try
+    {
+        layoutBundle->readModule();
+    }
+    catch(std::runtime_error& e)
+    {
+        // the modules that are not read yet are routed when they are opened
+        qWarning() << e.what();
+        return false;
+    }
+
+    layoutModulesRead++;
+
+    return true;
 }
 
 void MainWindow::showAskRemoveLoadedDiagram()
@@ -422,12 +568,10 @@ void MainWindow::closeAskRemoveLoadedDiagram()
 
     auto result = askRemoveDialog->result();
 
+    // the loaded diagram is replaced when the new one is finished
     if(result == QMessageBox::Yes)
     {
-        this->ui->tabNetlists->reset();
-        hierarchyModel.clear();
-        diagramLoaded = false;
-        parseJson();
+        startLoading();
     }
 }
 
@@ -447,8 +591,12 @@ void MainWindow::closeRoutingProgressDialog()
         return;
     }
 
-    auto result = longRoutingMessage->result();
-    if(result == QMessageBox::Yes)
+    // the result of a custom button is no standard button
+    if(splitSheetsButton != nullptr && longRoutingMessage->clickedButton() == splitSheetsButton)
+    {
+        emit splitLargeModule();
+    }
+    else if(longRoutingMessage->result() == QMessageBox::Yes)
     {
         emit continueLargeRouting();
     }
@@ -456,6 +604,36 @@ void MainWindow::closeRoutingProgressDialog()
     longRoutingMessage->close();
 }
 
+void MainWindow::showRoutingProgress(int progress)
+{
+    ui->statusbar->showMessage(tr("Routing... %1%").arg(progress));
+}
+
+void MainWindow::clearRoutingProgress()
+{
+    ui->statusbar->clearMessage();
+}
+
+void MainWindow::setSliceFolding(bool enabled)
+{
+    designLoader.setSliceFolding(enabled);
+}
+
+void MainWindow::setSimplificationPasses()
+{
+    QStringList passNames;
+
+    for(const auto* action : ui->menuSimplify->actions())
+    {
+        if(action->isChecked())
+        {
+            passNames.append(action->data().toString());
+        }
+    }
+
+    designLoader.setSimplificationPasses(passNames);
+}
+
 void MainWindow::createHierarchyTree(const std::shared_ptr<Yosys::Module>& module, QStandardItem* parentItem)
 {
 
@@ -586,7 +764,10 @@ void MainWindow::setNetlisttabDiagramm()
         return;
     }
 
-    ui->tabNetlists->setDiagram(std::move(diagram));
+    ui->tabNetlists->setDiagram(std::move(diagram), startConeName, startConeDepth);
+
+    // the cone only applies to the file given on the command line
+    startConeName.clear();
 }
 
 QString MainWindow::createHierarchyModulePath(QStandardItem* item)
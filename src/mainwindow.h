@@ -15,15 +15,19 @@
 #include <QMainWindow>
 #include <QJsonDocument>
 #include <QMessageBox>
+#include <QPushButton>
 #include <QString>
+#include <QStringList>
 #include <QStandardItem>
 
 #include <memory>
 #include <map>
 #include <vector>
 
-#include <yosys/parser.h>
+#include <yosys/designloader.h>
 #include <yosys/module.h>
+#include <yosys/coneextractor.h>
+#include <yosys/layoutbundle.h>
 #include <symbol/symbol.h>
 #include <symbol/symbol_parser.h>
 #include <routing/router.h>
@@ -32,6 +36,7 @@
 #include "dialogsettings.h"
 #include "dialogsearch.h"
 #include "qnetlistscene.h"
+#include "qnetlistloader.h"
 
 Q_DECLARE_SMART_POINTER_METATYPE(std::shared_ptr);
 
@@ -65,9 +70,17 @@ public:
      *
      * Initializes the main window with an optional parent widget.
      *
+     * @param jsonFilename The JSON file to load, or an empty string.
+     * @param skinFilename The skin file to use, or an empty string for the default skin.
+     * @param coneName The cell or net of the top module to only show the cone of, or an empty string.
+     * @param coneDepth The number of levels of the cone.
+     * @param foldSlices true to fold replicated cells into arrayed nodes.
+     * @param simplificationPasses The netlist simplification passes to enable.
      * @param parent The parent widget, or nullptr if there is no parent.
      */
-    MainWindow(const QString& jsonFilename, const QString& skinFilename, QWidget* parent = nullptr);
+    MainWindow(const QString& jsonFilename, const QString& skinFilename, const QString& coneName = "",
+        unsigned int coneDepth = Yosys::ConeExtractor::defaultDepth, bool foldSlices = false,
+        const QStringList& simplificationPasses = {}, QWidget* parent = nullptr);
 
     /**
      * @brief Destructor for MainWindow.
@@ -178,20 +191,51 @@ private slots:
     /**
      * @brief Slot to close the dialog asking to remove the loaded diagram.
      *
-     * When Yes is clicked the old diagram is removed and the new one is loaded.
-     * When No is clicked the dialog is closed.
+     * When Yes is clicked the new diagram is loaded, the old one is removed once
+     * the new one is finished. When No is clicked the dialog is closed.
      *
      */
     void closeAskRemoveLoadedDiagram();
 
     /**
-     * @brief Method to parse a JSON document.
+     * @brief Method to load the selected file.
      *
-     * This method parses a JSON document and updates the diagram with the parsed data.
-
+     * The file is read, parsed and linked in the background, the diagram
+     * is displayed when the loading is finished.
      */
     void parseJson();
 
+    /**
+     * @brief Slot to cancel the running loading.
+     *
+     * The displayed diagram is kept.
+     */
+    void cancelLoading();
+
+    /**
+     * @brief Slot to show the stage of the running loading.
+     *
+     * The stage is shown in the status bar.
+     *
+     * @param stage The started stage.
+     */
+    void showLoadProgress(Yosys::DesignLoader::EStage stage);
+
+    /**
+     * @brief Slot to show the error of a failed loading.
+     *
+     * @param error The error message.
+     */
+    void showLoadError(const QString& error);
+
+    /**
+     * @brief Slot to read the next module of the loaded layout bundle.
+     *
+     * One module is read per call, the slot queues itself until all modules
+     * of the bundle are read.
+     */
+    void readNextLayoutModule();
+
     /**
      * @brief Slot to show a routing progress dialog.
      *
@@ -206,6 +250,38 @@ private slots:
      */
     void closeRoutingProgressDialog();
 
+    /**
+     * @brief Slot to show the progress of a running routing.
+     *
+     * The progress is shown in the status bar.
+     *
+     * @param progress The progress of the routing between 0 and 100.
+     */
+    void showRoutingProgress(int progress);
+
+    /**
+     * @brief Slot to remove the routing progress from the status bar.
+     *
+     * This slot is triggered when no module is routed anymore.
+     */
+    void clearRoutingProgress();
+
+    /**
+     * @brief enables or disables the folding of replicated cells
+     *
+     * the setting is used when the next file is loaded
+     *
+     * @param enabled true to fold the replicated cells
+     */
+    void setSliceFolding(bool enabled);
+
+    /**
+     * @brief sets the netlist simplification passes of the checked actions
+     *
+     * the setting is used when the next file is loaded
+     */
+    void setSimplificationPasses();
+
     /**
      * @brief Slot to create the hierarchy tree.
      *
@@ -252,9 +328,19 @@ signals:
      */
     void continueLargeRouting();
 
+    /**
+     * @brief Signal to open a large module as sheets.
+     *
+     * This signal is emitted when the large module should be split into sheets instead of routed at once.
+     */
+    void splitLargeModule();
+
 private:
+    constexpr const static int statusMessageTimeout{5000}; ///< The time in milliseconds a status message is shown.
+
     Ui::MainWindow* ui;                                         ///< Pointer to the user interface.
-    Yosys::Parser parser;                                       ///< Instance of the Parser class for handling file parsing.
+    Yosys::DesignLoader designLoader;                           ///< Holds the parse settings of the menu for the next loading.
+    QNetlistLoader* netlistLoader;                              ///< Loads the files in the background.
     std::unique_ptr<Yosys::Diagram> diagram;                    ///< Instance of the Diagram class for handling diagram data.
     std::shared_ptr<Yosys::Module> currentModule;               ///< Pointer to the current module in the diagram.
     Symbol::SymbolParser symbolParser;                          ///< Instance of the SymbolParser class for handling symbol parsing.
@@ -268,8 +354,13 @@ private:
     DialogSettings* dialogSettings;                             ///< Settings dialog for configuring application settings.
     DialogSearch* dialogSearch;                                 ///< Search dialog for searching the diagram.
     QMessageBox* longRoutingMessage;                            ///< Dialog for showing the routing can take a while
+    QPushButton* splitSheetsButton;                             ///< Button of the routing dialog opening the module as sheets
     QMessageBox* askRemoveDialog;                               ///< Dialog for asking to remove the loaded diagram
     QMessageBox* errorMessage;                                  ///< Error message dialog for displaying errors.
+    QString startConeName;                                      ///< The cell or net to show the cone of after loading the file from the command line.
+    unsigned int startConeDepth;                                ///< The number of levels of the cone shown after loading the file from the command line.
+    std::unique_ptr<Yosys::LayoutBundle> layoutBundle;          ///< The layout bundle that is read while the top module is displayed.
+    qsizetype layoutModulesRead = 0;                            ///< The number of modules read from the layout bundle.
 
     /**
      * @brief Method to upgrade the display.
@@ -278,6 +369,25 @@ private:
      */
     void setNetlisttabDiagramm();
 
+    /**
+     * @brief Starts loading the selected file in the background.
+     */
+    void startLoading();
+
+    /**
+     * @brief Replaces the displayed diagram with a loaded design.
+     *
+     * @param result The loaded design.
+     */
+    void finishLoading(Yosys::DesignLoader::Result& result);
+
+    /**
+     * @brief read the next module of the layout bundle
+     *
+     * @return true if a module line was read, false at the end of the bundle or on an error
+     */
+    bool readLayoutModule();
+
     /**
      * @brief generate the module path from a hierarchy tree item
      *
@@ -4,13 +4,25 @@
 #include <QtCore/Qt>
 #include <QString>
 #include <QByteArray>
+#include <QRectF>
+#include <QPointF>
+#include <QSizeF>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <yosys/module.h>
+#include <yosys/node.h>
 #include <routing/cola_router.h>
 
 #include "qnetlistscene.h"
+#include "qnetlistview.h"
+#include "qnetlistgraphicsnode.h"
+#include "qnetlistitemfactory.h"
+#include "qroutingdriver.h"
 
 #include "netlisttab.h"
 #include "ui_netlisttab.h"
@@ -19,8 +31,10 @@ namespace OpenNetlistView {
 
 NetlistTab::NetlistTab(const std::shared_ptr<Yosys::Module>& module,
     const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+    const std::shared_ptr<QNetlistItemFactory::Renderers>& renderers,
     const QString& modulePath,
     const Routing::ColaRoutingParameters& routingParameters,
+    QRoutingDriver* routingDriver,
     QWidget* parent)
     : QWidget(parent)
     , ui(new Ui::NetlistTab)
@@ -28,6 +42,8 @@ NetlistTab::NetlistTab(const std::shared_ptr<Yosys::Module>& module,
     , module(module)
     , modulePath(modulePath)
     , symbols(symbols)
+    , renderers(renderers)
+    , routingDriver(routingDriver)
 {
 
     ui->setupUi(this);
@@ -37,7 +53,7 @@ NetlistTab::NetlistTab(const std::shared_ptr<Yosys::Module>& module,
 
     ui->labelPath->setText(modulePath);
 
-    router.setRoutingParameters(routingParameters);
+    router->setRoutingParameters(routingParameters);
 
     connect(this, &NetlistTab::zoomIn, ui->netlistView, &QNetListView::zoomIn);
     connect(this, &NetlistTab::zoomOut, ui->netlistView, &QNetListView::zoomOut);
@@ -45,8 +61,16 @@ NetlistTab::NetlistTab(const std::shared_ptr<Yosys::Module>& module,
     connect(this, &NetlistTab::toggleNames, ui->netlistView, &QNetListView::toggleNames);
     connect(this, &NetlistTab::clearAllHighlightColors, ui->netlistView, &QNetListView::clearAllHighlightColors);
     connect(this, &NetlistTab::zoomToNode, ui->netlistView, &QNetListView::zoomToNode);
+    connect(this, &NetlistTab::highlightBits, ui->netlistView, &QNetListView::highlightBits);
     connect(this, &NetlistTab::exportToSvg, ui->netlistView, &QNetListView::exportToSvg);
+    connect(this, &NetlistTab::setTileRendering, ui->netlistView, &QNetListView::setTileRendering);
     connect(ui->netlistView, &QNetListView::genericModuleDoubleClicked, this, &NetlistTab::genericModuleDoubleClicked);
+    connect(ui->netlistView, &QNetListView::expandInPlaceToggled, this, &NetlistTab::toggleExpandInPlace);
+    connect(ui->netlistView, &QNetListView::coneRequested, this, &NetlistTab::coneRequested);
+    connect(ui->netlistView, &QNetListView::modulePortDoubleClicked, this, &NetlistTab::modulePortDoubleClicked);
+    connect(ui->netlistView, &QNetListView::netHighlighted, this, [this](const QStringList& bits, const QColor& color) {
+        emit netHighlighted(this->modulePath, bits, color);
+    });
 
     this->scene->setParent(ui->netlistView);
     ui->netlistView->setScene(scene);
@@ -55,37 +79,162 @@ NetlistTab::NetlistTab(const std::shared_ptr<Yosys::Module>& module,
 
 NetlistTab::~NetlistTab()
 {
+    // the driver must not run the routers of a deleted tab
+    if(routingDriver != nullptr)
+    {
+        routingDriver->cancel(router.get());
+
+        for(auto& [nodeName, instance] : expandedInstances)
+        {
+            routingDriver->cancel(instance.router.get());
+        }
+    }
+
     delete ui;
 }
 
 void NetlistTab::upgradeDisplay()
 {
 
+    // the scene is updated when the queued routing is finished
+    if(routingDriver != nullptr && routingDriver->isPending(router.get()))
+    {
+        return;
+    }
+
     // set the module and symbols
-    router.setModule(module);
-    router.setSymbols(symbols);
+    router->setModule(module);
+    router->setSymbols(symbols);
+
+    const bool wasRouted = module->getIsRouted();
+
+    // route in time slices so the event loop keeps running
+    if(routingDriver != nullptr && !wasRouted)
+    {
+        routingDriver->enqueue(router.get(), [this]() { finishUpgradeDisplay(false); });
+        return;
+    }
 
     // run the router
-    router.runRouter();
+    router->runRouter();
 
-    // clear the scene
-    scene->clear();
+    finishUpgradeDisplay(wasRouted);
+}
 
-    // convert the routed objects to Qt objects
-    auto diagramItems = module->convertToQt();
+void NetlistTab::finishUpgradeDisplay(bool wasRouted)
+{
+    std::vector<QString> unroutedInstances;
 
-    for(auto* item : diagramItems)
+    // a new layout of the module does not contain the expanded nodes
+    for(auto& [nodeName, instance] : expandedInstances)
     {
-        scene->addItem(item);
+        if(instance.module->getIsRouted() && !instance.contentRect.isEmpty())
+        {
+            if(!wasRouted)
+            {
+                resizeInstanceNode(nodeName, true);
+            }
+        }
+        else if(routingDriver == nullptr || !routingDriver->isPending(instance.router.get()))
+        {
+            unroutedInstances.push_back(nodeName);
+        }
     }
 
-    // render the graphicsView
-    ui->netlistView->viewport()->update();
+    this->rebuildScene();
+
+    // the nodes of the instances are resized when their contents are routed
+    for(const auto& nodeName : unroutedInstances)
+    {
+        routeExpandedInstance(nodeName);
+    }
+
+    // the view of a new tab is fitted before the routing finished
+    if(firstDisplay)
+    {
+        firstDisplay = false;
+        emit zoomToFit();
+    }
+
+    emit displayUpgraded();
+}
+
+void NetlistTab::toggleExpandInPlace(const QString& nodeName)
+{
+    // a loaded layout can not make room for the instance
+    if(!module->getIsRouted() || module->getLayoutLoaded())
+    {
+        return;
+    }
+
+    // collapse the instance by giving the node its symbol size back
+    auto instanceIt = expandedInstances.find(nodeName);
+
+    if(instanceIt != expandedInstances.end())
+    {
+        if(routingDriver != nullptr)
+        {
+            routingDriver->cancel(instanceIt->second.router.get());
+        }
+
+        if(!instanceIt->second.contentRect.isEmpty())
+        {
+            resizeInstanceNode(nodeName, false);
+        }
+
+        expandedInstances.erase(instanceIt);
+
+        this->rebuildScene();
+        emit displayUpgraded();
+        return;
+    }
+
+    const auto subModules = module->getSubModules();
+    auto subModuleIt = subModules.find(nodeName);
+
+    if(subModuleIt == subModules.end() || getNodeByName(nodeName) == nullptr)
+    {
+        return;
+    }
+
+    // the submodule is shared by all of its instances and its own tab,
+    // so the instance routes a copy that only it changes
+    ExpandedInstance instance;
+    instance.module = subModuleIt->second->clone();
+    instance.router = std::make_unique<Routing::Router>();
+    instance.router->setRoutingParameters(router->getRoutingParameters());
+
+    expandedInstances.emplace(nodeName, std::move(instance));
+
+    // the other tabs of the module and the exporter must not see the moved
+    // nodes, so the tab routes a copy of its module the first time, the
+    // instance is routed when the copy is finished
+    if(!ownsModule)
+    {
+        module = module->clone();
+        ownsModule = true;
+
+        // the routing data of the shared module belongs to the router that routed
+        // it, so the router is kept and the copy gets a router of its own
+        sharedRouter = std::move(router);
+        router = std::make_unique<Routing::Router>();
+        router->setRoutingParameters(sharedRouter->getRoutingParameters());
+
+        this->upgradeDisplay();
+        return;
+    }
+
+    routeExpandedInstance(nodeName);
 }
 
 void NetlistTab::clearRoutingData()
 {
-    router.clear();
+    if(routingDriver != nullptr)
+    {
+        routingDriver->cancel(router.get());
+    }
+
+    router->clear();
 }
 
 void NetlistTab::setModulePath(const QString& modulePath)
@@ -100,21 +249,66 @@ QString NetlistTab::getModulePath() const
     return modulePath;
 }
 
-void NetlistTab::updateSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols)
+std::shared_ptr<Yosys::Module> NetlistTab::getModule() const
+{
+    return module;
+}
+
+bool NetlistTab::updateSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+    const std::shared_ptr<QNetlistItemFactory::Renderers>& renderers)
 {
     this->symbols = symbols;
+    this->renderers = renderers;
+
+    // a queued routing picks up the new symbols when it starts
+    bool keepLayout = (routingDriver == nullptr || !routingDriver->isPending(router.get())) && router->replaceSymbols(symbols);
+
+    for(auto& [nodeName, instance] : expandedInstances)
+    {
+        keepLayout = (routingDriver == nullptr || !routingDriver->isPending(instance.router.get())) && instance.router->replaceSymbols(symbols) && keepLayout;
+    }
+
+    // only the renderers changed, so the items are created again from the layout
+    if(keepLayout)
+    {
+        this->rebuildScene();
+        emit displayUpgraded();
+
+        return true;
+    }
+
     this->clearRoutingData();
+    this->clearExpandedInstances();
+
+    return false;
 }
 
 void NetlistTab::routingParametersChanged(const Routing::ColaRoutingParameters& routingParameters)
 {
-    router.setRoutingParameters(routingParameters);
-    router.clear();
+    if(routingDriver != nullptr)
+    {
+        routingDriver->cancel(router.get());
+    }
+
+    router->setRoutingParameters(routingParameters);
+    router->clear();
+
+    this->clearExpandedInstances();
+
+    for(auto& [nodeName, instance] : expandedInstances)
+    {
+        instance.router->setRoutingParameters(routingParameters);
+    }
 }
 
 Routing::ColaRoutingParameters NetlistTab::getRoutingParameters()
 {
-    return router.getRoutingParameters();
+    return router->getRoutingParameters();
+}
+
+QNetListView* NetlistTab::getNetlistView() const
+{
+    return ui->netlistView;
 }
 
 void NetlistTab::setModuleHierarchyVisible()
@@ -131,4 +325,165 @@ void NetlistTab::setModuleHierarchyVisible()
     }
 }
 
+void NetlistTab::routeExpandedInstance(const QString& nodeName)
+{
+    auto& instance = expandedInstances.at(nodeName);
+
+    instance.router->setModule(instance.module);
+    instance.router->setSymbols(symbols);
+
+    // route in time slices so the event loop keeps running
+    if(routingDriver != nullptr && !instance.module->getIsRouted())
+    {
+        routingDriver->enqueue(instance.router.get(), [this, nodeName]() { finishExpandedInstance(nodeName); });
+        return;
+    }
+
+    instance.router->runRouter();
+
+    finishExpandedInstance(nodeName);
+}
+
+void NetlistTab::finishExpandedInstance(const QString& nodeName)
+{
+    auto instanceIt = expandedInstances.find(nodeName);
+
+    if(instanceIt == expandedInstances.end())
+    {
+        return;
+    }
+
+    auto& instance = instanceIt->second;
+
+    instance.contentRect = instance.module->getIsRouted() ? instance.module->getRoutedBoundingRect() : QRectF();
+
+    if(instance.contentRect.isEmpty())
+    {
+        expandedInstances.erase(instanceIt);
+        return;
+    }
+
+    // a parent that is routed again resizes the node when it is finished
+    if(!module->getIsRouted() || (routingDriver != nullptr && routingDriver->isPending(router.get())))
+    {
+        return;
+    }
+
+    // only the neighbourhood of the node is rerouted
+    resizeInstanceNode(nodeName, true);
+
+    this->rebuildScene();
+    emit displayUpgraded();
+}
+
+void NetlistTab::clearExpandedInstances()
+{
+    for(auto& [nodeName, instance] : expandedInstances)
+    {
+        if(routingDriver != nullptr)
+        {
+            routingDriver->cancel(instance.router.get());
+        }
+
+        instance.router->clear();
+        instance.contentRect = QRectF();
+    }
+}
+
+void NetlistTab::resizeInstanceNode(const QString& nodeName, bool expanded)
+{
+    auto node = getNodeByName(nodeName);
+
+    if(node == nullptr || node->getSymbol() == nullptr)
+    {
+        return;
+    }
+
+    if(expanded)
+    {
+        const QRectF& contentRect = expandedInstances.at(nodeName).contentRect;
+
+        router->resizeNode(node,
+            contentRect.width() + (2 * expandMargin),
+            contentRect.height() + (2 * expandMargin) + expandHeader);
+    }
+    else
+    {
+        const auto boundingBox = node->getSymbol()->getBoundingBox();
+
+        router->resizeNode(node, boundingBox.first, boundingBox.second);
+    }
+}
+
+void NetlistTab::rebuildScene()
+{
+    // without an index the items are inserted without updating the bsp tree,
+    // the tree is built once when the index is enabled again
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    // clear the scene
+    scene->clear();
+
+    // the old renderers are released once no scene uses them anymore
+    this->sceneRenderers = this->renderers;
+
+    // convert the routed objects to Qt objects
+    auto diagramItems = QNetlistItemFactory::createItems(module, *this->sceneRenderers);
+
+    for(auto* item : diagramItems)
+    {
+        scene->addItem(item);
+    }
+
+    // place the contents of the expanded instances inside their nodes
+    for(auto& [nodeName, instance] : expandedInstances)
+    {
+        auto node = getNodeByName(nodeName);
+
+        if(node == nullptr || instance.contentRect.isEmpty() || !instance.module->getIsRouted())
+        {
+            continue;
+        }
+
+        auto* nodeItem = dynamic_cast<QNetlistGraphicsNode*>(node->getGraphicsItem());
+
+        if(nodeItem == nullptr)
+        {
+            continue;
+        }
+
+        const QRectF nodeRect = node->getRoutedRect();
+        nodeItem->setPos(nodeRect.topLeft());
+        nodeItem->setExpandedSize(nodeRect.size());
+
+        const QPointF offset = QPointF(expandMargin, expandMargin + expandHeader) - instance.contentRect.topLeft();
+
+        for(auto* item : QNetlistItemFactory::createItems(instance.module, *this->sceneRenderers))
+        {
+            item->setParentItem(nodeItem);
+            item->moveBy(offset.x(), offset.y());
+        }
+    }
+
+    scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+
+    // render the graphicsView
+    ui->netlistView->viewport()->update();
+}
+
+std::shared_ptr<Yosys::Node> NetlistTab::getNodeByName(const QString& nodeName) const
+{
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        if(node->getName() == nodeName)
+        {
+            return node;
+        }
+    }
+
+    return nullptr;
+}
+
 } // namespace OpenNetlistView
@@ -14,6 +14,10 @@
 #include <QObject>
 #include <QString>
 #include <QByteArray>
+#include <QRectF>
+#include <QPointer>
+#include <QStringList>
+#include <QColor>
 
 #include <memory>
 #include <map>
@@ -23,10 +27,14 @@
 #include <yosys/module.h>
 #include <routing/cola_router.h>
 
+#include "qnetlistitemfactory.h"
+
 namespace OpenNetlistView {
 
 // forward declaration
 class QNetlistScene;
+class QNetListView;
+class QRoutingDriver;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -47,20 +55,39 @@ class NetlistTab : public QWidget
 {
     Q_OBJECT
 
+private:
+    constexpr const static double expandMargin{20.0}; ///< The margin between the frame of an expanded node and its contents.
+    constexpr const static double expandHeader{20.0}; ///< The height of the header of an expanded node showing its name.
+
+    /**
+     * @struct ExpandedInstance
+     * @brief The routing state of a submodule that is expanded in place.
+     */
+    struct ExpandedInstance
+    {
+        std::shared_ptr<Yosys::Module> module;   ///< The copy of the submodule only used by this instance.
+        std::unique_ptr<Routing::Router> router; ///< The router laying out the contents of the instance.
+        QRectF contentRect;                      ///< The area of the routed contents or empty while they are routed.
+    };
+
 public:
     /**
      * @brief Construct a new Netlist Tab object
      *
      * @param module The module to be displayed in the tab.
      * @param symbols The symbols used for display.
+     * @param renderers The renderers of the symbols, shared by the tabs with the same symbols.
      * @param modulePath The path of the module in the design.
      * @param routingParameters The routing parameters for the module.
+     * @param routingDriver The driver routing the module in time slices or nullptr to route blocking.
      * @param parent The parent widget.
      */
     NetlistTab(const std::shared_ptr<Yosys::Module>& module,
         const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+        const std::shared_ptr<QNetlistItemFactory::Renderers>& renderers,
         const QString& modulePath,
         const Routing::ColaRoutingParameters& routingParameters,
+        QRoutingDriver* routingDriver = nullptr,
         QWidget* parent = nullptr);
 
     /**
@@ -72,6 +99,9 @@ public:
     /**
      * @brief Upgrade the display
      *
+     * With a routing driver an unrouted module is routed in time slices and
+     * the scene is updated when the routing is finished, signaled by displayUpgraded().
+     *
      */
     void upgradeDisplay();
 
@@ -95,12 +125,26 @@ public:
      */
     QString getModulePath() const;
 
+    /**
+     * @brief Get the module displayed in the tab
+     *
+     * @return std::shared_ptr<Yosys::Module> The module of the tab.
+     */
+    std::shared_ptr<Yosys::Module> getModule() const;
+
     /**
      * @brief update the symbols for drawing the netlist
      *
+     * If the geometry of the symbols used by the module did not change the
+     * layout is kept and the scene is rebuilt with the new symbols,
+     * otherwise the routing data is cleared.
+     *
      * @param symbols the updated symbols
+     * @param renderers the renderers of the updated symbols
+     * @return true if the layout was kept, false if the module has to be routed again
      */
-    void updateSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols);
+    bool updateSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+        const std::shared_ptr<QNetlistItemFactory::Renderers>& renderers);
 
     /**
      * @brief recievs the changed routing parameters and sends them to the router
@@ -112,8 +156,39 @@ public:
      */
     Routing::ColaRoutingParameters getRoutingParameters();
 
+    /**
+     * @brief get the view displaying the netlist of the tab
+     *
+     * @return QNetListView* The view of the tab.
+     */
+    QNetListView* getNetlistView() const;
+
+public slots:
+
+    /**
+     * @brief expands or collapses a submodule instance in place
+     *
+     * the node of the instance is resized to contain the routed contents
+     * of its module. The contents are a copy of the submodule, so other
+     * instances and tabs of the same module keep their own layout. The
+     * nodes around the instance are moved to make room for it and only
+     * their connections are rerouted. The module of the tab is shared with
+     * the other tabs and the exporter, so the first expanded instance makes
+     * the tab route a copy of it before the nodes are moved. Unknown
+     * instances are ignored.
+     *
+     * @param nodeName The name of the node instance.
+     */
+    void toggleExpandInPlace(const QString& nodeName);
+
 signals:
 
+    /**
+     * @brief Signal emitted after the routed module was added to the scene
+     *
+     */
+    void displayUpgraded();
+
     /**
      * @brief Signal for zooming into the scene
      *
@@ -151,6 +226,30 @@ signals:
      */
     void zoomToNode(const QString& nodeName);
 
+    /**
+     * @brief Signal for highlighting the paths carrying one of the given bits
+     *
+     * @param bits The bits of the net in the module of the tab.
+     * @param color The color to use for highlighting.
+     */
+    void highlightBits(const QStringList& bits, const QColor& color);
+
+    /**
+     * @brief Signal for a net being highlighted in the view
+     *
+     * @param modulePath The path of the module of the tab.
+     * @param bits The highlighted bits in the module of the tab.
+     * @param color The color used for highlighting.
+     */
+    void netHighlighted(const QString& modulePath, const QStringList& bits, const QColor& color);
+
+    /**
+     * @brief Signal for enabling or disabling tile rendering of the view
+     *
+     * @param enabled true to draw the view from cached tiles
+     */
+    void setTileRendering(bool enabled);
+
     /**
      * @brief Signal for exporting the scene to an SVG file
      *
@@ -167,14 +266,35 @@ signals:
      */
     void genericModuleDoubleClicked(const QString& moduleName, const QString& moduleType);
 
+    /**
+     * @brief Signal for the fan-in and fan-out of a node or path being requested
+     *
+     * @param name The name of the node or path.
+     */
+    void coneRequested(const QString& name);
+
+    /**
+     * @brief Signal for a port of the module being double clicked
+     *
+     * @param portName The name of the port.
+     */
+    void modulePortDoubleClicked(const QString& portName);
+
 private:
     Ui::NetlistTab* ui;   ///< The user interface for the tab.
     QNetlistScene* scene; ///< The scene for the tab.
 
-    QString modulePath;                                                          ///< The path of the module in the design.
-    std::shared_ptr<Yosys::Module> module;                                       ///< The module to be displayed in the tab.
-    std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>> symbols; ///< The symbols used for display
-    Routing::Router router;                                                      ///< The router for the module.
+    QString modulePath;                                                            ///< The path of the module in the design.
+    std::shared_ptr<Yosys::Module> module;                                         ///< The module to be displayed in the tab.
+    std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>> symbols;   ///< The symbols used for display
+    std::shared_ptr<QNetlistItemFactory::Renderers> renderers;                     ///< The renderers of the symbols used for new items.
+    std::shared_ptr<QNetlistItemFactory::Renderers> sceneRenderers;                ///< The renderers used by the items in the scene, kept until it is rebuilt.
+    std::unique_ptr<Routing::Router> router = std::make_unique<Routing::Router>(); ///< The router for the module.
+    std::unique_ptr<Routing::Router> sharedRouter;                                 ///< The router of the shared module, kept while it is used by others.
+    QPointer<QRoutingDriver> routingDriver;                                        ///< The driver routing the module in time slices.
+    bool firstDisplay = true;                                                      ///< Flag if the routed module was not displayed yet.
+    std::map<QString, ExpandedInstance> expandedInstances;                         ///< The instances expanded in place by node name.
+    bool ownsModule = false;                                                       ///< Flag if the module is a copy only used by this tab.
 
     /**
      * @brief Set the visibility of the module path
@@ -183,6 +303,60 @@ private:
      *
      */
     void setModuleHierarchyVisible();
+
+    /**
+     * @brief Places the expanded instances and fills the scene after the module was routed
+     *
+     * @param wasRouted true if the module was already routed before the display was upgraded.
+     */
+    void finishUpgradeDisplay(bool wasRouted);
+
+    /**
+     * @brief Routes the contents of an expanded instance
+     *
+     * With a routing driver the contents are routed in time slices,
+     * the node is resized when the routing is finished.
+     *
+     * @param nodeName The name of the node instance.
+     */
+    void routeExpandedInstance(const QString& nodeName);
+
+    /**
+     * @brief Resizes the node of an instance after its contents were routed
+     *
+     * An instance without contents is collapsed again.
+     *
+     * @param nodeName The name of the node instance.
+     */
+    void finishExpandedInstance(const QString& nodeName);
+
+    /**
+     * @brief Clears the routing of the contents of the expanded instances
+     *
+     */
+    void clearExpandedInstances();
+
+    /**
+     * @brief Resizes the node of an instance in the routed parent module
+     *
+     * @param nodeName The name of the node instance.
+     * @param expanded true to fit the contents of the instance otherwise the symbol is used.
+     */
+    void resizeInstanceNode(const QString& nodeName, bool expanded);
+
+    /**
+     * @brief Fills the scene with the routed module and the expanded instances
+     *
+     */
+    void rebuildScene();
+
+    /**
+     * @brief Get the node of the module with the given name
+     *
+     * @param nodeName The name of the node.
+     * @return std::shared_ptr<Yosys::Node> The node or nullptr if it does not exist.
+     */
+    std::shared_ptr<Yosys::Node> getNodeByName(const QString& nodeName) const;
 };
 
 } // namespace OpenNetlistView
@@ -7,6 +7,7 @@
 #include <QIODevice>
 #include <QTextStream>
 #include <QRectF>
+#include <QSizeF>
 #include <QPointF>
 #include <QDomDocument>
 #include <QGraphicsScene>
@@ -142,11 +143,73 @@ std::vector<std::pair<QString, QString>> QNetlistGraphicsNode::getProperties()
     return properties;
 }
 
+void QNetlistGraphicsNode::setExpandedSize(const QSizeF& size)
+{
+    prepareGeometryChange();
+    this->expandedSize = size;
+
+    // the text items are placed for the symbol
+    for(auto& textItem : this->nodeTextItems)
+    {
+        textItem->setVisible(!this->isExpanded());
+    }
+
+    this->update();
+}
+
+bool QNetlistGraphicsNode::isExpanded() const
+{
+    return !this->expandedSize.isEmpty();
+}
+
+QRectF QNetlistGraphicsNode::boundingRect() const
+{
+    if(this->isExpanded())
+    {
+        return {QPointF(0, 0), this->expandedSize};
+    }
+
+    return QGraphicsSvgItem::boundingRect();
+}
+
 void QNetlistGraphicsNode::paint(QPainter* painter,
     const QStyleOptionGraphicsItem* option,
     QWidget* widget)
 {
 
+    // an expanded node draws a frame with the instance name
+    // the contents of the submodule are drawn by the child items
+    if(this->isExpanded())
+    {
+        painter->setPen(QPen(Qt::darkGray, expandedFramePenWidth, Qt::DashLine));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(boundingRect());
+
+        auto nodeInst = std::dynamic_pointer_cast<Yosys::Node>(component);
+
+        if(nodeInst != nullptr)
+        {
+            painter->setPen(Qt::black);
+            painter->setFont(QFont("Arial", fontSize));
+            painter->drawText(boundingRect().adjusted(fontSize / 2.0, fontSize / 2.0, 0, 0),
+                Qt::AlignLeft | Qt::AlignTop,
+                nodeInst->getType() + ":" + nodeInst->getName());
+        }
+
+        if((option->state & QStyle::State_Selected) != 0)
+        {
+            painter->setPen(QPen(Qt::red, 1, Qt::DashLine));
+            painter->drawRect(boundingRect());
+        }
+        else if(highlightColor != Qt::transparent)
+        {
+            painter->setPen(QPen(highlightColor, 1, Qt::DashLine));
+            painter->drawRect(boundingRect());
+        }
+
+        return;
+    }
+
     // remove the options that should be customized to
     // avoid the default functionality of the base class
     auto modifiedOption = *option;
@@ -199,6 +262,12 @@ void QNetlistGraphicsNode::setTextPath()
     // check if the component is a node
     auto nodeInst = std::dynamic_pointer_cast<Yosys::Node>(component);
 
+    // arrayed nodes show the number of folded cells below the symbol
+    if(nodeInst != nullptr && nodeInst->getSliceCount() > 1)
+    {
+        this->createPortTextItem(QString("\u00d7%1").arg(nodeInst->getSliceCount()));
+    }
+
     // only add the type of the module if it is a generic module
     if(nodeInst == nullptr ||
         (nodeInst->getSymbol() != nullptr && !nodeInst->getSymbol()->isGenericSymbol()))
@@ -324,6 +393,13 @@ std::vector<std::pair<QString, QString>> QNetlistGraphicsNode::getNodeProperties
     // add the name of the node
     properties.emplace_back(QObject::tr(propertyTypeName), nodeInst->getName());
 
+    // add the cells an arrayed node was folded from
+    if(nodeInst->getSliceCount() > 1)
+    {
+        properties.emplace_back(QObject::tr(propertyTypeFoldedCells),
+            QString::number(nodeInst->getSliceCount()) + ": " + nodeInst->getFoldedNames().join(", "));
+    }
+
     // get the number of inputs and outputs
     long inputs = 0;
     long outputs = 0;
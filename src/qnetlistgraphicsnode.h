@@ -65,6 +65,7 @@ private:
     constexpr const static char* propertyTypeNodeOutputAmount{"Number of outputs:"}; ///< the number of outputs of the node in the properties dialog
     constexpr const static char* propertyTypeNodeInputName{"Input:"};                ///< the name of the input path in the properties dialog
     constexpr const static char* propertyTypeNodeOutputName{"Output:"};              ///< the name of the output path in the properties dialog
+    constexpr const static char* propertyTypeFoldedCells{"Folded cells:"};           ///< the names of the cells folded into the node in the properties dialog
 
     constexpr const static char* propertyValuePortType{"port"};       ///< the type of the port in the properties dialog
     constexpr const static char* propertyValuePortInput{"INPUT"};     ///< the input direction of the port in the properties dialog
@@ -77,6 +78,8 @@ private:
     constexpr const static int fontSize{10};     ///< the font size used for the port names
     constexpr const static float fontScale{0.5}; ///< the scale of the font for the port names
 
+    constexpr const static int expandedFramePenWidth{1}; ///< the pen width of the frame of an expanded node
+
 public:
     /**
      * @brief Construct a new QNetlistGraphicsItem object
@@ -141,6 +144,31 @@ public:
      */
     std::vector<std::pair<QString, QString>> getProperties();
 
+    /**
+     * @brief Show the node as an expanded frame instead of its symbol
+     *
+     * the frame is used to display the contents of the submodule
+     * as child items. The text items of the symbol are hidden.
+     * An empty size shows the symbol again.
+     *
+     * @param size The size of the frame in scene units.
+     */
+    void setExpandedSize(const QSizeF& size);
+
+    /**
+     * @brief Get if the node is shown as an expanded frame
+     *
+     * @return true if the node is expanded
+     */
+    bool isExpanded() const;
+
+    /**
+     * @brief Get the bounding rectangle of the item
+     *
+     * @return QRectF The rectangle of the frame when expanded otherwise of the symbol.
+     */
+    QRectF boundingRect() const override;
+
 protected:
     /**
      * @brief Paints the item as a SVG item.
@@ -202,6 +230,7 @@ private:
     std::vector<QNetlistGraphicsText*> nodeTextItems; ///< The text items for the paths
 
     QColor highlightColor = Qt::transparent; ///< The color to use for highlighting the item.
+    QSizeF expandedSize;                     ///< The size of the frame when the node is expanded.
 };
 
 } // namespace OpenNetlistView
@@ -14,8 +14,6 @@
 #include <QString>
 #include <QColor>
 
-#include <third_party/libavoid/connector.h>
-
 #include <memory>
 #include <vector>
 #include <utility>
@@ -103,9 +101,9 @@ void QNetlistGraphicsPath::setSrcTextPort(const QPointF& pos)
     this->srcTextPos = pos;
 }
 
-void QNetlistGraphicsPath::addDstTextPort(const QPointF& pos, Avoid::ConnRef* avoidRef)
+void QNetlistGraphicsPath::addDstTextPort(const QPointF& pos, const std::shared_ptr<Yosys::Port>& destination)
 {
-    this->dstTextPosList.emplace_back(pos, avoidRef);
+    this->dstTextPosList.emplace_back(pos, destination);
 }
 
 void QNetlistGraphicsPath::addDivergingPoint(const QPointF& pos)
@@ -287,9 +285,9 @@ void QNetlistGraphicsPath::placePathText()
     }
 
     // create dst text items
-    for(auto& [pos, avoidRef] : this->dstTextPosList)
+    for(auto& [pos, destination] : this->dstTextPosList)
     {
-        const QString pathName = this->yosysPath->generateLabelText(avoidRef);
+        const QString pathName = this->yosysPath->generateLabelText(destination);
         if(pathName != "")
         {
             this->createTextItem(pathName, pos, true);
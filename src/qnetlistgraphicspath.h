@@ -21,14 +21,11 @@
 #include "qnetlistgraphicsellipse.h"
 #include "qnetlistgraphicstext.h"
 
-namespace Avoid {
-class ConnRef;
-}
-
 namespace OpenNetlistView {
 
 namespace Yosys {
 class Path;
+class Port;
 }
 
 /**
@@ -122,8 +119,9 @@ public:
      * @brief Adds a destination text port to the path.
      *
      * @param pos The position of the destination text port.
+     * @param destination The destination port the text belongs to.
      */
-    void addDstTextPort(const QPointF& pos, Avoid::ConnRef* avoidRef);
+    void addDstTextPort(const QPointF& pos, const std::shared_ptr<Yosys::Port>& destination);
 
     /**
      * @brief Adds a diverging point to the path.
@@ -200,12 +198,12 @@ private:
      */
     void placeDivergingPoints();
 
-    std::shared_ptr<Yosys::Path> yosysPath;                           ///< The yosys path of the path.
-    QPointF srcTextPos;                                               ///< The position of the source text.
-    std::vector<std::tuple<QPointF, Avoid::ConnRef*>> dstTextPosList; ///< The list of destination text positions.
-    std::vector<QNetlistGraphicsText*> pathTextItems;                 ///< The list of path text items.
-    std::vector<QPointF> divergingPoints;                             ///< The list of diverging points.
-    std::vector<QNetlistGraphicsEllipse*> divergingPointsSymbols;     ///< The list of diverging point symbols.
+    std::shared_ptr<Yosys::Path> yosysPath;                                        ///< The yosys path of the path.
+    QPointF srcTextPos;                                                            ///< The position of the source text.
+    std::vector<std::tuple<QPointF, std::shared_ptr<Yosys::Port>>> dstTextPosList; ///< The list of destination text positions.
+    std::vector<QNetlistGraphicsText*> pathTextItems;                              ///< The list of path text items.
+    std::vector<QPointF> divergingPoints;                                          ///< The list of diverging points.
+    std::vector<QNetlistGraphicsEllipse*> divergingPointsSymbols;                  ///< The list of diverging point symbols.
 
     QColor highlightColor = Qt::transparent; ///< The color to use for highlighting the item.
 };
@@ -0,0 +1,202 @@
+#include <QGraphicsItem>
+#include <QSvgRenderer>
+#include <QString>
+#include <QRectF>
+#include <QPointF>
+#include <QPen>
+#include <QtCore/Qt>
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include <yosys/module.h>
+#include <yosys/node.h>
+#include <yosys/port.h>
+#include <yosys/path.h>
+#include <symbol/symbol.h>
+
+#include "qnetlistgraphicsnode.h"
+#include "qnetlistgraphicspath.h"
+
+#include "qnetlistitemfactory.h"
+
+namespace OpenNetlistView {
+
+std::vector<QGraphicsItem*> QNetlistItemFactory::createItems(const std::shared_ptr<Yosys::Module>& module, Renderers& renderers)
+{
+    const auto paths = module->getPaths();
+    const auto nodes = module->getNodes();
+    const auto ports = module->getPorts();
+
+    // converts all the paths, nodes and ports to QGraphicsItems
+    std::vector<QGraphicsItem*> qItems;
+    qItems.reserve(paths->size() + nodes->size() + ports->size());
+
+    const auto pathGeometries = module->createPathGeometries();
+
+    for(size_t pathIdx = 0; pathIdx < paths->size(); pathIdx++)
+    {
+        qItems.emplace_back(createPathItem(paths->at(pathIdx), pathGeometries[pathIdx]));
+    }
+
+    for(const auto& node : *nodes)
+    {
+        qItems.emplace_back(createNodeItem(node, renderers));
+    }
+
+    for(const auto& port : *ports)
+    {
+        qItems.emplace_back(createPortItem(port, renderers));
+    }
+
+    return qItems;
+}
+
+QNetlistGraphicsPath* QNetlistItemFactory::createPathItem(const std::shared_ptr<Yosys::Path>& path)
+{
+    return createPathItem(path, path->createGeometry());
+}
+
+QNetlistGraphicsPath* QNetlistItemFactory::createPathItem(const std::shared_ptr<Yosys::Path>& path, const Yosys::Path::Geometry& geometry)
+{
+
+    auto* qPathItem = new QNetlistGraphicsPath();
+
+    if(geometry.painterPath.isEmpty())
+    {
+        qPathItem->setYosysPath(path);
+        return qPathItem;
+    }
+
+    if(geometry.srcTextPos.has_value())
+    {
+        qPathItem->setSrcTextPort(*geometry.srcTextPos);
+    }
+
+    for(const auto& [pos, destination] : geometry.dstTextPorts)
+    {
+        qPathItem->addDstTextPort(pos, destination);
+    }
+
+    for(const auto& junction : geometry.junctions)
+    {
+        qPathItem->addDivergingPoint(junction);
+    }
+
+    qPathItem->setPath(geometry.painterPath);
+
+    // set the pen strength
+    double lineSize = lineStrength;
+
+    if(path->isBus())
+    {
+        lineSize = busLineStrength;
+    }
+
+    qPathItem->setPen(QPen(Qt::black,
+        lineSize,
+        Qt::SolidLine,
+        Qt::SquareCap,
+        Qt::RoundJoin));
+
+    // the labels are placed at the text positions set before
+    qPathItem->setYosysPath(path);
+
+    // set the paths qtitem to the one created
+    path->setGraphicsItem(qPathItem);
+
+    return qPathItem;
+}
+
+QNetlistGraphicsNode* QNetlistItemFactory::createNodeItem(const std::shared_ptr<Yosys::Node>& node, Renderers& renderers)
+{
+
+    auto* svgItem = new QNetlistGraphicsNode();
+
+    const auto symbol = node->getSymbol();
+
+    // get the renderer if it is not null set it to the svg item
+    auto* qRenderer = getRenderer(symbol, renderers);
+
+    if(qRenderer != nullptr)
+    {
+        svgItem->setSharedRenderer(qRenderer);
+    }
+
+    // set the position of the symbol
+    const QPointF centerPoint = node->getRoutedRect().center();
+
+    const auto boundingBox = symbol->getBoundingBox();
+
+    svgItem->setPos(centerPoint.x() - (boundingBox.first / 2),
+        centerPoint.y() - (boundingBox.second / 2));
+
+    svgItem->setComponent(node);
+
+    // set the nodes qtitem to the one created
+    node->setGraphicsItem(svgItem);
+
+    return svgItem;
+}
+
+QNetlistGraphicsNode* QNetlistItemFactory::createPortItem(const std::shared_ptr<Yosys::Port>& port, Renderers& renderers)
+{
+
+    auto* svgItem = new QNetlistGraphicsNode();
+
+    const auto symbol = port->getSymbol();
+
+    auto* qRenderer = getRenderer(symbol, renderers);
+
+    const QRectF routedRect = port->getRoutedRect();
+
+    if(qRenderer == nullptr || routedRect.isNull())
+    {
+        svgItem->setComponent(port);
+        return svgItem;
+    }
+
+    // set the symbols renderer
+    svgItem->setSharedRenderer(qRenderer);
+
+    // set the position of the symbol
+    const QPointF centerPoint = routedRect.center();
+
+    const auto boundingBox = symbol->getBoundingBox();
+
+    svgItem->setPos(centerPoint.x() - (boundingBox.first / 2), centerPoint.y() - (boundingBox.second / 2));
+
+    svgItem->setComponent(port);
+
+    // set the qtitem as the ports item
+    port->setGraphicsItem(svgItem);
+
+    return svgItem;
+}
+
+QSvgRenderer* QNetlistItemFactory::getRenderer(const std::shared_ptr<Symbol::Symbol>& symbol, Renderers& renderers)
+{
+    if(symbol == nullptr)
+    {
+        return nullptr;
+    }
+
+    const QString svgData = symbol->getSvgData();
+
+    if(svgData.isEmpty())
+    {
+        return nullptr;
+    }
+
+    auto& renderer = renderers[svgData];
+
+    if(renderer == nullptr)
+    {
+        renderer = std::make_unique<QSvgRenderer>(svgData.toUtf8());
+    }
+
+    return renderer.get();
+}
+
+} // namespace OpenNetlistView
@@ -0,0 +1,119 @@
+/**
+ * @file qnetlistitemfactory.h
+ * @brief Header file for the QNetlistItemFactory class.
+ *
+ * This file contains the declaration of the QNetlistItemFactory class, which
+ * converts the routed nodes, ports and paths of a module into the graphics
+ * items of the scene. It is the only place where the model meets the
+ * graphics classes, so the model, parser and routing libraries do not
+ * depend on QtWidgets or QtSvg.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __QNETLISTITEMFACTORY_H__
+#define __QNETLISTITEMFACTORY_H__
+
+#include <QGraphicsItem>
+#include <QSvgRenderer>
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#include <yosys/module.h>
+#include <yosys/node.h>
+#include <yosys/port.h>
+#include <yosys/path.h>
+#include <symbol/symbol.h>
+
+#include "qnetlistgraphicsnode.h"
+#include "qnetlistgraphicspath.h"
+
+namespace OpenNetlistView {
+
+/**
+ * @class QNetlistItemFactory
+ * @brief Creates the graphics items of a routed module.
+ *
+ * The created items are stored as the graphics items of their components.
+ * The SVG renderers of the symbols are created on the first use and shared
+ * by all items with the same symbol data. They are stored in the renderers
+ * passed by the caller, which must outlive the created items, so the
+ * factory must only be used on the GUI thread.
+ */
+class QNetlistItemFactory
+{
+private:
+    constexpr const static double lineStrength{0.5F};    ///< the strength of the line (not a bus)
+    constexpr const static double busLineStrength{2.0F}; ///< the strength of the line (bus)
+
+public:
+    /**
+     * @brief The SVG renderers of one symbol set by the SVG data of the symbols
+     */
+    using Renderers = std::unordered_map<QString, std::unique_ptr<QSvgRenderer>>;
+
+    /**
+     * @brief converts all paths, nodes and ports of the module to QGraphicsItems
+     *
+     * The geometry of the paths is created on worker threads first,
+     * the graphics items are created on the calling thread.
+     *
+     * @param module The routed module.
+     * @param renderers The renderers of the symbols used by the module.
+     * @return std::vector<QGraphicsItem*> the items of the paths, nodes and ports in this order
+     */
+    static std::vector<QGraphicsItem*> createItems(const std::shared_ptr<Yosys::Module>& module, Renderers& renderers);
+
+    /**
+     * @brief Converts the path to a Qt path.
+     *
+     * @param path The routed path.
+     * @return A pointer to the Qt path.
+     */
+    static QNetlistGraphicsPath* createPathItem(const std::shared_ptr<Yosys::Path>& path);
+
+    /**
+     * @brief Converts the path to a Qt path with a geometry created before.
+     *
+     * @param path The routed path.
+     * @param geometry The geometry created by Path::createGeometry().
+     * @return A pointer to the Qt path.
+     */
+    static QNetlistGraphicsPath* createPathItem(const std::shared_ptr<Yosys::Path>& path, const Yosys::Path::Geometry& geometry);
+
+    /**
+     * @brief Converts the node to a QGraphicsSvgItem.
+     *
+     * @param node The routed node.
+     * @param renderers The renderers of the symbols used by the module.
+     * @return The item representing the node.
+     */
+    static QNetlistGraphicsNode* createNodeItem(const std::shared_ptr<Yosys::Node>& node, Renderers& renderers);
+
+    /**
+     * @brief Converts the port to a QGraphicsSvgItem.
+     *
+     * @param port The routed port.
+     * @param renderers The renderers of the symbols used by the module.
+     * @return The item representing the port.
+     */
+    static QNetlistGraphicsNode* createPortItem(const std::shared_ptr<Yosys::Port>& port, Renderers& renderers);
+
+private:
+    /**
+     * @brief Get the shared SVG renderer for the data of the symbol
+     *
+     * @param symbol The symbol to render.
+     * @param renderers The renderers to take the renderer from or to add it to.
+     * @return The renderer or nullptr if the symbol has no SVG data.
+     */
+    static QSvgRenderer* getRenderer(const std::shared_ptr<Symbol::Symbol>& symbol, Renderers& renderers);
+};
+
+} // namespace OpenNetlistView
+
+#endif // __QNETLISTITEMFACTORY_H__
@@ -0,0 +1,134 @@
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QMetaObject>
+#include <QtCore/Qt>
+
+#include <memory>
+#include <functional>
+#include <exception>
+#include <utility>
+
+#include <yosys/designloader.h>
+#include <scheduler/taskscheduler.h>
+
+#include "qnetlistloader.h"
+
+namespace OpenNetlistView {
+
+QNetlistLoader::QNetlistLoader(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QNetlistLoader::~QNetlistLoader()
+{
+    // the task posts its result to this object
+    loadToken.cancel();
+    Scheduler::TaskScheduler::getShared().wait(loadJobs);
+}
+
+void QNetlistLoader::load(const QString& fileName,
+    const QByteArray& fileContent,
+    const Yosys::DesignLoader& designLoader,
+    std::function<void(Yosys::DesignLoader::Result&)> finished)
+{
+    cancel();
+
+    // every loading gets its own token, so canceling
+    // it does not affect the loading started next
+    loadToken = Scheduler::CancellationToken();
+    this->finished = std::move(finished);
+    loading = true;
+
+    const uint64_t loadId = ++currentLoadId;
+    const Scheduler::CancellationToken token = loadToken;
+
+    Scheduler::TaskScheduler::getShared().submit(
+        [this, loadId, token, fileName, fileContent, designLoader]() {
+            std::shared_ptr<Yosys::DesignLoader::Result> result;
+            QString error;
+
+            try
+            {
+                result = designLoader.load(fileName, fileContent, token, [this, loadId](Yosys::DesignLoader::EStage stage) {
+                    QMetaObject::invokeMethod(
+                        this,
+                        [this, loadId, stage]() {
+                            stageReached(loadId, stage);
+                        },
+                        Qt::QueuedConnection);
+                });
+            }
+            catch(const std::exception& e)
+            {
+                result = nullptr;
+                error = e.what();
+            }
+
+            // hand the result back to the GUI thread
+            QMetaObject::invokeMethod(
+                this,
+                [this, loadId, result, error]() {
+                    loadFinished(loadId, result, error);
+                },
+                Qt::QueuedConnection);
+        },
+        Scheduler::TaskScheduler::EPriority::NORMAL, &loadJobs, token);
+}
+
+void QNetlistLoader::cancel()
+{
+    if(!loading)
+    {
+        return;
+    }
+
+    // the task stops at the next stage and its result is dropped
+    loadToken.cancel();
+    finished = nullptr;
+    loading = false;
+}
+
+bool QNetlistLoader::isLoading() const
+{
+    return loading;
+}
+
+void QNetlistLoader::stageReached(uint64_t loadId, Yosys::DesignLoader::EStage stage)
+{
+    if(!loading || loadId != currentLoadId)
+    {
+        return;
+    }
+
+    emit stageStarted(stage);
+}
+
+void QNetlistLoader::loadFinished(uint64_t loadId, const std::shared_ptr<Yosys::DesignLoader::Result>& result, const QString& error)
+{
+    // drop the results of canceled loadings
+    if(!loading || loadId != currentLoadId)
+    {
+        return;
+    }
+
+    loading = false;
+
+    // the callback may start the next loading
+    auto loadedCallback = std::move(finished);
+    finished = nullptr;
+
+    if(result == nullptr)
+    {
+        emit loadFailed(error);
+        return;
+    }
+
+    if(loadedCallback)
+    {
+        loadedCallback(*result);
+    }
+}
+
+} // namespace OpenNetlistView
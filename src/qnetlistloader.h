@@ -0,0 +1,131 @@
+/**
+ * @file qnetlistloader.h
+ * @brief Header file for the QNetlistLoader class.
+ *
+ * This file contains the declaration of the QNetlistLoader class, which runs
+ * the loading of a design on the shared task scheduler and hands the finished
+ * design back to the GUI thread, so the window stays responsive while a large
+ * netlist is read, parsed and linked.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __QNETLISTLOADER_H__
+#define __QNETLISTLOADER_H__
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+#include <yosys/designloader.h>
+#include <scheduler/taskscheduler.h>
+
+namespace OpenNetlistView {
+
+/**
+ * @class QNetlistLoader
+ * @brief Loads one design at a time in the background.
+ *
+ * The stages of Yosys::DesignLoader are run as one task of the shared task
+ * scheduler. The started stages and the result are posted back to the thread
+ * of the loader, the finished design is handed over in one call so the GUI
+ * never sees a half loaded diagram. Starting a new loading cancels the
+ * running one and its result is dropped.
+ */
+class QNetlistLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Construct a new QNetlistLoader object
+     *
+     * @param parent The parent object.
+     */
+    explicit QNetlistLoader(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the QNetlistLoader object
+     *
+     * cancels the running loading and waits for its task
+     */
+    ~QNetlistLoader();
+
+    /**
+     * @brief Starts loading a design
+     *
+     * A running loading is canceled first.
+     *
+     * @param fileName The name of the file, it is read by the task if the content is empty.
+     * @param fileContent The content of the file or an empty array.
+     * @param designLoader The loader with the parse settings, it is copied.
+     * @param finished Called on the thread of the loader with the loaded design.
+     */
+    void load(const QString& fileName,
+        const QByteArray& fileContent,
+        const Yosys::DesignLoader& designLoader,
+        std::function<void(Yosys::DesignLoader::Result&)> finished);
+
+    /**
+     * @brief Cancels the running loading
+     *
+     * The finished callback is not called and no signal is emitted.
+     */
+    void cancel();
+
+    /**
+     * @brief Check if a design is loaded
+     *
+     * @return true if a loading was started and has not finished yet
+     */
+    bool isLoading() const;
+
+signals:
+    /**
+     * @brief Signal emitted when a stage of the loading is started
+     *
+     * @param stage The started stage.
+     */
+    void stageStarted(Yosys::DesignLoader::EStage stage);
+
+    /**
+     * @brief Signal emitted when the loading failed
+     *
+     * @param message The error message.
+     */
+    void loadFailed(const QString& message);
+
+private:
+    /**
+     * @brief Forwards a started stage of a loading
+     *
+     * @param loadId The id of the loading.
+     * @param stage The started stage.
+     */
+    void stageReached(uint64_t loadId, Yosys::DesignLoader::EStage stage);
+
+    /**
+     * @brief Hands the result of a loading to the finished callback
+     *
+     * Results of canceled loadings are dropped.
+     *
+     * @param loadId The id of the loading.
+     * @param result The loaded design or nullptr if the loading failed.
+     * @param error The error message if the loading failed.
+     */
+    void loadFinished(uint64_t loadId, const std::shared_ptr<Yosys::DesignLoader::Result>& result, const QString& error);
+
+    Scheduler::TaskGroup loadJobs;                              ///< The tasks of the started loadings.
+    Scheduler::CancellationToken loadToken;                     ///< Cancels the running loading.
+    std::function<void(Yosys::DesignLoader::Result&)> finished; ///< The callback of the running loading.
+    uint64_t currentLoadId = 0;                                 ///< The id of the running loading.
+    bool loading = false;                                       ///< If a loading is running.
+};
+
+} // namespace OpenNetlistView
+
+#endif // __QNETLISTLOADER_H__
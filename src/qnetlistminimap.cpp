@@ -0,0 +1,258 @@
+#include <QWidget>
+#include <QPainter>
+#include <QPixmap>
+#include <QColor>
+#include <QPen>
+#include <QBrush>
+#include <QScrollBar>
+#include <QGraphicsScene>
+#include <QSizePolicy>
+#include <QtCore/Qt>
+
+#include <algorithm>
+
+#include "qnetlistview.h"
+
+#include "qnetlistminimap.h"
+
+namespace OpenNetlistView {
+
+QNetlistMinimap::QNetlistMinimap(QWidget* parent)
+    : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+    setMouseTracking(false);
+}
+
+QNetlistMinimap::~QNetlistMinimap() = default;
+
+void QNetlistMinimap::setView(QNetListView* view)
+{
+    if(this->view == view)
+    {
+        return;
+    }
+
+    // disconnect the old view and its scroll bars
+    if(this->view != nullptr)
+    {
+        disconnect(this->view, nullptr, this, nullptr);
+        disconnect(this->view->horizontalScrollBar(), nullptr, this, nullptr);
+        disconnect(this->view->verticalScrollBar(), nullptr, this, nullptr);
+    }
+
+    this->view = view;
+
+    if(view != nullptr)
+    {
+        // moving or zooming the view only changes the viewport rectangle
+        connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, &QNetlistMinimap::updateViewportRect);
+        connect(view->verticalScrollBar(), &QScrollBar::valueChanged, this, &QNetlistMinimap::updateViewportRect);
+        connect(view->horizontalScrollBar(), &QScrollBar::rangeChanged, this, &QNetlistMinimap::updateViewportRect);
+        connect(view->verticalScrollBar(), &QScrollBar::rangeChanged, this, &QNetlistMinimap::updateViewportRect);
+
+        // changing the content of the scene requires a new overview
+        connect(view, &QNetListView::highlightChanged, this, &QNetlistMinimap::invalidateCache);
+    }
+
+    invalidateCache();
+}
+
+QNetListView* QNetlistMinimap::getView() const
+{
+    return view;
+}
+
+QSize QNetlistMinimap::sizeHint() const
+{
+    return {maxCacheSize / 2, maxCacheSize / 2};
+}
+
+void QNetlistMinimap::invalidateCache()
+{
+    // only mark the cache, rendering is done on the next repaint
+    // so hidden minimaps never render the scene
+    cacheDirty = true;
+    update();
+}
+
+void QNetlistMinimap::updateViewportRect()
+{
+    update();
+}
+
+void QNetlistMinimap::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    if(view == nullptr || view->scene() == nullptr)
+    {
+        return;
+    }
+
+    // the scene rect can grow without any highlight or routing change
+    if(cacheDirty || cachedSceneRect != view->scene()->sceneRect())
+    {
+        renderCache();
+    }
+
+    const QRectF target = overviewRect();
+
+    if(overviewCache.isNull() || target.isEmpty())
+    {
+        return;
+    }
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawPixmap(target, overviewCache, QRectF(overviewCache.rect()));
+
+    // draw the area of the scene that is visible in the view
+    const QRectF visibleSceneRect = view->mapToScene(view->viewport()->rect()).boundingRect();
+    const QRectF viewportRect = mapFromScene(visibleSceneRect).intersected(target);
+
+    QColor fillColor = palette().highlight().color();
+    fillColor.setAlpha(viewportFillAlpha);
+
+    painter.setPen(QPen(palette().highlight().color(), viewportPenWidth));
+    painter.setBrush(fillColor);
+    painter.drawRect(viewportRect);
+}
+
+void QNetlistMinimap::mousePressEvent(QMouseEvent* event)
+{
+    if(event->button() == Qt::LeftButton)
+    {
+        centerViewOn(event->position());
+        return;
+    }
+
+    QWidget::mousePressEvent(event);
+}
+
+void QNetlistMinimap::mouseMoveEvent(QMouseEvent* event)
+{
+    if((event->buttons() & Qt::LeftButton) != 0)
+    {
+        centerViewOn(event->position());
+        return;
+    }
+
+    QWidget::mouseMoveEvent(event);
+}
+
+void QNetlistMinimap::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    invalidateCache();
+}
+
+void QNetlistMinimap::renderCache()
+{
+    cacheDirty = false;
+    overviewCache = QPixmap();
+
+    auto* scene = view->scene();
+    cachedSceneRect = scene->sceneRect();
+
+    const QRectF target = overviewRect();
+
+    if(target.isEmpty())
+    {
+        return;
+    }
+
+    // limit the resolution of the cache so rendering stays cheap
+    // even when the minimap is large
+    const qreal pixelRatio = devicePixelRatioF();
+    QSize cacheSize = (target.size() * pixelRatio).toSize();
+    cacheSize = cacheSize.boundedTo(QSize(maxCacheSize, maxCacheSize) * pixelRatio);
+
+    if(cacheSize.isEmpty())
+    {
+        return;
+    }
+
+    overviewCache = QPixmap(cacheSize);
+    overviewCache.fill(Qt::white);
+
+    QPainter painter(&overviewCache);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    scene->render(&painter, QRectF(overviewCache.rect()), cachedSceneRect, Qt::KeepAspectRatio);
+    painter.end();
+}
+
+QRectF QNetlistMinimap::overviewRect() const
+{
+    const QRectF available = QRectF(rect()).adjusted(minimapMargin, minimapMargin, -minimapMargin, -minimapMargin);
+
+    if(view == nullptr || view->scene() == nullptr || available.isEmpty())
+    {
+        return {};
+    }
+
+    const QRectF sceneRect = view->scene()->sceneRect();
+
+    if(sceneRect.isEmpty())
+    {
+        return {};
+    }
+
+    // keep the aspect ratio of the scene and center the overview
+    const qreal scale = std::min(available.width() / sceneRect.width(), available.height() / sceneRect.height());
+    const QSizeF size = sceneRect.size() * scale;
+
+    QRectF target(QPointF(0, 0), size);
+    target.moveCenter(available.center());
+
+    return target;
+}
+
+QPointF QNetlistMinimap::mapToScene(const QPointF& widgetPos) const
+{
+    const QRectF target = overviewRect();
+
+    if(target.isEmpty())
+    {
+        return {};
+    }
+
+    const QRectF sceneRect = view->scene()->sceneRect();
+
+    const qreal xPos = sceneRect.left() + (widgetPos.x() - target.left()) * sceneRect.width() / target.width();
+    const qreal yPos = sceneRect.top() + (widgetPos.y() - target.top()) * sceneRect.height() / target.height();
+
+    return {xPos, yPos};
+}
+
+QRectF QNetlistMinimap::mapFromScene(const QRectF& sceneRect) const
+{
+    const QRectF target = overviewRect();
+
+    if(target.isEmpty())
+    {
+        return {};
+    }
+
+    const QRectF fullSceneRect = view->scene()->sceneRect();
+    const qreal scale = target.width() / fullSceneRect.width();
+
+    return {target.left() + (sceneRect.left() - fullSceneRect.left()) * scale,
+        target.top() + (sceneRect.top() - fullSceneRect.top()) * scale,
+        sceneRect.width() * scale,
+        sceneRect.height() * scale};
+}
+
+void QNetlistMinimap::centerViewOn(const QPointF& widgetPos)
+{
+    if(view == nullptr || view->scene() == nullptr)
+    {
+        return;
+    }
+
+    view->centerOn(mapToScene(widgetPos));
+}
+
+} // namespace OpenNetlistView
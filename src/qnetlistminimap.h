@@ -0,0 +1,179 @@
+/**
+ * @file qnetlistminimap.h
+ * @brief Header file for the QNetlistMinimap class.
+ *
+ * This file contains the declaration of the QNetlistMinimap class, which shows
+ * a small overview of the scene of a QNetListView together with the currently
+ * visible viewport and allows jumping to a position by clicking into it.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __QNETLISTMINIMAP_H__
+#define __QNETLISTMINIMAP_H__
+
+#include <QWidget>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QRectF>
+#include <QPointF>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QtCore/Qt>
+
+namespace OpenNetlistView {
+
+// forward declaration
+class QNetListView;
+
+/**
+ * @class QNetlistMinimap
+ * @brief A widget that displays an overview of the scene shown in a QNetListView.
+ *
+ * The scene is rendered only once into a low resolution pixmap which is reused
+ * for every repaint. The cache is marked dirty when the content of the scene
+ * changes (routing, highlighting) and is rebuilt lazily on the next repaint.
+ * Moving the main view only repaints the viewport rectangle on top of the cached
+ * pixmap, so navigating never requires painting the full detail scene.
+ */
+class QNetlistMinimap : public QWidget
+{
+    Q_OBJECT
+
+private:
+    constexpr const static int maxCacheSize{512};     ///< The maximum width or height of the cached pixmap in pixels.
+    constexpr const static int minimapMargin{4};      ///< The margin around the overview in pixels.
+    constexpr const static int viewportPenWidth{2};   ///< The pen width of the viewport rectangle.
+    constexpr const static int viewportFillAlpha{40}; ///< The alpha value of the viewport rectangle fill.
+
+public:
+    /**
+     * @brief Construct a new QNetlistMinimap object
+     *
+     * @param parent The parent widget.
+     */
+    explicit QNetlistMinimap(QWidget* parent = nullptr);
+
+    /**
+     * @brief Destroy the QNetlistMinimap object
+     *
+     */
+    ~QNetlistMinimap();
+
+    /**
+     * @brief Set the view whose scene is displayed in the minimap
+     *
+     * disconnects the previous view and connects the scroll bars
+     * and the change signals of the new view.
+     *
+     * @param view The view to display or nullptr to clear the minimap.
+     */
+    void setView(QNetListView* view);
+
+    /**
+     * @brief Get the view displayed in the minimap
+     *
+     * @return QNetListView* The view or nullptr if no view is set.
+     */
+    QNetListView* getView() const;
+
+    /**
+     * @brief Get the size hint of the minimap
+     *
+     * @return QSize The preferred size of the minimap.
+     */
+    QSize sizeHint() const override;
+
+public slots:
+
+    /**
+     * @brief Marks the cached overview as outdated
+     *
+     * the overview is rendered again on the next repaint.
+     *
+     */
+    void invalidateCache();
+
+    /**
+     * @brief Repaints the viewport rectangle without rendering the scene again
+     *
+     */
+    void updateViewportRect();
+
+protected:
+    /**
+     * @brief paints the cached overview and the viewport rectangle
+     *
+     * @param event qt paint event
+     */
+    void paintEvent(QPaintEvent* event) override;
+
+    /**
+     * @brief centers the main view on the clicked position
+     *
+     * @param event qt mouse event
+     */
+    void mousePressEvent(QMouseEvent* event) override;
+
+    /**
+     * @brief centers the main view on the dragged position
+     *
+     * @param event qt mouse event
+     */
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+    /**
+     * @brief invalidates the cache because the size of the overview changed
+     *
+     * @param event qt resize event
+     */
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    /**
+     * @brief renders the scene of the view into the cached pixmap
+     *
+     */
+    void renderCache();
+
+    /**
+     * @brief calculates the area of the widget the overview is drawn in
+     *
+     * @return QRectF The target rectangle keeping the aspect ratio of the scene.
+     */
+    QRectF overviewRect() const;
+
+    /**
+     * @brief maps a position in the widget to a position in the scene
+     *
+     * @param widgetPos The position in widget coordinates.
+     * @return QPointF The position in scene coordinates.
+     */
+    QPointF mapToScene(const QPointF& widgetPos) const;
+
+    /**
+     * @brief maps a rectangle in the scene to a rectangle in the widget
+     *
+     * @param sceneRect The rectangle in scene coordinates.
+     * @return QRectF The rectangle in widget coordinates.
+     */
+    QRectF mapFromScene(const QRectF& sceneRect) const;
+
+    /**
+     * @brief centers the main view on the given widget position
+     *
+     * @param widgetPos The position in widget coordinates.
+     */
+    void centerViewOn(const QPointF& widgetPos);
+
+    QPointer<QNetListView> view; ///< The view whose scene is displayed.
+    QPixmap overviewCache;       ///< The cached low resolution render of the scene.
+    QRectF cachedSceneRect;      ///< The scene rectangle the cache was rendered for.
+    bool cacheDirty = true;      ///< Flag if the cache has to be rendered again.
+};
+
+} // namespace OpenNetlistView
+
+#endif // __QNETLISTMINIMAP_H__
@@ -4,18 +4,28 @@
 #include <QByteArray>
 #include <QApplication>
 #include <QMessageBox>
+#include <QInputDialog>
 
 #include <memory>
 #include <map>
+#include <vector>
 #include <utility>
+#include <algorithm>
 #include <stdexcept>
 
 #include <yosys/module.h>
 #include <yosys/diagram.h>
+#include <yosys/netindex.h>
+#include <yosys/netname.h>
+#include <yosys/coneextractor.h>
+#include <yosys/sheetpartitioner.h>
+#include <yosys/port.h>
 #include <routing/cola_router.h>
 #include <symbol/symbol.h>
 
 #include "netlisttab.h"
+#include "qroutingdriver.h"
+#include "qnetlistitemfactory.h"
 
 #include "qnetlisttabwidget.h"
 
@@ -23,9 +33,16 @@ namespace OpenNetlistView {
 
 QNetlistTabWidget::QNetlistTabWidget(QWidget* parent)
     : QTabWidget(parent)
+    , routingDriver(new QRoutingDriver(this))
+    , renderers(std::make_shared<QNetlistItemFactory::Renderers>())
     , routingParameters{}
 {
 
+    // the tabs share one driver so modules shared by tabs are routed one after another
+    connect(routingDriver, &QRoutingDriver::routingProgress, this, &QNetlistTabWidget::routingProgress);
+    connect(routingDriver, &QRoutingDriver::routingIdle, this, &QNetlistTabWidget::routingIdle);
+    connect(routingDriver, &QRoutingDriver::routingFailed, this, &QNetlistTabWidget::showError);
+
     // connect the close tab signal
     connect(this, &QTabWidget::tabCloseRequested, [this](int index) {
         if(index == 0)
@@ -35,6 +52,7 @@ QNetlistTabWidget::QNetlistTabWidget(QWidget* parent)
         auto* tab = this->netlistTabs.at(index);
         this->removeTab(index);
         this->netlistTabs.erase(this->netlistTabs.begin() + index);
+        this->sheetGroups.erase(tab);
         delete tab;
     });
 
@@ -65,6 +83,8 @@ QNetlistTabWidget::QNetlistTabWidget(QWidget* parent)
 
         this->tabChanged = true;
 
+        emit currentViewChanged(tab->getNetlistView());
+
         // mark the module in the hierarchy tree
         emit setHierarchyPos(this->tabText(index));
     });
@@ -76,27 +96,45 @@ void QNetlistTabWidget::setSymbols(const std::shared_ptr<std::map<QString, std::
 {
     this->symbols = symbols;
 
+    // the renderers of the old symbols are kept by the tabs until their scenes are rebuilt
+    this->renderers = std::make_shared<QNetlistItemFactory::Renderers>();
+
+    // tabs whose symbols kept their geometry are only drawn again
+    std::vector<NetlistTab*> invalidatedTabs;
+
     for(auto* tab : this->netlistTabs)
     {
-        tab->updateSymbols(this->symbols);
+        if(tab->updateSymbols(this->symbols, this->renderers))
+        {
+            continue;
+        }
 
-        // redroute the current tab
+        // the current tab is routed first
         if(tab == currentWidget())
         {
-            try
-            {
+            invalidatedTabs.insert(invalidatedTabs.begin(), tab);
+        }
+        else
+        {
+            invalidatedTabs.push_back(tab);
+        }
+    }
 
-                tab->upgradeDisplay();
-            }
-            catch(const std::exception& e)
-            {
-                emit showError(e.what());
-            }
+    // the routings are queued in the driver and run without blocking the window
+    for(auto* tab : invalidatedTabs)
+    {
+        try
+        {
+            tab->upgradeDisplay();
+        }
+        catch(const std::exception& e)
+        {
+            emit showError(e.what());
         }
     }
 }
 
-void QNetlistTabWidget::setDiagram(std::unique_ptr<Yosys::Diagram> diagram)
+void QNetlistTabWidget::setDiagram(std::unique_ptr<Yosys::Diagram> diagram, const QString& coneName, unsigned int coneDepth)
 {
     // set the pointer
     this->diagram = std::move(diagram);
@@ -104,10 +142,39 @@ void QNetlistTabWidget::setDiagram(std::unique_ptr<Yosys::Diagram> diagram)
     // of a new diagram is loaded set the tab changed to true to update reset values in settings
     this->tabChanged = true;
 
+    // only the cone is routed so large top modules can be inspected quickly
+    if(!coneName.isEmpty() && addConeTab(this->diagram->getTopModule(), "/", coneName, coneDepth))
+    {
+        return;
+    }
+
     // creates the top module tab it is the root of the path and has no instance name
     addNetlistTab(this->diagram->getTopModule(), "/", "");
 }
 
+bool QNetlistTabWidget::addConeTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& name, unsigned int depth)
+{
+    if(this->symbols == nullptr || module == nullptr)
+    {
+        return false;
+    }
+
+    Yosys::ConeExtractor extractor(module);
+    auto coneModule = extractor.extract(name, depth);
+
+    if(coneModule == nullptr)
+    {
+        emit showError(tr("No cell or net with the name \"%1\" found in the module \"%2\"").arg(name, module->getType()));
+        return false;
+    }
+
+    // the cone is a new module in the same position of the hierarchy, its own path keeps the instance openable
+    calculateRoutingParameters(coneModule);
+    createNetlistTab(coneModule, getInstancePath(modulePath) + conePathSeparator + name, "");
+
+    return true;
+}
+
 void QNetlistTabWidget::setRoutingParameters(const Routing::ColaRoutingParameters& routingParameters)
 {
     this->routingParameters = routingParameters;
@@ -122,7 +189,13 @@ void QNetlistTabWidget::reset()
         delete *tab;
     }
     this->netlistTabs.clear();
+    this->sheetGroups.clear();
     this->diagram = nullptr;
+
+    // no item uses the renderers after the tabs are deleted
+    this->renderers->clear();
+
+    emit currentViewChanged(nullptr);
 }
 
 Routing::ColaRoutingParameters QNetlistTabWidget::getCurrentTabRoutingParameters() const
@@ -193,7 +266,23 @@ void QNetlistTabWidget::zoomToNode(const QString& nodeName)
     auto* tab = dynamic_cast<NetlistTab*>(currentWidget());
     if(tab != nullptr)
     {
-        tab->zoomToNode(nodeName);
+        // a cell removed by the simplification is shown as the component it was merged into
+        const QString representative = tab->getModule()->getSimplifiedCellRepresentative(nodeName);
+
+        tab->zoomToNode(representative.isEmpty() ? nodeName : representative);
+
+        // a net is highlighted through the whole hierarchy
+        const auto netnames = tab->getModule()->getNetnames();
+
+        for(const auto& netname : *netnames)
+        {
+            if(netname->getName() == nodeName)
+            {
+                tab->highlightBits(netname->getBits(), searchHighlightColor);
+                highlightNet(tab->getModulePath(), netname->getBits(), searchHighlightColor);
+                break;
+            }
+        }
     }
 }
 
@@ -209,6 +298,16 @@ QByteArray QNetlistTabWidget::exportToSvg(bool exportSelected)
     return {};
 }
 
+void QNetlistTabWidget::setTileRendering(bool enabled)
+{
+    this->tileRendering = enabled;
+
+    for(auto* tab : this->netlistTabs)
+    {
+        tab->setTileRendering(enabled);
+    }
+}
+
 void QNetlistTabWidget::genericModuleDoubleClicked(const QString& moduleName, const QString& moduleType)
 {
 
@@ -225,6 +324,34 @@ void QNetlistTabWidget::genericModuleDoubleClicked(const QString& moduleName, co
     addNetlistTab(module, modulePath, moduleName);
 }
 
+void QNetlistTabWidget::showCone(const QString& name)
+{
+    auto* activeTab = dynamic_cast<NetlistTab*>(currentWidget());
+
+    if(activeTab == nullptr)
+    {
+        return;
+    }
+
+    auto module = activeTab->getModule();
+    const auto modulePath = activeTab->getModulePath();
+
+    // the dialog is not blocking so it also works in the browser
+    auto* depthDialog = new QInputDialog(this);
+    depthDialog->setAttribute(Qt::WA_DeleteOnClose);
+    depthDialog->setWindowTitle(tr("Show Fan-In/Fan-Out"));
+    depthDialog->setLabelText(tr("Levels around \"%1\":").arg(name));
+    depthDialog->setInputMode(QInputDialog::IntInput);
+    depthDialog->setIntRange(0, maxConeDepth);
+    depthDialog->setIntValue(Yosys::ConeExtractor::defaultDepth);
+
+    connect(depthDialog, &QInputDialog::intValueSelected, this, [this, module, modulePath, name](int depth) {
+        addConeTab(module, modulePath, name, static_cast<unsigned int>(depth));
+    });
+
+    depthDialog->open();
+}
+
 void QNetlistTabWidget::addNetlistTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& moduleInstanceName)
 {
     // check if symbols are set if not abort
@@ -258,7 +385,8 @@ void QNetlistTabWidget::addNetlistTab(const std::shared_ptr<Yosys::Module>& modu
         portObjCount += path->getSigDestinations()->size();
     }
 
-    if(portObjCount > sizeQuestionThreshold)
+    // a module with a loaded layout is shown without routing
+    if(portObjCount > sizeQuestionThreshold && !module->getLayoutLoaded())
     {
         lastModule = module;
         lastModulePath = modulePath;
@@ -283,6 +411,98 @@ void QNetlistTabWidget::largeModuleAccepted()
     lastModuleInstanceName.clear();
 }
 
+void QNetlistTabWidget::largeModuleSplit()
+{
+    if(lastModule == nullptr)
+    {
+        return;
+    }
+
+    Yosys::SheetPartitioner partitioner(lastModule);
+    std::vector<std::shared_ptr<Yosys::Module>> sheets;
+
+    try
+    {
+        sheets = partitioner.partition();
+    }
+    catch(const std::exception& e)
+    {
+        emit showError(e.what());
+        return;
+    }
+
+    // creating a tab clears the last module
+    const QString modulePath = lastModulePath;
+    const QString moduleInstanceName = lastModuleInstanceName;
+    const size_t sheetGroup = nextSheetGroup++;
+
+    NetlistTab* firstSheetTab = nullptr;
+
+    // the sheets are queued in order so the first one is routed first
+    for(const auto& sheet : sheets)
+    {
+        calculateRoutingParameters(sheet);
+
+        auto* tab = createNetlistTab(sheet, modulePath, moduleInstanceName);
+
+        if(tab == nullptr)
+        {
+            continue;
+        }
+
+        sheetGroups[tab] = sheetGroup;
+
+        if(firstSheetTab == nullptr)
+        {
+            firstSheetTab = tab;
+        }
+    }
+
+    if(firstSheetTab != nullptr)
+    {
+        setCurrentWidget(firstSheetTab);
+    }
+}
+
+void QNetlistTabWidget::followOffSheetConnector(const QString& portName)
+{
+    auto* activeTab = dynamic_cast<NetlistTab*>(currentWidget());
+    auto groupIt = this->sheetGroups.find(activeTab);
+
+    if(groupIt == this->sheetGroups.end())
+    {
+        return;
+    }
+
+    const auto activeIt = std::find(this->netlistTabs.begin(), this->netlistTabs.end(), activeTab);
+    const size_t activeIdx = std::distance(this->netlistTabs.begin(), activeIt);
+
+    // the sheets are searched in a circle starting after the active one
+    for(size_t offset = 1; offset < this->netlistTabs.size(); offset++)
+    {
+        auto* tab = this->netlistTabs.at((activeIdx + offset) % this->netlistTabs.size());
+        auto sheetIt = this->sheetGroups.find(tab);
+
+        if(sheetIt == this->sheetGroups.end() || sheetIt->second != groupIt->second)
+        {
+            continue;
+        }
+
+        const auto ports = tab->getModule()->getPorts();
+
+        const bool hasConnector = std::any_of(ports->begin(), ports->end(), [&portName](const std::shared_ptr<Yosys::Port>& port) {
+            return port->getName() == portName;
+        });
+
+        if(hasConnector)
+        {
+            setCurrentWidget(tab);
+            tab->zoomToNode(portName);
+            return;
+        }
+    }
+}
+
 bool QNetlistTabWidget::getTabChanged()
 {
 
@@ -306,6 +526,51 @@ void QNetlistTabWidget::routingParametersChanged(Routing::ColaRoutingParameters
     }
 }
 
+void QNetlistTabWidget::highlightNet(const QString& modulePath, const QStringList& bits, const QColor& color)
+{
+    if(this->diagram == nullptr)
+    {
+        return;
+    }
+
+    auto netIndex = this->diagram->getNetIndex();
+
+    if(netIndex == nullptr)
+    {
+        return;
+    }
+
+    // the members only contain bound instances, so the instances of the open tabs are bound first
+    for(auto* tab : this->netlistTabs)
+    {
+        netIndex->getModuleByInstancePath(getInstancePath(tab->getModulePath()));
+    }
+
+    std::map<QString, QStringList> instanceBits;
+
+    for(const auto& bit : bits)
+    {
+        for(const auto& member : netIndex->traceNet(getInstancePath(modulePath), bit))
+        {
+            instanceBits[member.instancePath].append(member.bit);
+        }
+    }
+
+    // the tab that highlighted the net already shows it
+    const auto* source = dynamic_cast<NetlistTab*>(sender());
+
+    // a cone tab shows the bits of the instance it was extracted from
+    for(auto* tab : this->netlistTabs)
+    {
+        auto bitsIt = instanceBits.find(getInstancePath(tab->getModulePath()));
+
+        if(tab != source && bitsIt != instanceBits.end())
+        {
+            tab->highlightBits(bitsIt->second, color);
+        }
+    }
+}
+
 QString QNetlistTabWidget::generateModulePath(const std::shared_ptr<Yosys::Module>& module, const QString& moduleInstanceName)
 {
     // check if the module is the top module
@@ -323,25 +588,32 @@ QString QNetlistTabWidget::generateModulePath(const std::shared_ptr<Yosys::Modul
     }
     else
     {
-        modulePath += activeTab->getModulePath() + moduleInstanceName + "/";
+        modulePath += getInstancePath(activeTab->getModulePath()) + moduleInstanceName + "/";
     }
 
     return modulePath;
 }
 
-void QNetlistTabWidget::createNetlistTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& moduleInstanceName)
+QString QNetlistTabWidget::getInstancePath(const QString& modulePath)
+{
+    const auto coneIdx = modulePath.indexOf(conePathSeparator);
+
+    return coneIdx < 0 ? modulePath : modulePath.left(coneIdx);
+}
+
+NetlistTab* QNetlistTabWidget::createNetlistTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& moduleInstanceName)
 {
 
     if(module == nullptr)
     {
-        return;
+        return nullptr;
     }
 
     NetlistTab* tab = nullptr;
 
     try
     {
-        tab = new NetlistTab(module, symbols, modulePath, routingParameters, this);
+        tab = new NetlistTab(module, symbols, renderers, modulePath, routingParameters, routingDriver, this);
     }
     catch(const std::exception& e)
     {
@@ -350,12 +622,18 @@ void QNetlistTabWidget::createNetlistTab(const std::shared_ptr<Yosys::Module>& m
 
     if(tab == nullptr)
     {
-        return;
+        return nullptr;
     }
 
     this->netlistTabs.emplace_back(tab);
 
     connect(tab, &NetlistTab::genericModuleDoubleClicked, this, &QNetlistTabWidget::genericModuleDoubleClicked);
+    connect(tab, &NetlistTab::coneRequested, this, &QNetlistTabWidget::showCone);
+    connect(tab, &NetlistTab::modulePortDoubleClicked, this, &QNetlistTabWidget::followOffSheetConnector);
+    connect(tab, &NetlistTab::displayUpgraded, this, &QNetlistTabWidget::displayUpgraded);
+    connect(tab, &NetlistTab::netHighlighted, this, &QNetlistTabWidget::highlightNet);
+
+    tab->setTileRendering(this->tileRendering);
 
     QString tabName = module->getType();
 
@@ -374,6 +652,8 @@ void QNetlistTabWidget::createNetlistTab(const std::shared_ptr<Yosys::Module>& m
     lastModule = nullptr;
     lastModulePath.clear();
     lastModuleInstanceName.clear();
+
+    return tab;
 }
 
 void QNetlistTabWidget::calculateRoutingParameters(const std::shared_ptr<Yosys::Module>& module)
@@ -384,6 +664,12 @@ void QNetlistTabWidget::calculateRoutingParameters(const std::shared_ptr<Yosys::
         return;
     }
 
+    routingParameters = scaleRoutingParameters(module, routingParameters);
+}
+
+Routing::ColaRoutingParameters QNetlistTabWidget::scaleRoutingParameters(const std::shared_ptr<Yosys::Module>& module,
+    Routing::ColaRoutingParameters routingParameters)
+{
     // get the number of paths in the module
     const auto paths = module->getPaths();
 
@@ -421,6 +707,8 @@ void QNetlistTabWidget::calculateRoutingParameters(const std::shared_ptr<Yosys::
     routingParameters.defaultXConstraint = constraintValue;
     routingParameters.defaultYConstraint = constraintValue;
     routingParameters.defaultEdgeLength = defaultEdgeLength;
+
+    return routingParameters;
 }
 
 } // namespace OpenNetlistView
\ No newline at end of file
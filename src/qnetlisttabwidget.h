@@ -23,16 +23,23 @@
 #include <QWidget>
 #include <QObject>
 #include <QByteArray>
+#include <QStringList>
+#include <QColor>
 
 #include <memory>
 #include <map>
 
 #include <routing/cola_router.h>
+#include <yosys/coneextractor.h>
+
+#include "qnetlistview.h"
+#include "qnetlistitemfactory.h"
 
 namespace OpenNetlistView {
 
 // forward declaration
 class NetlistTab;
+class QRoutingDriver;
 
 namespace Symbol {
 class Symbol;
@@ -60,11 +67,15 @@ class QNetlistTabWidget : public QTabWidget
 private:
     constexpr const static size_t sizeQuestionThreshold = 200; ///< Threshold when to ask if the user wants to continue routing
 
-    constexpr const static double slopePortObj{0.61F};      ///< The solpe for constraint increas on node ports
-    constexpr const static double slopeNodeObj{0.16F};      ///< The slope for constraint increas on node objects
-    constexpr const static double slopeEPortObj{0.09F};     ///< The slope for constraint increas on edge ports
-    constexpr const static double minConstraint{75.0F};     ///< The minimum constraint value
-    constexpr const static double defaultEdgeLength{10.0F}; ///< The default edge length
+    constexpr const static double slopePortObj{0.61F};        ///< The solpe for constraint increas on node ports
+    constexpr const static double slopeNodeObj{0.16F};        ///< The slope for constraint increas on node objects
+    constexpr const static double slopeEPortObj{0.09F};       ///< The slope for constraint increas on edge ports
+    constexpr const static double minConstraint{75.0F};       ///< The minimum constraint value
+    constexpr const static double defaultEdgeLength{10.0F};   ///< The default edge length
+    constexpr const static int maxConeDepth{20};              ///< The maximum number of levels selectable for a cone
+    constexpr const static char* conePathSeparator{"#cone:"}; ///< Separates the instance path of a cone tab from the name it was started at
+
+    constexpr const static Qt::GlobalColor searchHighlightColor{Qt::yellow}; ///< The color of a net found by the search
 
 public:
     /**
@@ -83,6 +94,9 @@ public:
     /**
      * @brief Set the symbols to use for creating the diagrams in the tabs
      *
+     * Tabs whose symbols keep their bounding boxes and port positions keep
+     * their layout, all other tabs are routed again.
+     *
      * @param symbols The symbols to be set.
      */
     void setSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols);
@@ -90,9 +104,26 @@ public:
     /**
      * @brief Set the diagram containing the modules to be displayed
      *
+     * If a cone name is given only the cone around that cell or net of the
+     * top module is opened instead of the whole top module.
+     *
      * @param diagram The diagram to be set.
+     * @param coneName The name of the cell or net to open the cone of.
+     * @param coneDepth The number of levels of the cone.
+     */
+    void setDiagram(std::unique_ptr<Yosys::Diagram> diagram, const QString& coneName = "",
+        unsigned int coneDepth = Yosys::ConeExtractor::defaultDepth);
+
+    /**
+     * @brief Opens a tab with the fan-in and fan-out of a cell or net
+     *
+     * @param module The module containing the cell or net.
+     * @param modulePath The path of the module in the design.
+     * @param name The name of the cell or net.
+     * @param depth The number of levels of the cone.
+     * @return true if the cell or net was found
      */
-    void setDiagram(std::unique_ptr<Yosys::Diagram> diagram);
+    bool addConeTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& name, unsigned int depth);
 
     /**
      * @brief Set the routing parameters for the widget
@@ -106,6 +137,16 @@ public:
      */
     Routing::ColaRoutingParameters getCurrentTabRoutingParameters() const;
 
+    /**
+     * @brief Scales the constraints of the routing parameters to the size of a module
+     *
+     * @param module The module to be routed.
+     * @param routingParameters The routing parameters to scale.
+     * @return Routing::ColaRoutingParameters The routing parameters for the module.
+     */
+    static Routing::ColaRoutingParameters scaleRoutingParameters(const std::shared_ptr<Yosys::Module>& module,
+        Routing::ColaRoutingParameters routingParameters);
+
     /**
      * @brief reset the widget
      *
@@ -148,6 +189,11 @@ public slots:
 
     /**
      * @brief Slot for zooming to a specific node in the active tab
+     *
+     * when the name is a net of the module of the active tab the
+     * net is highlighted in all open tabs.
+     *
+     * @param nodeName The name of the node or net.
      */
     void zoomToNode(const QString& nodeName);
 
@@ -159,6 +205,13 @@ public slots:
      */
     QByteArray exportToSvg(bool exportSelected = false);
 
+    /**
+     * @brief Slot for enabling or disabling tile rendering in all tabs
+     *
+     * @param enabled True if the views should be drawn from cached tiles.
+     */
+    void setTileRendering(bool enabled);
+
     /**
      * @brief Slot for adding a new netlist tab
      *
@@ -167,6 +220,15 @@ public slots:
      */
     void genericModuleDoubleClicked(const QString& moduleName, const QString& moduleType);
 
+    /**
+     * @brief Slot asking for the depth of a cone and opening it in a new tab
+     *
+     * the cone is extracted from the module of the active tab
+     *
+     * @param name The name of the cell or net.
+     */
+    void showCone(const QString& name);
+
     /**
      * @brief Checks if the module is smaller then routes directly otherwise
      * asks the user if the routing should be continued
@@ -186,6 +248,24 @@ public slots:
      */
     void largeModuleAccepted();
 
+    /**
+     * @brief Slot opening the module that was asked for as sheets
+     *
+     * The module is split into sheets of bounded size that are shown in
+     * their own tabs and routed independently.
+     *
+     */
+    void largeModuleSplit();
+
+    /**
+     * @brief Slot switching to the next sheet using an off-sheet connector
+     *
+     * Does nothing if the active tab is no sheet.
+     *
+     * @param portName The name of the connector or module port.
+     */
+    void followOffSheetConnector(const QString& portName);
+
     /**
      * @brief Gets if the tab has changed
      *
@@ -222,6 +302,32 @@ signals:
      */
     void displayLargeModuleQuestion();
 
+    /**
+     * @brief Signal emitted when the view of the active tab changed
+     *
+     * @param view The view of the active tab or nullptr if no tab is open.
+     */
+    void currentViewChanged(QNetListView* view);
+
+    /**
+     * @brief Signal emitted when a tab added a newly routed module to its scene
+     *
+     */
+    void displayUpgraded();
+
+    /**
+     * @brief Signal emitted while a module is routed
+     *
+     * @param progress The progress of the routing between 0 and 100.
+     */
+    void routingProgress(int progress);
+
+    /**
+     * @brief Signal emitted when no module is routed anymore
+     *
+     */
+    void routingIdle();
+
 public slots:
 
     /**
@@ -233,7 +339,31 @@ public slots:
      */
     void routingParametersChanged(Routing::ColaRoutingParameters routingParameters);
 
+    /**
+     * @brief slot highlighting a net in the other open tabs
+     *
+     * the bits are traced through the hierarchy with the net index
+     * of the diagram, so the net is found in the parent and in the
+     * instances without comparing the names of the nets.
+     *
+     * @param modulePath The path of the module the bits belong to.
+     * @param bits The bits of the net in the module.
+     * @param color The color to use for highlighting.
+     */
+    void highlightNet(const QString& modulePath, const QStringList& bits, const QColor& color);
+
 private:
+    /**
+     * @brief Get the path of the instance shown by a tab
+     *
+     * A cone tab has the path of the instance it was extracted from with the
+     * name it was started at appended, so it does not block opening the instance.
+     *
+     * @param modulePath The path of the tab.
+     * @return QString The path without the cone part.
+     */
+    static QString getInstancePath(const QString& modulePath);
+
     /**
      * @brief Generate the module path for a new tab
      *
@@ -249,8 +379,9 @@ private:
      * @param module The module to be displayed.
      * @param modulePath The path of the module.
      * @param moduleInstanceName The instance name of the module.
+     * @return NetlistTab* The new tab or nullptr if it could not be created.
      */
-    void createNetlistTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& moduleInstanceName);
+    NetlistTab* createNetlistTab(const std::shared_ptr<Yosys::Module>& module, const QString& modulePath, const QString& moduleInstanceName);
 
     /**
      * @brief Calculate the routing parameters for the module
@@ -263,15 +394,21 @@ private:
     void calculateRoutingParameters(const std::shared_ptr<Yosys::Module>& module);
 
     std::vector<NetlistTab*> netlistTabs;                                                  ///< Vector of netlist tabs for the widget.
+    QRoutingDriver* routingDriver;                                                         ///< The driver routing the modules of all tabs in time slices.
     std::unique_ptr<Yosys::Diagram> diagram = nullptr;                                     ///< The diagram for the widget.
     std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>> symbols = nullptr; ///< Vector of symbols for the widget.
+    std::shared_ptr<QNetlistItemFactory::Renderers> renderers;                             ///< The renderers of the symbols, created again for every symbol set.
     Routing::ColaRoutingParameters routingParameters;                                      ///< The routing parameters for the widget.
 
     std::shared_ptr<Yosys::Module> lastModule = nullptr; ///< The last (larger) module that was added to the widget.
     QString lastModulePath;                              ///< The last (larger) module path that was added to the widget.
     QString lastModuleInstanceName;                      ///< The last (larger) module instance name that was added to the widget.
 
-    bool tabChanged = true; ///< Flag to check if the tab has changed.
+    std::map<NetlistTab*, size_t> sheetGroups; ///< The module every sheet tab was split from by tab.
+    size_t nextSheetGroup = 0;                 ///< The number of the next module split into sheets.
+
+    bool tabChanged = true;     ///< Flag to check if the tab has changed.
+    bool tileRendering = false; ///< Flag if the tabs are drawn from cached tiles.
 };
 
 } // namespace OpenNetlistView
@@ -0,0 +1,347 @@
+#include <QObject>
+#include <QImage>
+#include <QPicture>
+#include <QByteArray>
+#include <QPainter>
+#include <QRectF>
+#include <QSize>
+#include <QList>
+#include <QGraphicsScene>
+#include <QMetaObject>
+#include <QtCore/Qt>
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
+
+#include <scheduler/taskscheduler.h>
+
+#include "qnetlisttilerenderer.h"
+
+namespace OpenNetlistView {
+
+QNetlistTileRenderer::QNetlistTileRenderer(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QNetlistTileRenderer::~QNetlistTileRenderer()
+{
+    // the jobs only hold copies of the recorded chunks but
+    // their results are posted to this object
+    tileToken.cancel();
+    Scheduler::TaskScheduler::getShared().wait(tileJobs);
+}
+
+void QNetlistTileRenderer::setScene(QGraphicsScene* scene)
+{
+    if(this->scene == scene)
+    {
+        return;
+    }
+
+    if(this->scene != nullptr)
+    {
+        disconnect(this->scene, nullptr, this, nullptr);
+    }
+
+    this->scene = scene;
+
+    if(scene != nullptr)
+    {
+        connect(scene, &QGraphicsScene::changed, this, &QNetlistTileRenderer::invalidate);
+        connect(scene, &QGraphicsScene::sceneRectChanged, this, &QNetlistTileRenderer::invalidateAll);
+    }
+
+    invalidateAll();
+}
+
+void QNetlistTileRenderer::setBackgroundColor(const QColor& color)
+{
+    if(backgroundColor == color)
+    {
+        return;
+    }
+
+    backgroundColor = color;
+    invalidateAll();
+}
+
+void QNetlistTileRenderer::setDevicePixelRatio(qreal ratio)
+{
+    if(qFuzzyCompare(devicePixelRatio, ratio))
+    {
+        return;
+    }
+
+    devicePixelRatio = ratio;
+    invalidateAll();
+}
+
+void QNetlistTileRenderer::paint(QPainter& painter, const QRectF& exposedSceneRect, qreal viewScale)
+{
+    if(scene == nullptr)
+    {
+        return;
+    }
+
+    // tiles of other zoom levels are not used anymore
+    const int bucket = zoomBucket(viewScale);
+
+    if(bucket != currentBucket)
+    {
+        currentBucket = bucket;
+        tiles.clear();
+        pendingTiles.clear();
+    }
+
+    const QRectF drawRect = exposedSceneRect.intersected(scene->sceneRect());
+
+    if(drawRect.isEmpty())
+    {
+        return;
+    }
+
+    // get the range of tiles covering the exposed area
+    const qreal tileSceneSize = tileSize / bucketScale(bucket);
+    const auto firstColumn = static_cast<int64_t>(std::floor(drawRect.left() / tileSceneSize));
+    const auto lastColumn = static_cast<int64_t>(std::floor(drawRect.right() / tileSceneSize));
+    const auto firstRow = static_cast<int64_t>(std::floor(drawRect.top() / tileSceneSize));
+    const auto lastRow = static_cast<int64_t>(std::floor(drawRect.bottom() / tileSceneSize));
+
+    std::set<TileKey> visibleKeys;
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    for(int64_t row = firstRow; row <= lastRow; row++)
+    {
+        for(int64_t column = firstColumn; column <= lastColumn; column++)
+        {
+            const TileKey key{bucket, column, row};
+            visibleKeys.insert(key);
+
+            auto tileIt = tiles.find(key);
+
+            if(tileIt != tiles.end())
+            {
+                // the GUI thread only draws the finished image
+                painter.drawImage(tileSceneRect(key), tileIt->second);
+            }
+            else if(pendingTiles.find(key) == pendingTiles.end())
+            {
+                scheduleTile(key);
+            }
+        }
+    }
+
+    evictTiles(visibleKeys);
+}
+
+void QNetlistTileRenderer::invalidate(const QList<QRectF>& regions)
+{
+    for(const auto& region : regions)
+    {
+        if(region.isEmpty())
+        {
+            continue;
+        }
+
+        // remove the recorded chunks of the region
+        for(auto chunkIt = chunks.begin(); chunkIt != chunks.end();)
+        {
+            const QRectF chunkRect(chunkIt->first.first * chunkSize, chunkIt->first.second * chunkSize, chunkSize, chunkSize);
+
+            if(chunkRect.intersects(region))
+            {
+                chunkIt = chunks.erase(chunkIt);
+            }
+            else
+            {
+                ++chunkIt;
+            }
+        }
+
+        // remove the cached tiles and drop the running jobs of the region
+        for(auto tileIt = tiles.begin(); tileIt != tiles.end();)
+        {
+            if(tileSceneRect(tileIt->first).intersects(region))
+            {
+                tileIt = tiles.erase(tileIt);
+            }
+            else
+            {
+                ++tileIt;
+            }
+        }
+
+        for(auto pendingIt = pendingTiles.begin(); pendingIt != pendingTiles.end();)
+        {
+            if(tileSceneRect(pendingIt->first).intersects(region))
+            {
+                pendingIt = pendingTiles.erase(pendingIt);
+            }
+            else
+            {
+                ++pendingIt;
+            }
+        }
+    }
+
+    emit tileReady();
+}
+
+void QNetlistTileRenderer::invalidateAll()
+{
+    // the queued jobs are dropped, the running ones are ignored by their job id
+    tileToken.cancel();
+    tileToken = Scheduler::CancellationToken();
+
+    tiles.clear();
+    pendingTiles.clear();
+    chunks.clear();
+
+    emit tileReady();
+}
+
+int QNetlistTileRenderer::zoomBucket(qreal viewScale)
+{
+    const qreal scale = std::max(viewScale, static_cast<qreal>(minZoomBucketScale));
+
+    return static_cast<int>(std::lround(std::log2(scale) * zoomBucketsPerOctave));
+}
+
+qreal QNetlistTileRenderer::bucketScale(int bucket)
+{
+    return std::pow(2.0, static_cast<qreal>(bucket) / zoomBucketsPerOctave);
+}
+
+QRectF QNetlistTileRenderer::tileSceneRect(const TileKey& key)
+{
+    const auto& [bucket, column, row] = key;
+    const qreal tileSceneSize = tileSize / bucketScale(bucket);
+
+    return {static_cast<qreal>(column) * tileSceneSize, static_cast<qreal>(row) * tileSceneSize, tileSceneSize, tileSceneSize};
+}
+
+QList<QByteArray> QNetlistTileRenderer::chunksForRect(const QRectF& sceneRect)
+{
+    QList<QByteArray> pictures;
+
+    const auto firstColumn = static_cast<int64_t>(std::floor(sceneRect.left() / chunkSize));
+    const auto lastColumn = static_cast<int64_t>(std::floor(sceneRect.right() / chunkSize));
+    const auto firstRow = static_cast<int64_t>(std::floor(sceneRect.top() / chunkSize));
+    const auto lastRow = static_cast<int64_t>(std::floor(sceneRect.bottom() / chunkSize));
+
+    for(int64_t row = firstRow; row <= lastRow; row++)
+    {
+        for(int64_t column = firstColumn; column <= lastColumn; column++)
+        {
+            const ChunkKey key{column, row};
+            auto chunkIt = chunks.find(key);
+
+            if(chunkIt == chunks.end())
+            {
+                // record the items of the chunk in scene coordinates
+                // this is the only place the items are painted
+                const QRectF chunkRect(column * chunkSize, row * chunkSize, chunkSize, chunkSize);
+
+                QPicture picture;
+                QPainter recorder(&picture);
+                scene->render(&recorder, chunkRect, chunkRect, Qt::IgnoreAspectRatio);
+                recorder.end();
+
+                // the data is copied so no job shares the buffer of the picture
+                chunkIt = chunks.emplace(key, QByteArray(picture.data(), static_cast<qsizetype>(picture.size()))).first;
+            }
+
+            pictures.append(chunkIt->second);
+        }
+    }
+
+    return pictures;
+}
+
+void QNetlistTileRenderer::scheduleTile(const TileKey& key)
+{
+    const QRectF sceneRect = tileSceneRect(key);
+    const qreal scale = bucketScale(std::get<0>(key)) * devicePixelRatio;
+    const QSize imageSize(static_cast<int>(std::ceil(tileSize * devicePixelRatio)), static_cast<int>(std::ceil(tileSize * devicePixelRatio)));
+    const QColor background = backgroundColor;
+
+    // the data is implicitly shared and only read, every job plays its own pictures
+    const QList<QByteArray> pictures = chunksForRect(sceneRect);
+
+    const uint64_t jobId = nextJobId++;
+    pendingTiles[key] = jobId;
+
+    // the visible tiles are the work the user waits for
+    Scheduler::TaskScheduler::getShared().submit(
+        [this, key, jobId, sceneRect, scale, imageSize, background, pictures]() {
+            QImage image(imageSize, QImage::Format_ARGB32_Premultiplied);
+            image.fill(background);
+
+            QPainter painter(&image);
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.scale(scale, scale);
+            painter.translate(-sceneRect.topLeft());
+            painter.setClipRect(sceneRect);
+
+            for(const auto& pictureData : pictures)
+            {
+                QPicture picture;
+                picture.setData(pictureData.constData(), static_cast<uint>(pictureData.size()));
+                painter.drawPicture(0, 0, picture);
+            }
+
+            painter.end();
+
+            // hand the result back to the GUI thread
+            QMetaObject::invokeMethod(
+                this,
+                [this, key, image, jobId]() {
+                    tileFinished(key, image, jobId);
+                },
+                Qt::QueuedConnection);
+        },
+        Scheduler::TaskScheduler::EPriority::INTERACTIVE, &tileJobs, tileToken);
+}
+
+void QNetlistTileRenderer::tileFinished(const TileKey& key, const QImage& image, uint64_t jobId)
+{
+    // drop results of tiles that were invalidated while rendering
+    auto pendingIt = pendingTiles.find(key);
+
+    if(pendingIt == pendingTiles.end() || pendingIt->second != jobId)
+    {
+        return;
+    }
+
+    pendingTiles.erase(pendingIt);
+    tiles[key] = image;
+
+    emit tileReady();
+}
+
+void QNetlistTileRenderer::evictTiles(const std::set<TileKey>& visibleKeys)
+{
+    if(tiles.size() <= maxCachedTiles)
+    {
+        return;
+    }
+
+    for(auto tileIt = tiles.begin(); tileIt != tiles.end() && tiles.size() > maxCachedTiles;)
+    {
+        if(visibleKeys.find(tileIt->first) == visibleKeys.end())
+        {
+            tileIt = tiles.erase(tileIt);
+        }
+        else
+        {
+            ++tileIt;
+        }
+    }
+}
+
+} // namespace OpenNetlistView
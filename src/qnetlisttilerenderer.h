@@ -0,0 +1,209 @@
+/**
+ * @file qnetlisttilerenderer.h
+ * @brief Header file for the QNetlistTileRenderer class.
+ *
+ * This file contains the declaration of the QNetlistTileRenderer class, which
+ * renders the scene of a QNetListView into cached image tiles on the worker threads
+ * of the shared task scheduler, so the GUI thread only has to draw finished images.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __QNETLISTTILERENDERER_H__
+#define __QNETLISTTILERENDERER_H__
+
+#include <QObject>
+#include <QImage>
+#include <QPicture>
+#include <QByteArray>
+#include <QPainter>
+#include <QRectF>
+#include <QColor>
+#include <QList>
+#include <QPointer>
+#include <QGraphicsScene>
+
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <cstdint>
+
+#include <scheduler/taskscheduler.h>
+
+namespace OpenNetlistView {
+
+/**
+ * @class QNetlistTileRenderer
+ * @brief Renders a QGraphicsScene into cached tiles on worker threads.
+ *
+ * QGraphicsItems must only be painted on the GUI thread. The scene is therefore
+ * first recorded into QPicture display lists of fixed scene sized chunks on the GUI
+ * thread. This happens only once for every content change. The tiles for the
+ * current zoom level are then rendered from the recorded chunks into QImages by a
+ * the task scheduler and cached. Zoom levels are grouped into buckets so small zoom steps
+ * reuse the tiles of the bucket. Changes to the scene only invalidate the chunks and
+ * tiles that intersect the changed region.
+ */
+class QNetlistTileRenderer : public QObject
+{
+    Q_OBJECT
+
+private:
+    constexpr const static int tileSize{256};               ///< The width and height of a tile in pixels.
+    constexpr const static double chunkSize{2048.0F};       ///< The width and height of a recorded chunk in scene units.
+    constexpr const static int zoomBucketsPerOctave{4};     ///< The number of zoom buckets per doubling of the zoom.
+    constexpr const static size_t maxCachedTiles{1024};     ///< The number of tiles kept before unused tiles are dropped.
+    constexpr const static double minZoomBucketScale{1E-4}; ///< The minimum scale used to calculate a zoom bucket.
+
+    using TileKey = std::tuple<int, int64_t, int64_t>; ///< The zoom bucket and the column and row of a tile.
+    using ChunkKey = std::pair<int64_t, int64_t>;      ///< The column and row of a chunk.
+
+public:
+    /**
+     * @brief Construct a new QNetlistTileRenderer object
+     *
+     * @param parent The parent object.
+     */
+    explicit QNetlistTileRenderer(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the QNetlistTileRenderer object
+     *
+     * waits for running tile jobs to finish
+     */
+    ~QNetlistTileRenderer();
+
+    /**
+     * @brief Set the scene that is rendered
+     *
+     * @param scene The scene to render or nullptr.
+     */
+    void setScene(QGraphicsScene* scene);
+
+    /**
+     * @brief Set the background color of the tiles
+     *
+     * @param color The background color.
+     */
+    void setBackgroundColor(const QColor& color);
+
+    /**
+     * @brief Set the device pixel ratio of the target device
+     *
+     * @param ratio The device pixel ratio.
+     */
+    void setDevicePixelRatio(qreal ratio);
+
+    /**
+     * @brief Draws the cached tiles covering the exposed area
+     *
+     * missing tiles are scheduled on the task scheduler and drawn
+     * as soon as they are ready. The painter has to use the world
+     * transformation of the view.
+     *
+     * @param painter The painter to draw the tiles with.
+     * @param exposedSceneRect The area of the scene that has to be drawn.
+     * @param viewScale The current scale of the view.
+     */
+    void paint(QPainter& painter, const QRectF& exposedSceneRect, qreal viewScale);
+
+public slots:
+
+    /**
+     * @brief Invalidates the tiles and chunks of the given scene regions
+     *
+     * @param regions The regions of the scene that changed.
+     */
+    void invalidate(const QList<QRectF>& regions);
+
+    /**
+     * @brief Invalidates all tiles and chunks
+     *
+     */
+    void invalidateAll();
+
+signals:
+
+    /**
+     * @brief Signal emitted when a tile finished rendering
+     *
+     */
+    void tileReady();
+
+private:
+    /**
+     * @brief calculates the zoom bucket for the given scale
+     *
+     * @param viewScale The scale of the view.
+     * @return int The zoom bucket.
+     */
+    static int zoomBucket(qreal viewScale);
+
+    /**
+     * @brief calculates the scale a zoom bucket is rendered with
+     *
+     * @param bucket The zoom bucket.
+     * @return qreal The scale of the bucket.
+     */
+    static qreal bucketScale(int bucket);
+
+    /**
+     * @brief calculates the scene area of a tile
+     *
+     * @param key The key of the tile.
+     * @return QRectF The area of the tile in scene coordinates.
+     */
+    static QRectF tileSceneRect(const TileKey& key);
+
+    /**
+     * @brief get the recorded chunks intersecting the area
+     *
+     * missing chunks are recorded on the calling (GUI) thread. The chunks are
+     * returned as the serialized data of the pictures, because playing a
+     * QPicture modifies its shared buffer and can not be done by several
+     * jobs at once.
+     *
+     * @param sceneRect The area of the scene.
+     * @return QList<QByteArray> The data of the recorded chunks.
+     */
+    QList<QByteArray> chunksForRect(const QRectF& sceneRect);
+
+    /**
+     * @brief schedules the rendering of a tile on the task scheduler
+     *
+     * @param key The key of the tile.
+     */
+    void scheduleTile(const TileKey& key);
+
+    /**
+     * @brief stores a finished tile in the cache
+     *
+     * @param key The key of the tile.
+     * @param image The rendered image of the tile.
+     * @param jobId The id of the job that rendered the tile.
+     */
+    void tileFinished(const TileKey& key, const QImage& image, uint64_t jobId);
+
+    /**
+     * @brief removes tiles that are not visible when the cache is full
+     *
+     * @param visibleKeys The keys of the visible tiles.
+     */
+    void evictTiles(const std::set<TileKey>& visibleKeys);
+
+    QPointer<QGraphicsScene> scene;           ///< The scene that is rendered.
+    Scheduler::TaskGroup tileJobs;            ///< The jobs rendering the tiles on the task scheduler.
+    Scheduler::CancellationToken tileToken;   ///< Cancels the queued jobs when the tiles are invalidated.
+    std::map<TileKey, QImage> tiles;          ///< The cached tiles.
+    std::map<TileKey, uint64_t> pendingTiles; ///< The tiles currently rendered by the jobs and their job ids.
+    std::map<ChunkKey, QByteArray> chunks;    ///< The picture data of the recorded chunks of the scene.
+    QColor backgroundColor{Qt::white};        ///< The background color of the tiles.
+    qreal devicePixelRatio = 1.0;             ///< The device pixel ratio of the target.
+    int currentBucket = 0;                    ///< The zoom bucket of the cached tiles.
+    uint64_t nextJobId = 0;                   ///< The id of the next scheduled job, used to drop outdated results.
+};
+
+} // namespace OpenNetlistView
+
+#endif // __QNETLISTTILERENDERER_H__
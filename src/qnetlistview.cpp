@@ -20,17 +20,28 @@
 #include <QIcon>
 #include <QGraphicsItem>
 #include <QToolTip>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QStyleOptionRubberBand>
+#include <QRubberBand>
+#include <QStyle>
+#include <QSet>
+#include <QStringList>
 
 #include <map>
 #include <vector>
+#include <algorithm>
 
 #include <yosys/node.h>
+#include <yosys/port.h>
 #include <yosys/component.h>
+#include <yosys/path.h>
 #include <symbol/symbol.h>
 
 #include <qnetlistgraphicsnode.h>
 #include <qnetlistgraphicspath.h>
 #include "dialogproperties.h"
+#include "qnetlisttilerenderer.h"
 
 #include "qnetlistview.h"
 
@@ -42,11 +53,15 @@ QNetListView::QNetListView(QWidget* parent)
     , pathContextMenu(new QMenu(this))
     , propertiesDialog(new DialogProperties(this))
     , selectedItems({})
+    , tileRenderer(new QNetlistTileRenderer(this))
 
 {
     setDragMode(QGraphicsView::RubberBandDrag);
     setMouseTracking(true);
 
+    // repaint when a tile finished rendering
+    connect(tileRenderer, &QNetlistTileRenderer::tileReady, viewport(), QOverload<>::of(&QWidget::update));
+
     // populate the context menu
     this->populateNodeContextMenu();
     this->populatePathContextMenu();
@@ -94,6 +109,21 @@ QByteArray QNetListView::exportToSvg(bool exportSelected)
     return svgData;
 }
 
+bool QNetListView::isTileRendering() const
+{
+    return tileRendering;
+}
+
+void QNetListView::setTileRendering(bool enabled)
+{
+    tileRendering = enabled;
+
+    // only keep the renderer connected to the scene while it is used
+    tileRenderer->setScene(enabled ? scene() : nullptr);
+
+    viewport()->update();
+}
+
 void QNetListView::zoomIn()
 {
     scale(scaleFactor, scaleFactor);
@@ -177,6 +207,32 @@ void QNetListView::clearAllHighlightColors()
             component->clearHighlightColor();
         }
     }
+
+    emit highlightChanged();
+}
+
+void QNetListView::highlightBits(const QStringList& bits, const QColor& color)
+{
+    const QSet<QString> bitSet(bits.begin(), bits.end());
+
+    for(const auto& item : this->scene()->items())
+    {
+        auto* path = dynamic_cast<QNetlistGraphicsPath*>(item);
+
+        if(path == nullptr || path->getYosysPath() == nullptr)
+        {
+            continue;
+        }
+
+        const auto& pathBits = path->getYosysPath()->getBits();
+
+        if(std::any_of(pathBits.begin(), pathBits.end(), [&bitSet](const QString& bit) { return bitSet.contains(bit); }))
+        {
+            path->setHighlightColor(color);
+        }
+    }
+
+    emit highlightChanged();
 }
 
 void QNetListView::wheelEvent(QWheelEvent* event)
@@ -261,6 +317,50 @@ void QNetListView::mouseDoubleClickEvent(QMouseEvent* mouseEvent)
             emit genericModuleDoubleClicked(node->getName(), node->getType());
         }
     }
+    else if(std::dynamic_pointer_cast<Yosys::Port>(component) != nullptr && graphicNode->parentItem() == nullptr)
+    {
+        auto port = std::dynamic_pointer_cast<Yosys::Port>(component);
+
+        // ports of the module lead to the other sheets of a net
+        if(port->getParentNode() == nullptr)
+        {
+            emit modulePortDoubleClicked(port->getName());
+        }
+    }
+}
+
+void QNetListView::paintEvent(QPaintEvent* event)
+{
+    if(!tileRendering || scene() == nullptr)
+    {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+
+    tileRenderer->setScene(scene());
+    tileRenderer->setBackgroundColor(backgroundBrush().color());
+    tileRenderer->setDevicePixelRatio(viewport()->devicePixelRatioF());
+
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), backgroundBrush());
+
+    // draw the tiles in scene coordinates
+    painter.setWorldTransform(viewportTransform());
+    const QRectF exposedSceneRect = mapToScene(event->rect()).boundingRect();
+    tileRenderer->paint(painter, exposedSceneRect, transform().m11());
+
+    // the rubber band is normally drawn by QGraphicsView::paintEvent
+    if(!rubberBandRect().isNull())
+    {
+        painter.resetTransform();
+
+        QStyleOptionRubberBand option;
+        option.initFrom(viewport());
+        option.rect = rubberBandRect();
+        option.shape = QRubberBand::Rectangle;
+
+        style()->drawControl(QStyle::CE_RubberBand, &option, &painter, viewport());
+    }
 }
 
 void QNetListView::highlightSelectedObject()
@@ -276,12 +376,20 @@ void QNetListView::highlightSelectedObject()
     {
         auto* path = dynamic_cast<QNetlistGraphicsPath*>(item);
         path->setHighlightColor(color);
+
+        // the net is also highlighted in the other open modules
+        if(path->getYosysPath() != nullptr)
+        {
+            emit netHighlighted(path->getYosysPath()->getBits(), color);
+        }
     }
     else if(dynamic_cast<QNetlistGraphicsNode*>(item) != nullptr)
     {
         auto* component = dynamic_cast<QNetlistGraphicsNode*>(item);
         component->setHighlightColor(color);
     }
+
+    emit highlightChanged();
 }
 
 void QNetListView::clearHighlightSelectedObject()
@@ -300,6 +408,8 @@ void QNetListView::clearHighlightSelectedObject()
         auto* component = dynamic_cast<QNetlistGraphicsNode*>(item);
         component->clearHighlightColor();
     }
+
+    emit highlightChanged();
 }
 
 void QNetListView::contextMenuSelectConnectivity()
@@ -333,6 +443,8 @@ void QNetListView::contextMenuHighlightConnectivity()
     // get the paths that are connected to the item
     auto connectedItems = netlistItem->getConnectedItems();
 
+    QStringList bits;
+
     // check if the path items are valid and highlight them
     for(auto* connectedItem : connectedItems)
     {
@@ -340,8 +452,21 @@ void QNetListView::contextMenuHighlightConnectivity()
         {
             auto* path = dynamic_cast<QNetlistGraphicsPath*>(connectedItem);
             path->setHighlightColor(color);
+
+            if(path->getYosysPath() != nullptr)
+            {
+                bits.append(path->getYosysPath()->getBits());
+            }
         }
     }
+
+    // the nets are also highlighted in the other open modules
+    if(!bits.isEmpty())
+    {
+        emit netHighlighted(bits, color);
+    }
+
+    emit highlightChanged();
 }
 
 void QNetListView::contextMenuGoToSource()
@@ -423,6 +548,49 @@ void QNetListView::contextMenuSelectDestinations()
     }
 }
 
+void QNetListView::contextToggleExpandInPlace()
+{
+    // get the item under the mouse
+    QGraphicsItem* item = getItemAtContextMenu();
+
+    auto* graphicNode = dynamic_cast<QNetlistGraphicsNode*>(item);
+
+    // items inside an expanded node belong to the submodule
+    if(graphicNode == nullptr || graphicNode->parentItem() != nullptr)
+    {
+        return;
+    }
+
+    auto node = std::dynamic_pointer_cast<Yosys::Node>(graphicNode->getComponent());
+
+    // only generic modules have contents that can be expanded
+    if(node != nullptr && !SymbolTypes::isValidSymbolType(node->getType()))
+    {
+        emit expandInPlaceToggled(node->getName());
+    }
+}
+
+void QNetListView::contextShowCone()
+{
+    // get the item under the mouse
+    QGraphicsItem* item = getItemAtContextMenu();
+
+    // items inside an expanded node belong to the submodule
+    if(item == nullptr || item->parentItem() != nullptr)
+    {
+        return;
+    }
+
+    if(auto* graphicPath = dynamic_cast<QNetlistGraphicsPath*>(item))
+    {
+        emit coneRequested(graphicPath->getYosysPath()->getName());
+    }
+    else if(auto* graphicNode = dynamic_cast<QNetlistGraphicsNode*>(item))
+    {
+        emit coneRequested(graphicNode->getComponent()->getName());
+    }
+}
+
 void QNetListView::contextZoomTo()
 {
     // get the item under the mouse
@@ -559,6 +727,16 @@ void QNetListView::populateNodeContextMenu()
     this->nodeContextMenu->addAction(zoomToAction);
     connect(zoomToAction, &QAction::triggered, this, &QNetListView::contextZoomTo);
 
+    // add expand in place
+    auto* expandInPlaceAction = new QAction(tr("Expand/Collapse in Place"), this->nodeContextMenu);
+    this->nodeContextMenu->addAction(expandInPlaceAction);
+    connect(expandInPlaceAction, &QAction::triggered, this, &QNetListView::contextToggleExpandInPlace);
+
+    // add show cone
+    auto* showConeAction = new QAction(tr("Show Fan-In/Fan-Out..."), this->nodeContextMenu);
+    this->nodeContextMenu->addAction(showConeAction);
+    connect(showConeAction, &QAction::triggered, this, &QNetListView::contextShowCone);
+
     // add a separator
     this->nodeContextMenu->addSeparator();
 
@@ -620,6 +798,11 @@ void QNetListView::populatePathContextMenu()
     this->pathContextMenu->addAction(zoomToAction);
     connect(zoomToAction, &QAction::triggered, this, &QNetListView::contextZoomTo);
 
+    // add show cone
+    auto* showConeAction = new QAction(tr("Show Fan-In/Fan-Out..."), this->pathContextMenu);
+    this->pathContextMenu->addAction(showConeAction);
+    connect(showConeAction, &QAction::triggered, this, &QNetListView::contextShowCone);
+
     // add a separator
     this->pathContextMenu->addSeparator();
 
@@ -23,6 +23,7 @@
 #include <map>
 
 #include "dialogproperties.h"
+#include "qnetlisttilerenderer.h"
 
 namespace OpenNetlistView {
 
@@ -91,8 +92,25 @@ public:
      */
     QByteArray exportToSvg(bool exportSelected = false);
 
+    /**
+     * @brief Get if the view is drawn from cached tiles
+     *
+     * @return true if tile rendering is enabled
+     */
+    bool isTileRendering() const;
+
 public slots:
 
+    /**
+     * @brief Enables or disables drawing the view from cached tiles
+     *
+     * when enabled the scene is rendered into tiles by worker threads
+     * and the GUI thread only draws the finished tiles
+     *
+     * @param enabled true to enable tile rendering
+     */
+    void setTileRendering(bool enabled);
+
     /**
      * @brief Zooms into the diagram.
      *
@@ -129,6 +147,14 @@ public slots:
      */
     void clearAllHighlightColors();
 
+    /**
+     * @brief highlights the paths carrying one of the given bits
+     *
+     * @param bits the bits of the net in the module of the scene
+     * @param color the color to use for highlighting
+     */
+    void highlightBits(const QStringList& bits, const QColor& color);
+
 signals:
 
     /**
@@ -139,6 +165,41 @@ signals:
      */
     void genericModuleDoubleClicked(const QString& moduleName, const QString& moduleType);
 
+    /**
+     * @brief emitted when the highlight color of items in the scene changed
+     *
+     */
+    void highlightChanged();
+
+    /**
+     * @brief emitted when a path or the connectivity of a node was highlighted
+     *
+     * @param bits the highlighted bits in the module of the scene
+     * @param color the color used for highlighting
+     */
+    void netHighlighted(const QStringList& bits, const QColor& color);
+
+    /**
+     * @brief emitted when a generic module should be expanded or collapsed in place
+     *
+     * @param nodeName the name of the node instance
+     */
+    void expandInPlaceToggled(const QString& nodeName);
+
+    /**
+     * @brief emitted when the fan-in and fan-out of a node or path should be shown
+     *
+     * @param name the name of the node or path
+     */
+    void coneRequested(const QString& name);
+
+    /**
+     * @brief emitted when a port of the module is double clicked
+     *
+     * @param portName the name of the port
+     */
+    void modulePortDoubleClicked(const QString& portName);
+
 protected:
     /**
      * @brief custom wheel event to add zooming and horizontal scrolling
@@ -168,6 +229,13 @@ protected:
      */
     void mouseDoubleClickEvent(QMouseEvent* mouseEvent) override;
 
+    /**
+     * @brief custom paint event that draws cached tiles when tile rendering is enabled
+     *
+     * @param event qt paint event
+     */
+    void paintEvent(QPaintEvent* event) override;
+
 private slots:
 
     /**
@@ -213,6 +281,16 @@ private slots:
      */
     void contextMenuSelectDestinations();
 
+    /**
+     * @brief expands or collapses the generic module under the context menu in place
+     */
+    void contextToggleExpandInPlace();
+
+    /**
+     * @brief requests the fan-in and fan-out of the object under the context menu
+     */
+    void contextShowCone();
+
     /**
      * @brief zooms to the object under the context menu
      */
@@ -300,6 +378,9 @@ private:
     std::vector<QGraphicsItem*> selectedItems; ///< The selected items before the context menu was opened.
 
     DialogProperties* propertiesDialog = nullptr; ///< The properties dialog for the selected object.
+
+    QNetlistTileRenderer* tileRenderer = nullptr; ///< Renders the scene into cached tiles.
+    bool tileRendering = false;                   ///< Flag if the view is drawn from cached tiles.
 };
 
 } // namespace OpenNetlistView
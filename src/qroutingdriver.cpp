@@ -0,0 +1,170 @@
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+
+#include <routing/router.h>
+
+#include "qroutingdriver.h"
+
+namespace OpenNetlistView {
+
+QRoutingDriver::QRoutingDriver(QObject* parent)
+    : QObject(parent)
+{
+    // a zero interval runs the next slice as soon as the
+    // pending events of the event loop are processed
+    sliceTimer.setSingleShot(true);
+    sliceTimer.setInterval(0);
+
+    connect(&sliceTimer, &QTimer::timeout, this, &QRoutingDriver::runSlice);
+}
+
+QRoutingDriver::~QRoutingDriver()
+{
+    // leave no module in a half routed state
+    if(jobRunning && !jobs.empty())
+    {
+        jobs.front().router->cancelRouting();
+    }
+}
+
+void QRoutingDriver::enqueue(Routing::Router* router, std::function<void()> finished)
+{
+    if(router == nullptr)
+    {
+        return;
+    }
+
+    auto jobIt = std::find_if(jobs.begin(), jobs.end(), [router](const RoutingJob& job) {
+        return job.router == router;
+    });
+
+    // a router that is already queued only gets the new callback
+    if(jobIt != jobs.end())
+    {
+        jobIt->finished = std::move(finished);
+        return;
+    }
+
+    jobs.push_back({router, std::move(finished)});
+
+    startNext();
+}
+
+void QRoutingDriver::cancel(Routing::Router* router)
+{
+    auto jobIt = std::find_if(jobs.begin(), jobs.end(), [router](const RoutingJob& job) {
+        return job.router == router;
+    });
+
+    if(jobIt == jobs.end())
+    {
+        return;
+    }
+
+    if(jobIt == jobs.begin() && jobRunning)
+    {
+        router->cancelRouting();
+        jobRunning = false;
+    }
+
+    jobs.erase(jobIt);
+
+    startNext();
+}
+
+bool QRoutingDriver::isPending(Routing::Router* router) const
+{
+    return std::any_of(jobs.begin(), jobs.end(), [router](const RoutingJob& job) {
+        return job.router == router;
+    });
+}
+
+void QRoutingDriver::runSlice()
+{
+    if(jobs.empty())
+    {
+        return;
+    }
+
+    Routing::Router* router = jobs.front().router;
+
+    QElapsedTimer sliceTime;
+    sliceTime.start();
+
+    bool done = false;
+
+    try
+    {
+        // the routing is started in the first slice so a module shared
+        // with a previous job is only routed once
+        if(!jobRunning)
+        {
+            jobRunning = true;
+            done = !router->beginRouting();
+        }
+
+        while(!done && sliceTime.elapsed() < sliceMilliseconds)
+        {
+            done = router->runRoutingStep();
+        }
+    }
+    catch(const std::exception& e)
+    {
+        router->cancelRouting();
+        jobRunning = false;
+        jobs.pop_front();
+
+        emit routingFailed(e.what());
+
+        startNext();
+        return;
+    }
+
+    if(!done)
+    {
+        emit routingProgress(static_cast<int>(std::lround(router->getRoutingProgress() * progressScale)));
+
+        sliceTimer.start();
+        return;
+    }
+
+    // remove the job before the callback so it can queue new routings
+    auto finished = std::move(jobs.front().finished);
+    jobRunning = false;
+    jobs.pop_front();
+
+    emit routingProgress(progressScale);
+
+    if(finished)
+    {
+        finished();
+    }
+
+    startNext();
+}
+
+void QRoutingDriver::startNext()
+{
+    if(jobs.empty())
+    {
+        sliceTimer.stop();
+        emit routingIdle();
+        return;
+    }
+
+    if(!sliceTimer.isActive())
+    {
+        sliceTimer.start();
+    }
+}
+
+} // namespace OpenNetlistView
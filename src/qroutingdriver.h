@@ -0,0 +1,141 @@
+/**
+ * @file qroutingdriver.h
+ * @brief Header file for the QRoutingDriver class.
+ *
+ * This file contains the declaration of the QRoutingDriver class, which runs
+ * the routing of modules in short time slices from the event loop so the GUI
+ * stays responsive while a module is routed.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __QROUTINGDRIVER_H__
+#define __QROUTINGDRIVER_H__
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <deque>
+#include <functional>
+
+#include <routing/router.h>
+
+namespace OpenNetlistView {
+
+/**
+ * @class QRoutingDriver
+ * @brief Runs queued routings step by step in time slices of the event loop.
+ *
+ * The routers are advanced with Routing::Router::runRoutingStep() until a time
+ * slice is used up, then control is given back to the event loop. This works
+ * without threads so the WebAssembly build uses the same code path as the
+ * native build. The routings are run one after another because tabs of the same
+ * module type share the module that is routed.
+ */
+class QRoutingDriver : public QObject
+{
+    Q_OBJECT
+
+private:
+    constexpr const static int sliceMilliseconds{16}; ///< The time in milliseconds a slice may route before returning to the event loop.
+    constexpr const static int progressScale{100};    ///< The value of the progress when the routing is finished.
+
+    /**
+     * @struct RoutingJob
+     * @brief A routing waiting for or running in the driver.
+     */
+    struct RoutingJob
+    {
+        Routing::Router* router;        ///< The router to run.
+        std::function<void()> finished; ///< Called after the router finished.
+    };
+
+public:
+    /**
+     * @brief Construct a new QRoutingDriver object
+     *
+     * @param parent The parent object.
+     */
+    explicit QRoutingDriver(QObject* parent = nullptr);
+
+    /**
+     * @brief Destroy the QRoutingDriver object
+     *
+     */
+    ~QRoutingDriver();
+
+    /**
+     * @brief Queue a router to be run
+     *
+     * The module and symbols have to be set on the router. The router
+     * must stay valid until finished is called or the job is canceled.
+     *
+     * @param router The router to run.
+     * @param finished Called after the router finished, also if there was nothing to route.
+     */
+    void enqueue(Routing::Router* router, std::function<void()> finished);
+
+    /**
+     * @brief Remove a router from the driver
+     *
+     * A running routing is aborted and the module is left unrouted.
+     * The finished callback of the router is not called.
+     *
+     * @param router The router to remove.
+     */
+    void cancel(Routing::Router* router);
+
+    /**
+     * @brief Check if a router is queued or running
+     *
+     * @param router The router to check.
+     * @return true if the router has not finished yet
+     */
+    bool isPending(Routing::Router* router) const;
+
+signals:
+
+    /**
+     * @brief Signal emitted after every time slice of a routing
+     *
+     * @param progress The progress of the running routing between 0 and 100.
+     */
+    void routingProgress(int progress);
+
+    /**
+     * @brief Signal emitted when all queued routings are finished
+     *
+     */
+    void routingIdle();
+
+    /**
+     * @brief Signal emitted when a routing failed
+     *
+     * @param message The error message.
+     */
+    void routingFailed(const QString& message);
+
+private slots:
+
+    /**
+     * @brief Runs the current routing for one time slice
+     *
+     */
+    void runSlice();
+
+private:
+    /**
+     * @brief Starts the next queued routing if the driver is idle
+     *
+     */
+    void startNext();
+
+    std::deque<RoutingJob> jobs; ///< The queued routings, the first one is running.
+    QTimer sliceTimer;           ///< The timer scheduling the next time slice.
+    bool jobRunning = false;     ///< Flag if the first queued routing has been started.
+};
+
+} // namespace OpenNetlistView
+
+#endif // __QROUTINGDRIVER_H__
@@ -1,3 +1,6 @@
+#include <QPointF>
+#include <QPolygonF>
+
 #include <third_party/libavoid/router.h>
 #include <third_party/libavoid/geomtypes.h>
 #include <third_party/libavoid/shape.h>
@@ -11,12 +14,21 @@
 #include <utility>
 #include <memory>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <tuple>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
 
 #include <yosys/module.h>
-#include <symbol/port.h>
+#include <yosys/path.h>
+#include <scheduler/taskscheduler.h>
 
 #include "avoid_router.h"
+#include "grid_snapper.h"
 
 // used for debug output generation in the debug build
 #if defined(_DEBUG) && !defined(EMSCRIPTEN)
@@ -26,6 +38,40 @@
 
 namespace OpenNetlistView::Routing {
 
+namespace {
+
+/**
+ * @brief Get the key of a bucket in the hash of the shape buckets
+ *
+ * @param bucketX The x index of the bucket.
+ * @param bucketY The y index of the bucket.
+ * @return int64_t The key of the bucket.
+ */
+int64_t getBucketKey(int bucketX, int bucketY)
+{
+    return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(bucketX)) << 32) | static_cast<uint32_t>(bucketY));
+}
+
+/**
+ * @brief Converts a route of libavoid to a polygon
+ *
+ * @param route The route.
+ * @return QPolygonF The points of the route.
+ */
+QPolygonF toPolygon(const Avoid::PolyLine& route)
+{
+    QPolygonF points;
+
+    for(const auto& point : route.ps)
+    {
+        points.append(QPointF(point.x, point.y));
+    }
+
+    return points;
+}
+
+} // namespace
+
 AvoidRouter::AvoidRouter()
     : module(nullptr)
     , topologyAddon(nullptr)
@@ -61,6 +107,15 @@ void AvoidRouter::setColaEdges(std::vector<cola::Edge> edges)
 }
 
 void AvoidRouter::runAvoid()
+{
+    this->beginAvoid();
+
+    while(!this->runAvoidStep())
+    {
+    }
+}
+
+void AvoidRouter::beginAvoid()
 {
 
     // only route if there is a module, cola rectangles and edges available
@@ -69,13 +124,57 @@ void AvoidRouter::runAvoid()
         return;
     }
 
-    // generate the avoid graph representation and route the lines
+    // generate the avoid graph representation and the connections
     this->createAvoidRep();
-    this->routeAvoid();
+    this->createAvoidConnections();
+
+    // the connections are routed in batches by the steps
+    this->routedConnectors = 0;
+    this->transactionPending = this->router->beginTransactionSteps();
+    this->routingActive = true;
+}
+
+bool AvoidRouter::runAvoidStep()
+{
+    if(!this->routingActive)
+    {
+        return true;
+    }
+
+    if(this->transactionPending)
+    {
+        if(!this->router->processTransactionStep(connectorsPerStep))
+        {
+            this->routedConnectors = std::min(this->routedConnectors + connectorsPerStep, this->avoidConRefs.size());
+            return false;
+        }
+
+        this->router->finishTransactionSteps();
+        this->transactionPending = false;
+    }
+
+    this->finishAvoidRouting();
+    this->routingActive = false;
+
+    return true;
+}
+
+double AvoidRouter::getAvoidProgress() const
+{
+    if(!this->routingActive || this->avoidConRefs.empty())
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(this->routedConnectors) / static_cast<double>(this->avoidConRefs.size());
 }
 
 void AvoidRouter::clear()
 {
+    // the running routing is dropped with the router
+    this->routingActive = false;
+    this->transactionPending = false;
+    this->routedConnectors = 0;
 
     // delete the router object and create a new one
     delete router;
@@ -84,7 +183,10 @@ void AvoidRouter::clear()
     this->avoidPins.clear();
     this->avoidConnID = 1;
     this->connEnds.clear();
+    this->pinIndices.clear();
+    this->avoidBundles.clear();
     this->avoidConRefs.clear();
+    this->connRefRectIDs.clear();
 
     for(auto& rect : colaRectangles)
     {
@@ -116,8 +218,7 @@ void AvoidRouter::createAvoidRep()
 
         // checks if the rectangle is one of a node or of a port
         // if it is a node create the rectangle and set it as the rectNode
-        if(rectHeight >= 1 + Symbol::Port::portRectHeight &&
-            rectWidth >= 1 + Symbol::Port::portRectWidth)
+        if(GridSnapper::isShapeRectangle(rectangle))
         {
             auto* avoidRect = new Avoid::Rectangle(Avoid::Point(centerX, centerY), rectWidth, rectHeight);
 
@@ -204,9 +305,10 @@ void AvoidRouter::createAvoidRep()
                 connDir);
 
             avoidPin->setExclusive(false);
-            avoidPins.emplace_back(avoidPin);
+            avoidPins.push_back({avoidPin, avoidShapes.back(), static_cast<unsigned int>(this->avoidConnID), xOffset, yOffset, connDir});
             auto* connEnd = new Avoid::ConnEnd(avoidShapes.back(), this->avoidConnID);
             connEnds[rectangleID] = connEnd;
+            pinIndices[rectangleID] = avoidPins.size() - 1;
             this->avoidConnID++;
         }
         else
@@ -219,7 +321,7 @@ void AvoidRouter::createAvoidRep()
     }
 }
 
-void AvoidRouter::routeAvoid()
+void AvoidRouter::createAvoidConnections()
 {
     this->router->setTransactionUse(true);
 
@@ -228,44 +330,396 @@ void AvoidRouter::routeAvoid()
         this->avoidRootCluster,
         this->colaIDMap);
 
+    // the router uses a copy of the addon so the limits have to be set before
+    if(this->topologyImprovementLimited)
+    {
+        this->topologyAddon->setImprovementLimits(true, topologyMaxIterations, topologyMaxSeconds);
+
+        // the conflict regions are independent of each other and are solved in parallel
+        this->topologyAddon->setRegionRunner([](size_t count, const std::function<void(size_t)>& solve) {
+            Scheduler::TaskScheduler::getShared().parallelFor(0, count, [&solve](size_t regionBegin, size_t regionEnd) {
+                for(size_t regionIdx = regionBegin; regionIdx < regionEnd; regionIdx++)
+                {
+                    solve(regionIdx);
+                }
+            });
+        });
+    }
+
     this->router->setTopologyAddon(this->topologyAddon);
 
+    // connections between the same sides of two shapes are bundled in the
+    // order of the edges, so the routing does not depend on the addresses
+    std::map<std::tuple<Avoid::ShapeRef*, Avoid::ShapeRef*, int, int>, size_t> bundleIndices;
+    std::vector<std::vector<std::pair<int, int>>> bundleEdges;
+    std::vector<size_t> edgeBundles;
+
     for(const auto& edge : colaEdges)
     {
 
         // TODO: Convert all int functions to unsigned int because the cola library uses unsigned int / size_t
 
         // find the connEnds that match the ids of of the rectangles in the edge
-        // vector created by the cola library then create a connection reference
-        // and add it to the connection object
+        // vector created by the cola library, edges without pins are not routed
+        const int srcRectID = static_cast<int>(edge.first);
+        const int dstRectID = static_cast<int>(edge.second);
+
+        if(connEnds.find(srcRectID) == connEnds.end() || connEnds.find(dstRectID) == connEnds.end())
+        {
+            edgeBundles.push_back(bundleEdges.size());
+            bundleEdges.push_back({});
+            continue;
+        }
+
+        const AvoidPinInfo& srcPin = avoidPins[pinIndices[srcRectID]];
+        const AvoidPinInfo& dstPin = avoidPins[pinIndices[dstRectID]];
 
-        if(connEnds.find(static_cast<int>(edge.first)) == connEnds.end() ||
-            connEnds.find(static_cast<int>(edge.second)) == connEnds.end())
+        // pins without a side and connections within a shape are routed on their own
+        if(srcPin.shape == dstPin.shape || srcPin.direction == Avoid::ConnDirNone || dstPin.direction == Avoid::ConnDirNone)
         {
+            edgeBundles.push_back(bundleEdges.size());
+            bundleEdges.push_back({std::make_pair(srcRectID, dstRectID)});
             continue;
         }
-        auto* connRef = new Avoid::ConnRef(this->router,
-            *(connEnds[static_cast<int>(edge.first)]),
-            *(connEnds[static_cast<int>(edge.second)]));
 
-        auto conn = module->getPathByColaSrcDstIDs(static_cast<int>(edge.first), static_cast<int>(edge.second));
+        const auto bundleKey = std::make_tuple(srcPin.shape, dstPin.shape, static_cast<int>(srcPin.direction), static_cast<int>(dstPin.direction));
+        const auto [bundleIt, inserted] = bundleIndices.try_emplace(bundleKey, bundleEdges.size());
 
-        if(conn != nullptr)
+        if(inserted)
         {
-            conn->addAvoidConnRef(connRef);
-            conn->addAvoidPortRelation(connRef, static_cast<int>(edge.second));
+            bundleEdges.emplace_back();
         }
 
-        avoidConRefs.emplace_back(connRef);
+        bundleEdges[bundleIt->second].emplace_back(srcRectID, dstRectID);
+        edgeBundles.push_back(bundleIt->second);
     }
 
-    // route the graph
+    // the middle connection of a bundle is routed, so the others are moved the least
+    for(auto& edges : bundleEdges)
+    {
+        if(edges.size() >= minBundleSize)
+        {
+            std::stable_sort(edges.begin(), edges.end(), [this](const auto& first, const auto& second) {
+                const QPointF firstPos = getPinPosition(first.first);
+                const QPointF secondPos = getPinPosition(second.first);
+                return firstPos.x() + firstPos.y() < secondPos.x() + secondPos.y();
+            });
+        }
+    }
 
-    this->router->processTransaction();
+    std::vector<bool> bundleCreated(bundleEdges.size(), false);
+
+    for(size_t edgeIdx = 0; edgeIdx < colaEdges.size(); edgeIdx++)
+    {
+        const size_t bundleIdx = edgeBundles[edgeIdx];
+        const auto& edges = bundleEdges[bundleIdx];
+
+        if(edges.empty() || bundleCreated[bundleIdx])
+        {
+            continue;
+        }
+
+        if(edges.size() < minBundleSize)
+        {
+            this->createConnRef(static_cast<int>(colaEdges[edgeIdx].first), static_cast<int>(colaEdges[edgeIdx].second));
+            continue;
+        }
+
+        // the bundle is created with the first of its edges
+        const size_t representativeIdx = edges.size() / 2;
+        this->createConnRef(edges[representativeIdx].first, edges[representativeIdx].second);
+
+        AvoidBundle bundle{this->avoidConRefs.back(), edges[representativeIdx].first, edges[representativeIdx].second, {}};
+
+        for(size_t memberIdx = 0; memberIdx < edges.size(); memberIdx++)
+        {
+            if(memberIdx != representativeIdx)
+            {
+                bundle.members.push_back({edges[memberIdx].first, edges[memberIdx].second, nullptr});
+            }
+        }
+
+        this->avoidBundles.push_back(std::move(bundle));
+        bundleCreated[bundleIdx] = true;
+    }
+}
+
+void AvoidRouter::createConnRef(int srcRectID, int dstRectID)
+{
+    auto* connRef = new Avoid::ConnRef(this->router, *(connEnds[srcRectID]), *(connEnds[dstRectID]));
+
+    auto conn = module->getPathByColaSrcDstIDs(srcRectID, dstRectID);
+
+    if(conn != nullptr)
+    {
+        conn->addAvoidConnRef(connRef);
+        conn->addAvoidPortRelation(connRef, dstRectID);
+    }
+
+    avoidConRefs.emplace_back(connRef);
+    connRefRectIDs[connRef] = {srcRectID, dstRectID};
+}
+
+void AvoidRouter::finishBundles()
+{
+    // every pass routes at least one more member on its own, so the loop ends
+    while(this->checkBundles())
+    {
+        this->router->processTransaction();
+    }
+}
+
+bool AvoidRouter::checkBundles()
+{
+    if(this->avoidBundles.empty())
+    {
+        return false;
+    }
+
+    // the shapes are looked up in buckets so the check stays fast for large modules
+    std::unordered_map<int64_t, std::vector<size_t>> shapeBuckets;
+
+    for(size_t shapeIdx = 0; shapeIdx < avoidShapes.size(); shapeIdx++)
+    {
+        const Avoid::Box box = avoidShapes[shapeIdx]->polygon().offsetBoundingBox(0.0);
+
+        for(int bucketX = static_cast<int>(std::floor(box.min.x / shapeBucketSize)); bucketX <= static_cast<int>(std::floor(box.max.x / shapeBucketSize)); bucketX++)
+        {
+            for(int bucketY = static_cast<int>(std::floor(box.min.y / shapeBucketSize)); bucketY <= static_cast<int>(std::floor(box.max.y / shapeBucketSize)); bucketY++)
+            {
+                shapeBuckets[getBucketKey(bucketX, bucketY)].push_back(shapeIdx);
+            }
+        }
+    }
+
+    // the lines routed by libavoid, the bundled lines are added once they are checked
+    AvoidLineSegments lineSegments;
+
+    for(auto* connRef : this->avoidConRefs)
+    {
+        addLineSegments(toPolygon(connRef->displayRoute()), connRefRectIDs.at(connRef).first, lineSegments);
+    }
+
+    bool rerouteNeeded = false;
+
+    for(auto& bundle : this->avoidBundles)
+    {
+        const QPolygonF route = toPolygon(bundle.representative->displayRoute());
+
+        for(auto& member : bundle.members)
+        {
+            const QPointF srcOffset = getPinPosition(member.srcRectID) - getPinPosition(bundle.srcRectID);
+            const QPointF dstOffset = getPinPosition(member.dstRectID) - getPinPosition(bundle.dstRectID);
+
+            QPolygonF bundledRoute;
+
+            if(!route.isEmpty())
+            {
+                bundledRoute = Yosys::Path::deriveBundledRoute(route, route.front() + srcOffset, route.back() + dstOffset);
+            }
+
+            auto conn = module->getPathByColaSrcDstIDs(member.srcRectID, member.dstRectID);
+
+            if(bundledRoute.isEmpty() || crossesShapes(bundledRoute, member, shapeBuckets) || overlapsLines(bundledRoute, member.srcRectID, lineSegments))
+            {
+                // a line added by an earlier check is replaced by the connection
+                if(member.bundledLine != nullptr && conn != nullptr)
+                {
+                    conn->removeBundledLine(member.bundledLine);
+                }
+
+                member.bundledLine = nullptr;
+
+                this->createConnRef(member.srcRectID, member.dstRectID);
+                rerouteNeeded = true;
+                continue;
+            }
+
+            addLineSegments(bundledRoute, member.srcRectID, lineSegments);
+
+            // the line follows the moved pins
+            if(member.bundledLine != nullptr)
+            {
+                member.bundledLine->srcOffset = srcOffset;
+                member.bundledLine->dstOffset = dstOffset;
+                continue;
+            }
+
+            member.bundledLine = std::make_shared<Yosys::Path::BundledLine>(Yosys::Path::BundledLine{bundle.representative, srcOffset, dstOffset});
+
+            if(conn != nullptr)
+            {
+                conn->addBundledLine(member.bundledLine, member.dstRectID);
+            }
+        }
+
+        // the members routed on their own are not part of the bundle anymore
+        bundle.members.erase(std::remove_if(bundle.members.begin(), bundle.members.end(), [](const AvoidBundleMember& member) {
+            return member.bundledLine == nullptr;
+        }),
+            bundle.members.end());
+    }
+
+    return rerouteNeeded;
+}
+
+void AvoidRouter::populateDisplayRoutes()
+{
+    for(auto* connRef : this->avoidConRefs)
+    {
+        connRef->displayRoute();
+    }
+}
+
+QPointF AvoidRouter::getPinPosition(int rectID) const
+{
+    const Avoid::Point position = avoidPins[pinIndices.at(rectID)].pin->position();
+
+    return {position.x, position.y};
+}
+
+bool AvoidRouter::crossesShapes(const QPolygonF& route, const AvoidBundleMember& member,
+    const std::unordered_map<int64_t, std::vector<size_t>>& shapeBuckets) const
+{
+    const Avoid::ShapeRef* srcShape = avoidPins[pinIndices.at(member.srcRectID)].shape;
+    const Avoid::ShapeRef* dstShape = avoidPins[pinIndices.at(member.dstRectID)].shape;
+
+    for(qsizetype pointIdx = 1; pointIdx < route.size(); pointIdx++)
+    {
+        const double minX = std::min(route[pointIdx - 1].x(), route[pointIdx].x());
+        const double maxX = std::max(route[pointIdx - 1].x(), route[pointIdx].x());
+        const double minY = std::min(route[pointIdx - 1].y(), route[pointIdx].y());
+        const double maxY = std::max(route[pointIdx - 1].y(), route[pointIdx].y());
+
+        for(int bucketX = static_cast<int>(std::floor(minX / shapeBucketSize)); bucketX <= static_cast<int>(std::floor(maxX / shapeBucketSize)); bucketX++)
+        {
+            for(int bucketY = static_cast<int>(std::floor(minY / shapeBucketSize)); bucketY <= static_cast<int>(std::floor(maxY / shapeBucketSize)); bucketY++)
+            {
+                const auto bucket = shapeBuckets.find(getBucketKey(bucketX, bucketY));
+
+                if(bucket == shapeBuckets.end())
+                {
+                    continue;
+                }
+
+                for(const size_t shapeIdx : bucket->second)
+                {
+                    const Avoid::ShapeRef* shape = avoidShapes[shapeIdx];
+
+                    // the line starts and ends at the pins on the border of the shapes
+                    if((pointIdx == 1 && shape == srcShape) || (pointIdx == route.size() - 1 && shape == dstShape))
+                    {
+                        continue;
+                    }
+
+                    const Avoid::Box box = shape->polygon().offsetBoundingBox(0.0);
+
+                    if(minX < box.max.x && maxX > box.min.x && minY < box.max.y && maxY > box.min.y)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void AvoidRouter::addLineSegments(const QPolygonF& route, int srcRectID, AvoidLineSegments& lineSegments)
+{
+    for(qsizetype pointIdx = 1; pointIdx < route.size(); pointIdx++)
+    {
+        const QPointF& start = route[pointIdx - 1];
+        const QPointF& end = route[pointIdx];
+
+        const size_t segmentIdx = lineSegments.segments.size();
+        lineSegments.segments.emplace_back(start, end);
+        lineSegments.srcRectIDs.push_back(srcRectID);
+
+        for(int bucketX = static_cast<int>(std::floor(std::min(start.x(), end.x()) / shapeBucketSize)); bucketX <= static_cast<int>(std::floor(std::max(start.x(), end.x()) / shapeBucketSize)); bucketX++)
+        {
+            for(int bucketY = static_cast<int>(std::floor(std::min(start.y(), end.y()) / shapeBucketSize)); bucketY <= static_cast<int>(std::floor(std::max(start.y(), end.y()) / shapeBucketSize)); bucketY++)
+            {
+                lineSegments.buckets[getBucketKey(bucketX, bucketY)].push_back(segmentIdx);
+            }
+        }
+    }
+}
+
+bool AvoidRouter::overlapsLines(const QPolygonF& route, int srcRectID, const AvoidLineSegments& lineSegments)
+{
+    // the length two parallel segments share, negative if they do not overlap
+    auto getSharedLength = [](double firstStart, double firstEnd, double secondStart, double secondEnd) {
+        return std::min(std::max(firstStart, firstEnd), std::max(secondStart, secondEnd)) -
+               std::max(std::min(firstStart, firstEnd), std::min(secondStart, secondEnd));
+    };
+
+    for(qsizetype pointIdx = 1; pointIdx < route.size(); pointIdx++)
+    {
+        const QPointF& start = route[pointIdx - 1];
+        const QPointF& end = route[pointIdx];
+        const bool horizontal = std::abs(start.y() - end.y()) < lineOverlapDistance;
+
+        // the neighbouring buckets hold the segments that are just across a bucket border
+        const double minX = std::min(start.x(), end.x()) - lineOverlapDistance;
+        const double maxX = std::max(start.x(), end.x()) + lineOverlapDistance;
+        const double minY = std::min(start.y(), end.y()) - lineOverlapDistance;
+        const double maxY = std::max(start.y(), end.y()) + lineOverlapDistance;
+
+        for(int bucketX = static_cast<int>(std::floor(minX / shapeBucketSize)); bucketX <= static_cast<int>(std::floor(maxX / shapeBucketSize)); bucketX++)
+        {
+            for(int bucketY = static_cast<int>(std::floor(minY / shapeBucketSize)); bucketY <= static_cast<int>(std::floor(maxY / shapeBucketSize)); bucketY++)
+            {
+                const auto bucket = lineSegments.buckets.find(getBucketKey(bucketX, bucketY));
+
+                if(bucket == lineSegments.buckets.end())
+                {
+                    continue;
+                }
+
+                for(const size_t segmentIdx : bucket->second)
+                {
+                    if(lineSegments.srcRectIDs[segmentIdx] == srcRectID)
+                    {
+                        continue;
+                    }
+
+                    const auto& [otherStart, otherEnd] = lineSegments.segments[segmentIdx];
+
+                    if(horizontal != (std::abs(otherStart.y() - otherEnd.y()) < lineOverlapDistance))
+                    {
+                        continue;
+                    }
+
+                    const bool overlaps = horizontal ? std::abs(start.y() - otherStart.y()) < lineOverlapDistance &&
+                                                           getSharedLength(start.x(), end.x(), otherStart.x(), otherEnd.x()) > lineOverlapDistance
+                                                     : std::abs(start.x() - otherStart.x()) < lineOverlapDistance &&
+                                                           getSharedLength(start.y(), end.y(), otherStart.y(), otherEnd.y()) > lineOverlapDistance;
+
+                    if(overlaps)
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void AvoidRouter::finishAvoidRouting()
+{
     this->router->improveOrthogonalTopology();
 
+    // the lines are checked against the routes after the topology improvement
+    this->finishBundles();
+
     this->router->setTransactionUse(false);
 
+    this->populateDisplayRoutes();
+
 // create a svg file with the graph to use for debugging
 #if defined(_DEBUG) && !defined(EMSCRIPTEN)
     std::setlocale(LC_NUMERIC, "C");
@@ -278,4 +732,183 @@ void AvoidRouter::routeAvoid()
 #endif // defined(_DEBUG) && !defined(EMSCRIPTEN)
 }
 
-} // namespace OpenNetlistView::Routing
\ No newline at end of file
+void AvoidRouter::resizeShape(Avoid::ShapeRef* shape, double width, double height)
+{
+    if(shape == nullptr)
+    {
+        return;
+    }
+
+    const Avoid::Box oldBox = shape->polygon().offsetBoundingBox(0.0);
+
+    // batch all changes so only the affected connections are rerouted
+    this->router->setTransactionUse(true);
+
+    const Avoid::Rectangle newRect(shape->position(), width, height);
+    const Avoid::Box newBox = newRect.offsetBoundingBox(0.0);
+
+    this->router->moveShape(shape, newRect);
+
+    // make room for a grown shape by moving the shapes on each side of it
+    // outwards by the growth on that side, this keeps the order and the
+    // distances of the other shapes so no new overlaps are created
+    const double growLeft = std::max(0.0, oldBox.min.x - newBox.min.x);
+    const double growRight = std::max(0.0, newBox.max.x - oldBox.max.x);
+    const double growTop = std::max(0.0, oldBox.min.y - newBox.min.y);
+    const double growBottom = std::max(0.0, newBox.max.y - oldBox.max.y);
+
+    std::map<Avoid::ShapeRef*, std::pair<double, double>> shapeMoves;
+
+    for(auto* otherShape : avoidShapes)
+    {
+        if(otherShape == shape)
+        {
+            continue;
+        }
+
+        const Avoid::Box otherBox = otherShape->polygon().offsetBoundingBox(0.0);
+
+        double xDiff = 0.0;
+        double yDiff = 0.0;
+
+        if(otherBox.min.x >= oldBox.max.x)
+        {
+            xDiff = growRight;
+        }
+        else if(otherBox.max.x <= oldBox.min.x)
+        {
+            xDiff = -growLeft;
+        }
+
+        if(otherBox.min.y >= oldBox.max.y)
+        {
+            yDiff = growBottom;
+        }
+        else if(otherBox.max.y <= oldBox.min.y)
+        {
+            yDiff = -growTop;
+        }
+
+        if(xDiff != 0.0 || yDiff != 0.0)
+        {
+            this->router->moveShape(otherShape, xDiff, yDiff);
+            shapeMoves.emplace(otherShape, std::make_pair(xDiff, yDiff));
+        }
+    }
+
+    // the cola rectangles are moved as well, so a later routing from
+    // them starts from the new placement and not from the old one
+    this->updateColaRectangles(shape, oldBox, newBox, shapeMoves);
+
+    // recreate the pins of the shape with proportional offsets so they stay on the
+    // same side of the shape, the old pins would end up inside of the larger shape
+    for(auto& pinInfo : avoidPins)
+    {
+        if(pinInfo.shape != shape)
+        {
+            continue;
+        }
+
+        double xPortion = std::clamp(pinInfo.xOffset / oldBox.width(), 0.0, 1.0);
+        double yPortion = std::clamp(pinInfo.yOffset / oldBox.height(), 0.0, 1.0);
+
+        switch(pinInfo.direction)
+        {
+            case Avoid::ConnDirFlag::ConnDirLeft:
+                xPortion = Avoid::ATTACH_POS_LEFT;
+                break;
+            case Avoid::ConnDirFlag::ConnDirRight:
+                xPortion = Avoid::ATTACH_POS_RIGHT;
+                break;
+            case Avoid::ConnDirFlag::ConnDirUp:
+                yPortion = Avoid::ATTACH_POS_TOP;
+                break;
+            case Avoid::ConnDirFlag::ConnDirDown:
+                yPortion = Avoid::ATTACH_POS_BOTTOM;
+                break;
+            default:
+                break;
+        }
+
+        delete pinInfo.pin;
+
+        pinInfo.pin = new Avoid::ShapeConnectionPin(shape,
+            pinInfo.classId,
+            xPortion,
+            yPortion,
+            true,
+            0,
+            pinInfo.direction);
+
+        pinInfo.pin->setExclusive(false);
+    }
+
+    // attach the connections of the shape to the new pins
+    for(const auto& [connRef, rectIDs] : connRefRectIDs)
+    {
+        const auto ends = connRef->endpointConnEnds();
+
+        if(ends.first.shape() != shape && ends.second.shape() != shape)
+        {
+            continue;
+        }
+
+        connRef->setEndpoints(*(connEnds[rectIDs.first]), *(connEnds[rectIDs.second]));
+    }
+
+    this->router->processTransaction();
+
+    // the bundled lines follow the moved pins of the shape or are routed on their own
+    this->finishBundles();
+
+    this->router->setTransactionUse(false);
+
+    this->populateDisplayRoutes();
+}
+
+void AvoidRouter::updateColaRectangles(Avoid::ShapeRef* shape, const Avoid::Box& oldBox, const Avoid::Box& newBox,
+    const std::map<Avoid::ShapeRef*, std::pair<double, double>>& shapeMoves)
+{
+    // the pin rectangles follow the rectangle of their shape like in createAvoidRep
+    Avoid::ShapeRef* currentShape = nullptr;
+    size_t shapeIdx = 0;
+
+    for(auto* rectangle : colaRectangles)
+    {
+        if(GridSnapper::isShapeRectangle(rectangle))
+        {
+            currentShape = shapeIdx < avoidShapes.size() ? avoidShapes[shapeIdx] : nullptr;
+            shapeIdx++;
+
+            if(currentShape == shape)
+            {
+                rectangle->reset(vpsc::XDIM, newBox.min.x, newBox.max.x);
+                rectangle->reset(vpsc::YDIM, newBox.min.y, newBox.max.y);
+                continue;
+            }
+        }
+        else if(currentShape == shape && currentShape != nullptr)
+        {
+            // the pins keep their relative position on the shape
+            const double xPortion = std::clamp((rectangle->getCentreX() - oldBox.min.x) / oldBox.width(), 0.0, 1.0);
+            const double yPortion = std::clamp((rectangle->getCentreY() - oldBox.min.y) / oldBox.height(), 0.0, 1.0);
+
+            rectangle->moveCentre(newBox.min.x + (xPortion * newBox.width()), newBox.min.y + (yPortion * newBox.height()));
+            continue;
+        }
+
+        auto moveIt = shapeMoves.find(currentShape);
+
+        if(moveIt != shapeMoves.end())
+        {
+            rectangle->moveCentre(rectangle->getCentreX() + moveIt->second.first, rectangle->getCentreY() + moveIt->second.second);
+        }
+    }
+}
+
+void AvoidRouter::setTopologyImprovementLimited(bool limited)
+{
+    this->topologyImprovementLimited = limited;
+}
+
+} // namespace OpenNetlistView::Routing
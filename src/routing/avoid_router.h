@@ -7,6 +7,10 @@
  * the libavoid library for routing and provides methods to set the module, rectangles,
  * and edges to be routed, as well as to run the routing process.
  *
+ * Parallel connections between the same sides of two shapes are routed as a bundle,
+ * only one connection of the bundle is routed by libavoid and the others follow
+ * its route at the distance of their pins.
+ *
  * The AvoidRouter class is part of the OpenNetlistView::Routing namespace.
  *
  * @author Lukas Bauer
@@ -15,6 +19,9 @@
 #ifndef __AVOID_ROUTER_H__
 #define __AVOID_ROUTER_H__
 
+#include <QPointF>
+#include <QPolygonF>
+
 #include <third_party/libavoid/router.h>
 #include <third_party/libvpsc/rectangle.h>
 #include <third_party/libcola/cola.h>
@@ -22,11 +29,67 @@
 
 #include <memory>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
 
 #include <yosys/module.h>
+#include <yosys/path.h>
 
 namespace OpenNetlistView::Routing {
 
+/**
+ * @struct AvoidPinInfo
+ * @brief Stores a connection pin together with the data it was created from.
+ *
+ * The data is needed to recreate the pin at the same side of the shape
+ * when the shape is resized.
+ */
+struct AvoidPinInfo
+{
+    Avoid::ShapeConnectionPin* pin; ///< The pin of the shape.
+    Avoid::ShapeRef* shape;         ///< The shape the pin belongs to.
+    unsigned int classId;           ///< The class ID used by the connection ends of the pin.
+    double xOffset;                 ///< The x offset of the pin from the top left corner of the shape.
+    double yOffset;                 ///< The y offset of the pin from the top left corner of the shape.
+    Avoid::ConnDirFlag direction;   ///< The side of the shape the pin is located on.
+};
+
+/**
+ * @struct AvoidBundleMember
+ * @brief A connection of a bundle that follows the route of the representative.
+ */
+struct AvoidBundleMember
+{
+    int srcRectID;                                         ///< The cola rectangle ID of the source pin.
+    int dstRectID;                                         ///< The cola rectangle ID of the destination pin.
+    std::shared_ptr<Yosys::Path::BundledLine> bundledLine; ///< The line added to the path, nullptr until the bundle is routed.
+};
+
+/**
+ * @struct AvoidBundle
+ * @brief Parallel connections between the same sides of two shapes.
+ */
+struct AvoidBundle
+{
+    Avoid::ConnRef* representative;         ///< The connection of the bundle routed by libavoid.
+    int srcRectID;                          ///< The cola rectangle ID of the source pin of the representative.
+    int dstRectID;                          ///< The cola rectangle ID of the destination pin of the representative.
+    std::vector<AvoidBundleMember> members; ///< The connections following the representative.
+};
+
+/**
+ * @struct AvoidLineSegments
+ * @brief The segments of the routed lines looked up in buckets by their position.
+ */
+struct AvoidLineSegments
+{
+    std::vector<std::pair<QPointF, QPointF>> segments;        ///< The start and end point of every segment.
+    std::vector<int> srcRectIDs;                              ///< The cola rectangle ID of the source pin of the line of every segment.
+    std::unordered_map<int64_t, std::vector<size_t>> buckets; ///< The indices of the segments by their buckets.
+};
+
 /**
  * @class AvoidRouter
  * @brief A class for performing avoid line routing in diagrams.
@@ -49,6 +112,15 @@ private:
     constexpr const static double bufferDistance{10.0F}; ///< The distance between lines and shapes
     constexpr const static double nudgeDistance{7.5F};   ///< The distance to between lines and lines
 
+    constexpr const static unsigned int topologyMaxIterations{500}; ///< The maximum separations tried by the limited topology improvement
+    constexpr const static double topologyMaxSeconds{0.0F};         ///< The maximum time in seconds of the limited topology improvement, 0 keeps it reproducible
+
+    constexpr const static size_t connectorsPerStep{32}; ///< The number of connections routed in one step of a stepwise routing
+
+    constexpr const static size_t minBundleSize{2};          ///< The minimum number of parallel connections routed as a bundle
+    constexpr const static double shapeBucketSize{128.0F};   ///< The size of the buckets used to find the shapes and lines near a bundled line
+    constexpr const static double lineOverlapDistance{1.0F}; ///< The distance below which parallel segments of two lines overlap
+
 public:
     /**
      * @brief Constructor for the AvoidRouter class.
@@ -97,12 +169,68 @@ public:
      */
     void runAvoid();
 
+    /**
+     * @brief Prepares an avoid line routing that is run in steps.
+     *
+     * Creates the avoid representation and the connections. The
+     * connections are then routed in batches by runAvoidStep() until
+     * it returns true. runAvoid() is the same as calling beginAvoid()
+     * and runAvoidStep() until the routing is finished.
+     */
+    void beginAvoid();
+
+    /**
+     * @brief Routes the next batch of connections.
+     *
+     * The step after the last batch improves the routes of all
+     * connections.
+     *
+     * @return true if the routing is finished or no routing is running
+     */
+    bool runAvoidStep();
+
+    /**
+     * @brief Gets the estimated progress of the running routing.
+     *
+     * @return the progress between 0 and 1
+     */
+    double getAvoidProgress() const;
+
     /**
      * @brief cleans the state of the avoid router
      *
      */
     void clear();
 
+    /**
+     * @brief resizes a routed shape and reroutes only the affected connections
+     *
+     * The shape keeps its center. The shapes left, right, above and below of a
+     * grown shape are moved outwards by the growth on their side, so the shape
+     * does not overlap its neighbours. A shrunk shape leaves the others in place.
+     * The pins of the shape are moved to the same side and relative position of
+     * the resized shape, then the connections of the moved shapes and the ones
+     * crossing the new area are rerouted incrementally.
+     *
+     * @param shape the shape to resize
+     * @param width the new width of the shape
+     * @param height the new height of the shape
+     */
+    void resizeShape(Avoid::ShapeRef* shape, double width, double height);
+
+    /**
+     * @brief enables the limited mode of the topology improvement
+     *
+     * in the limited mode only the regions with crossing or overlapping
+     * connections are improved and the work is capped by an iteration and
+     * time budget. Otherwise the whole diagram is improved without a limit.
+     * The mode is off by default and set by the routing parameters of the
+     * router. Takes effect on the next routing.
+     *
+     * @param limited true to limit the topology improvement
+     */
+    void setTopologyImprovementLimited(bool limited);
+
 private:
     /**
      * @brief Creates the avoid line routing representation.
@@ -110,9 +238,104 @@ private:
     void createAvoidRep();
 
     /**
-     * @brief Routes the avoid lines.
+     * @brief Creates the connections between the avoid shapes.
+     */
+    void createAvoidConnections();
+
+    /**
+     * @brief Improves the routed avoid lines after all connections are routed.
+     */
+    void finishAvoidRouting();
+
+    /**
+     * @brief Creates a connection between two pins and adds it to its path.
+     *
+     * @param srcRectID The cola rectangle ID of the source pin.
+     * @param dstRectID The cola rectangle ID of the destination pin.
+     */
+    void createConnRef(int srcRectID, int dstRectID);
+
+    /**
+     * @brief Checks the lines of the bundle members until all of them can be drawn.
+     *
+     * Every routing can move the representatives, so the check is repeated
+     * after the members that are routed on their own are routed.
+     */
+    void finishBundles();
+
+    /**
+     * @brief Adds the lines of the bundle members to their paths or updates their pin offsets.
+     *
+     * A member whose line can not follow the route of the representative
+     * without a reversed segment, crossing a shape or overlapping another
+     * line is removed from its path and routed on its own.
+     *
+     * @return true if a member has to be routed on its own
      */
-    void routeAvoid();
+    bool checkBundles();
+
+    /**
+     * @brief Creates the display routes of all connections.
+     *
+     * libavoid simplifies the display route of a connection on its first read.
+     * The routes are read by the paths on worker threads, and a bundle
+     * representative is read by several paths, so the routes are created here
+     * after every change of the routing.
+     */
+    void populateDisplayRoutes();
+
+    /**
+     * @brief Moves the cola rectangles of the shapes changed by a resize.
+     *
+     * @param shape The resized shape.
+     * @param oldBox The box of the shape before the resize.
+     * @param newBox The box of the shape after the resize.
+     * @param shapeMoves The offsets of the shapes moved to make room.
+     */
+    void updateColaRectangles(Avoid::ShapeRef* shape, const Avoid::Box& oldBox, const Avoid::Box& newBox,
+        const std::map<Avoid::ShapeRef*, std::pair<double, double>>& shapeMoves);
+
+    /**
+     * @brief Gets the current position of a pin.
+     *
+     * @param rectID The cola rectangle ID of the pin.
+     * @return QPointF The position of the pin.
+     */
+    QPointF getPinPosition(int rectID) const;
+
+    /**
+     * @brief Checks if a bundled line crosses a shape.
+     *
+     * The first and last segment may enter the shape of their pin.
+     *
+     * @param route The route of the bundled line.
+     * @param member The bundle member of the line.
+     * @param shapeBuckets The indices of the shapes by their buckets.
+     * @return true if a segment runs through a shape
+     */
+    bool crossesShapes(const QPolygonF& route, const AvoidBundleMember& member,
+        const std::unordered_map<int64_t, std::vector<size_t>>& shapeBuckets) const;
+
+    /**
+     * @brief Adds the segments of a routed line to the buckets.
+     *
+     * @param route The route of the line.
+     * @param srcRectID The cola rectangle ID of the source pin of the line.
+     * @param lineSegments The segments to add to.
+     */
+    static void addLineSegments(const QPolygonF& route, int srcRectID, AvoidLineSegments& lineSegments);
+
+    /**
+     * @brief Checks if a bundled line overlaps a line of another net.
+     *
+     * The lines of the same source pin belong to the same net and may overlap.
+     *
+     * @param route The route of the bundled line.
+     * @param srcRectID The cola rectangle ID of the source pin of the line.
+     * @param lineSegments The segments of the other lines.
+     * @return true if a segment runs on a parallel segment of another line
+     */
+    static bool overlapsLines(const QPolygonF& route, int srcRectID, const AvoidLineSegments& lineSegments);
 
     std::shared_ptr<Yosys::Module> module;        ///< the module to be routed
     std::vector<vpsc::Rectangle*> colaRectangles; ///< the rectangles from the cola graph to route
@@ -124,14 +347,24 @@ private:
     Avoid::Router* router;                             ///< the router to be used for the avoid line routing
     std::vector<Avoid::Rectangle*> avoidRectangles;    ///< the rectangles to be used for the avoid line routing
     std::vector<Avoid::ShapeRef*> avoidShapes;         ///< the shapes to be used for the avoid line routing
-    std::vector<Avoid::ShapeConnectionPin*> avoidPins; ///< the pins to be used for the avoid line routing
+    std::vector<AvoidPinInfo> avoidPins;               ///< the pins to be used for the avoid line routing
     std::map<int, Avoid::ConnEnd*> connEnds;           ///< the ends of the connections to be used for the avoid line routing
+    std::map<int, size_t> pinIndices;                  ///< the index of the pin of every cola rectangle ID of a pin
+    std::vector<AvoidBundle> avoidBundles;             ///< the bundles of parallel connections
     std::vector<Avoid::ConnRef*> avoidConRefs;         ///< the connections to be used for the avoid line routing
+
+    std::map<Avoid::ConnRef*, std::pair<int, int>> connRefRectIDs; ///< the cola rectangle IDs of the ends of each connection
     std::vector<vpsc::Rectangle*> avoidColaRects;      ///< the rectangles to be used for the avoid line routing
     cola::RootCluster* avoidRootCluster;               ///< the root cluster to be used for the avoid line routing
 
     int avoidConnID = 1;  ///< the ID of the avoid connection
     int avoidShapeID = 1; ///< the ID of the avoid shape
+
+    bool topologyImprovementLimited = false; ///< flag if the topology improvement is limited to conflict regions
+
+    bool routingActive = false;      ///< flag if a stepwise routing is running
+    bool transactionPending = false; ///< flag if the connections of the stepwise routing are not all routed yet
+    size_t routedConnectors = 0;     ///< the number of connections routed by the stepwise routing
 };
 
 } // namespace OpenNetlistView::Routing
@@ -10,6 +10,7 @@
 #include <map>
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
 
 #include <yosys/module.h>
 
@@ -68,6 +69,15 @@ std::vector<cola::Edge> ColaRouter::getEdges()
 }
 
 void ColaRouter::runCola()
+{
+    this->beginCola();
+
+    while(!this->runColaStep())
+    {
+    }
+}
+
+void ColaRouter::beginCola()
 {
     // check if the module is set
     if(!this->module)
@@ -77,11 +87,79 @@ void ColaRouter::runCola()
 
     this->createColaItems();
     this->createColaGraph();
-    this->runColaLayout();
+
+    // setup the contraint algorithm
+    this->layoutAlg = std::make_unique<cola::ConstrainedFDLayout>(this->rectangles,
+        this->allEdges,
+        routingParameters.defaultEdgeLength,
+        this->edgeLengths,
+        this->testConv);
+
+    layoutAlg->setConstraints(this->compoundConstraints);
+    layoutAlg->setClusterHierarchy(this->rootCluster);
+
+    // run the algorithm first without avoiding overlaps
+    // so groups of nodes can move past each other
+    layoutAlg->setAvoidNodeOverlaps(false);
+    layoutAlg->beginRun();
+
+    this->phase = EColaPhase::FREE_LAYOUT;
+}
+
+bool ColaRouter::runColaStep()
+{
+    if(this->phase == EColaPhase::IDLE)
+    {
+        return true;
+    }
+
+    if(!layoutAlg->runStep())
+    {
+        return false;
+    }
+
+    layoutAlg->endRun();
+
+    // the second run avoids overlapping groups of nodes
+    if(this->phase == EColaPhase::FREE_LAYOUT)
+    {
+        layoutAlg->setAvoidNodeOverlaps(true);
+        layoutAlg->beginRun();
+
+        this->phase = EColaPhase::OVERLAP_LAYOUT;
+        return false;
+    }
+
+    this->finishColaLayout();
+
+    this->layoutAlg.reset();
+    this->phase = EColaPhase::IDLE;
+
+    return true;
+}
+
+double ColaRouter::getColaProgress() const
+{
+    if(this->phase == EColaPhase::IDLE || testConv->maxiterations == 0)
+    {
+        return 0.0;
+    }
+
+    // the iterations of both runs are counted by the same convergence test
+    return std::min(1.0, static_cast<double>(testConv->iterations) / testConv->maxiterations);
 }
 
 void ColaRouter::clear()
 {
+    // stop a layout that is run in steps
+    if(this->phase != EColaPhase::IDLE)
+    {
+        layoutAlg->endRun();
+        this->phase = EColaPhase::IDLE;
+    }
+
+    this->layoutAlg.reset();
+
     // delete the contents and recreate the objects
     for(auto& rect : this->rectangles)
     {
@@ -101,6 +179,7 @@ void ColaRouter::clear()
 
     // reset the vectors
     this->allEdges.clear();
+    this->connEdges.clear();
     this->edgeLengths.clear();
     this->rectangles.clear();
     this->compoundConstraints.clear();
@@ -225,35 +304,18 @@ void ColaRouter::createColaConnectionsPaths()
     }
 }
 
-void ColaRouter::runColaLayout()
+void ColaRouter::finishColaLayout()
 {
 
-    // setup the contraint algorithm
-    cola::ConstrainedFDLayout layoutAlg(this->rectangles,
-        this->allEdges,
-        routingParameters.defaultEdgeLength,
-        this->edgeLengths,
-        this->testConv);
-
-    layoutAlg.setConstraints(this->compoundConstraints);
-    layoutAlg.setClusterHierarchy(this->rootCluster);
-
-    // run the algorithm so that the algorithm will avoid
-    // overlapping groups of nodes
-    layoutAlg.setAvoidNodeOverlaps(false);
-    layoutAlg.run();
-    layoutAlg.setAvoidNodeOverlaps(true);
-    layoutAlg.run();
-
 #ifndef EMSCRIPTEN
-    layoutAlg.makeFeasible();
+    layoutAlg->makeFeasible();
 #endif // EMSCRIPTEN
 
 // creates a svg representation of the graph for debugging
 #if defined(_DEBUG) && !defined(EMSCRIPTEN)
     QLocale::setDefault(QLocale::C);
     std::setlocale(LC_NUMERIC, "C");
-    layoutAlg.outputInstanceToSVG("rectangularClusters");
+    layoutAlg->outputInstanceToSVG("rectangularClusters");
     QLocale::setDefault(QLocale::system());
     std::setlocale(LC_NUMERIC, "");
 #endif // defined(_DEBUG) && !defined(EMSCRIPTEN)
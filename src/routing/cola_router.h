@@ -43,6 +43,8 @@ struct ColaRoutingParameters
     double testTolerance;      ///< The test tolerance.
     int testMaxIterations;     ///< The test iterations.
     double defaultEdgeLength;  ///< default edge length
+
+    bool limitTopologyImprovement = false; ///< limit the topology improvement of the lines to conflict regions
 };
 
 /**
@@ -60,6 +62,18 @@ struct ColaRoutingParameters
 class ColaRouter
 {
 
+private:
+    /**
+     * @enum EColaPhase
+     * @brief The phase of a cola layout that is run in steps.
+     */
+    enum class EColaPhase
+    {
+        IDLE,          ///< no layout is running
+        FREE_LAYOUT,   ///< the layout without node overlap avoidance is running
+        OVERLAP_LAYOUT ///< the layout avoiding node overlaps is running
+    };
+
 public:
     /**
      * @brief Construct a new Cola Router object
@@ -135,6 +149,32 @@ public:
      */
     void runCola();
 
+    /**
+     * @brief Prepare a cola layout that is run in steps
+     *
+     * Creates the cola graph of the module. The layout is then
+     * advanced by runColaStep() until it returns true.
+     * runCola() is the same as calling beginCola() and runColaStep()
+     * until the layout is finished.
+     *
+     * @throw std::runtime_error if a cola representation could not be generated
+     */
+    void beginCola();
+
+    /**
+     * @brief Run one iteration of the cola layout
+     *
+     * @return true if the layout is finished or no layout is running
+     */
+    bool runColaStep();
+
+    /**
+     * @brief Get the estimated progress of the running layout
+     *
+     * @return double the progress between 0 and 1
+     */
+    double getColaProgress() const;
+
     /**
      * @brief Clear the cola router
      *
@@ -175,12 +215,13 @@ private:
     void createColaConnectionsPaths();
 
     /**
-     * @brief Run the cola layout
+     * @brief Finish the cola layout
      *
-     * This function runs the cola layout algorithm
+     * This function removes the remaining overlaps after
+     * the last layout run
      *
      */
-    void runColaLayout();
+    void finishColaLayout();
 
     std::shared_ptr<Yosys::Module> module;         ///< the module to be routed from the yosys data
     std::vector<cola::Edge> allEdges;              ///< all edges of the graph including those within the symbols
@@ -191,6 +232,9 @@ private:
     cola::RootCluster* rootCluster;                ///< the top level cluster of objects in cola graph
     cola::TestConvergence* testConv;               ///< the convergence test for cola used in constraint layouting
     ColaRoutingParameters routingParameters;       ///< the routing parameters for the cola router
+
+    std::unique_ptr<cola::ConstrainedFDLayout> layoutAlg; ///< the layout algorithm of the layout run in steps
+    EColaPhase phase = EColaPhase::IDLE;                  ///< the phase of the layout run in steps
 };
 
 } // namespace OpenNetlistView::Routing
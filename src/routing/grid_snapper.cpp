@@ -0,0 +1,170 @@
+#include <QRect>
+#include <QRectF>
+#include <QPoint>
+#include <QPointF>
+
+#include <third_party/libvpsc/rectangle.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include <symbol/port.h>
+
+#include "grid_snapper.h"
+
+namespace OpenNetlistView::Routing {
+
+size_t GridSnapper::snapRectangles(std::vector<vpsc::Rectangle*>& rectangles, double gridSize, double clearance)
+{
+    if(gridSize <= 0.0)
+    {
+        throw std::runtime_error("The grid size of the snapping has to be positive");
+    }
+
+    std::vector<SnapGroup> groups = collectGroups(rectangles);
+
+    // the buckets hold every group that covered them at some point, the current
+    // area of a group is checked, so entries of moved groups do not need to be removed
+    std::unordered_map<int64_t, std::vector<size_t>> buckets;
+
+    auto bucketKey = [](int bucketX, int bucketY) {
+        return static_cast<int64_t>((static_cast<uint64_t>(static_cast<uint32_t>(bucketX)) << 32) | static_cast<uint32_t>(bucketY));
+    };
+
+    auto addToBuckets = [&buckets, &bucketKey](size_t groupIdx, const QRect& range, const QRect& skipRange) {
+        for(int bucketX = range.left(); bucketX <= range.right(); bucketX++)
+        {
+            for(int bucketY = range.top(); bucketY <= range.bottom(); bucketY++)
+            {
+                if(!skipRange.contains(bucketX, bucketY))
+                {
+                    buckets[bucketKey(bucketX, bucketY)].push_back(groupIdx);
+                }
+            }
+        }
+    };
+
+    for(size_t groupIdx = 0; groupIdx < groups.size(); groupIdx++)
+    {
+        addToBuckets(groupIdx, getBucketRange(groups[groupIdx].area), QRect());
+    }
+
+    auto collides = [&groups, &buckets, &bucketKey, clearance](size_t groupIdx, const QRectF& area) {
+        const QRectF clearedArea = area.adjusted(-clearance, -clearance, clearance, clearance);
+        const QRect range = getBucketRange(clearedArea);
+
+        for(int bucketX = range.left(); bucketX <= range.right(); bucketX++)
+        {
+            for(int bucketY = range.top(); bucketY <= range.bottom(); bucketY++)
+            {
+                const auto bucket = buckets.find(bucketKey(bucketX, bucketY));
+
+                if(bucket == buckets.end())
+                {
+                    continue;
+                }
+
+                for(const size_t otherIdx : bucket->second)
+                {
+                    if(otherIdx != groupIdx && clearedArea.intersects(groups[otherIdx].area))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    };
+
+    size_t snappedGroups = 0;
+
+    for(size_t groupIdx = 0; groupIdx < groups.size(); groupIdx++)
+    {
+        SnapGroup& group = groups[groupIdx];
+        const vpsc::Rectangle* shape = rectangles[group.firstRect];
+
+        const double lowerX = std::floor(shape->getMinX() / gridSize) * gridSize;
+        const double lowerY = std::floor(shape->getMinY() / gridSize) * gridSize;
+
+        // the four grid points around the corner of the shape, the nearest one first
+        std::array<QPointF, 4> offsets = {QPointF(lowerX - shape->getMinX(), lowerY - shape->getMinY()),
+                                          QPointF(lowerX + gridSize - shape->getMinX(), lowerY - shape->getMinY()),
+                                          QPointF(lowerX - shape->getMinX(), lowerY + gridSize - shape->getMinY()),
+                                          QPointF(lowerX + gridSize - shape->getMinX(), lowerY + gridSize - shape->getMinY())};
+
+        std::sort(offsets.begin(), offsets.end(), [](const QPointF& first, const QPointF& second) {
+            return QPointF::dotProduct(first, first) < QPointF::dotProduct(second, second);
+        });
+
+        for(const auto& offset : offsets)
+        {
+            const QRectF snappedArea = group.area.translated(offset);
+
+            if(collides(groupIdx, snappedArea))
+            {
+                continue;
+            }
+
+            addToBuckets(groupIdx, getBucketRange(snappedArea), getBucketRange(group.area));
+            group.area = snappedArea;
+
+            // the pins keep their offsets to the shape
+            for(size_t rectIdx = group.firstRect; rectIdx < group.endRect; rectIdx++)
+            {
+                vpsc::Rectangle* rectangle = rectangles[rectIdx];
+                rectangle->moveMinX(rectangle->getMinX() + offset.x());
+                rectangle->moveMinY(rectangle->getMinY() + offset.y());
+            }
+
+            snappedGroups++;
+            break;
+        }
+    }
+
+    return snappedGroups;
+}
+
+bool GridSnapper::isShapeRectangle(const vpsc::Rectangle* rectangle)
+{
+    return rectangle->height() >= 1 + Symbol::Port::portRectHeight &&
+           rectangle->width() >= 1 + Symbol::Port::portRectWidth;
+}
+
+std::vector<GridSnapper::SnapGroup> GridSnapper::collectGroups(const std::vector<vpsc::Rectangle*>& rectangles)
+{
+    std::vector<SnapGroup> groups;
+
+    for(size_t rectIdx = 0; rectIdx < rectangles.size(); rectIdx++)
+    {
+        const vpsc::Rectangle* rectangle = rectangles[rectIdx];
+        const QRectF area(QPointF(rectangle->getMinX(), rectangle->getMinY()), QPointF(rectangle->getMaxX(), rectangle->getMaxY()));
+
+        if(isShapeRectangle(rectangle))
+        {
+            groups.push_back({rectIdx, rectIdx + 1, area});
+        }
+        // pins before the first shape are not read by the avoid router either
+        else if(!groups.empty())
+        {
+            groups.back().endRect = rectIdx + 1;
+            groups.back().area = groups.back().area.united(area);
+        }
+    }
+
+    return groups;
+}
+
+QRect GridSnapper::getBucketRange(const QRectF& area)
+{
+    return QRect(QPoint(static_cast<int>(std::floor(area.left() / bucketSize)), static_cast<int>(std::floor(area.top() / bucketSize))),
+                 QPoint(static_cast<int>(std::floor(area.right() / bucketSize)), static_cast<int>(std::floor(area.bottom() / bucketSize))));
+}
+
+} // namespace OpenNetlistView::Routing
@@ -0,0 +1,102 @@
+/**
+ * @file grid_snapper.h
+ * @brief Defines the GridSnapper class for snapping a cola placement to the routing grid.
+ *
+ * This file contains the declaration of the GridSnapper class, which moves the
+ * rectangles of the nodes and module ports placed by the cola layout onto a grid
+ * before the obstacle avoidance routing. Shapes and pins on the grid share their
+ * coordinates, so the orthogonal visibility graph of the avoid router has fewer
+ * scanline positions and the routed schematic looks neater.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __GRID_SNAPPER_H__
+#define __GRID_SNAPPER_H__
+
+#include <QRect>
+#include <QRectF>
+
+#include <third_party/libvpsc/rectangle.h>
+
+#include <vector>
+#include <cstddef>
+
+namespace OpenNetlistView::Routing {
+
+/**
+ * @class GridSnapper
+ * @brief Snaps the rectangles of a cola placement to a grid without creating overlaps.
+ *
+ * The rectangles are grouped like the avoid router reads them, a shape rectangle of
+ * a node or module port followed by the small rectangles of its pins. A group is
+ * moved as a whole so the top left corner of its shape lies on the nearest grid
+ * point that keeps the clearance to all other groups. The groups are snapped one
+ * after another and a candidate is checked against the snapped position of the
+ * groups before it and the original position of the groups after it. So a group
+ * without a free grid point can stay where it is and the snapped placement never
+ * has an overlap the original placement did not have.
+ *
+ * The candidates are found in a hash of buckets over the area of the groups, so
+ * the snapping stays linear in the number of groups for spread out placements.
+ */
+class GridSnapper
+{
+public:
+    constexpr const static double defaultGridSize{10.0F};  ///< The default distance between grid lines, the port pitch of the symbols.
+    constexpr const static double defaultClearance{10.0F}; ///< The default minimum distance between snapped groups.
+    constexpr const static double bucketSize{128.0F};      ///< The size of the buckets used to find neighbouring groups.
+
+    /**
+     * @brief Snaps the groups of a cola placement to the grid
+     *
+     * @param rectangles The rectangles of the cola placement, they are moved in place.
+     * @param gridSize The distance between grid lines.
+     * @param clearance The minimum distance kept between a snapped group and the other groups.
+     * @throw std::runtime_error if the grid size is not positive
+     * @return size_t The number of groups that lie on the grid after the snapping.
+     */
+    static size_t snapRectangles(std::vector<vpsc::Rectangle*>& rectangles,
+                                 double gridSize = defaultGridSize,
+                                 double clearance = defaultClearance);
+
+    /**
+     * @brief Checks if a rectangle is the shape of a node or module port and not a pin
+     *
+     * @param rectangle The rectangle to check.
+     * @return true if the rectangle is larger than the rectangle of a pin
+     */
+    static bool isShapeRectangle(const vpsc::Rectangle* rectangle);
+
+private:
+    /**
+     * @struct SnapGroup
+     * @brief A shape rectangle with the rectangles of its pins.
+     */
+    struct SnapGroup
+    {
+        size_t firstRect; ///< The index of the shape rectangle.
+        size_t endRect;   ///< The index after the last pin rectangle.
+        QRectF area;      ///< The current area covered by the rectangles of the group.
+    };
+
+    /**
+     * @brief Collects the groups of the rectangles
+     *
+     * @param rectangles The rectangles of the cola placement.
+     * @return std::vector<SnapGroup> The groups in the order of their shape rectangles.
+     */
+    static std::vector<SnapGroup> collectGroups(const std::vector<vpsc::Rectangle*>& rectangles);
+
+    /**
+     * @brief Get the range of buckets covered by an area
+     *
+     * @param area The area to look up.
+     * @return QRect The first and last bucket in both directions.
+     */
+    static QRect getBucketRange(const QRectF& area);
+};
+
+} // namespace OpenNetlistView::Routing
+
+#endif // __GRID_SNAPPER_H__
@@ -0,0 +1,459 @@
+#include <QLineF>
+#include <QRectF>
+#include <QPointF>
+#include <QPolygonF>
+
+#include <vector>
+#include <memory>
+#include <map>
+#include <set>
+#include <deque>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+#include <yosys/module.h>
+#include <yosys/node.h>
+#include <yosys/port.h>
+#include <yosys/path.h>
+
+#include "layout_metrics.h"
+
+namespace OpenNetlistView::Routing {
+
+LayoutQuality LayoutMetrics::measure(const std::shared_ptr<Yosys::Module>& module)
+{
+    LayoutQuality quality;
+
+    if(module == nullptr || !module->getIsRouted())
+    {
+        return quality;
+    }
+
+    std::vector<QLineF> segments;
+    std::vector<size_t> groups;
+
+    const auto paths = module->getPaths();
+
+    for(size_t pathIdx = 0; pathIdx < paths->size(); pathIdx++)
+    {
+        // the lines of a path share the segments close to the source
+        std::set<std::tuple<double, double, double, double>> pathSegments;
+
+        for(const auto& routedLine : paths->at(pathIdx)->getRoutedLines())
+        {
+            const QPolygonF& points = routedLine.points;
+
+            for(qsizetype pointIdx = 1; pointIdx < points.size(); pointIdx++)
+            {
+                QPointF start = points.at(pointIdx - 1);
+                QPointF end = points.at(pointIdx);
+
+                if(start == end)
+                {
+                    continue;
+                }
+
+                if(std::make_pair(end.x(), end.y()) < std::make_pair(start.x(), start.y()))
+                {
+                    std::swap(start, end);
+                }
+
+                if(pathSegments.emplace(start.x(), start.y(), end.x(), end.y()).second)
+                {
+                    quality.wireLength += QLineF(start, end).length();
+                    segments.emplace_back(start, end);
+                    groups.push_back(pathIdx);
+                }
+            }
+
+            // a bend is a change of the direction between two segments
+            QPointF lastDirection;
+
+            for(qsizetype pointIdx = 1; pointIdx < points.size(); pointIdx++)
+            {
+                const QPointF direction = points.at(pointIdx) - points.at(pointIdx - 1);
+
+                if(direction.isNull())
+                {
+                    continue;
+                }
+
+                if(!lastDirection.isNull() &&
+                    (direction.x() * lastDirection.y() != direction.y() * lastDirection.x() ||
+                        QPointF::dotProduct(direction, lastDirection) < 0))
+                {
+                    quality.bends++;
+                }
+
+                lastDirection = direction;
+            }
+        }
+    }
+
+    quality.crossings = countCrossings(segments, groups);
+
+    std::vector<QRectF> rects;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        rects.push_back(node->getRoutedRect());
+    }
+
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        rects.push_back(port->getRoutedRect());
+    }
+
+    quality.nodeOverlaps = countOverlaps(rects);
+
+    const QRectF boundingRect = module->getRoutedBoundingRect();
+
+    if(boundingRect.height() > 0)
+    {
+        quality.aspectRatio = boundingRect.width() / boundingRect.height();
+    }
+
+    quality.stress = computeStress(module);
+
+    return quality;
+}
+
+size_t LayoutMetrics::countCrossings(const std::vector<QLineF>& segments, const std::vector<size_t>& groups)
+{
+    std::vector<QLineF> horizontals;
+    std::vector<QLineF> verticals;
+    std::vector<size_t> diagonals;
+    std::map<size_t, std::pair<std::vector<QLineF>, std::vector<QLineF>>> groupSegments;
+
+    for(size_t segmentIdx = 0; segmentIdx < segments.size(); segmentIdx++)
+    {
+        const QLineF& segment = segments[segmentIdx];
+
+        if(segment.p1() == segment.p2())
+        {
+            continue;
+        }
+
+        if(segment.y1() == segment.y2())
+        {
+            const QLineF horizontal(std::min(segment.x1(), segment.x2()), segment.y1(), std::max(segment.x1(), segment.x2()), segment.y1());
+            horizontals.push_back(horizontal);
+            groupSegments[groups[segmentIdx]].first.push_back(horizontal);
+        }
+        else if(segment.x1() == segment.x2())
+        {
+            const QLineF vertical(segment.x1(), std::min(segment.y1(), segment.y2()), segment.x1(), std::max(segment.y1(), segment.y2()));
+            verticals.push_back(vertical);
+            groupSegments[groups[segmentIdx]].second.push_back(vertical);
+        }
+        else
+        {
+            diagonals.push_back(segmentIdx);
+        }
+    }
+
+    // the crossings inside of a group are counted by the sweep over all segments
+    size_t crossings = countOrthogonalCrossings(horizontals, verticals);
+
+    for(const auto& groupSegment : groupSegments)
+    {
+        crossings -= countOrthogonalCrossings(groupSegment.second.first, groupSegment.second.second);
+    }
+
+    // the orthogonal router creates no diagonal segments, so they are compared pairwise
+    auto isEndPoint = [](const QPointF& point, const QLineF& segment) {
+        return point == segment.p1() || point == segment.p2();
+    };
+
+    for(size_t diagonalIdx : diagonals)
+    {
+        const QLineF& diagonal = segments[diagonalIdx];
+
+        for(size_t segmentIdx = 0; segmentIdx < segments.size(); segmentIdx++)
+        {
+            const QLineF& segment = segments[segmentIdx];
+            const bool isDiagonal = segment.x1() != segment.x2() && segment.y1() != segment.y2();
+
+            // two diagonal segments are only compared once
+            if(groups[segmentIdx] == groups[diagonalIdx] || (isDiagonal && segmentIdx <= diagonalIdx))
+            {
+                continue;
+            }
+
+            QPointF intersection;
+
+            if(diagonal.intersects(segment, &intersection) == QLineF::BoundedIntersection &&
+                !isEndPoint(intersection, diagonal) && !isEndPoint(intersection, segment))
+            {
+                crossings++;
+            }
+        }
+    }
+
+    return crossings;
+}
+
+size_t LayoutMetrics::countOverlaps(const std::vector<QRectF>& rects)
+{
+    std::vector<QRectF> sortedRects;
+    sortedRects.reserve(rects.size());
+
+    for(const auto& rect : rects)
+    {
+        if(!rect.normalized().isEmpty())
+        {
+            sortedRects.push_back(rect.normalized());
+        }
+    }
+
+    std::sort(sortedRects.begin(), sortedRects.end(), [](const QRectF& first, const QRectF& second) {
+        return first.left() < second.left();
+    });
+
+    // the active areas reach past the left edge of the current area
+    std::vector<QRectF> activeRects;
+    size_t overlaps = 0;
+
+    for(const auto& rect : sortedRects)
+    {
+        activeRects.erase(std::remove_if(activeRects.begin(), activeRects.end(), [&rect](const QRectF& activeRect) {
+            return activeRect.right() <= rect.left();
+        }),
+            activeRects.end());
+
+        for(const auto& activeRect : activeRects)
+        {
+            if(activeRect.top() < rect.bottom() && rect.top() < activeRect.bottom())
+            {
+                overlaps++;
+            }
+        }
+
+        activeRects.push_back(rect);
+    }
+
+    return overlaps;
+}
+
+size_t LayoutMetrics::countOrthogonalCrossings(const std::vector<QLineF>& horizontals, const std::vector<QLineF>& verticals)
+{
+    if(horizontals.empty() || verticals.empty())
+    {
+        return 0;
+    }
+
+    std::vector<double> yCoords;
+    yCoords.reserve(horizontals.size());
+
+    for(const auto& horizontal : horizontals)
+    {
+        yCoords.push_back(horizontal.y1());
+    }
+
+    std::sort(yCoords.begin(), yCoords.end());
+    yCoords.erase(std::unique(yCoords.begin(), yCoords.end()), yCoords.end());
+
+    // the events at the same x remove horizontals first and insert them last,
+    // so only crossings inside of both segments are counted
+    enum EEventType
+    {
+        REMOVE = 0,
+        QUERY = 1,
+        INSERT = 2
+    };
+
+    std::vector<std::tuple<double, int, size_t>> events;
+    events.reserve(horizontals.size() * 2 + verticals.size());
+
+    for(size_t horizontalIdx = 0; horizontalIdx < horizontals.size(); horizontalIdx++)
+    {
+        events.emplace_back(horizontals[horizontalIdx].x1(), INSERT, horizontalIdx);
+        events.emplace_back(horizontals[horizontalIdx].x2(), REMOVE, horizontalIdx);
+    }
+
+    for(size_t verticalIdx = 0; verticalIdx < verticals.size(); verticalIdx++)
+    {
+        events.emplace_back(verticals[verticalIdx].x1(), QUERY, verticalIdx);
+    }
+
+    std::sort(events.begin(), events.end());
+
+    // fenwick tree counting the active horizontals per y coordinate
+    std::vector<size_t> activeCounts(yCoords.size() + 1, 0);
+
+    auto update = [&activeCounts](size_t yIdx, bool insert) {
+        for(size_t treeIdx = yIdx + 1; treeIdx < activeCounts.size(); treeIdx += treeIdx & (~treeIdx + 1))
+        {
+            if(insert)
+            {
+                activeCounts[treeIdx]++;
+            }
+            else
+            {
+                activeCounts[treeIdx]--;
+            }
+        }
+    };
+
+    auto prefixCount = [&activeCounts](size_t yEnd) {
+        size_t count = 0;
+
+        for(size_t treeIdx = yEnd; treeIdx > 0; treeIdx -= treeIdx & (~treeIdx + 1))
+        {
+            count += activeCounts[treeIdx];
+        }
+
+        return count;
+    };
+
+    auto yIndex = [&yCoords](double y) {
+        return static_cast<size_t>(std::lower_bound(yCoords.begin(), yCoords.end(), y) - yCoords.begin());
+    };
+
+    size_t crossings = 0;
+
+    for(const auto& [x, type, segmentIdx] : events)
+    {
+        if(type == QUERY)
+        {
+            const QLineF& vertical = verticals[segmentIdx];
+
+            // the horizontals strictly between the end points of the vertical
+            const size_t firstIdx = static_cast<size_t>(std::upper_bound(yCoords.begin(), yCoords.end(), vertical.y1()) - yCoords.begin());
+            const size_t endIdx = yIndex(vertical.y2());
+
+            if(firstIdx < endIdx)
+            {
+                crossings += prefixCount(endIdx) - prefixCount(firstIdx);
+            }
+        }
+        else
+        {
+            update(yIndex(horizontals[segmentIdx].y1()), type == INSERT);
+        }
+    }
+
+    return crossings;
+}
+
+double LayoutMetrics::computeStress(const std::shared_ptr<Yosys::Module>& module)
+{
+    std::vector<QPointF> positions;
+    std::map<const void*, size_t> vertexIdxs;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        vertexIdxs[node.get()] = positions.size();
+        positions.push_back(node->getRoutedRect().center());
+    }
+
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        vertexIdxs[port.get()] = positions.size();
+        positions.push_back(port->getRoutedRect().center());
+    }
+
+    // the ports of a node are represented by the node
+    auto findVertex = [&vertexIdxs](const std::shared_ptr<Yosys::Port>& port) -> std::ptrdiff_t {
+        if(port == nullptr)
+        {
+            return -1;
+        }
+
+        const void* key = port->getParentNode() != nullptr ? static_cast<const void*>(port->getParentNode().get()) : static_cast<const void*>(port.get());
+        auto vertexIt = vertexIdxs.find(key);
+
+        return vertexIt != vertexIdxs.end() ? static_cast<std::ptrdiff_t>(vertexIt->second) : -1;
+    };
+
+    std::vector<std::vector<size_t>> adjacency(positions.size());
+
+    const auto paths = module->getPaths();
+
+    for(const auto& path : *paths)
+    {
+        const std::ptrdiff_t sourceIdx = findVertex(path->getSigSource());
+
+        if(sourceIdx < 0)
+        {
+            continue;
+        }
+
+        for(const auto& destination : *path->getSigDestinations())
+        {
+            const std::ptrdiff_t destinationIdx = findVertex(destination);
+
+            if(destinationIdx >= 0 && destinationIdx != sourceIdx)
+            {
+                adjacency[sourceIdx].push_back(destinationIdx);
+                adjacency[destinationIdx].push_back(sourceIdx);
+            }
+        }
+    }
+
+    // the scale s minimizing sum((s * x / d - 1)^2) is A / B with A = sum(x / d)
+    // and B = sum(x^2 / d^2), which leaves a stress of 1 - A^2 / (B * N) per pair
+    double sumRatio = 0.0;
+    double sumSquaredRatio = 0.0;
+    size_t pairs = 0;
+
+    const size_t sourceStep = std::max<size_t>(1, positions.size() / stressSources);
+
+    for(size_t sourceIdx = 0; sourceIdx < positions.size(); sourceIdx += sourceStep)
+    {
+        std::vector<size_t> distances(positions.size(), 0);
+        std::vector<bool> visited(positions.size(), false);
+        std::deque<size_t> queue{sourceIdx};
+        visited[sourceIdx] = true;
+
+        while(!queue.empty())
+        {
+            const size_t vertexIdx = queue.front();
+            queue.pop_front();
+
+            for(size_t neighbourIdx : adjacency[vertexIdx])
+            {
+                if(!visited[neighbourIdx])
+                {
+                    visited[neighbourIdx] = true;
+                    distances[neighbourIdx] = distances[vertexIdx] + 1;
+                    queue.push_back(neighbourIdx);
+                }
+            }
+        }
+
+        for(size_t vertexIdx = 0; vertexIdx < positions.size(); vertexIdx++)
+        {
+            if(distances[vertexIdx] == 0)
+            {
+                continue;
+            }
+
+            const QPointF offset = positions[vertexIdx] - positions[sourceIdx];
+            const double ratio = std::hypot(offset.x(), offset.y()) / static_cast<double>(distances[vertexIdx]);
+
+            sumRatio += ratio;
+            sumSquaredRatio += ratio * ratio;
+            pairs++;
+        }
+    }
+
+    if(pairs == 0 || sumSquaredRatio == 0.0)
+    {
+        return 0.0;
+    }
+
+    return 1.0 - (sumRatio * sumRatio) / (sumSquaredRatio * static_cast<double>(pairs));
+}
+
+} // namespace OpenNetlistView::Routing
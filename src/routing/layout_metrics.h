@@ -0,0 +1,110 @@
+/**
+ * @file layout_metrics.h
+ * @brief Defines the LayoutMetrics class for measuring the quality of a routed module.
+ *
+ * This file contains the declaration of the LayoutMetrics class, which computes
+ * quality measures of a routed module like the number of crossings and bends, the
+ * wire length, the node overlaps, the aspect ratio and the stress of the placement.
+ * The measures are used to check that changes to the routing do not worsen the layout.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __LAYOUT_METRICS_H__
+#define __LAYOUT_METRICS_H__
+
+#include <QLineF>
+#include <QRectF>
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+#include <yosys/module.h>
+
+namespace OpenNetlistView::Routing {
+
+/**
+ * @struct LayoutQuality
+ * @brief A structure to hold the quality measures of a routed module.
+ */
+struct LayoutQuality
+{
+    size_t crossings = 0;     ///< The number of crossings between lines of different paths.
+    size_t bends = 0;         ///< The number of bends of all routed lines.
+    double wireLength = 0.0;  ///< The summed length of all routed lines.
+    size_t nodeOverlaps = 0;  ///< The number of overlapping pairs of nodes and module ports.
+    double aspectRatio = 0.0; ///< The width divided by the height of the routed module.
+    double stress = 0.0;      ///< The scale normalized stress of the node placement.
+};
+
+/**
+ * @class LayoutMetrics
+ * @brief Computes the quality measures of a routed module.
+ *
+ * The measures are computed from the routed lines and areas of the module, so they
+ * work for modules routed by the Router and for modules with a loaded layout.
+ *
+ * The crossings are counted with a sweep line over the axis parallel segments in
+ * O((n + k) log n), segments that are not axis parallel are compared pairwise.
+ * The node overlaps are found with a sweep over the left edges of the areas.
+ * The stress is sampled from a bounded number of breadth first searches, so it
+ * stays linear in the size of the module.
+ */
+class LayoutMetrics
+{
+public:
+    constexpr const static size_t stressSources{64}; ///< The maximum number of nodes the stress is sampled from.
+
+    /**
+     * @brief Computes all quality measures of a routed module
+     *
+     * @param module The routed module.
+     * @return LayoutQuality The quality measures, all zero if the module is not routed.
+     */
+    static LayoutQuality measure(const std::shared_ptr<Yosys::Module>& module);
+
+    /**
+     * @brief Counts the crossings between the segments of different groups
+     *
+     * Two segments cross if they intersect in a point that is not an end point
+     * of either segment. Segments of the same group never cross.
+     *
+     * @param segments The segments to check.
+     * @param groups The group of every segment, for example the index of the path.
+     * @return size_t The number of crossing pairs.
+     */
+    static size_t countCrossings(const std::vector<QLineF>& segments, const std::vector<size_t>& groups);
+
+    /**
+     * @brief Counts the overlapping pairs of areas
+     *
+     * Areas that only touch do not overlap.
+     *
+     * @param rects The areas to check.
+     * @return size_t The number of overlapping pairs.
+     */
+    static size_t countOverlaps(const std::vector<QRectF>& rects);
+
+private:
+    /**
+     * @brief Counts the crossings between horizontal and vertical segments with a sweep line
+     *
+     * @param horizontals The horizontal segments.
+     * @param verticals The vertical segments.
+     * @return size_t The number of crossing pairs.
+     */
+    static size_t countOrthogonalCrossings(const std::vector<QLineF>& horizontals, const std::vector<QLineF>& verticals);
+
+    /**
+     * @brief Computes the scale normalized stress of the node placement
+     *
+     * @param module The routed module.
+     * @return double The mean squared relative deviation of the sampled distances.
+     */
+    static double computeStress(const std::shared_ptr<Yosys::Module>& module);
+};
+
+} // namespace OpenNetlistView::Routing
+
+#endif // __LAYOUT_METRICS_H__
@@ -2,14 +2,21 @@
 #include <utility>
 #include <map>
 #include <algorithm>
+#include <vector>
+#include <functional>
+#include <string>
+#include <exception>
+#include <cstddef>
 
 #include <yosys/module.h>
 #include <yosys/port.h>
 #include <symbol/symbol.h>
+#include <scheduler/taskscheduler.h>
 
 #include "router.h"
 #include "cola_router.h"
 #include "avoid_router.h"
+#include "grid_snapper.h"
 
 namespace OpenNetlistView::Routing {
 
@@ -38,6 +45,7 @@ void Router::setSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<
 void Router::setRoutingParameters(const ColaRoutingParameters& routingParameters)
 {
     cola.setRoutingParameters(routingParameters);
+    avoid.setTopologyImprovementLimited(routingParameters.limitTopologyImprovement);
 }
 
 ColaRoutingParameters Router::getRoutingParameters()
@@ -46,37 +54,235 @@ ColaRoutingParameters Router::getRoutingParameters()
 }
 
 void Router::runRouter()
+{
+    if(!this->beginRouting())
+    {
+        return;
+    }
+
+    while(!this->runRoutingStep())
+    {
+    }
+}
+
+bool Router::beginRouting()
 {
 
     // if the symbols or module are not set abort
-    // also abort when the module is already routed
+    // also abort when the module is already routed or a routing is running
     if((symbols != nullptr && symbols->empty()) ||
-        module == nullptr || module->getIsRouted())
+        module == nullptr || module->getIsRouted() || state != ERoutingState::IDLE)
     {
-        return;
+        return false;
     }
 
     this->assignSymbols();
-    this->runCola();
 
-    this->runAvoid();
+    // a module with a loaded layout already has its geometry
+    if(module->getLayoutLoaded())
+    {
+        module->setIsRouted();
+        return false;
+    }
+
+    this->beginCola();
 
-    this->module->setIsRouted();
+    return true;
 }
 
-void Router::clear()
+bool Router::runRoutingStep()
+{
+    switch(state)
+    {
+        case ERoutingState::COLA:
+
+            if(cola.runColaStep())
+            {
+                this->module = cola.getModule();
+                this->beginAvoid();
+            }
+            return false;
+
+        case ERoutingState::AVOID:
+
+            if(!avoid.runAvoidStep())
+            {
+                return false;
+            }
+
+            this->module = avoid.getModule();
+            this->module->setIsRouted();
+            state = ERoutingState::IDLE;
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+bool Router::isRouting() const
+{
+    return state != ERoutingState::IDLE;
+}
+
+double Router::getRoutingProgress() const
 {
-    // clean the avoid and cola routers
+    switch(state)
+    {
+        case ERoutingState::COLA:
+            return colaProgressShare * cola.getColaProgress();
+
+        case ERoutingState::AVOID:
+            return colaProgressShare + ((1.0 - colaProgressShare) * avoid.getAvoidProgress());
+
+        default:
+            return (module != nullptr && module->getIsRouted()) ? 1.0 : 0.0;
+    }
+}
+
+void Router::cancelRouting()
+{
+    // take the module back from the router that currently holds it
+    if(state == ERoutingState::COLA)
+    {
+        this->module = cola.getModule();
+    }
+    else if(state == ERoutingState::AVOID)
+    {
+        this->module = avoid.getModule();
+    }
+
+    state = ERoutingState::IDLE;
+
     this->cola.clear();
     this->avoid.clear();
 
+    if(module != nullptr)
+    {
+        module->clearRoutingData();
+    }
+}
+
+void Router::clear()
+{
+    // a running routing still holds the module
+    this->cancelRouting();
+
     // clear the diagrams routing data
-    module->clearRoutingData();
+    if(module == nullptr)
+    {
+        return;
+    }
 
     // reset the isRouted flag
     module->resetIsRouted();
 }
 
+bool Router::replaceSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols)
+{
+    this->symbols = symbols;
+
+    if(module == nullptr || !module->getIsRouted() || this->isRouting())
+    {
+        return false;
+    }
+
+    // remember the symbols the layout was routed with
+    std::vector<std::shared_ptr<Symbol::Symbol>> oldSymbols;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        oldSymbols.push_back(node->getSymbol());
+    }
+
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        oldSymbols.push_back(port->getSymbol());
+    }
+
+    assignSymbols();
+
+    std::vector<std::shared_ptr<Symbol::Symbol>> newSymbols;
+
+    for(const auto& node : *nodes)
+    {
+        newSymbols.push_back(node->getSymbol());
+    }
+
+    for(const auto& port : *ports)
+    {
+        newSymbols.push_back(port->getSymbol());
+    }
+
+    return std::equal(oldSymbols.begin(), oldSymbols.end(), newSymbols.begin(), newSymbols.end(),
+        [](const std::shared_ptr<Symbol::Symbol>& oldSymbol, const std::shared_ptr<Symbol::Symbol>& newSymbol) {
+            if(oldSymbol == nullptr || newSymbol == nullptr)
+            {
+                return oldSymbol == newSymbol;
+            }
+
+            return oldSymbol->hasSameGeometry(*newSymbol);
+        });
+}
+
+std::vector<std::string> Router::routeModules(const std::vector<std::shared_ptr<Yosys::Module>>& modules,
+    const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+    const std::function<ColaRoutingParameters(const std::shared_ptr<Yosys::Module>&)>& routingParameters,
+    const std::function<void(size_t)>& routed)
+{
+    std::vector<std::string> errors(modules.size());
+
+    // the symbols are shared by the routers, so the generic flags are set before they only read them
+    for(const auto& [name, symbol] : *symbols)
+    {
+        if(name.startsWith(genericPrefix))
+        {
+            symbol->setGeneric(true);
+        }
+    }
+
+    Scheduler::TaskScheduler::getShared().parallelFor(0, modules.size(), [&modules, &symbols, &routingParameters, &routed, &errors](size_t moduleBegin, size_t moduleEnd) {
+        for(size_t moduleIdx = moduleBegin; moduleIdx < moduleEnd; moduleIdx++)
+        {
+            const auto& module = modules[moduleIdx];
+
+            Router router;
+            router.setRoutingParameters(routingParameters(module));
+            router.setModule(module);
+            router.setSymbols(std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(*symbols));
+
+            try
+            {
+                router.runRouter();
+            }
+            catch(const std::exception& e)
+            {
+                router.cancelRouting();
+                errors[moduleIdx] = e.what();
+                continue;
+            }
+
+            routed(moduleIdx);
+        }
+    });
+
+    return errors;
+}
+
+void Router::resizeNode(const std::shared_ptr<Yosys::Node>& node, double width, double height)
+{
+    if(node == nullptr || module == nullptr || !module->getIsRouted())
+    {
+        return;
+    }
+
+    avoid.resizeShape(node->getAvoidRectReference(), width, height);
+}
+
 void Router::assignSymbols()
 {
 
@@ -150,24 +356,29 @@ void Router::assignSymbols()
     }
 }
 
-void Router::runCola()
+void Router::beginCola()
 {
 
-    // run the cola layout on the module
+    // the cola router holds the module until the layout is finished
+    state = ERoutingState::COLA;
     cola.setModule(std::move(module));
-    cola.runCola();
-    this->module = std::move(cola.getModule());
+    cola.beginCola();
 }
 
-void Router::runAvoid()
+void Router::beginAvoid()
 {
 
     // run the obstacle avoidance on the module
+    state = ERoutingState::AVOID;
     avoid.setModule(std::move(module));
-    avoid.setColaRectangles(cola.getRectangles());
+
+    // shapes and pins on the grid share the scanlines of the visibility graph
+    auto rectangles = cola.getRectangles();
+    GridSnapper::snapRectangles(rectangles);
+
+    avoid.setColaRectangles(std::move(rectangles));
     avoid.setColaEdges(cola.getEdges());
-    avoid.runAvoid();
-    this->module = std::move(avoid.getModule());
+    avoid.beginAvoid();
 }
 
 std::shared_ptr<Symbol::Symbol> Router::createJoinSplit(const std::shared_ptr<Yosys::Node>& node)
@@ -245,13 +456,16 @@ std::shared_ptr<Symbol::Symbol> Router::createGenericSymbol(const std::shared_pt
     }
 
     // generate the name of the symbol
-    const QString moduleName = "generic_i" + QString::number(inputs) + "_o" + QString::number(outputs);
+    const QString moduleName = genericPrefix + QString::number(inputs) + "_o" + QString::number(outputs);
 
-    // check if the symbol is already generated then use it
+    // check if the symbol is already generated then use it, it may be shared with other routers so it is only written if needed
     auto foundSymbol = this->symbols->find(moduleName);
     if(foundSymbol != this->symbols->end())
     {
-        foundSymbol->second->setGeneric(true);
+        if(!foundSymbol->second->isGenericSymbol())
+        {
+            foundSymbol->second->setGeneric(true);
+        }
         return foundSymbol->second;
     }
 
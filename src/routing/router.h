@@ -20,11 +20,13 @@
 #define __ROUTER_H__
 
 #include <QString>
-#include <QGraphicsSvgItem>
 
 #include <memory>
 #include <vector>
 #include <map>
+#include <functional>
+#include <string>
+#include <cstddef>
 
 #include <yosys/module.h>
 #include <symbol/symbol.h>
@@ -47,6 +49,10 @@ namespace OpenNetlistView::Routing {
  * - Set the module and symbols using setModule() and setSymbols().
  * - Run the routing process using runRouter().
  * - Clear the routing data using clear().
+ *
+ * The routing can also be run in steps with beginRouting() and runRoutingStep().
+ * Each step is one iteration of the cola layout or one batch of avoid connections,
+ * so a caller can spread the routing over several passes of its event loop.
  */
 class Router
 {
@@ -54,6 +60,21 @@ class Router
 public:
     constexpr const static char* busIdentifier = "-bus"; ///< the identifier for bus symbols
 
+private:
+    constexpr const static double colaProgressShare{0.5F}; ///< the share of the cola layout in the progress of the routing
+    constexpr const static char* genericPrefix = "generic_i"; ///< the beginning of the names of generated generic symbols
+
+    /**
+     * @enum ERoutingState
+     * @brief The state of a routing that is run in steps.
+     */
+    enum class ERoutingState
+    {
+        IDLE, ///< no routing is running
+        COLA, ///< the cola layout is running
+        AVOID ///< the avoid line routing is running
+    };
+
 public:
     /**
      * @brief Construct a new Router object
@@ -114,6 +135,50 @@ public:
      */
     void runRouter();
 
+    /**
+     * @brief Start a routing that is run in steps
+     *
+     * assigns the symbols and prepares the cola layout. The routing is
+     * then advanced by runRoutingStep() until it returns true. The module
+     * and the router must not be changed while the routing is running.
+     * After an exception cancelRouting() has to be called. A module with a
+     * layout loaded from a layout bundle only gets its symbols and is marked
+     * as routed without running the cola and avoid layout.
+     *
+     * @throw std::runtime_error if a cola representation could not be generated
+     *
+     * @return true if a routing was started, false if there is nothing to route
+     */
+    bool beginRouting();
+
+    /**
+     * @brief Run the next step of the routing started with beginRouting()
+     *
+     * @return true if the routing is finished and the module is routed
+     */
+    bool runRoutingStep();
+
+    /**
+     * @brief Check if a routing is running in steps
+     *
+     * @return true if beginRouting() was called and the routing is not finished
+     */
+    bool isRouting() const;
+
+    /**
+     * @brief Get the estimated progress of the running routing
+     *
+     * @return double the progress between 0 and 1
+     */
+    double getRoutingProgress() const;
+
+    /**
+     * @brief Abort a routing that is run in steps
+     *
+     * the module is returned to the router without routing data
+     */
+    void cancelRouting();
+
     /**
      * @brief Clear the router
      *
@@ -121,6 +186,52 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Replace the symbols of the routed module without routing it again
+     *
+     * The symbols are assigned to the nodes and ports again. The layout stays
+     * valid if every new symbol has the same bounding box and port positions
+     * as the symbol it replaces, only the rendering of the module changes.
+     *
+     * @param symbols the new symbols
+     * @return true if the layout is still valid, false if the module is not routed
+     *         or a geometry changed and the module has to be routed again
+     */
+    bool replaceSymbols(const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols);
+
+    /**
+     * @brief Route modules in parallel on the task scheduler
+     *
+     * Every module is routed by its own router. The routers get their own
+     * copy of the symbols map, because the generated join, split and module
+     * symbols are added to the map while routing.
+     *
+     * @param modules the modules to route
+     * @param symbols the symbols to use in the routing
+     * @param routingParameters returns the routing parameters for a module
+     * @param routed called on the worker with the index of a routed module
+     *        while its router still holds the routing data
+     * @return std::vector<std::string> the error of every module, empty if the module was routed
+     */
+    static std::vector<std::string> routeModules(const std::vector<std::shared_ptr<Yosys::Module>>& modules,
+        const std::shared_ptr<std::map<QString, std::shared_ptr<Symbol::Symbol>>>& symbols,
+        const std::function<ColaRoutingParameters(const std::shared_ptr<Yosys::Module>&)>& routingParameters,
+        const std::function<void(size_t)>& routed);
+
+    /**
+     * @brief Resize the routed rectangle of a node
+     *
+     * The nodes and ports around a grown node are moved outwards to make
+     * room for it. Only the connections of the moved shapes and the ones
+     * crossing the new area are rerouted, the placement is not run again.
+     * The module has to be routed before calling this.
+     *
+     * @param node the node to resize
+     * @param width the new width of the node
+     * @param height the new height of the node
+     */
+    void resizeNode(const std::shared_ptr<Yosys::Node>& node, double width, double height);
+
 private:
     /**
      * @brief assign the symbols to the nodes and ports
@@ -129,16 +240,16 @@ private:
     void assignSymbols();
 
     /**
-     * @brief run the cola layout
+     * @brief start the cola layout
      *
      */
-    void runCola();
+    void beginCola();
 
     /**
-     * @brief run the avoid line routing
+     * @brief start the avoid line routing on the result of the cola layout
      *
      */
-    void runAvoid();
+    void beginAvoid();
 
     /**
      * @brief create a join or split symbol
@@ -169,6 +280,8 @@ private:
 
     ColaRouter cola;   ///< the instance of the cola router
     AvoidRouter avoid; ///< the instance of the avoid router
+
+    ERoutingState state = ERoutingState::IDLE; ///< the state of the routing run in steps
 };
 
 } // namespace OpenNetlistView::Routing
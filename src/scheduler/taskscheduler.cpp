@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+#include "taskscheduler.h"
+
+namespace OpenNetlistView::Scheduler {
+
+namespace {
+
+thread_local const TaskScheduler* currentScheduler = nullptr; ///< The scheduler of the worker running on the thread.
+thread_local int currentWorkerIdx = -1;                        ///< The index of the worker running on the thread.
+
+} // namespace
+
+CancellationToken::CancellationToken()
+    : canceled(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+void CancellationToken::cancel()
+{
+    canceled->store(true, std::memory_order_release);
+}
+
+bool CancellationToken::isCanceled() const
+{
+    return canceled->load(std::memory_order_acquire);
+}
+
+TaskGroup::TaskGroup()
+    : pendingTasks(0)
+{
+}
+
+bool TaskGroup::isDone() const
+{
+    return pendingTasks.load(std::memory_order_acquire) == 0;
+}
+
+TaskScheduler& TaskScheduler::getShared()
+{
+#if defined(EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    static TaskScheduler scheduler(0);
+#else
+    // the thread that calls parallelFor runs the first chunk and the queued chunks of its loop,
+    // it only sleeps once the remaining chunks are running on the workers
+    static TaskScheduler scheduler(std::max(1U, std::thread::hardware_concurrency()) - 1);
+#endif
+
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(size_t workerCount)
+    : queuedTasks(0)
+    , stopping(false)
+{
+#if defined(EMSCRIPTEN) && !defined(__EMSCRIPTEN_PTHREADS__)
+    workerCount = 0;
+#endif
+
+    for(size_t workerIdx = 0; workerIdx < workerCount; workerIdx++)
+    {
+        workerQueues.push_back(std::make_unique<TaskQueues>());
+    }
+
+    // the queues of all workers exist before the first worker steals
+    for(size_t workerIdx = 0; workerIdx < workerCount; workerIdx++)
+    {
+        workers.emplace_back(&TaskScheduler::runWorker, this, workerIdx);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+
+    workCondition.notify_all();
+
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+size_t TaskScheduler::getWorkerCount() const
+{
+    return workers.size();
+}
+
+void TaskScheduler::submit(std::function<void()> task, EPriority priority, TaskGroup* group, const CancellationToken& token)
+{
+    if(group != nullptr)
+    {
+        group->pendingTasks.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    Task newTask{std::move(task), group, token};
+
+    if(workers.empty())
+    {
+        runTask(newTask);
+        return;
+    }
+
+    const int workerIdx = getCurrentWorker();
+    TaskQueues& queues = workerIdx >= 0 ? *workerQueues[workerIdx] : sharedQueues;
+
+    // counted before it is queued so the count never drops below zero
+    queuedTasks.fetch_add(1, std::memory_order_acq_rel);
+
+    {
+        std::lock_guard<std::mutex> lock(queues.mutex);
+        queues.tasks[static_cast<size_t>(priority)].push_back(std::move(newTask));
+    }
+
+    notify(workCondition, false);
+}
+
+void TaskScheduler::wait(TaskGroup& group)
+{
+    while(!group.isDone())
+    {
+        Task task;
+
+        if(takeTask(task, &group))
+        {
+            runTask(task);
+            continue;
+        }
+
+        // the remaining tasks of the group are running on other threads
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        doneCondition.wait(lock, [&group]() { return group.isDone(); });
+    }
+
+    std::exception_ptr error;
+
+    {
+        std::lock_guard<std::mutex> lock(group.errorMutex);
+        std::swap(error, group.error);
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskScheduler::parallelFor(size_t begin,
+                                size_t end,
+                                const std::function<void(size_t, size_t)>& body,
+                                EPriority priority,
+                                const CancellationToken& token,
+                                size_t grainSize)
+{
+    if(begin >= end)
+    {
+        return;
+    }
+
+    const size_t count = end - begin;
+    const size_t maxChunks = (workers.size() + 1) * chunksPerWorker;
+    const size_t chunkCount = std::min(maxChunks, (count + std::max<size_t>(grainSize, 1) - 1) / std::max<size_t>(grainSize, 1));
+
+    if(chunkCount <= 1 || workers.empty())
+    {
+        if(!token.isCanceled())
+        {
+            body(begin, end);
+        }
+
+        return;
+    }
+
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    TaskGroup group;
+
+    for(size_t chunkBegin = begin + chunkSize; chunkBegin < end; chunkBegin += chunkSize)
+    {
+        const size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+
+        submit([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); }, priority, &group, token);
+    }
+
+    // the first chunk is run by the calling thread
+    try
+    {
+        if(!token.isCanceled())
+        {
+            body(begin, std::min(end, begin + chunkSize));
+        }
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(group.errorMutex);
+
+        // a chunk that was stolen by a worker may have failed first
+        if(!group.error)
+        {
+            group.error = std::current_exception();
+        }
+    }
+
+    wait(group);
+}
+
+void TaskScheduler::runWorker(size_t workerIdx)
+{
+    currentScheduler = this;
+    currentWorkerIdx = static_cast<int>(workerIdx);
+
+    while(true)
+    {
+        Task task;
+
+        if(takeTask(task, nullptr))
+        {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        workCondition.wait(lock, [this]() { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+
+        if(stopping && queuedTasks.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool TaskScheduler::takeTask(Task& task, const TaskGroup* group)
+{
+    if(queuedTasks.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+
+    const int workerIdx = getCurrentWorker();
+    const size_t workerCount = workerQueues.size();
+
+    for(size_t priorityIdx = 0; priorityIdx < priorityCount; priorityIdx++)
+    {
+        bool taken = false;
+
+        // the newest task of the own queue is the one with the warmest data
+        if(workerIdx >= 0)
+        {
+            TaskQueues& ownQueues = *workerQueues[workerIdx];
+            std::lock_guard<std::mutex> lock(ownQueues.mutex);
+            taken = takeFromQueue(ownQueues.tasks[priorityIdx], group, true, task);
+        }
+
+        if(!taken)
+        {
+            std::lock_guard<std::mutex> lock(sharedQueues.mutex);
+            taken = takeFromQueue(sharedQueues.tasks[priorityIdx], group, false, task);
+        }
+
+        // steal the oldest task of another worker starting with the next one
+        for(size_t stealIdx = 1; !taken && stealIdx <= workerCount; stealIdx++)
+        {
+            const size_t victimIdx = static_cast<size_t>(workerIdx + static_cast<int>(stealIdx)) % workerCount;
+
+            if(static_cast<int>(victimIdx) == workerIdx)
+            {
+                continue;
+            }
+
+            TaskQueues& victimQueues = *workerQueues[victimIdx];
+            std::lock_guard<std::mutex> lock(victimQueues.mutex);
+            taken = takeFromQueue(victimQueues.tasks[priorityIdx], group, false, task);
+        }
+
+        if(taken)
+        {
+            queuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TaskScheduler::takeFromQueue(std::deque<Task>& queue, const TaskGroup* group, bool fromBack, Task& task)
+{
+    if(queue.empty())
+    {
+        return false;
+    }
+
+    if(group == nullptr)
+    {
+        if(fromBack)
+        {
+            task = std::move(queue.back());
+            queue.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        return true;
+    }
+
+    // a waiting thread only runs tasks of the group it waits for
+    auto taskIt = fromBack ? std::find_if(queue.rbegin(), queue.rend(), [group](const Task& queued) { return queued.group == group; }).base()
+                           : std::find_if(queue.begin(), queue.end(), [group](const Task& queued) { return queued.group == group; });
+
+    if(fromBack)
+    {
+        if(taskIt == queue.begin())
+        {
+            return false;
+        }
+
+        --taskIt;
+    }
+    else if(taskIt == queue.end())
+    {
+        return false;
+    }
+
+    task = std::move(*taskIt);
+    queue.erase(taskIt);
+
+    return true;
+}
+
+void TaskScheduler::runTask(Task& task)
+{
+    if(!task.token.isCanceled())
+    {
+        try
+        {
+            task.function();
+        }
+        catch(...)
+        {
+            if(task.group != nullptr)
+            {
+                std::lock_guard<std::mutex> lock(task.group->errorMutex);
+
+                if(!task.group->error)
+                {
+                    task.group->error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    // release the captures before the group is finished
+    task.function = nullptr;
+
+    if(task.group != nullptr && task.group->pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        notify(doneCondition, true);
+    }
+}
+
+int TaskScheduler::getCurrentWorker() const
+{
+    return currentScheduler == this ? currentWorkerIdx : -1;
+}
+
+void TaskScheduler::notify(std::condition_variable& condition, bool all)
+{
+    // the lock orders the notification after the check of a thread going to sleep
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+
+    if(all)
+    {
+        condition.notify_all();
+    }
+    else
+    {
+        condition.notify_one();
+    }
+}
+
+} // namespace OpenNetlistView::Scheduler
@@ -0,0 +1,286 @@
+/**
+ * @file taskscheduler.h
+ * @brief Header file for the TaskScheduler class in the OpenNetlistView::Scheduler namespace.
+ *
+ * This file contains the declaration of the TaskScheduler class, which runs the
+ * parse, route and render work of the application on one shared set of worker
+ * threads, together with the TaskGroup and CancellationToken classes used to
+ * wait for and cancel the submitted tasks.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __TASKSCHEDULER_H__
+#define __TASKSCHEDULER_H__
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+namespace OpenNetlistView::Scheduler {
+
+/**
+ * @class CancellationToken
+ * @brief A flag shared between the submitter and the tasks that can be canceled.
+ *
+ * Copies of a token share the flag. Tasks of a canceled token that have not
+ * started yet are dropped by the scheduler, running tasks can poll the token
+ * to stop early.
+ */
+class CancellationToken
+{
+public:
+    /**
+     * @brief Construct a new CancellationToken object that is not canceled
+     *
+     */
+    CancellationToken();
+
+    /**
+     * @brief Cancels the token and all of its copies
+     *
+     */
+    void cancel();
+
+    /**
+     * @brief Checks if the token was canceled
+     *
+     * @return true if cancel was called on the token or one of its copies
+     */
+    bool isCanceled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> canceled; ///< The flag shared by the copies of the token.
+};
+
+/**
+ * @class TaskGroup
+ * @brief Tracks a set of tasks so they can be waited for together.
+ *
+ * The group must outlive its tasks, so it has to be waited for before it is
+ * destroyed. The first exception thrown by a task of the group is rethrown
+ * by TaskScheduler::wait.
+ */
+class TaskGroup
+{
+public:
+    /**
+     * @brief Construct a new TaskGroup object without tasks
+     *
+     */
+    TaskGroup();
+
+    /**
+     * @brief Checks if all tasks of the group are finished
+     *
+     * @return true if no task of the group is queued or running
+     */
+    bool isDone() const;
+
+private:
+    friend class TaskScheduler;
+
+    std::atomic<size_t> pendingTasks; ///< The number of queued and running tasks.
+    std::mutex errorMutex;            ///< Protects the error.
+    std::exception_ptr error;         ///< The first exception thrown by a task.
+};
+
+/**
+ * @class TaskScheduler
+ * @brief A work stealing scheduler shared by the parser, the routers and the renderers.
+ *
+ * Every worker owns a queue per priority. Tasks submitted from a worker are
+ * pushed to the queue of the worker and taken from its back, so nested work
+ * stays on the thread that created it. Tasks submitted from other threads go
+ * to a shared queue. An idle worker looks at the priorities from interactive
+ * to speculative and takes a task from its own queue, the shared queue or the
+ * front of the queue of another worker in that order.
+ *
+ * A thread that waits for a group runs the queued tasks of the group itself,
+ * so parallel loops can be nested inside of tasks without blocking a worker.
+ * Without thread support the tasks are run when they are submitted.
+ */
+class TaskScheduler
+{
+public:
+    /**
+     * @enum EPriority
+     * @brief The priority of a task, earlier values are run first.
+     */
+    enum class EPriority
+    {
+        INTERACTIVE, ///< Work the user waits for, like visible tiles.
+        NORMAL,      ///< Work started by the user, like parsing and exporting.
+        SPECULATIVE  ///< Work that may never be needed, like prefetching.
+    };
+
+    constexpr const static size_t priorityCount{3};   ///< The number of priorities.
+    constexpr const static size_t chunksPerWorker{4}; ///< The chunks of a parallel loop for every thread.
+
+    /**
+     * @brief Get the scheduler shared by the application
+     *
+     * @return TaskScheduler& The scheduler with one worker less than the hardware threads.
+     */
+    static TaskScheduler& getShared();
+
+    /**
+     * @brief Construct a new TaskScheduler object
+     *
+     * @param workerCount The number of worker threads, 0 runs every task when it is submitted.
+     */
+    explicit TaskScheduler(size_t workerCount);
+
+    /**
+     * @brief Destroy the TaskScheduler object
+     *
+     * The queued tasks are run before the workers are stopped.
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Get the number of worker threads
+     *
+     * @return size_t The number of workers.
+     */
+    size_t getWorkerCount() const;
+
+    /**
+     * @brief Submits a task
+     *
+     * @param task The function to run.
+     * @param priority The priority of the task.
+     * @param group The group to add the task to or nullptr.
+     * @param token The token to cancel the task with.
+     */
+    void submit(std::function<void()> task,
+                EPriority priority = EPriority::NORMAL,
+                TaskGroup* group = nullptr,
+                const CancellationToken& token = CancellationToken());
+
+    /**
+     * @brief Waits for all tasks of a group
+     *
+     * The calling thread runs the queued tasks of the group while it waits.
+     *
+     * @param group The group to wait for.
+     * @throw The first exception thrown by a task of the group.
+     */
+    void wait(TaskGroup& group);
+
+    /**
+     * @brief Runs a loop in parallel
+     *
+     * The range is split into chunks that are run as tasks, the calling thread
+     * runs the first chunk and helps with the rest until the loop is done.
+     *
+     * @param begin The first index.
+     * @param end The index after the last one.
+     * @param body The function run for every chunk with its first and past the end index.
+     * @param priority The priority of the chunks.
+     * @param token The token to cancel the remaining chunks with.
+     * @param grainSize The minimum number of indexes in a chunk.
+     * @throw The first exception thrown by a chunk.
+     */
+    void parallelFor(size_t begin,
+                     size_t end,
+                     const std::function<void(size_t, size_t)>& body,
+                     EPriority priority = EPriority::NORMAL,
+                     const CancellationToken& token = CancellationToken(),
+                     size_t grainSize = 1);
+
+private:
+    /**
+     * @struct Task
+     * @brief A submitted task with the data to track it.
+     */
+    struct Task
+    {
+        std::function<void()> function; ///< The function to run.
+        TaskGroup* group = nullptr;     ///< The group of the task or nullptr.
+        CancellationToken token;        ///< The token to cancel the task with.
+    };
+
+    /**
+     * @struct TaskQueues
+     * @brief The queues of one worker or the shared queues.
+     */
+    struct TaskQueues
+    {
+        std::mutex mutex;                                  ///< Protects the queues.
+        std::array<std::deque<Task>, priorityCount> tasks; ///< The tasks of every priority.
+    };
+
+    std::vector<std::unique_ptr<TaskQueues>> workerQueues; ///< The queues owned by every worker.
+    TaskQueues sharedQueues;                               ///< The queues for tasks submitted from other threads.
+    std::vector<std::thread> workers;                      ///< The worker threads.
+    std::atomic<size_t> queuedTasks;                       ///< The number of tasks in all queues.
+    std::mutex sleepMutex;                                 ///< Protects the sleeping of the workers and waiting threads.
+    std::condition_variable workCondition;                 ///< Wakes the workers when a task is queued.
+    std::condition_variable doneCondition;                 ///< Wakes the waiting threads when a group is done.
+    bool stopping;                                         ///< If the workers should stop once the queues are empty.
+
+    /**
+     * @brief The loop of a worker thread
+     *
+     * @param workerIdx The index of the worker.
+     */
+    void runWorker(size_t workerIdx);
+
+    /**
+     * @brief Takes the next task to run
+     *
+     * @param task The taken task.
+     * @param group Only tasks of this group are taken if it is not nullptr.
+     * @return true if a task was taken
+     */
+    bool takeTask(Task& task, const TaskGroup* group);
+
+    /**
+     * @brief Takes a task from the queue of a priority
+     *
+     * @param queue The queue to take the task from.
+     * @param group Only tasks of this group are taken if it is not nullptr.
+     * @param fromBack If the newest task is taken instead of the oldest one.
+     * @param task The taken task.
+     * @return true if a task was taken
+     */
+    static bool takeFromQueue(std::deque<Task>& queue, const TaskGroup* group, bool fromBack, Task& task);
+
+    /**
+     * @brief Runs a task and finishes it in its group
+     *
+     * @param task The task to run.
+     */
+    void runTask(Task& task);
+
+    /**
+     * @brief Get the index of the worker running on the calling thread
+     *
+     * @return int The index of the worker or -1 if the thread is no worker of this scheduler.
+     */
+    int getCurrentWorker() const;
+
+    /**
+     * @brief Wakes the threads sleeping on a condition
+     *
+     * @param condition The condition to notify.
+     * @param all If all threads are woken instead of one.
+     */
+    void notify(std::condition_variable& condition, bool all);
+};
+
+} // namespace OpenNetlistView::Scheduler
+
+#endif // __TASKSCHEDULER_H__
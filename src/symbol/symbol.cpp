@@ -1,6 +1,4 @@
 #include <QString>
-#include <QByteArray>
-#include <QSvgRenderer>
 #include <QDomDocument>
 #include <third_party/libcola/cola.h>
 #include <third_party/libcola/cluster.h>
@@ -29,7 +27,6 @@ Symbol::Symbol(QString name, double boundingBoxWidth, double boundingBoxHeight)
     : name(std::move(name))
     , boundingBoxWidth(boundingBoxWidth)
     , boundingBoxHeight(boundingBoxHeight)
-    , qRenderer(nullptr)
 {
     this->aliases = std::vector<std::shared_ptr<QString>>();
     this->ports = std::vector<std::shared_ptr<Port>>();
@@ -66,7 +63,6 @@ const std::vector<std::shared_ptr<Port>>& Symbol::getPorts() const
 void Symbol::addSvgData(QString svgData)
 {
     this->svgData = std::move(svgData);
-    this->createQRenderer();
 }
 
 QString Symbol::getSvgData()
@@ -118,6 +114,25 @@ std::pair<double, double> Symbol::getBoundingBox() const
     return std::make_pair(this->boundingBoxWidth, this->boundingBoxHeight);
 }
 
+bool Symbol::hasSameGeometry(const Symbol& other) const
+{
+    if(this->boundingBoxWidth != other.boundingBoxWidth ||
+        this->boundingBoxHeight != other.boundingBoxHeight ||
+        this->isGeneric != other.isGeneric ||
+        this->ports.size() != other.ports.size())
+    {
+        return false;
+    }
+
+    // the ports are compared in the order they were parsed
+    return std::equal(this->ports.begin(), this->ports.end(), other.ports.begin(),
+        [](const std::shared_ptr<Port>& port, const std::shared_ptr<Port>& otherPort) {
+            return port->getName() == otherPort->getName() &&
+                   port->getXPos() == otherPort->getXPos() &&
+                   port->getYPos() == otherPort->getYPos();
+        });
+}
+
 std::map<QString, int> Symbol::generateColaRep(std::vector<cola::Edge>& edges,
     cola::EdgeLengths& edgeLengths,
     std::vector<vpsc::Rectangle*>& rectangles,
@@ -189,11 +204,6 @@ std::map<QString, int> Symbol::generateColaRep(std::vector<cola::Edge>& edges,
     return rectangleIDs;
 }
 
-QSvgRenderer* Symbol::getQRenderer()
-{
-    return this->qRenderer;
-}
-
 std::shared_ptr<Symbol> Symbol::createJoinSplit(const int portCount, const std::shared_ptr<Symbol>& baseSymbol)
 {
 
@@ -238,16 +248,6 @@ std::ostream& operator<<(std::ostream& outStream, const Symbol& symbol)
     return outStream << sStream.str();
 }
 
-void Symbol::createQRenderer()
-{
-
-    const QByteArray svgData = this->svgData.toUtf8();
-
-    delete this->qRenderer;
-
-    this->qRenderer = new QSvgRenderer(svgData);
-}
-
 std::shared_ptr<Symbol> Symbol::createJoinSplitHelper(const int inputPorts, const int outputPorts, const std::shared_ptr<Symbol>& baseSymbol, bool isJoin)
 {
     const QString splitJoinName = baseSymbol->getName() + "_i" + QString::number(inputPorts) + "_o" + QString::number(outputPorts);
@@ -13,7 +13,6 @@
 #define __SYMBOL_H__
 
 #include <QString>
-#include <QSvgRenderer>
 #include <third_party/libcola/cola.h>
 #include <third_party/libvpsc/rectangle.h>
 #include <third_party/libcola/connected_components.h>
@@ -185,6 +184,18 @@ public:
      */
     std::pair<double, double> getBoundingBox() const;
 
+    /**
+     * @brief checks if the symbol has the same geometry as another symbol
+     *
+     * The geometry consists of the bounding box and the names and positions
+     * of the ports, the svg data is not compared. A layout routed with one
+     * symbol is valid for the other symbol if the geometry is the same.
+     *
+     * @param other the symbol to compare with
+     * @return true if the bounding boxes and all ports are the same, false otherwise
+     */
+    bool hasSameGeometry(const Symbol& other) const;
+
     /**
      * @brief Generates the cola representation of the symbol.
      *
@@ -204,13 +215,6 @@ public:
         cola::CompoundConstraints& compoundConstraints,
         cola::RootCluster* rootCluster);
 
-    /**
-     * @brief Get the SVG renderer for the symbol.
-     *
-     * @return The SVG renderer for the symbol.
-     */
-    QSvgRenderer* getQRenderer();
-
     /**
      * @brief Overloads the output stream operator for the Symbol class.
      *
@@ -247,13 +251,6 @@ public:
     static std::shared_ptr<Symbol> createGenericSymbol(const int inputCount, const int outputCount, const std::shared_ptr<Symbol>& baseSymbol);
 
 private:
-    /**
-     * @brief Creates the SVG renderer for the symbol.
-     *
-     * For this the SVG data of the symbol is used
-     */
-    void createQRenderer();
-
     /**
      * @brief Creates a split or join symbol with the given input and output ports and base symbol.
      *
@@ -273,7 +270,6 @@ private:
     double boundingBoxWidth;                       ///< The width of the bounding box.
     double boundingBoxHeight;                      ///< The height of the bounding box.
     QString svgData;                               ///< The SVG data of the symbol.
-    QSvgRenderer* qRenderer;                       ///< The SVG renderer for the symbol.
     bool isGeneric = false;                        ///< True if the symbol is a generic symbol, false otherwise.
 };
 
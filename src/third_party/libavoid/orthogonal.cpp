@@ -28,6 +28,8 @@
 #include <cmath>
 #include <set>
 #include <list>
+#include <vector>
+#include <utility>
 #include <algorithm>
 
 #include "libavoid/router.h"
@@ -3144,6 +3146,150 @@ void ImproveOrthogonalRoutes::simplifyOrthogonalRoutes(void)
 }
 
 
+// An axis aligned box around one segment of a connector route.
+struct RouteSegmentBox
+{
+    size_t connIndex;
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+
+    bool overlaps(const RouteSegmentBox& rhs) const
+    {
+        return (minX <= rhs.maxX) && (rhs.minX <= maxX) &&
+                (minY <= rhs.maxY) && (rhs.minY <= maxY);
+    }
+};
+
+
+// Broad phase for the connector pair loops of 
+// buildOrthogonalNudgingOrderInfo().  For every orthogonal connector this
+// returns the sorted indexes of the other orthogonal connectors that have
+// a segment touching or overlapping one of its segments.
+//
+// Splitting segments and counting crossings only has an effect for
+// connectors that have a point in common, and splitting only adds points
+// on existing segments, so the other pairs can be skipped without changing
+// the result.  The segments are put into a uniform grid, so the candidates
+// of a connector are only searched in the cells of its own segments.
+std::vector<std::vector<size_t> > findTouchingConnectors(
+        const ConnRefVector& connRefs, const RouteVector& connRoutes)
+{
+    std::vector<std::vector<size_t> > touching(connRefs.size());
+
+    std::vector<RouteSegmentBox> boxes;
+    std::vector<std::pair<size_t, size_t> > connBoxes(connRefs.size(),
+            std::make_pair(0, 0));
+    double minX = DBL_MAX;
+    double maxX = -DBL_MAX;
+    double minY = DBL_MAX;
+    double maxY = -DBL_MAX;
+
+    for (size_t ind = 0; ind < connRefs.size(); ++ind)
+    {
+        connBoxes[ind].first = boxes.size();
+        if (connRefs[ind]->routingType() == ConnType_Orthogonal)
+        {
+            const Polygon& route = connRoutes[ind];
+            for (size_t i = 1; i < route.size(); ++i)
+            {
+                const Point& p0 = route.ps[i - 1];
+                const Point& p1 = route.ps[i];
+
+                RouteSegmentBox box;
+                box.connIndex = ind;
+                box.minX = std::min(p0.x, p1.x);
+                box.maxX = std::max(p0.x, p1.x);
+                box.minY = std::min(p0.y, p1.y);
+                box.maxY = std::max(p0.y, p1.y);
+                boxes.push_back(box);
+
+                minX = std::min(minX, box.minX);
+                maxX = std::max(maxX, box.maxX);
+                minY = std::min(minY, box.minY);
+                maxY = std::max(maxY, box.maxY);
+            }
+        }
+        connBoxes[ind].second = boxes.size();
+    }
+
+    if (boxes.empty())
+    {
+        return touching;
+    }
+
+    // Use about as many grid cells as there are segments.
+    const size_t cellsPerSide = 
+            (size_t) std::ceil(std::sqrt((double) boxes.size()));
+    double cellSize = std::max(maxX - minX, maxY - minY) / cellsPerSide;
+    if (!(cellSize > 0))
+    {
+        cellSize = 1;
+    }
+    const size_t columns = (size_t) ((maxX - minX) / cellSize) + 1;
+    const size_t rows = (size_t) ((maxY - minY) / cellSize) + 1;
+
+    // The cell of a position only grows with the position, so two
+    // touching boxes always have a cell in common.
+    auto cellColumn = [&](double x)
+    {
+        return std::min((size_t) ((x - minX) / cellSize), columns - 1);
+    };
+    auto cellRow = [&](double y)
+    {
+        return std::min((size_t) ((y - minY) / cellSize), rows - 1);
+    };
+
+    std::vector<std::vector<size_t> > cells(columns * rows);
+    for (size_t b = 0; b < boxes.size(); ++b)
+    {
+        const RouteSegmentBox& box = boxes[b];
+        for (size_t row = cellRow(box.minY); row <= cellRow(box.maxY); ++row)
+        {
+            for (size_t col = cellColumn(box.minX); 
+                    col <= cellColumn(box.maxX); ++col)
+            {
+                cells[(row * columns) + col].push_back(b);
+            }
+        }
+    }
+
+    for (size_t ind = 0; ind < connRefs.size(); ++ind)
+    {
+        std::vector<size_t>& candidates = touching[ind];
+        for (size_t b = connBoxes[ind].first; b < connBoxes[ind].second; ++b)
+        {
+            const RouteSegmentBox& box = boxes[b];
+            for (size_t row = cellRow(box.minY); row <= cellRow(box.maxY); 
+                    ++row)
+            {
+                for (size_t col = cellColumn(box.minX); 
+                        col <= cellColumn(box.maxX); ++col)
+                {
+                    const std::vector<size_t>& cell = 
+                            cells[(row * columns) + col];
+                    for (size_t i = 0; i < cell.size(); ++i)
+                    {
+                        const RouteSegmentBox& other = boxes[cell[i]];
+                        if ((other.connIndex != ind) && box.overlaps(other))
+                        {
+                            candidates.push_back(other.connIndex);
+                        }
+                    }
+                }
+            }
+        }
+        // Visit the pairs in the same order as the all pairs loops.
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), 
+                candidates.end());
+    }
+
+    return touching;
+}
+
+
 // Populates m_point_orders and m_shared_path_connectors_with_common_endpoints.
 void ImproveOrthogonalRoutes::buildOrthogonalNudgingOrderInfo(void)
 {
@@ -3173,6 +3319,10 @@ void ImproveOrthogonalRoutes::buildOrthogonalNudgingOrderInfo(void)
         connRoutes[ind] = connRefs[ind]->displayRoute();
     }
 
+    // Only the pairs of connectors with touching routes are checked.
+    const std::vector<std::vector<size_t> > touchingConns = 
+            findTouchingConnectors(connRefs, connRoutes);
+
     // Do segment splitting.
     for (size_t ind1 = 0; ind1 < connRefs.size(); ++ind1)
     {
@@ -3182,19 +3332,8 @@ void ImproveOrthogonalRoutes::buildOrthogonalNudgingOrderInfo(void)
             continue;
         }
 
-        for (size_t ind2 = 0; ind2 < connRefs.size(); ++ind2)
+        for (size_t ind2 : touchingConns[ind1])
         {
-            if (ind1 == ind2)
-            {
-                continue;
-            }
-
-            ConnRef *conn2 = connRefs[ind2];
-            if (conn2->routingType() != ConnType_Orthogonal)
-            {
-                continue;
-            }
-
             Avoid::Polygon& route = connRoutes[ind1];
             Avoid::Polygon& route2 = connRoutes[ind2];
             splitBranchingSegments(route2, true, route);
@@ -3209,14 +3348,14 @@ void ImproveOrthogonalRoutes::buildOrthogonalNudgingOrderInfo(void)
             continue;
         }
 
-        for (size_t ind2 = ind1 + 1; ind2 < connRefs.size(); ++ind2)
+        for (size_t ind2 : touchingConns[ind1])
         {
-            ConnRef *conn2 = connRefs[ind2];
-            if (conn2->routingType() != ConnType_Orthogonal)
+            if (ind2 <= ind1)
             {
                 continue;
             }
 
+            ConnRef *conn2 = connRefs[ind2];
             Avoid::Polygon& route = connRoutes[ind1];
             Avoid::Polygon& route2 = connRoutes[ind2];
             int crossings = 0;
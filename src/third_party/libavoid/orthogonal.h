@@ -26,13 +26,26 @@
 #ifndef AVOID_ORTHOGONAL_H
 #define AVOID_ORTHOGONAL_H
 
+#include <cstddef>
+#include <vector>
+
+#include "libavoid/geomtypes.h"
+
 namespace Avoid {
 
 class Router;
+class ConnRef;
 
 extern void generateStaticOrthogonalVisGraph(Router *router);
 extern void improveOrthogonalRoutes(Router *router);
 
+// Returns for every connector the sorted indexes of the other orthogonal
+// connectors that have a route segment touching one of its segments.
+// connRoutes holds the route of the connector with the same index.
+extern std::vector<std::vector<size_t> > findTouchingConnectors(
+        const std::vector<ConnRef *>& connRefs, 
+        const std::vector<Polygon>& connRoutes);
+
 
 }
 
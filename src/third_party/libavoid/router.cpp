@@ -62,6 +62,7 @@ Router::Router(const unsigned int flags)
       m_consolidate_actions(true),
       m_currently_calling_destructors(false),
       m_topology_addon(new TopologyAddonInterface()),
+      m_step_conn_count(0),
       // Mode options:
       m_allows_polyline_routing(false),
       m_allows_orthogonal_routing(false),
@@ -656,6 +657,41 @@ bool Router::processTransaction(void)
 }
 
 
+bool Router::beginTransactionSteps(void)
+{
+    // Same checks as processTransaction().
+    if ((actionList.empty() && (m_hyperedge_rerouter.count() == 0) &&
+         (m_settings_changes == false)) || SimpleRouting)
+    {
+        return false;
+    }
+    m_settings_changes = false;
+
+    processActions();
+
+    m_static_orthogonal_graph_invalidated = true;
+    beginRerouteConnectors();
+
+    return true;
+}
+
+
+bool Router::processTransactionStep(const size_t maxConnectors)
+{
+    return rerouteConnectorsStep(maxConnectors);
+}
+
+
+void Router::finishTransactionSteps(void)
+{
+    // Route anything left if the caller stopped early.
+    while (!rerouteConnectorsStep(connRefs.size()))
+    {
+    }
+    finishRerouteConnectors();
+}
+
+
 void Router::addJunction(JunctionRef *junction)
 {
     // There shouldn't be remove events or move events for the same junction
@@ -923,14 +959,24 @@ void Router::attachedShapes(IntList &shapes, const unsigned int shapeId,
     // rerouted connectors (via a callback) that they need to be redrawn.
 void Router::rerouteAndCallbackConnectors(void)
 {
-    ConnRefList reroutedConns;
-    ConnRefList::const_iterator fin = connRefs.end();
+    beginRerouteConnectors();
+    while (!rerouteConnectorsStep(connRefs.size()))
+    {
+    }
+    finishRerouteConnectors();
+}
+
+
+void Router::beginRerouteConnectors(void)
+{
+    m_step_rerouted_conns.clear();
     
     this->m_conn_reroute_flags.alertConns();
 
     // Updating the orthogonal visibility graph if necessary. 
     regenerateStaticBuiltGraph();
 
+    ConnRefList::const_iterator fin = connRefs.end();
     for (ConnRefList::const_iterator i = connRefs.begin(); i != fin; ++i) 
     {
         (*i)->freeActivePins();
@@ -939,24 +985,35 @@ void Router::rerouteAndCallbackConnectors(void)
     // Calculate and return connectors that are part of hyperedges and will
     // be completely rerouted by that code and thus don't need to have routes
     // generated here.
-    ConnRefSet hyperedgeConns =
+    m_step_hyperedge_conns =
             m_hyperedge_rerouter.calcHyperedgeConnectors();
 
+    m_step_conn_it = connRefs.begin();
+    m_step_conn_count = 0;
+}
+
+
+bool Router::rerouteConnectorsStep(const size_t maxConnectors)
+{
     // TODO: It might be worth sorting connectors and routing them from 
     //       smallest to largest estimated cost.  This way we likely get 
     //       better exclusive pin assignment during initial routing.
 
     size_t totalConns = connRefs.size();
-    size_t numOfReroutedConns = 0;
-    for (ConnRefList::const_iterator i = connRefs.begin(); i != fin; ++i) 
+    size_t stepConns = 0;
+    ConnRefList::const_iterator fin = connRefs.end();
+    for (; (m_step_conn_it != fin) && (stepConns < maxConnectors);
+            ++m_step_conn_it)
     {
         // Progress reporting and continuation check.
         performContinuationCheck(TransactionPhaseRouteSearch, 
-                numOfReroutedConns, totalConns);
-        ++numOfReroutedConns;
+                m_step_conn_count, totalConns);
+        ++m_step_conn_count;
+        ++stepConns;
 
-        ConnRef *connector = *i;
-        if (hyperedgeConns.find(connector) != hyperedgeConns.end())
+        ConnRef *connector = *m_step_conn_it;
+        if (m_step_hyperedge_conns.find(connector) !=
+                m_step_hyperedge_conns.end())
         {
             // This will be rerouted by the hyperedge code, so do nothing.
             continue;
@@ -973,11 +1030,20 @@ void Router::rerouteAndCallbackConnectors(void)
         bool rerouted = connector->generatePath();
         if (rerouted)
         {
-            reroutedConns.push_back(connector);
+            m_step_rerouted_conns.push_back(connector);
         }
         TIMER_STOP(this);
     }
 
+    return m_step_conn_it == fin;
+}
+
+
+void Router::finishRerouteConnectors(void)
+{
+    ConnRefList reroutedConns;
+    reroutedConns.swap(m_step_rerouted_conns);
+    m_step_hyperedge_conns.clear();
 
     // Perform any complete hyperedge rerouting that has been requested.
     m_hyperedge_rerouter.performRerouting();
@@ -1010,7 +1076,7 @@ void Router::rerouteAndCallbackConnectors(void)
     }
 
     // Alert connectors that they need redrawing.
-    fin = reroutedConns.end();
+    ConnRefList::const_iterator fin = reroutedConns.end();
     for (ConnRefList::const_iterator i = reroutedConns.begin(); i != fin; ++i) 
     {
         ConnRef *conn = *i;
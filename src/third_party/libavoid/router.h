@@ -478,6 +478,40 @@ class AVOID_EXPORT Router {
         //!
         bool processTransaction(void);
 
+        //! @brief Begins processing the current transaction in steps.
+        //!
+        //! This has the same effect as processTransaction(), but the 
+        //! connectors are routed in batches by processTransactionStep() 
+        //! so the caller can return to its event loop between batches.
+        //! finishTransactionSteps() has to be called after the last step.
+        //! The router must not be changed until the steps are finished.
+        //!
+        //! @return A boolean value describing whether there were any actions
+        //!         to process.  If false no steps have to be processed.
+        //!
+        //! @sa processTransactionStep
+        //! @sa finishTransactionSteps
+        //!
+        bool beginTransactionSteps(void);
+
+        //! @brief Routes the next batch of connectors of a transaction
+        //!        started with beginTransactionSteps().
+        //!
+        //! @param[in]  maxConnectors  The number of connectors to route in
+        //!                            this step.
+        //!
+        //! @return A boolean value describing whether all connectors have
+        //!         been routed.
+        //!
+        bool processTransactionStep(const size_t maxConnectors);
+
+        //! @brief Finishes a transaction processed in steps.
+        //!
+        //! Performs the hyperedge, crossing and orthogonal improvements 
+        //! and calls the callbacks of the rerouted connectors.
+        //!
+        void finishTransactionSteps(void);
+
         //! @brief Delete a shape from the router scene.
         //!
         //! Connectors that could have a better (usually shorter) path after
@@ -848,6 +882,9 @@ class AVOID_EXPORT Router {
                 const int p_cluster);
         void adjustClustersWithDel(const int p_cluster);
         void rerouteAndCallbackConnectors(void);
+        void beginRerouteConnectors(void);
+        bool rerouteConnectorsStep(const size_t maxConnectors);
+        void finishRerouteConnectors(void);
         void improveCrossings(void);
 
         ActionInfoList actionList;
@@ -866,6 +903,12 @@ class AVOID_EXPORT Router {
         
         TopologyAddonInterface *m_topology_addon;
 
+        // State of a transaction processed in steps.
+        ConnRefList m_step_rerouted_conns;
+        ConnRefSet m_step_hyperedge_conns;
+        ConnRefList::const_iterator m_step_conn_it;
+        size_t m_step_conn_count;
+
         // Overall modes:
         bool m_allows_polyline_routing;
         bool m_allows_orthogonal_routing;
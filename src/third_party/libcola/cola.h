@@ -524,6 +524,97 @@ vpsc::Rectangle bounds(vpsc::Rectangles& rs);
 
 class ConstrainedFDLayout;
 
+/**
+ * @brief  The ideal distances (D) and path types (G) of all pairs of nodes.
+ *
+ * Both matrices are symmetric, so only the pairs u<v are stored, row by row,
+ * as a packed upper triangle.  The distances are floats and the path types
+ * bytes, both in one allocation, which needs 5 bytes per pair instead of
+ * the 20 bytes of two full n*n matrices of double and unsigned short.
+ * The pairs (u,v) with v>u for one u are adjacent, so the all pairs loops
+ * read them as rows.
+ */
+class PairMatrices
+{
+    public:
+        PairMatrices()
+            : n(0), 
+              pairCount(0)
+        {
+        }
+
+        // Allocates the matrices for n nodes with all entries zero.
+        void resize(unsigned nodeCount)
+        {
+            n = nodeCount;
+            pairCount = (size_t)n * (n - (n > 0)) / 2;
+            // the path types follow the distances in the same allocation
+            storage.assign(pairCount + (pairCount + sizeof(float) - 1) 
+                    / sizeof(float), 0.0f);
+        }
+        unsigned size(void) const
+        {
+            return n;
+        }
+        // Index of the pair in the packed triangle, u and v must differ.
+        size_t index(unsigned u, unsigned v) const
+        {
+            COLA_ASSERT(u != v && u < n && v < n);
+            if (u > v)
+            {
+                std::swap(u, v);
+            }
+            return rowOffset(u) + (v - u - 1);
+        }
+        // Offset of the pair (u,u+1), the first pair of row u.
+        size_t rowOffset(unsigned u) const
+        {
+            return (size_t)u * (2 * (size_t)n - u - 1) / 2;
+        }
+        double distance(unsigned u, unsigned v) const
+        {
+            return storage[index(u, v)];
+        }
+        unsigned short pathType(unsigned u, unsigned v) const
+        {
+            return pathTypes()[index(u, v)];
+        }
+        void setDistance(unsigned u, unsigned v, double d)
+        {
+            storage[index(u, v)] = (float)d;
+        }
+        void setPathType(unsigned u, unsigned v, unsigned short p)
+        {
+            pathTypes()[index(u, v)] = (unsigned char)p;
+        }
+        // The distances and path types of the pairs (u,v) with v>u,
+        // entry v-u-1 belongs to v.
+        const float *distanceRow(unsigned u) const
+        {
+            return storage.data() + rowOffset(u);
+        }
+        const unsigned char *pathTypeRow(unsigned u) const
+        {
+            return pathTypes() + rowOffset(u);
+        }
+
+    private:
+        const unsigned char *pathTypes(void) const
+        {
+            return reinterpret_cast<const unsigned char *>(
+                    storage.data() + pairCount);
+        }
+        unsigned char *pathTypes(void)
+        {
+            return reinterpret_cast<unsigned char *>(
+                    storage.data() + pairCount);
+        }
+
+        unsigned n;
+        size_t pairCount;
+        std::vector<float> storage;
+};
+
 /**
  * @brief  Interface for writing COLA addons to handle topology preserving 
  *         layout.
@@ -562,9 +653,9 @@ class TopologyAddonInterface
             COLA_UNUSED(boundingBoxes);
             COLA_UNUSED(clusterHierarchy);
         }
-        virtual void computePathLengths(unsigned short** G)
+        virtual void computePathLengths(PairMatrices& pairs)
         {
-            COLA_UNUSED(G);
+            COLA_UNUSED(pairs);
         }
         virtual double computeStress(void) const
         {
@@ -682,6 +773,35 @@ public:
      */
     void runOnce(bool x=true, bool y=true);
 
+    /**
+     * @brief  Prepares a layout run that is advanced by runStep().
+     *
+     * run() is the same as calling beginRun(), runStep() until it returns
+     * true and endRun().  This allows the caller to spread the iterations
+     * of a layout over several calls, e.g., from an event loop.  The 
+     * layout must not be changed between beginRun() and endRun().
+     *
+     * @param[in] x  If true, layout will be performed in x-dimension
+     *               (default: true).
+     * @param[in] y  If true, layout will be performed in y-dimension
+     *               (default: true).
+     */
+    void beginRun(bool x=true, bool y=true);
+
+    /**
+     * @brief  Applies one iteration of a run started with beginRun().
+     *
+     * @return  True if the layout has converged and endRun() should be
+     *          called.
+     */
+    bool runStep(void);
+
+    /**
+     * @brief  Frees the temporary constraints and variables of a run 
+     *         started with beginRun().
+     */
+    void endRun(void);
+
     /**
      * @brief  Specify a set of compound constraints to apply to the layout.
      *
@@ -819,6 +939,30 @@ public:
      */
     void setUseNeighbourStress(bool useNeighbourStress);
 
+    /**
+     * @brief  Specifies in which iterations the convergence test is run.
+     *
+     * The test needs the stress, which is a pass over all pairs of nodes.
+     * With an interval of k the stress is only computed and tested in
+     * every k-th iteration of a run and the iteration before it, and in
+     * the iterations that move the nodes less than displacementTolerance
+     * times the ideal edge length on average.  The other iterations only
+     * sum up the displacement of the nodes, which is a pass over the
+     * nodes.  If the last computed stress is older than the previous
+     * iteration, the test is given its average decrease per iteration.
+     * A run ends after the maximum iterations of the convergence test
+     * even if the test was not run in every iteration.
+     *
+     * Default value is an interval of 1, testing every iteration.
+     *
+     * @param[in] interval  The number of iterations between two tests.
+     * @param[in] displacementTolerance  The average displacement relative
+     *                                   to the ideal edge length below
+     *                                   which an iteration is tested.
+     */
+    void setStressTestInterval(unsigned interval,
+            double displacementTolerance = 1e-3);
+
     /**
      * @brief  Retrieve a copy of the "D matrix" computed by the computePathLengths
      * method, linearised as a vector.
@@ -862,13 +1006,13 @@ private:
     unsigned n; // number of nodes
     std::valarray<double> X, Y;
     vpsc::Rectangles boundingBoxes;
-    double applyForcesAndConstraints(const vpsc::Dim dim,const double oldStress);
+    void applyForcesAndConstraints(const vpsc::Dim dim,const double oldStress);
     double computeStepSize(const SparseMatrix& H, const std::valarray<double>& g,
             const std::valarray<double>& d) const;
     void computeDescentVectorOnBothAxes(const bool xaxis, const bool yaxis,
             double stress, std::valarray<double>& x0, std::valarray<double>& x1);
     void moveTo(const vpsc::Dim dim, std::valarray<double>& target);
-    double applyDescentVector(
+    void applyDescentVector(
             const std::valarray<double>& d,
             const std::valarray<double>& oldCoords,
             std::valarray<double> &coords, 
@@ -885,6 +1029,22 @@ private:
     bool noForces(double, double, unsigned) const;
     void computeForces(const vpsc::Dim dim, SparseMap &H, 
             std::valarray<double> &g);
+    // The all pairs loops of computeForces and computeStress are compiled
+    // for every combination of the options they depend on.  selectKernels()
+    // picks the variants whenever an option changes, so the loops of a run
+    // contain no checks of the options.
+    template <bool neighbourStress, bool horizontal>
+    void computePairForces(SparseMap &H, std::valarray<double> &g);
+    template <bool neighbourStress, bool horizontal>
+    void computePairForcesTile(unsigned tileStart, unsigned tileEnd,
+            const float *tileDistances, const unsigned char *tilePathTypes,
+            SparseMap &H, std::valarray<double> &g);
+    template <bool neighbourStress>
+    double computePairStress(void) const;
+    void selectKernels(void);
+    typedef void (ConstrainedFDLayout::*PairForcesKernel)(SparseMap &,
+            std::valarray<double> &);
+    typedef double (ConstrainedFDLayout::*PairStressKernel)(void) const;
     void recGenerateClusterVariablesAndConstraints(
             vpsc::Variables (&vars)[2], unsigned int& priority, 
             cola::NonOverlapConstraints *noc, Cluster *cluster, 
@@ -898,8 +1058,8 @@ private:
     bool using_default_done; // Whether we allocated a default TestConvergence object.
     PreIteration* preIteration;
     cola::CompoundConstraints ccs;
-    double** D;
-    unsigned short** G;
+    // The D and G matrices, see computePathLengths().
+    PairMatrices pairs;
     double minD;
     PseudoRandom random;
 
@@ -915,9 +1075,26 @@ private:
     bool m_generateNonOverlapConstraints;
     bool m_useNeighbourStress;
     const std::valarray<double> m_edge_lengths;
-
     NonOverlapConstraintExemptions *m_nonoverlap_exemptions;
 
+    // Kernels chosen by selectKernels(), forces indexed by vpsc::Dim.
+    PairForcesKernel m_pairForcesKernels[2];
+    PairStressKernel m_pairStressKernel;
+    // Whether the topology addon is the no-op TopologyAddonInterface.
+    bool m_defaultTopologyAddon;
+
+    // Options of setStressTestInterval().
+    unsigned m_stressTestInterval;
+    double m_displacementTolerance;
+
+    // State of a run advanced by runStep().
+    vpsc::Variables m_run_vs[2];
+    double m_run_stress = 0;
+    bool m_run_x_axis = true;
+    bool m_run_y_axis = true;
+    unsigned m_run_iterations = 0;
+    unsigned m_run_stress_iteration = 0;
+
     friend class topology::ColaTopologyAddon;
     friend class dialect::Graph;
 };
@@ -27,6 +27,7 @@
 #include <vector>
 #include <cmath>
 #include <limits>
+#include <typeinfo>
 
 #include "libvpsc/solve_VPSC.h"
 #include "libvpsc/variable.h"
@@ -121,8 +122,12 @@ ConstrainedFDLayout::ConstrainedFDLayout(const vpsc::Rectangles& rs,
     , m_useNeighbourStress(false)
     , m_edge_lengths(eLengths.data(), eLengths.size())
     , m_nonoverlap_exemptions(new NonOverlapConstraintExemptions())
+    , m_defaultTopologyAddon(true)
+    , m_stressTestInterval(1)
+    , m_displacementTolerance(1e-3)
 {
     minD = DBL_MAX;
+    selectKernels();
 
     if(done == nullptr)
     {
@@ -143,14 +148,6 @@ ConstrainedFDLayout::ConstrainedFDLayout(const vpsc::Rectangles& rs,
         Y[i] = (*ri)->getCentreY();
         FILE_LOG(logDEBUG) << *ri;
     }
-    D = new double*[n];
-    G = new unsigned short*[n];
-    for(unsigned i = 0; i < n; i++)
-    {
-        D[i] = new double[n];
-        G[i] = new unsigned short[n];
-    }
-
     computePathLengths(es, m_edge_lengths);
 }
 
@@ -162,7 +159,19 @@ std::vector<double> ConstrainedFDLayout::readLinearD(void)
     {
         for(unsigned j = 0; j < n; ++j)
         {
-            d[n * i + j] = D[i][j];
+            if(i == j)
+            {
+                d[n * i + j] = 0;
+            }
+            else if(pairs.pathType(i, j) == 0)
+            {
+                // i and j are in disconnected subgraphs
+                d[n * i + j] = DBL_MAX;
+            }
+            else
+            {
+                d[n * i + j] = pairs.distance(i, j);
+            }
         }
     }
     return d;
@@ -176,7 +185,7 @@ std::vector<unsigned> ConstrainedFDLayout::readLinearG(void)
     {
         for(unsigned j = 0; j < n; ++j)
         {
-            g[n * i + j] = G[i][j];
+            g[n * i + j] = i == j ? 0 : pairs.pathType(i, j);
         }
     }
     return g;
@@ -217,6 +226,14 @@ void ConstrainedFDLayout::setAvoidNodeOverlaps(bool avoidOverlaps,
 void ConstrainedFDLayout::setUseNeighbourStress(bool useNeighbourStress)
 {
     m_useNeighbourStress = useNeighbourStress;
+    selectKernels();
+}
+
+void ConstrainedFDLayout::setStressTestInterval(unsigned interval,
+    double displacementTolerance)
+{
+    m_stressTestInterval = std::max(interval, 1u);
+    m_displacementTolerance = displacementTolerance;
 }
 
 void ConstrainedFDLayout::setDesiredPositions(DesiredPositions* desiredPositions)
@@ -254,31 +271,36 @@ void ConstrainedFDLayout::computePathLengths(
         }
     }
 
-    shortest_paths::johnsons(n, D, es, eLengths);
-    // dumpSquareMatrix<double>(n,D);
+    // The shortest paths are computed one source at a time, so only the
+    // packed triangle is ever held for all pairs.
+    pairs.resize(n);
+    std::vector<shortest_paths::Node<double>> vs(n);
+    shortest_paths::dijkstra_init(vs, es, eLengths);
+    std::vector<double> pathLengths(n);
     for(unsigned i = 0; i < n; i++)
     {
-        for(unsigned j = 0; j < n; j++)
+        shortest_paths::dijkstra(i, vs, pathLengths.data());
+        for(unsigned j = i + 1; j < n; j++)
         {
-            if(i == j)
-                continue;
-            double& d = D[i][j];
-            unsigned short& p = G[i][j];
-            p = 2;
+            double d = pathLengths[j];
+            unsigned short p = 2;
             if(d == DBL_MAX)
             {
-                // i and j are in disconnected subgraphs
+                // i and j are in disconnected subgraphs, the distance
+                // is never read for them
                 p = 0;
+                d = FLT_MAX;
             }
             else
             {
                 d *= m_idealEdgeLength;
+                if((d > 0) && (d < minD))
+                {
+                    minD = d;
+                }
             }
-
-            if((d > 0) && (d < minD))
-            {
-                minD = d;
-            }
+            pairs.setDistance(i, j, d);
+            pairs.setPathType(i, j, p);
         }
     }
     if(minD == DBL_MAX)
@@ -287,10 +309,12 @@ void ConstrainedFDLayout::computePathLengths(
     for(vector<Edge>::const_iterator e = es.begin(); e != es.end(); ++e)
     {
         unsigned u = e->first, v = e->second;
-        G[u][v] = G[v][u] = 1;
+        if(u != v)
+        {
+            pairs.setPathType(u, v, 1);
+        }
     }
-    topologyAddon->computePathLengths(G);
-    // dumpSquareMatrix<short>(n,G);
+    topologyAddon->computePathLengths(pairs);
 }
 
 typedef valarray<double> Position;
@@ -344,59 +368,117 @@ void ConstrainedFDLayout::computeDescentVectorOnBothAxes(
  * positions.
  */
 void ConstrainedFDLayout::run(const bool xAxis, const bool yAxis)
+{
+    beginRun(xAxis, yAxis);
+    while(!runStep())
+    {
+    }
+    endRun();
+}
+
+void ConstrainedFDLayout::beginRun(const bool xAxis, const bool yAxis)
 {
     // This generates constraints for non-overlap inside and outside
     // of clusters.  To assign correct variable indexes it requires
     // that vs[] contains elements equal to the number of rectangles.
-    vpsc::Variables vs[2];
-    vs[0].resize(n);
-    vs[1].resize(n);
-    generateNonOverlapAndClusterCompoundConstraints(vs);
+    m_run_vs[0].clear();
+    m_run_vs[1].clear();
+    m_run_vs[0].resize(n);
+    m_run_vs[1].resize(n);
+    generateNonOverlapAndClusterCompoundConstraints(m_run_vs);
 
     FILE_LOG(logDEBUG) << "ConstrainedFDLayout::run...";
-    double stress = DBL_MAX;
-    do
+    m_run_stress = DBL_MAX;
+    m_run_x_axis = xAxis;
+    m_run_y_axis = yAxis;
+    m_run_iterations = 0;
+    m_run_stress_iteration = 0;
+}
+
+bool ConstrainedFDLayout::runStep(void)
+{
+    double& stress = m_run_stress;
+    const bool xAxis = m_run_x_axis;
+    const bool yAxis = m_run_y_axis;
+
+    if(preIteration)
     {
-        if(preIteration)
+        if(!(*preIteration)())
         {
-            if(!(*preIteration)())
-            {
-                break;
-            }
-            // printf("preIteration->changed=%d\n",preIteration->changed);
-            if(preIteration->changed)
-            {
-                stress = DBL_MAX;
-            }
-            if(preIteration->resizes.size() > 0)
-            {
-                FILE_LOG(logDEBUG) << " Resize event!";
-                handleResizes(preIteration->resizes);
-            }
+            return true;
         }
-        unsigned N = 2 * n;
-        Position x0(N), x1(N);
-        getPosition(X, Y, x0);
-        if(rungekutta)
+        // printf("preIteration->changed=%d\n",preIteration->changed);
+        if(preIteration->changed)
         {
-            Position a(N), b(N), c(N), d(N), ia(N), ib(N);
-            computeDescentVectorOnBothAxes(xAxis, yAxis, stress, x0, a);
-            ia = x0 + (a - x0) / 2.0;
-            computeDescentVectorOnBothAxes(xAxis, yAxis, stress, ia, b);
-            ib = x0 + (b - x0) / 2.0;
-            computeDescentVectorOnBothAxes(xAxis, yAxis, stress, ib, c);
-            computeDescentVectorOnBothAxes(xAxis, yAxis, stress, c, d);
-            x1 = a + 2.0 * b + 2.0 * c + d;
-            x1 /= 6.0;
+            stress = DBL_MAX;
         }
-        else
+        if(preIteration->resizes.size() > 0)
         {
-            computeDescentVectorOnBothAxes(xAxis, yAxis, stress, x0, x1);
+            FILE_LOG(logDEBUG) << " Resize event!";
+            handleResizes(preIteration->resizes);
         }
-        setPosition(x1);
-        stress = computeStress();
-        FILE_LOG(logDEBUG) << "stress=" << stress;
-    } while(!(*done)(stress, X, Y));
+    }
+    unsigned N = 2 * n;
+    Position x0(N), x1(N);
+    getPosition(X, Y, x0);
+    if(rungekutta)
+    {
+        Position a(N), b(N), c(N), d(N), ia(N), ib(N);
+        computeDescentVectorOnBothAxes(xAxis, yAxis, stress, x0, a);
+        ia = x0 + (a - x0) / 2.0;
+        computeDescentVectorOnBothAxes(xAxis, yAxis, stress, ia, b);
+        ib = x0 + (b - x0) / 2.0;
+        computeDescentVectorOnBothAxes(xAxis, yAxis, stress, ib, c);
+        computeDescentVectorOnBothAxes(xAxis, yAxis, stress, c, d);
+        x1 = a + 2.0 * b + 2.0 * c + d;
+        x1 /= 6.0;
+    }
+    else
+    {
+        computeDescentVectorOnBothAxes(xAxis, yAxis, stress, x0, x1);
+    }
+    setPosition(x1);
+    m_run_iterations++;
+
+    // Between the tested iterations only the displacement is checked,
+    // an iteration that barely moves the nodes may have converged.
+    const unsigned interval = m_stressTestInterval;
+    const bool scheduledTest = interval <= 1
+        || m_run_iterations % interval == 0
+        || (m_run_iterations + 1) % interval == 0;
+    if(!scheduledTest)
+    {
+        double displacement = 0;
+        for(unsigned i = 0; i < n; ++i)
+        {
+            double dx = X[i] - x0[i], dy = Y[i] - x0[i + n];
+            displacement += dx * dx + dy * dy;
+        }
+        double tolerance = m_displacementTolerance * m_idealEdgeLength;
+        if(displacement > tolerance * tolerance * n)
+        {
+            return m_run_iterations > done->maxiterations;
+        }
+    }
+    const double lastStress = stress;
+    const unsigned stressAge = m_run_iterations - m_run_stress_iteration;
+    stress = computeStress();
+    m_run_stress_iteration = m_run_iterations;
+    FILE_LOG(logDEBUG) << "stress=" << stress;
+
+    // The last computed stress can be several iterations old.  The test
+    // compares consecutive iterations, so it gets the average decrease
+    // per iteration since then instead of the whole decrease.
+    if(stressAge > 1 && lastStress != DBL_MAX)
+    {
+        done->old_stress = stress + (lastStress - stress) / stressAge;
+    }
+
+    return (*done)(stress, X, Y) || (interval > 1 && m_run_iterations > done->maxiterations);
+}
+
+void ConstrainedFDLayout::endRun(void)
+{
     for(unsigned i = 0; i < n; i++)
     {
         vpsc::Rectangle* r = boundingBoxes[i];
@@ -411,10 +493,11 @@ void ConstrainedFDLayout::run(const bool xAxis, const bool yAxis)
     // Free extra variables used for cluster containment.
     for(size_t dim = 0; dim < 2; ++dim)
     {
-        for(size_t i = n; i < vs[dim].size(); ++i)
+        for(size_t i = n; i < m_run_vs[dim].size(); ++i)
         {
-            delete vs[dim][i];
+            delete m_run_vs[dim][i];
         }
+        m_run_vs[dim].clear();
     }
 }
 
@@ -943,13 +1026,6 @@ ConstrainedFDLayout::~ConstrainedFDLayout()
         delete done;
     }
 
-    for(unsigned i = 0; i < n; ++i)
-    {
-        delete[] G[i];
-        delete[] D[i];
-    }
-    delete[] G;
-    delete[] D;
     delete topologyAddon;
     delete m_nonoverlap_exemptions;
 }
@@ -988,6 +1064,7 @@ void ConstrainedFDLayout::setTopology(TopologyAddonInterface* newTopology)
     COLA_ASSERT(topologyAddon);
     delete topologyAddon;
     topologyAddon = newTopology->clone();
+    m_defaultTopologyAddon = typeid(*topologyAddon) == typeid(TopologyAddonInterface);
 }
 
 TopologyAddonInterface* ConstrainedFDLayout::getTopology(void)
@@ -1157,7 +1234,7 @@ void ConstrainedFDLayout::moveTo(const vpsc::Dim dim, Position& target)
  * little as possible.  If "meta-constraints" such as avoidOverlaps or edge
  * straightening are required then dummy variables will be generated.
  */
-double ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const double oldStress)
+void ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const double oldStress)
 {
     FILE_LOG(logDEBUG) << "ConstrainedFDLayout::applyForcesAndConstraints(): dim=" << dim;
     valarray<double> g(n);
@@ -1176,12 +1253,11 @@ double ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const
     }
     vpsc::Variables vs;
     vpsc::Constraints cs;
-    double stress;
     setupVarsAndConstraints(n, ccs, dim, boundingBoxes, clusterHierarchy, vs, cs, coords);
 
     if(topologyAddon->useTopologySolver())
     {
-        stress = topologyAddon->applyForcesAndConstraints(this, dim, g, vs, cs, coords, des, oldStress);
+        topologyAddon->applyForcesAndConstraints(this, dim, g, vs, cs, coords, des, oldStress);
     }
     else
     {
@@ -1200,7 +1276,7 @@ double ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const
         double stepsize = computeStepSize(H, g, d);
         stepsize = max(0., min(stepsize, 1.));
         // printf(" dim=%d beta: ",dim);
-        stress = applyDescentVector(d, oldCoords, coords, oldStress, stepsize);
+        applyDescentVector(d, oldCoords, coords, oldStress, stepsize);
         moveBoundingBoxes();
     }
     updateCompoundConstraints(dim, ccs);
@@ -1208,7 +1284,7 @@ double ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const
     {
         checkUnsatisfiable(cs, unsatisfiable[dim]);
     }
-    FILE_LOG(logDEBUG) << "ConstrainedFDLayout::applyForcesAndConstraints... done, stress=" << stress;
+    FILE_LOG(logDEBUG) << "ConstrainedFDLayout::applyForcesAndConstraints... done";
     if(clusterHierarchy)
     {
         clusterHierarchy->computeVarRect(vs, dim);
@@ -1217,19 +1293,18 @@ double ConstrainedFDLayout::applyForcesAndConstraints(const vpsc::Dim dim, const
 
     for_each(vs.begin(), vs.end(), delete_object());
     for_each(cs.begin(), cs.end(), delete_object());
-    return stress;
 }
 /*
- * Attempts to set coords=oldCoords-stepsize*d.  If this does not reduce
- * the stress from oldStress then stepsize is halved.  This is repeated
- * until stepsize falls below a threshhold.
+ * Sets coords=oldCoords-stepsize*d unless stepsize is below a threshhold.
+ * The stress of the new position is not computed, the convergence test
+ * of runStep() computes it once per iteration.
  * @param d is a descent vector (a movement vector intended to reduce the
  * stress)
  * @param oldCoords are the previous position vector
  * @param coords will hold the new position after applying d
  * @param stepsize is a scalar multiple of the d to apply
  */
-double ConstrainedFDLayout::applyDescentVector(
+void ConstrainedFDLayout::applyDescentVector(
     valarray<double> const& d,
     valarray<double> const& oldCoords,
     valarray<double>& coords,
@@ -1240,18 +1315,10 @@ double ConstrainedFDLayout::applyDescentVector(
 
     COLA_ASSERT(d.size() == oldCoords.size());
     COLA_ASSERT(d.size() == coords.size());
-    while(fabs(stepsize) > 0.00000000001)
+    if(fabs(stepsize) > 0.00000000001)
     {
         coords = oldCoords - stepsize * d;
-        double stress = computeStress();
-        // printf(" applyDV: oldstress=%f, stress=%f, stepsize=%f\n", oldStress,stress,stepsize);
-        // if(oldStress>=stress) {
-        return stress;
-        //}
-        coords = oldCoords;
-        stepsize *= 0.5;
-    }
-    return computeStress();
+    }
 }
 
 // Computes X and Y offsets for nodes that are at the same position.
@@ -1288,16 +1355,106 @@ void ConstrainedFDLayout::computeForces(
     if(n == 1)
         return;
     g = 0;
+    (this->*m_pairForcesKernels[dim])(H, g);
+    if(desiredPositions)
+    {
+        for(DesiredPositions::const_iterator p = desiredPositions->begin();
+            p != desiredPositions->end();
+            ++p)
+        {
+            unsigned i = p->id;
+            double d = (dim == vpsc::HORIZONTAL)
+                           ? p->x - X[i]
+                           : p->y - Y[i];
+            d *= p->weight;
+            g[i] -= d;
+            H(i, i) += p->weight;
+        }
+    }
+}
+
+void ConstrainedFDLayout::selectKernels(void)
+{
+    if(m_useNeighbourStress)
+    {
+        m_pairForcesKernels[vpsc::HORIZONTAL] = &ConstrainedFDLayout::computePairForces<true, true>;
+        m_pairForcesKernels[vpsc::VERTICAL] = &ConstrainedFDLayout::computePairForces<true, false>;
+        m_pairStressKernel = &ConstrainedFDLayout::computePairStress<true>;
+    }
+    else
+    {
+        m_pairForcesKernels[vpsc::HORIZONTAL] = &ConstrainedFDLayout::computePairForces<false, true>;
+        m_pairForcesKernels[vpsc::VERTICAL] = &ConstrainedFDLayout::computePairForces<false, false>;
+        m_pairStressKernel = &ConstrainedFDLayout::computePairStress<false>;
+    }
+}
+
+// Number of nodes whose full rows of D and G computePairForces unpacks at once.
+static const unsigned PAIR_TILE_SIZE = 32;
+
+/*
+ * The stress model part of computeForces for every pair of nodes.
+ * The packed triangles only hold the pairs (u,v) with v>u as rows, so the
+ * full rows of a tile of nodes are unpacked first.  The pairs (v,u) with
+ * v before the tile are then read as short runs of the row of v instead of
+ * one cache line per pair.
+ */
+template <bool neighbourStress, bool horizontal>
+void ConstrainedFDLayout::computePairForces(
+    SparseMap& H,
+    valarray<double>& g)
+{
+    const unsigned tileSize = std::min(PAIR_TILE_SIZE, n);
+    std::vector<float> tileDistances((size_t)tileSize * n);
+    std::vector<unsigned char> tilePathTypes((size_t)tileSize * n);
+    for(unsigned tileStart = 0; tileStart < n; tileStart += tileSize)
+    {
+        unsigned tileEnd = std::min(tileStart + tileSize, n);
+        for(unsigned v = 0; v < tileEnd; v++)
+        {
+            const float* distances = pairs.distanceRow(v);
+            const unsigned char* pathTypes = pairs.pathTypeRow(v);
+            for(unsigned u = std::max(tileStart, v + 1); u < tileEnd; u++)
+            {
+                size_t tileIdx = (size_t)(u - tileStart) * n + v;
+                tileDistances[tileIdx] = distances[u - v - 1];
+                tilePathTypes[tileIdx] = pathTypes[u - v - 1];
+            }
+        }
+        for(unsigned u = tileStart; u < tileEnd; u++)
+        {
+            size_t tileIdx = (size_t)(u - tileStart) * n + u + 1;
+            std::copy(pairs.distanceRow(u), pairs.distanceRow(u) + (n - u - 1),
+                tileDistances.begin() + tileIdx);
+            std::copy(pairs.pathTypeRow(u), pairs.pathTypeRow(u) + (n - u - 1),
+                tilePathTypes.begin() + tileIdx);
+        }
+        computePairForcesTile<neighbourStress, horizontal>(tileStart,
+            tileEnd, tileDistances.data(), tilePathTypes.data(), H, g);
+    }
+}
+
+template <bool neighbourStress, bool horizontal>
+void ConstrainedFDLayout::computePairForcesTile(
+    unsigned tileStart,
+    unsigned tileEnd,
+    const float* tileDistances,
+    const unsigned char* tilePathTypes,
+    SparseMap& H,
+    valarray<double>& g)
+{
     // for each node:
-    for(unsigned u = 0; u < n; u++)
+    for(unsigned u = tileStart; u < tileEnd; u++)
     {
+        const float* distances = tileDistances + (size_t)(u - tileStart) * n;
+        const unsigned char* pathTypes = tilePathTypes + (size_t)(u - tileStart) * n;
         // Stress model
         double Huu = 0;
         for(unsigned v = 0; v < n; v++)
         {
             if(u == v)
                 continue;
-            if(m_useNeighbourStress && neighbours[u][v] != 1)
+            if(neighbourStress && neighbours[u][v] != 1)
                 continue;
 
             // The following loop randomly displaces nodes that are at identical positions
@@ -1319,12 +1476,12 @@ void ConstrainedFDLayout::computeForces(
                 sd2 = rx * rx + ry * ry;
             }
 
-            unsigned short p = G[u][v];
+            unsigned short p = pathTypes[v];
             // no forces between disconnected parts of the graph
             if(p == 0)
                 continue;
             double l = sqrt(sd2);
-            double d = D[u][v];
+            double d = distances[v];
             if(l > d && p > 1)
                 continue; // attractive forces not required
             double d2 = d * d;
@@ -1333,28 +1490,13 @@ void ConstrainedFDLayout::computeForces(
             {
                 l = 0.1;
             }
-            double dx = dim == vpsc::HORIZONTAL ? rx : ry;
-            double dy = dim == vpsc::HORIZONTAL ? ry : rx;
+            double dx = horizontal ? rx : ry;
+            double dy = horizontal ? ry : rx;
             g[u] += dx * (l - d) / (d2 * l);
             Huu -= H(u, v) = (d * dy * dy / (l * l * l) - 1) / d2;
         }
         H(u, u) = Huu;
     }
-    if(desiredPositions)
-    {
-        for(DesiredPositions::const_iterator p = desiredPositions->begin();
-            p != desiredPositions->end();
-            ++p)
-        {
-            unsigned i = p->id;
-            double d = (dim == vpsc::HORIZONTAL)
-                           ? p->x - X[i]
-                           : p->y - Y[i];
-            d *= p->weight;
-            g[i] -= d;
-            H(i, i) += p->weight;
-        }
-    }
 }
 /*
  * Returns the optimal step-size in the direction d, given gradient g and
@@ -1386,29 +1528,7 @@ double ConstrainedFDLayout::computeStepSize(
 double ConstrainedFDLayout::computeStress() const
 {
     FILE_LOG(logDEBUG) << "ConstrainedFDLayout::computeStress()";
-    double stress = 0;
-    for(unsigned u = 0; (u + 1) < n; u++)
-    {
-        for(unsigned v = u + 1; v < n; v++)
-        {
-            if(m_useNeighbourStress && neighbours[u][v] != 1)
-                continue;
-            unsigned short p = G[u][v];
-            // no forces between disconnected parts of the graph
-            if(p == 0)
-                continue;
-            double rx = X[u] - X[v], ry = Y[u] - Y[v];
-            double l = sqrt(rx * rx + ry * ry);
-            double d = D[u][v];
-            if(l > d && p > 1)
-                continue; // no attractive forces required
-            double d2 = d * d;
-            double rl = d - l;
-            double s = rl * rl / d2;
-            stress += s;
-            FILE_LOG(logDEBUG2) << "s(" << u << "," << v << ")=" << s;
-        }
-    }
+    double stress = (this->*m_pairStressKernel)();
     if(preIteration)
     {
         if((*preIteration)())
@@ -1424,7 +1544,11 @@ double ConstrainedFDLayout::computeStress() const
             }
         }
     }
-    stress += topologyAddon->computeStress();
+    // the default addon adds no stress
+    if(!m_defaultTopologyAddon)
+    {
+        stress += topologyAddon->computeStress();
+    }
     if(desiredPositions)
     {
         for(DesiredPositions::const_iterator p = desiredPositions->begin();
@@ -1437,6 +1561,42 @@ double ConstrainedFDLayout::computeStress() const
     }
     return stress;
 }
+
+/*
+ * The stress of every pair of nodes, the part of computeStress that
+ * does not depend on preIteration, the topology or desired positions.
+ */
+template <bool neighbourStress>
+double ConstrainedFDLayout::computePairStress(void) const
+{
+    double stress = 0;
+    for(unsigned u = 0; (u + 1) < n; u++)
+    {
+        // the pairs of u with the later nodes are one row
+        const float* distances = pairs.distanceRow(u);
+        const unsigned char* pathTypes = pairs.pathTypeRow(u);
+        for(unsigned v = u + 1; v < n; v++)
+        {
+            if(neighbourStress && neighbours[u][v] != 1)
+                continue;
+            unsigned short p = pathTypes[v - u - 1];
+            // no forces between disconnected parts of the graph
+            if(p == 0)
+                continue;
+            double rx = X[u] - X[v], ry = Y[u] - Y[v];
+            double l = sqrt(rx * rx + ry * ry);
+            double d = distances[v - u - 1];
+            if(l > d && p > 1)
+                continue; // no attractive forces required
+            double d2 = d * d;
+            double rl = d - l;
+            double s = rl * rl / d2;
+            stress += s;
+            FILE_LOG(logDEBUG2) << "s(" << u << "," << v << ")=" << s;
+        }
+    }
+    return stress;
+}
 void ConstrainedFDLayout::moveBoundingBoxes()
 {
     for(unsigned i = 0; i < n; i++)
@@ -1539,7 +1699,7 @@ void ConstrainedFDLayout::outputInstanceToSVG(std::string instanceName)
     {
         for(size_t j = i + 1; j < n; ++j)
         {
-            if(G[i][j] == 1)
+            if(pairs.pathType(i, j) == 1)
             {
                 fprintf(fp, "    es.push_back(std::make_pair(%lu, %lu));\n", i, j);
             }
@@ -1614,7 +1774,7 @@ void ConstrainedFDLayout::outputInstanceToSVG(std::string instanceName)
     {
         for(size_t j = i + 1; j < n; ++j)
         {
-            if(G[i][j] == 1)
+            if(pairs.pathType(i, j) == 1)
             {
                 fprintf(fp, "<path d=\"M %g %g L %g %g\" "
                             "style=\"stroke-width: 1px; stroke: black;\" />\n",
@@ -100,7 +100,7 @@ void ColaTopologyAddon::handleResizes(const cola::Resizes& resizeList,
     FILE_LOG(cola::logDEBUG) << "ColaTopologyAddon::handleResizes()... done.";
 }
 
-void ColaTopologyAddon::computePathLengths(unsigned short** G)
+void ColaTopologyAddon::computePathLengths(cola::PairMatrices& pairs)
 {
     // we don't need to compute attractive forces between nodes connected
     // by an edge if there is a topologyRoute between them (since the
@@ -112,7 +112,7 @@ void ColaTopologyAddon::computePathLengths(unsigned short** G)
             if(!e->cycle()) {
                 unsigned u=e->firstSegment->start->node->id,
                          v=e->lastSegment->end->node->id;
-                G[u][v]=G[v][u]=2;
+                pairs.setPathType(u,v,2);
             }
         }
     }
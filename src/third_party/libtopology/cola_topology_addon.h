@@ -91,7 +91,7 @@ class ColaTopologyAddon : public cola::TopologyAddonInterface
                 cola::CompoundConstraints& ccs, 
                 vpsc::Rectangles& boundingBoxes,
                 cola::RootCluster* clusterHierarchy);
-        void computePathLengths(unsigned short** G);
+        void computePathLengths(cola::PairMatrices& pairs);
         double computeStress(void) const;
         bool useTopologySolver(void) const;
         void makeFeasible(bool generateNonOverlapConstraints, 
@@ -25,6 +25,11 @@
 #include <set>
 #include <list>
 #include <algorithm>
+#include <chrono>
+#include <map>
+#include <utility>
+#include <vector>
+#include <functional>
 
 #ifdef ORTHOG_TOPOLOGY_DEBUG
 #include <sstream>
@@ -53,6 +58,9 @@
 
 #define CONSTRAIN_CHECKPOINTS  false
 
+// The weight of the shapes and segments a conflict region must not move.
+#define PINNED_WEIGHT  1e6
+
 
 namespace topology {
 
@@ -88,15 +96,26 @@ class LayoutEdgeSegmentSeparation
     vpsc::Variable *var1;
     vpsc::Variable *var2;
     ConnRef *connRef;
+    // The route indexes of the two segments, so separations of the same
+    // distance are always tried in the same order.
+    size_t index1;
+    size_t index2;
 
     bool operator<(const LayoutEdgeSegmentSeparation& rhs) const
     {
-        COLA_ASSERT((var1 != rhs.var1) || (var2 != rhs.var2));
-        if (distance == rhs.distance)
+        if (distance != rhs.distance)
+        {
+            return distance < rhs.distance;
+        }
+        if (connRef->id() != rhs.connRef->id())
+        {
+            return connRef->id() < rhs.connRef->id();
+        }
+        if (index1 != rhs.index1)
         {
-            return (var1 < rhs.var1) || (var2 < rhs.var2);
+            return index1 < rhs.index1;
         }
-        return distance < rhs.distance;
+        return index2 < rhs.index2;
     }
 };
 typedef std::set<LayoutEdgeSegmentSeparation> LayoutEdgeSegmentSeparations;
@@ -544,6 +563,64 @@ static bool insideLayoutObstacleBounds(const Point& point,
 }
 
 
+// Orders the nodes of different objects by the ids of the shapes and
+// connectors rather than by their addresses, so the sweep and with it the
+// improvement is the same from run to run.
+static int compareLayoutNodeObjects(const Node *u, const Node *v)
+{
+    const LayoutEdgeSegment *segmentU =
+            dynamic_cast<const LayoutEdgeSegment *> (u->ss);
+    const LayoutEdgeSegment *segmentV =
+            dynamic_cast<const LayoutEdgeSegment *> (v->ss);
+    if (!segmentU != !segmentV)
+    {
+        return (segmentU) ? 1 : -1;
+    }
+    if (segmentU)
+    {
+        if (segmentU->connRef->id() != segmentV->connRef->id())
+        {
+            return (segmentU->connRef->id() < segmentV->connRef->id()) ? -1 : 1;
+        }
+        if (segmentU->indexes.front() != segmentV->indexes.front())
+        {
+            return (segmentU->indexes.front() < segmentV->indexes.front()) ?
+                    -1 : 1;
+        }
+    }
+    else if (u->v && v->v && (u->v->id() != v->v->id()))
+    {
+        return (u->v->id() < v->v->id()) ? -1 : 1;
+    }
+
+    const LayoutNode *layoutNodeU = dynamic_cast<const LayoutNode *> (u);
+    const LayoutNode *layoutNodeV = dynamic_cast<const LayoutNode *> (v);
+    int sideU = (layoutNodeU) ? layoutNodeU->side : 0;
+    int sideV = (layoutNodeV) ? layoutNodeV->side : 0;
+    if (sideU != sideV)
+    {
+        return (sideU < sideV) ? -1 : 1;
+    }
+    return (u < v) ? -1 : ((u > v) ? 1 : 0);
+}
+
+static int compareLayoutEvents(const void *a, const void *b)
+{
+    Event *ea = *(Event**) a;
+    Event *eb = *(Event**) b;
+    if (ea->pos != eb->pos)
+    {
+        return (ea->pos < eb->pos) ? -1 : 1;
+    }
+    if (ea->type != eb->type)
+    {
+        return ea->type - eb->type;
+    }
+    COLA_ASSERT(ea->v != eb->v);
+    return compareLayoutNodeObjects(ea->v, eb->v);
+}
+
+
 // When processing the scanline, it may be possible that shapes share edges,
 // or a connector segment shares a position with a shape edge.  Thus, we
 // order objects in the scanline list so that shape right sides come before
@@ -557,12 +634,6 @@ struct LayoutScanlineCmpNodePos
             return u->pos < v->pos;
         }
 
-        // Use the pointers to the base objects to differentiate them.
-        void *up = (u->v) ? (void *) u->v :
-                ((u->c) ? (void *) u->c : (void *) u->ss);
-        void *vp = (v->v) ? (void *) v->v :
-                ((v->c) ? (void *) v->c : (void *) v->ss);
-
         const LayoutNode *layoutNodeU = dynamic_cast<const LayoutNode *> (u);
         const LayoutNode *layoutNodeV = dynamic_cast<const LayoutNode *> (v);
 
@@ -575,7 +646,8 @@ struct LayoutScanlineCmpNodePos
             return valU < valV;
         }
 
-        return up < vp;
+        // Use the base objects to differentiate them.
+        return compareLayoutNodeObjects(u, v) < 0;
     }
 };
 
@@ -914,6 +986,8 @@ static void processLayoutConstraintEvent(LayoutScanlineNodeSet& scanline,
                 newLess.var1 = les->variable;
                 newLess.var2 = otherLes->variable;
                 newLess.connRef = les->connRef;
+                newLess.index1 = les->indexes.front();
+                newLess.index2 = otherLes->indexes.front();
                 if (newLess.distance < moveLimit)
                 {
                     less.insert(newLess);
@@ -969,10 +1043,546 @@ class EndpointAnchorInMoveDir
 typedef std::list<EndpointAnchorInMoveDir> EndpointAnchorList;
 
 
+// Caps the number of separations that are tried and the time spent on them.
+class ImprovementBudget
+{
+    public:
+        ImprovementBudget(unsigned int maxIterations, double maxSeconds)
+            : m_max_iterations(maxIterations),
+              m_iterations(0),
+              m_has_deadline(maxSeconds > 0),
+              m_deadline(std::chrono::steady_clock::now() +
+                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                          std::chrono::duration<double>(maxSeconds)))
+        {
+        }
+        bool exhausted(void) const
+        {
+            if ((m_max_iterations > 0) && (m_iterations >= m_max_iterations))
+            {
+                return true;
+            }
+            return m_has_deadline &&
+                    (std::chrono::steady_clock::now() >= m_deadline);
+        }
+        void consume(void)
+        {
+            ++m_iterations;
+        }
+    private:
+        unsigned int m_max_iterations;
+        unsigned int m_iterations;
+        bool m_has_deadline;
+        std::chrono::steady_clock::time_point m_deadline;
+};
+
+typedef std::set<ConnRef *> ConnRefSet;
+typedef std::pair<long, long> GridCell;
+
+// An axis aligned piece of a connector route used for conflict detection.
+struct ConflictSegment
+{
+    ConnRef *connRef;
+    Point low;
+    Point high;
+    size_t dim;  // The dimension the segment has a constant position in.
+};
+
+static GridCell gridCellFor(const Point& point, const double cellSize)
+{
+    return GridCell(static_cast<long>(floor(point.x / cellSize)),
+            static_cast<long>(floor(point.y / cellSize)));
+}
+
+static bool segmentsConflict(const ConflictSegment& lhs,
+        const ConflictSegment& rhs)
+{
+    if (lhs.dim == rhs.dim)
+    {
+        // Parallel segments only conflict when they overlap on the
+        // same position.
+        const size_t altDim = (lhs.dim + 1) % 2;
+        return (lhs.low[lhs.dim] == rhs.low[rhs.dim]) &&
+                (std::min(lhs.high[altDim], rhs.high[altDim]) >
+                 std::max(lhs.low[altDim], rhs.low[altDim]));
+    }
+
+    // Perpendicular segments conflict when they cross inside both.
+    const ConflictSegment& fixedX = (lhs.dim == XDIM) ? lhs : rhs;
+    const ConflictSegment& fixedY = (lhs.dim == XDIM) ? rhs : lhs;
+    return (fixedX.low.x > fixedY.low.x) && (fixedX.low.x < fixedY.high.x) &&
+            (fixedY.low.y > fixedX.low.y) && (fixedY.low.y < fixedX.high.y);
+}
+
+static bool segmentPassesThroughObstacle(const ConflictSegment& segment,
+        const Box& box)
+{
+    const size_t altDim = (segment.dim + 1) % 2;
+    const double pos = segment.low[segment.dim];
+    return (pos > box.min[segment.dim]) && (pos < box.max[segment.dim]) &&
+            (segment.low[altDim] < box.max[altDim]) &&
+            (segment.high[altDim] > box.min[altDim]);
+}
+
+// The connectors a conflict region may move, the ones passing through it
+// that the moved segments have to keep their distance to, the shapes in it
+// and the ones of them it may move.
+struct ConflictRegion
+{
+    ConnRefSet activeConnectors;
+    ConnRefSet fixedConnectors;
+    ObstacleList obstacles;
+    std::set<Obstacle *> movableObstacles;
+    Box bounds;
+};
+typedef std::vector<ConflictRegion> ConflictRegions;
+
+static LayoutObstacle layoutObstacleFor(Obstacle *obstacle, const size_t dim)
+{
+    ShapeRef *shape = dynamic_cast<ShapeRef *> (obstacle);
+    JunctionRef *junction = dynamic_cast<JunctionRef *> (obstacle);
+    if (shape)
+    {
+        return LayoutObstacle(shape, dim);
+    }
+    else if (junction)
+    {
+        return LayoutObstacle(junction, dim);
+    }
+    return LayoutObstacle();
+}
+
+static bool overlapsRegion(const Point& min, const Point& max,
+        const Box& bounds)
+{
+    return (max.x >= bounds.min.x) && (min.x <= bounds.max.x) &&
+            (max.y >= bounds.min.y) && (min.y <= bounds.max.y);
+}
+
+static size_t findRegionRoot(std::vector<size_t>& parents, size_t region)
+{
+    while (parents[region] != region)
+    {
+        parents[region] = parents[parents[region]];
+        region = parents[region];
+    }
+    return region;
+}
+
+static void mergeConflictRegion(ConflictRegion& region,
+        const ConflictRegion& other)
+{
+    region.activeConnectors.insert(other.activeConnectors.begin(),
+            other.activeConnectors.end());
+    region.fixedConnectors.insert(other.fixedConnectors.begin(),
+            other.fixedConnectors.end());
+    for (ConnRefSet::const_iterator conn = region.activeConnectors.begin();
+            conn != region.activeConnectors.end(); ++conn)
+    {
+        region.fixedConnectors.erase(*conn);
+    }
+    for (size_t dim = 0; dim < 2; ++dim)
+    {
+        region.bounds.min[dim] = std::min(region.bounds.min[dim],
+                other.bounds.min[dim]);
+        region.bounds.max[dim] = std::max(region.bounds.max[dim],
+                other.bounds.max[dim]);
+    }
+}
+
+// Finds the places where connectors cross or overlap each other or pass
+// through shapes.  The routes are bucketed into a grid so only segments
+// sharing a cell are compared.  The conflicting cells grown by a halo of
+// one cell are split into connected regions.  Regions that share a
+// connector, overlap another region or share a shape with it are merged, so
+// the remaining regions never read or write the same connectors and shapes.
+// The other connectors passing through a region are kept as fixed segments.  A
+// region may move its shapes if the connectors ending in them are all moved
+// by the region too.
+static ConflictRegions findConflictRegions(Router *router,
+        const double cellSize, const bool shapesMovable)
+{
+    std::vector<ConflictSegment> segments;
+    std::map<GridCell, std::vector<size_t> > cellSegments;
+    std::map<ConnRef *, std::vector<size_t> > connSegments;
+
+    for (ConnRefList::const_iterator curr = router->connRefs.begin();
+            curr != router->connRefs.end(); ++curr)
+    {
+        if ((*curr)->routingType() != ConnType_Orthogonal)
+        {
+            continue;
+        }
+        // This also creates the display routes before the regions are
+        // solved, so the solvers only read the routes of other regions.
+        const Polygon& route = (*curr)->displayRoute();
+        for (size_t i = 1; i < route.size(); ++i)
+        {
+            ConflictSegment segment;
+            segment.connRef = *curr;
+            segment.dim = (route.ps[i - 1].x == route.ps[i].x) ? XDIM : YDIM;
+            const size_t altDim = (segment.dim + 1) % 2;
+            const bool ordered = route.ps[i - 1][altDim] <= route.ps[i][altDim];
+            segment.low = ordered ? route.ps[i - 1] : route.ps[i];
+            segment.high = ordered ? route.ps[i] : route.ps[i - 1];
+
+            const size_t index = segments.size();
+            segments.push_back(segment);
+            connSegments[*curr].push_back(index);
+
+            const GridCell lowCell = gridCellFor(segment.low, cellSize);
+            const GridCell highCell = gridCellFor(segment.high, cellSize);
+            for (long x = lowCell.first; x <= highCell.first; ++x)
+            {
+                for (long y = lowCell.second; y <= highCell.second; ++y)
+                {
+                    cellSegments[GridCell(x, y)].push_back(index);
+                }
+            }
+        }
+    }
+
+    std::set<GridCell> conflictCells;
+    for (std::map<GridCell, std::vector<size_t> >::const_iterator cell =
+            cellSegments.begin(); cell != cellSegments.end(); ++cell)
+    {
+        const std::vector<size_t>& indexes = cell->second;
+        for (size_t i = 0; i < indexes.size(); ++i)
+        {
+            for (size_t j = i + 1; j < indexes.size(); ++j)
+            {
+                const ConflictSegment& lhs = segments[indexes[i]];
+                const ConflictSegment& rhs = segments[indexes[j]];
+                if ((lhs.connRef != rhs.connRef) &&
+                        segmentsConflict(lhs, rhs))
+                {
+                    conflictCells.insert(cell->first);
+                }
+            }
+        }
+    }
+
+    // Segments running through shapes other than the ones they are
+    // attached to.
+    for (ObstacleList::const_iterator obstacleIt = router->m_obstacles.begin();
+            obstacleIt != router->m_obstacles.end(); ++obstacleIt)
+    {
+        ShapeRef *shape = dynamic_cast<ShapeRef *> (*obstacleIt);
+        if (shape == nullptr)
+        {
+            continue;
+        }
+        const Box box = shape->polygon().offsetBoundingBox(0.0);
+        const GridCell lowCell = gridCellFor(box.min, cellSize);
+        const GridCell highCell = gridCellFor(box.max, cellSize);
+        for (long x = lowCell.first; x <= highCell.first; ++x)
+        {
+            for (long y = lowCell.second; y <= highCell.second; ++y)
+            {
+                std::map<GridCell, std::vector<size_t> >::const_iterator cell =
+                        cellSegments.find(GridCell(x, y));
+                if (cell == cellSegments.end())
+                {
+                    continue;
+                }
+                for (size_t i = 0; i < cell->second.size(); ++i)
+                {
+                    const ConflictSegment& segment = segments[cell->second[i]];
+                    std::pair<ConnEnd, ConnEnd> ends =
+                            segment.connRef->endpointConnEnds();
+                    if ((ends.first.shape() == shape) ||
+                            (ends.second.shape() == shape))
+                    {
+                        continue;
+                    }
+                    if (segmentPassesThroughObstacle(segment, box))
+                    {
+                        conflictCells.insert(cell->first);
+                    }
+                }
+            }
+        }
+    }
+
+    // Grow the conflicts by one cell so the connectors next to a conflict
+    // can move out of the way.
+    std::set<GridCell> haloCells;
+    for (std::set<GridCell>::const_iterator cell = conflictCells.begin();
+            cell != conflictCells.end(); ++cell)
+    {
+        for (long x = cell->first - 1; x <= cell->first + 1; ++x)
+        {
+            for (long y = cell->second - 1; y <= cell->second + 1; ++y)
+            {
+                if (cellSegments.find(GridCell(x, y)) != cellSegments.end())
+                {
+                    haloCells.insert(GridCell(x, y));
+                }
+            }
+        }
+    }
+
+    // Split the cells into connected regions, the connectors in the cells
+    // of a region are the ones it moves.
+    std::map<ConnRef *, size_t> connRegions;
+    std::vector<size_t> parents;
+    std::set<GridCell> visited;
+    for (std::set<GridCell>::const_iterator start = haloCells.begin();
+            start != haloCells.end(); ++start)
+    {
+        if (!visited.insert(*start).second)
+        {
+            continue;
+        }
+        const size_t region = parents.size();
+        parents.push_back(region);
+
+        std::vector<GridCell> stack(1, *start);
+        while (!stack.empty())
+        {
+            const GridCell cell = stack.back();
+            stack.pop_back();
+
+            const std::vector<size_t>& indexes = cellSegments[cell];
+            for (size_t i = 0; i < indexes.size(); ++i)
+            {
+                ConnRef *connRef = segments[indexes[i]].connRef;
+                std::map<ConnRef *, size_t>::iterator owner =
+                        connRegions.find(connRef);
+                if (owner == connRegions.end())
+                {
+                    connRegions[connRef] = region;
+                }
+                else
+                {
+                    parents[findRegionRoot(parents, owner->second)] =
+                            findRegionRoot(parents, region);
+                }
+            }
+
+            for (long x = cell.first - 1; x <= cell.first + 1; ++x)
+            {
+                for (long y = cell.second - 1; y <= cell.second + 1; ++y)
+                {
+                    const GridCell neighbour(x, y);
+                    if ((haloCells.find(neighbour) != haloCells.end()) &&
+                            visited.insert(neighbour).second)
+                    {
+                        stack.push_back(neighbour);
+                    }
+                }
+            }
+        }
+    }
+
+    // Number the merged regions in the order of the grid.
+    ConflictRegions regions;
+    std::vector<size_t> rootRegions(parents.size(), parents.size());
+    for (size_t region = 0; region < parents.size(); ++region)
+    {
+        const size_t root = findRegionRoot(parents, region);
+        if (rootRegions[root] == parents.size())
+        {
+            rootRegions[root] = regions.size();
+            regions.push_back(ConflictRegion());
+        }
+    }
+
+    for (ConnRefList::const_iterator curr = router->connRefs.begin();
+            curr != router->connRefs.end(); ++curr)
+    {
+        std::map<ConnRef *, size_t>::const_iterator conn =
+                connRegions.find(*curr);
+        if (conn == connRegions.end())
+        {
+            continue;
+        }
+        ConflictRegion& region =
+                regions[rootRegions[findRegionRoot(parents, conn->second)]];
+        region.activeConnectors.insert(*curr);
+    }
+
+    // The solver of a region has to know about everything near its
+    // connectors.
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        ConflictRegion& region = regions[i];
+        region.bounds.min = Point(DBL_MAX, DBL_MAX);
+        region.bounds.max = Point(-DBL_MAX, -DBL_MAX);
+
+        for (ConnRefSet::const_iterator conn =
+                region.activeConnectors.begin();
+                conn != region.activeConnectors.end(); ++conn)
+        {
+            const std::vector<size_t>& indexes = connSegments[*conn];
+            for (size_t j = 0; j < indexes.size(); ++j)
+            {
+                const ConflictSegment& segment = segments[indexes[j]];
+                for (size_t dim = 0; dim < 2; ++dim)
+                {
+                    region.bounds.min[dim] = std::min(region.bounds.min[dim],
+                            segment.low[dim] - cellSize);
+                    region.bounds.max[dim] = std::max(region.bounds.max[dim],
+                            segment.high[dim] + cellSize);
+                }
+            }
+        }
+    }
+
+    std::vector<LayoutObstacle> obstacles;
+    for (ObstacleList::const_iterator obstacleIt =
+            router->m_obstacles.begin();
+            obstacleIt != router->m_obstacles.end(); ++obstacleIt)
+    {
+        obstacles.push_back(layoutObstacleFor(*obstacleIt, XDIM));
+    }
+
+    // Regions that overlap, or overlap the same shape, would read the
+    // connectors and shapes the other one moves, so they are merged too.
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            for (size_t j = i + 1; j < regions.size(); ++j)
+            {
+                if (overlapsRegion(regions[j].bounds.min,
+                            regions[j].bounds.max, regions[i].bounds))
+                {
+                    mergeConflictRegion(regions[i], regions[j]);
+                    regions.erase(regions.begin() + j);
+                    --j;
+                    merged = true;
+                }
+            }
+        }
+        for (size_t k = 0; k < obstacles.size(); ++k)
+        {
+            size_t owner = regions.size();
+            for (size_t i = 0; i < regions.size(); ++i)
+            {
+                if (!overlapsRegion(obstacles[k].min, obstacles[k].max,
+                            regions[i].bounds))
+                {
+                    continue;
+                }
+                if (owner == regions.size())
+                {
+                    owner = i;
+                    continue;
+                }
+                mergeConflictRegion(regions[owner], regions[i]);
+                regions.erase(regions.begin() + i);
+                --i;
+                merged = true;
+            }
+        }
+    }
+
+    // The other connectors passing through a region are kept in place.
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        for (size_t j = 0; j < regions.size(); ++j)
+        {
+            if (overlapsRegion(segments[i].low, segments[i].high,
+                        regions[j].bounds) &&
+                    (regions[j].activeConnectors.find(segments[i].connRef) ==
+                     regions[j].activeConnectors.end()))
+            {
+                regions[j].fixedConnectors.insert(segments[i].connRef);
+            }
+        }
+    }
+
+    // The shapes are assigned here, while nothing is moved yet.
+    for (size_t k = 0; k < obstacles.size(); ++k)
+    {
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            if (overlapsRegion(obstacles[k].min, obstacles[k].max,
+                        regions[i].bounds))
+            {
+                regions[i].obstacles.push_back(obstacles[k].obstacle);
+                break;
+            }
+        }
+    }
+
+    if (!shapesMovable)
+    {
+        return regions;
+    }
+
+    // Moving a shape moves the ends of the connectors inside it, so only
+    // the shapes whose connectors all belong to the region can be moved.
+    std::map<GridCell, std::vector<std::pair<ConnRef *, Point> > > cellEnds;
+    for (std::map<ConnRef *, std::vector<size_t> >::const_iterator conn =
+            connSegments.begin(); conn != connSegments.end(); ++conn)
+    {
+        const Polygon& route = conn->first->displayRoute();
+        const Point& first = route.ps.front();
+        const Point& last = route.ps.back();
+        cellEnds[gridCellFor(first, cellSize)].push_back(
+                std::make_pair(conn->first, first));
+        cellEnds[gridCellFor(last, cellSize)].push_back(
+                std::make_pair(conn->first, last));
+    }
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        ConflictRegion& region = regions[i];
+        for (size_t k = 0; k < obstacles.size(); ++k)
+        {
+            const LayoutObstacle& obstacle = obstacles[k];
+            if (!obstacle.shape() || !overlapsRegion(obstacle.min,
+                        obstacle.max, region.bounds))
+            {
+                continue;
+            }
+
+            bool movable = true;
+            const GridCell minCell = gridCellFor(obstacle.min, cellSize);
+            const GridCell maxCell = gridCellFor(obstacle.max, cellSize);
+            for (long x = minCell.first; movable && (x <= maxCell.first); ++x)
+            {
+                for (long y = minCell.second; movable &&
+                        (y <= maxCell.second); ++y)
+                {
+                    std::map<GridCell, std::vector<std::pair<ConnRef *,
+                            Point> > >::const_iterator cell =
+                            cellEnds.find(GridCell(x, y));
+                    if (cell == cellEnds.end())
+                    {
+                        continue;
+                    }
+                    for (size_t j = 0; j < cell->second.size(); ++j)
+                    {
+                        if (insideLayoutObstacleBounds(cell->second[j].second,
+                                    obstacle) &&
+                                (region.activeConnectors.find(
+                                    cell->second[j].first) ==
+                                 region.activeConnectors.end()))
+                        {
+                            movable = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (movable)
+            {
+                region.movableObstacles.insert(obstacle.obstacle);
+            }
+        }
+    }
+    return regions;
+}
+
 static void buildOrthogonalLayoutSegments(Router *router,
         const size_t dim, LayoutEdgeSegmentList& segmentList,
         LayoutObstacleVector& obstacleVector,
-        EndpointAnchorList& extraTerminalsList)
+        EndpointAnchorList& extraTerminalsList,
+        const ConflictRegion *region = nullptr)
 {
     // We can handle bends that occur as a result of checkpoints as intentional.
     // In this case we don't try to remove those bends.  Also, we keep a fixed
@@ -980,25 +1590,19 @@ static void buildOrthogonalLayoutSegments(Router *router,
     // the shared path doesn't get ripped away.
     const bool preserveCheckpointBends = true;
 
-    const size_t n = router->m_obstacles.size();
+    // A region only needs the shapes near its connectors.
+    const ObstacleList& obstacles =
+            region ? region->obstacles : router->m_obstacles;
+    const size_t n = obstacles.size();
 
     obstacleVector = LayoutObstacleVector(n);
 
     // If we're going to nudge final segments, then cache the shape
     // rectangles to save us rebuilding them multiple times.
-    ObstacleList::iterator obstacleIt = router->m_obstacles.begin();
+    ObstacleList::const_iterator obstacleIt = obstacles.begin();
     for (unsigned i = 0; i < n; i++)
     {
-        ShapeRef *shape = dynamic_cast<ShapeRef *> (*obstacleIt);
-        JunctionRef *junction = dynamic_cast<JunctionRef *> (*obstacleIt);
-        if (shape)
-        {
-            obstacleVector[i] = LayoutObstacle(shape, dim);
-        }
-        else if (junction)
-        {
-            obstacleVector[i] = LayoutObstacle(junction, dim);
-        }
+        obstacleVector[i] = layoutObstacleFor(*obstacleIt, dim);
         ++obstacleIt;
     }
 
@@ -1012,6 +1616,33 @@ static void buildOrthogonalLayoutSegments(Router *router,
             continue;
         }
         Polygon& displayRoute = (*curr)->displayRoute();
+
+        if (region && (region->activeConnectors.find(*curr) ==
+                    region->activeConnectors.end()))
+        {
+            if (region->fixedConnectors.find(*curr) ==
+                    region->fixedConnectors.end())
+            {
+                continue;
+            }
+
+            // The connectors passing through a region are only obstacles
+            // for the segments that are moved.
+            for (size_t i = 1; i < displayRoute.size(); ++i)
+            {
+                if ((displayRoute.ps[i - 1][dim] == displayRoute.ps[i][dim]) &&
+                        (displayRoute.ps[i - 1][altDim] !=
+                         displayRoute.ps[i][altDim]))
+                {
+                    const bool ordered = displayRoute.ps[i - 1][altDim] <
+                            displayRoute.ps[i][altDim];
+                    segmentList.push_back(new LayoutEdgeSegment(*curr,
+                            ordered ? (i - 1) : i, ordered ? i : (i - 1),
+                            dim));
+                }
+            }
+            continue;
+        }
         bool routeHasCheckpointInfo = !displayRoute.checkpointsOnRoute.empty();
         // Determine all line segments that we are interested in shifting.
         // We don't consider the first or last segment of a path.
@@ -1226,7 +1857,8 @@ static void setupOrthogonalLayoutConstraints(Router *router,
         EndpointAnchorList& extraTerminalsList,
         cola::CompoundConstraints& ccs, cola::VariableIDMap& idMap,
         cola::RootCluster *clusterHierarchy, vpsc::Rectangles& rs,
-        LineReps *lineReps, const double moveLimit)
+        LineReps *lineReps, const double moveLimit,
+        const ConflictRegion *region, ImprovementBudget& budget)
 {
     COLA_UNUSED(router);
 
@@ -1318,7 +1950,8 @@ static void setupOrthogonalLayoutConstraints(Router *router,
         events[ctr++] = new Event(SegOpen, v, lowPt[altDim]);
         events[ctr++] = new Event(SegClose, v, highPt[altDim]);
     }
-    qsort((Event*)events, (size_t) totalEvents, sizeof(Event*), compare_events);
+    qsort((Event*)events, (size_t) totalEvents, sizeof(Event*),
+            compareLayoutEvents);
 
     // Update the variable Ids on the existing compound constraints
     for (size_t i = 0; i < ccs.size(); ++i)
@@ -1375,6 +2008,56 @@ static void setupOrthogonalLayoutConstraints(Router *router,
     }
     delete [] events;
 
+    // A region does not move the connectors passing through it and the
+    // shapes it does not own, they are held in place and a separation moving
+    // them is rejected.
+    // Everything else has to stay inside the region, the solver does not
+    // know what is outside of it.
+    vpsc::Variables pinnedVars;
+    std::vector<bool> pinnedObstacles(ovn, false);
+    vpsc::Variables boundedVars;
+    std::vector<std::pair<double, double> > varBounds;
+    if (region)
+    {
+        const double regionMin = region->bounds.min[dim];
+        const double regionMax = region->bounds.max[dim];
+        for (unsigned i = 0; i < ovn; i++)
+        {
+            LayoutObstacle& obstacle = obstacleVector[i];
+            if (region->movableObstacles.find(obstacle.obstacle) ==
+                    region->movableObstacles.end())
+            {
+                pinnedObstacles[i] = true;
+                pinnedVars.push_back(obstacle.variable);
+                continue;
+            }
+            const double position = obstacle.variable->desiredPosition;
+            const double halfSize = obstacle.halfSizeInDim(dim);
+            boundedVars.push_back(obstacle.variable);
+            varBounds.push_back(std::make_pair(
+                    std::min(position, regionMin + halfSize),
+                    std::max(position, regionMax - halfSize)));
+        }
+        for (LayoutEdgeSegmentList::iterator curr = segmentList.begin();
+                curr != segmentList.end(); ++curr)
+        {
+            vpsc::Variable *variable = (*curr)->variable;
+            if ((*curr)->fixed)
+            {
+                pinnedVars.push_back(variable);
+                continue;
+            }
+            boundedVars.push_back(variable);
+            varBounds.push_back(std::make_pair(
+                    std::min(variable->desiredPosition, regionMin),
+                    std::max(variable->desiredPosition, regionMax)));
+        }
+        for (size_t i = 0; i < pinnedVars.size(); ++i)
+        {
+            pinnedVars[i]->weight = PINNED_WEIGHT;
+        }
+    }
+
     vpsc::Constraints valid = cs;
     std::vector<double> priorPos(vs.size());
 
@@ -1404,12 +2087,20 @@ static void setupOrthogonalLayoutConstraints(Router *router,
     vpscInstance.satisfy();
 
     bool subConstraintSatisfiable = true;
-    while (!less.empty())
+    while (!less.empty() && !budget.exhausted())
     {
         LayoutEdgeSegmentSeparations::iterator frontIt = less.begin();
         LayoutEdgeSegmentSeparation sepChoice = *frontIt;
         less.erase(frontIt);
 
+        // Only the connectors of the region are straightened.
+        if (region && (region->activeConnectors.find(sepChoice.connRef) ==
+                    region->activeConnectors.end()))
+        {
+            continue;
+        }
+        budget.consume();
+
         // Reset subConstraintSatisfiable for new solve.
         subConstraintSatisfiable = true;
 
@@ -1510,6 +2201,22 @@ static void setupOrthogonalLayoutConstraints(Router *router,
                 subConstraintSatisfiable = false;
             }
         }
+        for (size_t i = 0; i < pinnedVars.size(); ++i)
+        {
+            if (fabs(pinnedVars[i]->finalPosition -
+                        pinnedVars[i]->desiredPosition) > 0.01)
+            {
+                subConstraintSatisfiable = false;
+            }
+        }
+        for (size_t i = 0; i < boundedVars.size(); ++i)
+        {
+            if ((boundedVars[i]->finalPosition < varBounds[i].first) ||
+                    (boundedVars[i]->finalPosition > varBounds[i].second))
+            {
+                subConstraintSatisfiable = false;
+            }
+        }
 
         if (!subConstraintSatisfiable)
         {
@@ -1536,7 +2243,10 @@ static void setupOrthogonalLayoutConstraints(Router *router,
             {
                 LayoutObstacle& obstacle = obstacleVector[i];
 
-                obstacle.updatePositionsFromSolver();
+                if (!pinnedObstacles[i])
+                {
+                    obstacle.updatePositionsFromSolver();
+                }
             }
             for (LayoutEdgeSegmentList::iterator curr = segmentList.begin();
                     curr != segmentList.end(); ++curr)
@@ -1546,7 +2256,10 @@ static void setupOrthogonalLayoutConstraints(Router *router,
             for (EndpointAnchorList::iterator curr = extraTerminalsList.begin();
                     curr != extraTerminalsList.end(); ++curr)
             {
-                curr->updatePosition(obstacleVector);
+                if (!pinnedObstacles[curr->obstacleIndex])
+                {
+                    curr->updatePosition(obstacleVector);
+                }
             }
 #ifdef ORTHOG_TOPOLOGY_DEBUG
             std::stringstream filename;
@@ -1687,7 +2400,10 @@ AvoidTopologyAddon::AvoidTopologyAddon(vpsc::Rectangles& rs,
       m_constraints(cs),
       m_cluster_hierarchy(ch),
       m_id_map(map),
-      m_move_limit(moveLimit)
+      m_move_limit(moveLimit),
+      m_region_limited(false),
+      m_max_iterations(0),
+      m_max_seconds(0)
 {
 }
 
@@ -1700,6 +2416,19 @@ Avoid::TopologyAddonInterface *AvoidTopologyAddon::clone(void) const
     return new AvoidTopologyAddon(*this);
 }
 
+void AvoidTopologyAddon::setImprovementLimits(bool regionLimited,
+        unsigned int maxIterations, double maxSeconds)
+{
+    m_region_limited = regionLimited;
+    m_max_iterations = maxIterations;
+    m_max_seconds = maxSeconds;
+}
+
+void AvoidTopologyAddon::setRegionRunner(const RegionRunner& runner)
+{
+    m_region_runner = runner;
+}
+
 void AvoidTopologyAddon::improveOrthogonalTopology(Router *router)
 {
     //router->timers.Register(???, timerStart);
@@ -1710,18 +2439,73 @@ void AvoidTopologyAddon::improveOrthogonalTopology(Router *router)
     router->outputDiagramSVG("layout-0-000");
 #endif
 
+    // The time limit is shared by everything.  Without regions the
+    // iteration limit is shared by both dimensions, otherwise every region
+    // of a dimension gets its own copy so the result does not depend on
+    // the order the regions are solved in.
+    ImprovementBudget budget(m_max_iterations, m_max_seconds);
+
     for (size_t dimension = 0; dimension < 2; ++dimension)
     {
-        LayoutEdgeSegmentList segmentList;
-        LayoutObstacleVector obstacleVector;
-        EndpointAnchorList extraTerminalsList;
-        LineReps lineReps;
+        if (!m_region_limited)
+        {
+            LayoutEdgeSegmentList segmentList;
+            LayoutObstacleVector obstacleVector;
+            EndpointAnchorList extraTerminalsList;
+            LineReps lineReps;
+
+            buildOrthogonalLayoutSegments(router, dimension, segmentList,
+                    obstacleVector, extraTerminalsList);
+            setupOrthogonalLayoutConstraints(router, dimension, segmentList,
+                    obstacleVector, extraTerminalsList, m_constraints, 
+                    m_id_map, m_cluster_hierarchy, m_rectangles, &lineReps, 
+                    m_move_limit, nullptr, budget);
 
-        buildOrthogonalLayoutSegments(router, dimension, segmentList,
-                obstacleVector, extraTerminalsList);
-        setupOrthogonalLayoutConstraints(router, dimension, segmentList,
-                obstacleVector, extraTerminalsList, m_constraints, m_id_map,
-                m_cluster_hierarchy, m_rectangles, &lineReps, m_move_limit);
+            simplifyOrthogonalRoutes(router);
+            continue;
+        }
+
+        // The conflicts left after the first dimension are found again.
+        // The diagram constraints can tie shapes of different regions
+        // together, so with constraints the regions keep the shapes fixed.
+        const bool shapesMovable = m_constraints.empty() &&
+                (!m_cluster_hierarchy || m_cluster_hierarchy->clusters.empty());
+        const ConflictRegions regions = findConflictRegions(router,
+                std::max(m_move_limit, 1.0), shapesMovable);
+
+        // The regions do not share connectors or shapes and only move
+        // shapes when there are no diagram constraints, so every region is
+        // solved on its own without them.
+        std::function<void(size_t)> solveRegion = 
+                [&](size_t regionIndex)
+        {
+            LayoutEdgeSegmentList segmentList;
+            LayoutObstacleVector obstacleVector;
+            EndpointAnchorList extraTerminalsList;
+            LineReps lineReps;
+            cola::CompoundConstraints noConstraints;
+            ImprovementBudget regionBudget = budget;
+
+            buildOrthogonalLayoutSegments(router, dimension, segmentList,
+                    obstacleVector, extraTerminalsList, 
+                    &regions[regionIndex]);
+            setupOrthogonalLayoutConstraints(router, dimension, segmentList,
+                    obstacleVector, extraTerminalsList, noConstraints, 
+                    m_id_map, nullptr, m_rectangles, &lineReps, 
+                    m_move_limit, &regions[regionIndex], regionBudget);
+        };
+
+        if (m_region_runner)
+        {
+            m_region_runner(regions.size(), solveRegion);
+        }
+        else
+        {
+            for (size_t i = 0; i < regions.size(); ++i)
+            {
+                solveRegion(i);
+            }
+        }
 
         simplifyOrthogonalRoutes(router);
     }
@@ -22,6 +22,9 @@
 #ifndef AVOID_ORTHOGLAYOUT_H
 #define AVOID_ORTHOGLAYOUT_H
 
+#include <cstddef>
+#include <functional>
+
 #include "libcola/cola.h"
 
 namespace topology {
@@ -37,6 +40,13 @@ namespace topology {
 class AvoidTopologyAddon : public Avoid::TopologyAddonInterface
 {
     public:
+        /**
+         * @brief A function that calls solve(i) for every i in [0, count)
+         *        and returns when all calls have finished.
+         */
+        typedef std::function<void(size_t count, 
+                const std::function<void(size_t)>& solve)> RegionRunner;
+
         /**
          * @brief Constructs a AvoidTopologyAddon instance for a set of COLA
          *        diagram constraints.
@@ -69,6 +79,48 @@ class AvoidTopologyAddon : public Avoid::TopologyAddonInterface
         ~AvoidTopologyAddon();
         Avoid::TopologyAddonInterface *clone(void) const;
 
+        /**
+         * @brief Limits the work done by improveOrthogonalTopology().
+         *
+         * In region limited mode only the regions where connectors cross
+         * or overlap each other or pass through shapes are improved.  Every
+         * region gets its own VPSC instance built from the connectors in
+         * the region and a halo around it and the shapes near them.  The
+         * other connectors passing through a region are added as fixed
+         * segments, so moved segments keep their distances to them.  A
+         * region only moves the shapes whose connectors it all moves, and
+         * none if there are diagram constraints or clusters.  Regions that
+         * overlap or share a connector or shape are merged, the remaining
+         * ones are independent and are solved with the region runner.
+         *
+         * The number of solved separations and the time spent on them can
+         * be capped, the improvement then stops with the best layout found
+         * so far.  Only the iteration limit gives the same layout on every
+         * run, the time limit depends on the speed of the machine.
+         *
+         * @param[in] regionLimited  Only improve the regions with conflicts.
+         * @param[in] maxIterations  The maximum number of separations that
+         *                           are tried, in region limited mode per
+         *                           region and dimension, 0 for no limit.
+         * @param[in] maxSeconds     The maximum time in seconds spent on
+         *                           trying separations, 0 for no limit.
+         */
+        void setImprovementLimits(bool regionLimited, 
+                unsigned int maxIterations, double maxSeconds);
+
+        /**
+         * @brief Sets the function used to solve the conflict regions.
+         *
+         * The regions of the region limited mode do not share connectors
+         * or shapes, so they can be solved at the same time and give the
+         * same layout as solving them in order.  By default they are solved
+         * one after another.
+         *
+         * @param[in] runner  The function calling the solver of every
+         *                    region.
+         */
+        void setRegionRunner(const RegionRunner& runner);
+
         void improveOrthogonalTopology(Avoid::Router *router);
         bool outputCode(FILE *fp) const;
         bool outputDeletionCode(FILE *fp) const;
@@ -79,6 +131,10 @@ class AvoidTopologyAddon : public Avoid::TopologyAddonInterface
         cola::RootCluster *m_cluster_hierarchy;
         cola::VariableIDMap m_id_map;
         double m_move_limit;
+        bool m_region_limited;
+        unsigned int m_max_iterations;
+        double m_max_seconds;
+        RegionRunner m_region_runner;
 };
 
 
@@ -0,0 +1,367 @@
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+#include <QtAlgorithms>
+
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "parser.h"
+
+#include "bitsscanner.h"
+
+namespace OpenNetlistView::Yosys {
+
+BitsScanner::BitsScanner() = default;
+
+BitsScanner::~BitsScanner() = default;
+
+QByteArray BitsScanner::scan(const QByteArray& json)
+{
+    enum class Container
+    {
+        OBJECT,
+        CONNECTIONS,
+        ARRAY
+    };
+
+    std::vector<Container> containers;
+
+    bool expectKey = false;      // the next string is the key of a member
+    bool bitsKey = false;        // the key of the current member is "bits"
+    bool connectionsKey = false; // the key of the current member is "connections"
+
+    QByteArray result;
+    result.reserve(json.size() / 2);
+
+    const char* data = json.constData();
+    const qsizetype size = json.size();
+
+    qsizetype copyPos = 0;
+    qsizetype pos = 0;
+
+    while(pos < size)
+    {
+        const bool inObject = !containers.empty() && containers.back() != Container::ARRAY;
+
+        switch(data[pos])
+        {
+        case '"':
+        {
+            const qsizetype stringEnd = skipString(json, pos + 1);
+
+            if(inObject && expectKey)
+            {
+                const QByteArrayView key(data + pos + 1, stringEnd - pos - 2);
+                bitsKey = key == QByteArrayView(YosysJson::bits);
+                connectionsKey = key == QByteArrayView(YosysJson::connections);
+            }
+
+            pos = stringEnd;
+            break;
+        }
+        case '{':
+            containers.push_back(inObject && !expectKey && connectionsKey ? Container::CONNECTIONS : Container::OBJECT);
+            expectKey = true;
+            bitsKey = false;
+            connectionsKey = false;
+            pos++;
+            break;
+        case '[':
+        {
+            // the bits of the ports and netnames and the values of the connections
+            if(inObject && !expectKey && (bitsKey || containers.back() == Container::CONNECTIONS))
+            {
+                const qsizetype arrayEnd = decodeArray(json, pos);
+
+                if(arrayEnd >= 0)
+                {
+                    result.append(data + copyPos, pos - copyPos);
+                    result.append(QByteArray::number(static_cast<qint64>(bitsSpans.size() - 1)));
+
+                    copyPos = arrayEnd;
+                    pos = arrayEnd;
+                    bitsKey = false;
+                    break;
+                }
+            }
+
+            containers.push_back(Container::ARRAY);
+            bitsKey = false;
+            connectionsKey = false;
+            pos++;
+            break;
+        }
+        case '}':
+        case ']':
+            if(!containers.empty())
+            {
+                containers.pop_back();
+            }
+            pos++;
+            break;
+        case ',':
+            expectKey = inObject;
+            pos++;
+            break;
+        case ':':
+            expectKey = false;
+            pos++;
+            break;
+        default:
+            pos++;
+            break;
+        }
+    }
+
+    result.append(data + copyPos, size - copyPos);
+
+    return result;
+}
+
+bool BitsScanner::hasBits(int64_t bitsIdx) const
+{
+    return bitsIdx >= 0 && bitsIdx < static_cast<int64_t>(bitsSpans.size());
+}
+
+QStringList BitsScanner::getBits(int64_t bitsIdx) const
+{
+    if(!hasBits(bitsIdx))
+    {
+        throw std::runtime_error("No decoded bits with the index " + std::to_string(bitsIdx));
+    }
+
+    const auto& [offset, length] = bitsSpans[bitsIdx];
+
+    QStringList bits;
+    bits.reserve(static_cast<qsizetype>(length));
+
+    for(size_t bitIdx = offset; bitIdx < offset + length; bitIdx++)
+    {
+        switch(bitIds[bitIdx])
+        {
+        case constZero:
+            bits.push_back("0");
+            break;
+        case constOne:
+            bits.push_back("1");
+            break;
+        case constX:
+            bits.push_back("x");
+            break;
+        case constZ:
+            bits.push_back("z");
+            break;
+        default:
+            bits.push_back(QString::number(bitIds[bitIdx]));
+            break;
+        }
+    }
+
+    return bits;
+}
+
+int64_t BitsScanner::addBits(const std::vector<int64_t>& bits)
+{
+    bitsSpans.emplace_back(bitIds.size(), bits.size());
+    bitIds.insert(bitIds.end(), bits.begin(), bits.end());
+
+    return static_cast<int64_t>(bitsSpans.size() - 1);
+}
+
+void BitsScanner::clear()
+{
+    bitIds.clear();
+    bitsSpans.clear();
+}
+
+qsizetype BitsScanner::decodeArray(const QByteArray& json, qsizetype pos)
+{
+    const char* data = json.constData();
+    const qsizetype size = json.size();
+    const size_t offset = bitIds.size();
+
+    pos = skipWhitespace(json, pos + 1);
+
+    // an empty array is stored as well so the parser can report it
+    if(pos < size && data[pos] == ']')
+    {
+        bitsSpans.emplace_back(offset, 0);
+        return pos + 1;
+    }
+
+    while(pos < size)
+    {
+        if(data[pos] >= '0' && data[pos] <= '9')
+        {
+            const qsizetype digitCount = countDigits(json, pos);
+
+            if(digitCount > static_cast<qsizetype>(maxDigits))
+            {
+                break;
+            }
+
+            int64_t bitId = 0;
+
+            for(qsizetype digitIdx = 0; digitIdx < digitCount; digitIdx++)
+            {
+                bitId = bitId * 10 + (data[pos + digitIdx] - '0');
+            }
+
+            bitIds.push_back(bitId);
+            pos += digitCount;
+        }
+        else if(data[pos] == '"' && pos + 2 < size && data[pos + 2] == '"')
+        {
+            const char constant = data[pos + 1];
+
+            if(constant == '0')
+            {
+                bitIds.push_back(constZero);
+            }
+            else if(constant == '1')
+            {
+                bitIds.push_back(constOne);
+            }
+            else if(constant == 'x')
+            {
+                bitIds.push_back(constX);
+            }
+            else if(constant == 'z')
+            {
+                bitIds.push_back(constZ);
+            }
+            else
+            {
+                break;
+            }
+
+            pos += 3;
+        }
+        else
+        {
+            break;
+        }
+
+        pos = skipWhitespace(json, pos);
+
+        if(pos < size && data[pos] == ']')
+        {
+            bitsSpans.emplace_back(offset, bitIds.size() - offset);
+            return pos + 1;
+        }
+
+        if(pos >= size || data[pos] != ',')
+        {
+            break;
+        }
+
+        pos = skipWhitespace(json, pos + 1);
+    }
+
+    // the array is left to the json parser
+    bitIds.resize(offset);
+
+    return -1;
+}
+
+qsizetype BitsScanner::skipString(const QByteArray& json, qsizetype pos)
+{
+    const char* data = json.constData();
+    const qsizetype size = json.size();
+
+    while(pos < size)
+    {
+#ifdef __SSE2__
+        // jump to the next quote or backslash
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        while(pos + 16 <= size)
+        {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+
+            if(mask != 0)
+            {
+                pos += qCountTrailingZeroBits(static_cast<quint32>(mask));
+                break;
+            }
+
+            pos += 16;
+        }
+
+        if(pos >= size)
+        {
+            break;
+        }
+#endif
+
+        if(data[pos] == '"')
+        {
+            return pos + 1;
+        }
+
+        // an escaped character can not end the string
+        pos += data[pos] == '\\' ? 2 : 1;
+    }
+
+    return size;
+}
+
+qsizetype BitsScanner::countDigits(const QByteArray& json, qsizetype pos)
+{
+    const char* data = json.constData();
+    const qsizetype size = json.size();
+    const qsizetype start = pos;
+
+#ifdef __SSE2__
+    const __m128i belowZero = _mm_set1_epi8('0' - 1);
+    const __m128i aboveNine = _mm_set1_epi8('9' + 1);
+
+    while(pos + 16 <= size)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chunk, belowZero), _mm_cmplt_epi8(chunk, aboveNine));
+        const int noDigitMask = ~_mm_movemask_epi8(digits) & 0xFFFF;
+
+        if(noDigitMask != 0)
+        {
+            return pos - start + qCountTrailingZeroBits(static_cast<quint32>(noDigitMask));
+        }
+
+        pos += 16;
+    }
+#endif
+
+    while(pos < size && data[pos] >= '0' && data[pos] <= '9')
+    {
+        pos++;
+    }
+
+    return pos - start;
+}
+
+qsizetype BitsScanner::skipWhitespace(const QByteArray& json, qsizetype pos)
+{
+    const char* data = json.constData();
+    const qsizetype size = json.size();
+
+    while(pos < size && (data[pos] == ' ' || data[pos] == '\n' || data[pos] == '\r' || data[pos] == '\t'))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+} // namespace OpenNetlistView::Yosys
@@ -0,0 +1,146 @@
+/**
+ * @file bitsscanner.h
+ * @brief Header file for the BitsScanner class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the BitsScanner class, which decodes the
+ * bit arrays of a Yosys JSON netlist from the raw file content before the rest of
+ * the file is read by the JSON parser of Qt.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __BITSSCANNER_H__
+#define __BITSSCANNER_H__
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenNetlistView::Yosys {
+
+/**
+ * @class BitsScanner
+ * @brief Decodes the bit arrays of a Yosys JSON netlist into a compact buffer.
+ *
+ * Most of the bytes of a netlist are the integer arrays of the "bits" fields of
+ * the ports and netnames and of the connections of the cells. The scanner reads
+ * them in one pass over the raw file, stores the bit ids in one buffer and
+ * replaces every array in the returned JSON with the index of its bits. So the
+ * JSON parser and the QVariant conversions of the parser never see the bits.
+ *
+ * Strings are skipped and digit runs are measured 16 bytes at a time with SSE2
+ * if it is available. Arrays that contain anything else than non negative
+ * integers and the constants "0", "1", "x" and "z" are kept in the JSON.
+ */
+class BitsScanner
+{
+public:
+    constexpr const static int64_t constZero{-1}; ///< The bit id of the constant "0".
+    constexpr const static int64_t constOne{-2};  ///< The bit id of the constant "1".
+    constexpr const static int64_t constX{-3};    ///< The bit id of the constant "x".
+    constexpr const static int64_t constZ{-4};    ///< The bit id of the constant "z".
+    constexpr const static size_t maxDigits{18};  ///< The maximum number of digits of a bit id.
+
+    /**
+     * @brief Construct a new BitsScanner object
+     *
+     */
+    BitsScanner();
+
+    /**
+     * @brief Destroy the BitsScanner object
+     *
+     */
+    ~BitsScanner();
+
+    /**
+     * @brief Decodes the bit arrays of a netlist
+     *
+     * The bits of earlier scans are kept, so the indexes stay valid
+     * until the scanner is cleared.
+     *
+     * @param json The content of the Yosys JSON file.
+     * @return QByteArray The JSON with the bit arrays replaced by their index.
+     */
+    QByteArray scan(const QByteArray& json);
+
+    /**
+     * @brief Checks if an index belongs to a decoded bit array
+     *
+     * @param bitsIdx The index that replaced the array in the JSON.
+     * @return true if the bits of the index are stored
+     */
+    bool hasBits(int64_t bitsIdx) const;
+
+    /**
+     * @brief Get the bits of a decoded array
+     *
+     * @param bitsIdx The index that replaced the array in the JSON.
+     * @throw std::runtime_error if no bits are stored for the index
+     * @return QStringList The bits in the format of the parser.
+     */
+    QStringList getBits(int64_t bitsIdx) const;
+
+    /**
+     * @brief Stores bits that were decoded from another netlist format
+     *
+     * @param bits The bit ids with the constants of the scanner.
+     * @return int64_t The index of the stored bits.
+     */
+    int64_t addBits(const std::vector<int64_t>& bits);
+
+    /**
+     * @brief Removes all decoded bits
+     *
+     */
+    void clear();
+
+private:
+    std::vector<int64_t> bitIds;                      ///< The bit ids of all decoded arrays.
+    std::vector<std::pair<size_t, size_t>> bitsSpans; ///< The offset and length of every array in the bit ids.
+
+    /**
+     * @brief Decodes one bit array
+     *
+     * @param json The content of the JSON file.
+     * @param pos The position of the opening bracket.
+     * @return qsizetype The position after the closing bracket or -1 if the array is no bit array.
+     */
+    qsizetype decodeArray(const QByteArray& json, qsizetype pos);
+
+    /**
+     * @brief Finds the end of a string
+     *
+     * @param json The content of the JSON file.
+     * @param pos The position after the opening quote.
+     * @return qsizetype The position after the closing quote.
+     */
+    static qsizetype skipString(const QByteArray& json, qsizetype pos);
+
+    /**
+     * @brief Counts the digits starting at a position
+     *
+     * @param json The content of the JSON file.
+     * @param pos The position of the first byte to check.
+     * @return qsizetype The number of consecutive digits.
+     */
+    static qsizetype countDigits(const QByteArray& json, qsizetype pos);
+
+    /**
+     * @brief Skips whitespace
+     *
+     * @param json The content of the JSON file.
+     * @param pos The position of the first byte to check.
+     * @return qsizetype The position of the first byte that is no whitespace.
+     */
+    static qsizetype skipWhitespace(const QByteArray& json, qsizetype pos);
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __BITSSCANNER_H__
@@ -1,4 +1,3 @@
-#include <QGraphicsItem>
 #include <QString>
 
 #include <utility>
@@ -13,6 +13,8 @@
 
 #include <QString>
 
+class QGraphicsItem;
+
 namespace OpenNetlistView::Yosys {
 
 /**
@@ -47,6 +49,10 @@ public:
 
     /**
      * @brief sets the pointer to the qt graphics item that represents the component
+     *
+     * The item is only stored, it is created by the QNetlistItemFactory
+     * of the gui, so the model does not depend on the graphics classes.
+     *
      * @param item The pointer to the qt graphics item
      */
     void setGraphicsItem(QGraphicsItem* item);
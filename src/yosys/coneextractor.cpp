@@ -0,0 +1,432 @@
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+#include <deque>
+#include <utility>
+#include <algorithm>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "path.h"
+#include "parser.h"
+
+#include "coneextractor.h"
+
+namespace OpenNetlistView::Yosys {
+
+ConeExtractor::ConeExtractor(std::shared_ptr<Module> module)
+    : module(std::move(module))
+{
+}
+
+ConeExtractor::~ConeExtractor() = default;
+
+std::shared_ptr<Module> ConeExtractor::extract(const QString& name, unsigned int depth, EConeDirection direction)
+{
+    coneNodes.clear();
+    coneNodeSet.clear();
+    seedPaths.clear();
+    copiedPorts.clear();
+    portNames.clear();
+
+    if(module == nullptr)
+    {
+        return nullptr;
+    }
+
+    // the ports of the original module keep their names, so the new ports avoid all of them
+    for(const auto& port : *module->getPorts())
+    {
+        portNames.insert(port->getName());
+    }
+
+    std::vector<std::pair<std::shared_ptr<Node>, unsigned int>> fanInStart;
+    std::vector<std::pair<std::shared_ptr<Node>, unsigned int>> fanOutStart;
+
+    const auto nodes = module->getNodes();
+
+    auto nodeIt = std::find_if(nodes->begin(), nodes->end(), [&name](const std::shared_ptr<Node>& node) {
+        return node->getName() == name;
+    });
+
+    if(nodeIt != nodes->end())
+    {
+        // a cell is the level zero of its own cone
+        addConeNode(*nodeIt);
+        fanInStart.emplace_back(*nodeIt, 0);
+        fanOutStart.emplace_back(*nodeIt, 0);
+    }
+    else
+    {
+        const auto paths = module->getPaths();
+
+        auto pathIt = std::find_if(paths->begin(), paths->end(), [&name](const std::shared_ptr<Path>& path) {
+            if(path->getName() == name)
+            {
+                return true;
+            }
+
+            const auto& alternativeNames = path->getAlternativeNames();
+
+            return std::any_of(alternativeNames.begin(), alternativeNames.end(), [&name](const std::shared_ptr<QString>& alternativeName) {
+                return *alternativeName == name;
+            });
+        });
+
+        std::shared_ptr<Path> seedPath;
+
+        if(pathIt != paths->end())
+        {
+            seedPath = *pathIt;
+        }
+        else
+        {
+            const auto ports = module->getPorts();
+
+            auto portIt = std::find_if(ports->begin(), ports->end(), [&name](const std::shared_ptr<Port>& port) {
+                return port->getName() == name;
+            });
+
+            if(portIt != ports->end())
+            {
+                seedPath = (*portIt)->getPath();
+            }
+        }
+
+        if(seedPath == nullptr)
+        {
+            return nullptr;
+        }
+
+        seedPaths.push_back(seedPath);
+
+        // the cells driving and driven by a net are its first level
+        const auto source = seedPath->getSigSource();
+
+        if(source != nullptr && source->getParentNode() != nullptr)
+        {
+            const auto sourceNode = source->getParentNode();
+            fanInStart.emplace_back(sourceNode, isSplitJoin(sourceNode) ? 0 : 1);
+        }
+
+        for(const auto& destination : *seedPath->getSigDestinations())
+        {
+            if(destination->getParentNode() != nullptr)
+            {
+                const auto destinationNode = destination->getParentNode();
+                fanOutStart.emplace_back(destinationNode, isSplitJoin(destinationNode) ? 0 : 1);
+            }
+        }
+    }
+
+    if(direction != EConeDirection::FANOUT)
+    {
+        collectNodes(fanInStart, depth, true);
+    }
+
+    if(direction != EConeDirection::FANIN)
+    {
+        collectNodes(fanOutStart, depth, false);
+    }
+
+    return buildModule(generateConeType(module->getType(), name, depth));
+}
+
+QString ConeExtractor::generateConeType(const QString& moduleType, const QString& name, unsigned int depth)
+{
+    return QString("%1 (cone %2, %3)").arg(moduleType, name, QString::number(depth));
+}
+
+void ConeExtractor::collectNodes(const std::vector<std::pair<std::shared_ptr<Node>, unsigned int>>& startNodes, unsigned int depth, bool fanIn)
+{
+    // breadth first search where split and join nodes cost no level,
+    // they are put in front of the queue so the levels stay ordered
+    std::map<Node*, unsigned int> levels;
+    std::deque<std::pair<std::shared_ptr<Node>, unsigned int>> queue;
+
+    for(const auto& [node, level] : startNodes)
+    {
+        auto levelIt = levels.find(node.get());
+
+        if(level > depth || (levelIt != levels.end() && levelIt->second <= level))
+        {
+            continue;
+        }
+
+        levels[node.get()] = level;
+        queue.emplace_back(node, level);
+    }
+
+    while(!queue.empty())
+    {
+        const auto [node, level] = queue.front();
+        queue.pop_front();
+
+        // the node was reached on a shorter way after it was queued
+        if(levels[node.get()] < level)
+        {
+            continue;
+        }
+
+        addConeNode(node);
+
+        const Port::EDirection followDirection = fanIn ? Port::EDirection::INPUT : Port::EDirection::OUTPUT;
+
+        for(const auto& port : node->getPorts())
+        {
+            if(port->getDirection() != followDirection || port->getPath() == nullptr)
+            {
+                continue;
+            }
+
+            const auto path = port->getPath();
+            std::vector<std::shared_ptr<Node>> neighbours;
+
+            if(fanIn)
+            {
+                const auto source = path->getSigSource();
+
+                if(source != nullptr && source->getParentNode() != nullptr)
+                {
+                    neighbours.push_back(source->getParentNode());
+                }
+            }
+            else
+            {
+                for(const auto& destination : *path->getSigDestinations())
+                {
+                    if(destination->getParentNode() != nullptr)
+                    {
+                        neighbours.push_back(destination->getParentNode());
+                    }
+                }
+            }
+
+            for(const auto& neighbour : neighbours)
+            {
+                const bool passThrough = isSplitJoin(neighbour);
+                const unsigned int nextLevel = passThrough ? level : level + 1;
+
+                if(nextLevel > depth)
+                {
+                    continue;
+                }
+
+                auto levelIt = levels.find(neighbour.get());
+
+                if(levelIt != levels.end() && levelIt->second <= nextLevel)
+                {
+                    continue;
+                }
+
+                levels[neighbour.get()] = nextLevel;
+
+                if(passThrough)
+                {
+                    queue.emplace_front(neighbour, nextLevel);
+                }
+                else
+                {
+                    queue.emplace_back(neighbour, nextLevel);
+                }
+            }
+        }
+    }
+}
+
+void ConeExtractor::addConeNode(const std::shared_ptr<Node>& node)
+{
+    if(coneNodeSet.insert(node.get()).second)
+    {
+        coneNodes.push_back(node);
+    }
+}
+
+std::shared_ptr<Module> ConeExtractor::buildModule(const QString& type)
+{
+    auto coneModule = std::make_shared<Module>(type);
+    const auto subModules = module->getSubModules();
+
+    // copy the nodes with new ports
+    for(const auto& node : coneNodes)
+    {
+        std::vector<std::shared_ptr<Port>> ports;
+
+        for(const auto& port : node->getPorts())
+        {
+            auto portCopy = std::make_shared<Port>(port->getName(), port->getDirection(), port->getBits());
+            portCopy->setSymbolNameAlias(port->getSymbolNameAlias());
+
+            copiedPorts[port.get()] = portCopy;
+            ports.push_back(portCopy);
+        }
+
+        auto nodeCopy = std::make_shared<Node>(node->getName(), node->getType(), ports);
+        nodeCopy->setFoldedNames(node->getFoldedNames());
+
+        for(const auto& portCopy : ports)
+        {
+            portCopy->setParentNode(nodeCopy);
+        }
+
+        coneModule->addNode(nodeCopy);
+
+        auto subModuleIt = subModules.find(node->getName());
+
+        if(subModuleIt != subModules.end())
+        {
+            coneModule->addSubModule(subModuleIt->first, subModuleIt->second);
+        }
+    }
+
+    // the paths in the order they are found, the seed paths first
+    std::vector<std::shared_ptr<Path>> paths;
+    std::set<Path*> pathSet;
+
+    auto addPath = [&paths, &pathSet](const std::shared_ptr<Path>& path) {
+        if(path != nullptr && pathSet.insert(path.get()).second)
+        {
+            paths.push_back(path);
+        }
+    };
+
+    for(const auto& path : seedPaths)
+    {
+        addPath(path);
+    }
+
+    for(const auto& node : coneNodes)
+    {
+        for(const auto& port : node->getPorts())
+        {
+            addPath(port->getPath());
+        }
+    }
+
+    for(const auto& path : paths)
+    {
+        auto pathCopy = std::make_shared<Path>(path->getName(), path->getBits(), path->isNameHidden());
+
+        for(const auto& alternativeName : path->getAlternativeNames())
+        {
+            pathCopy->addAlternativeName(*alternativeName);
+        }
+
+        const auto source = path->getSigSource();
+        std::shared_ptr<Port> sourceCopy;
+
+        if(source != nullptr)
+        {
+            auto copiedIt = copiedPorts.find(source.get());
+
+            if(copiedIt != copiedPorts.end())
+            {
+                sourceCopy = copiedIt->second;
+            }
+            else if(source->getParentNode() == nullptr)
+            {
+                sourceCopy = copyModulePort(source, coneModule);
+            }
+        }
+
+        // a net driven from outside of the cone becomes an input
+        if(sourceCopy == nullptr)
+        {
+            sourceCopy = std::make_shared<Port>(generateBoundaryPortName(path->getName(), true), Port::EDirection::INPUT, path->getBits());
+            coneModule->addPort(sourceCopy);
+        }
+
+        pathCopy->setSigSource(sourceCopy);
+        sourceCopy->setPath(pathCopy);
+
+        bool leavesCone = false;
+
+        for(const auto& destination : *path->getSigDestinations())
+        {
+            std::shared_ptr<Port> destinationCopy;
+            auto copiedIt = copiedPorts.find(destination.get());
+
+            if(copiedIt != copiedPorts.end())
+            {
+                destinationCopy = copiedIt->second;
+            }
+            else if(destination->getParentNode() == nullptr)
+            {
+                destinationCopy = copyModulePort(destination, coneModule);
+            }
+            else
+            {
+                leavesCone = true;
+                continue;
+            }
+
+            pathCopy->addSigDestination(destinationCopy);
+            destinationCopy->setPath(pathCopy);
+        }
+
+        // all destinations outside of the cone share one output
+        if(leavesCone)
+        {
+            auto outputPort = std::make_shared<Port>(generateBoundaryPortName(path->getName(), false), Port::EDirection::OUTPUT, path->getBits());
+            coneModule->addPort(outputPort);
+
+            pathCopy->addSigDestination(outputPort);
+            outputPort->setPath(pathCopy);
+        }
+
+        coneModule->addPath(pathCopy);
+    }
+
+    return coneModule;
+}
+
+std::shared_ptr<Port> ConeExtractor::copyModulePort(const std::shared_ptr<Port>& port, const std::shared_ptr<Module>& coneModule)
+{
+    auto copiedIt = copiedPorts.find(port.get());
+
+    if(copiedIt != copiedPorts.end())
+    {
+        return copiedIt->second;
+    }
+
+    auto portCopy = std::make_shared<Port>(port->getName(), port->getDirection(), port->getBits());
+
+    if(port->getDirection() == Port::EDirection::CONST)
+    {
+        portCopy->setConstPortValue(port->getConstPortValue());
+    }
+
+    copiedPorts[port.get()] = portCopy;
+    coneModule->addPort(portCopy);
+
+    return portCopy;
+}
+
+QString ConeExtractor::generateBoundaryPortName(const QString& netName, bool input)
+{
+    const QString baseName = netName + (input ? inputPortSuffix : outputPortSuffix);
+    QString portName = baseName;
+
+    for(size_t number = 1; portNames.find(portName) != portNames.end(); number++)
+    {
+        portName = baseName + QString::number(number);
+    }
+
+    portNames.insert(portName);
+
+    return portName;
+}
+
+bool ConeExtractor::isSplitJoin(const std::shared_ptr<Node>& node)
+{
+    const QString type = node->getType();
+
+    return type == YosysJson::splitType || type == YosysJson::joinType;
+}
+
+} // namespace OpenNetlistView::Yosys
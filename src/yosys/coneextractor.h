@@ -0,0 +1,166 @@
+/**
+ * @file coneextractor.h
+ * @brief Header file for the ConeExtractor class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the ConeExtractor class, which builds a
+ * small synthetic module containing only the fan-in and fan-out of a cell or net,
+ * so the logic around a signal can be routed without routing the whole module.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __CONEEXTRACTOR_H__
+#define __CONEEXTRACTOR_H__
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+class Node;
+class Port;
+class Path;
+
+/**
+ * @class ConeExtractor
+ * @brief Extracts the neighbourhood of a cell or net into a new module.
+ *
+ * Starting at a node or path of the module the nodes reachable over the given
+ * number of levels are collected. Fan-in follows the paths from the inputs of a
+ * node to their sources, fan-out follows the outputs to the destinations. Split
+ * and join nodes are passed without counting as a level. Only the collected
+ * nodes and paths are visited, so the cost depends on the size of the cone and
+ * not on the size of the module.
+ *
+ * The nodes, ports and paths are copied into the new module, so it can be routed
+ * independently of the original module. Paths crossing the border of the cone are
+ * connected to new module ports named like the path with a suffix for the direction,
+ * made unique against the other ports. Ports of the original module connected to the
+ * cone are copied.
+ */
+class ConeExtractor
+{
+public:
+    constexpr const static unsigned int defaultDepth{2};   ///< The default number of levels of a cone.
+    constexpr const static char* inputPortSuffix{":in"};   ///< The suffix of a port of a net driven from outside of the cone.
+    constexpr const static char* outputPortSuffix{":out"}; ///< The suffix of a port of a net leaving the cone.
+
+    /**
+     * @enum EConeDirection
+     * @brief The directions a cone is extracted in.
+     */
+    enum class EConeDirection
+    {
+        FANIN,  ///< only the logic driving the start
+        FANOUT, ///< only the logic driven by the start
+        BOTH    ///< the fan-in and the fan-out
+    };
+
+    /**
+     * @brief Construct a new ConeExtractor object
+     *
+     * @param module The module to extract the cones from.
+     */
+    explicit ConeExtractor(std::shared_ptr<Module> module);
+
+    /**
+     * @brief Destroy the ConeExtractor object
+     *
+     */
+    ~ConeExtractor();
+
+    /**
+     * @brief Extracts the cone around a cell or net
+     *
+     * The name is first looked up in the nodes of the module, then in the
+     * paths and then in the ports of the module.
+     *
+     * @param name The name of the node, path or port to start at.
+     * @param depth The number of levels to follow.
+     * @param direction The directions to follow.
+     * @return std::shared_ptr<Module> The module of the cone or nullptr if the name does not exist.
+     */
+    std::shared_ptr<Module> extract(const QString& name, unsigned int depth = defaultDepth, EConeDirection direction = EConeDirection::BOTH);
+
+    /**
+     * @brief Generates the type of the module of a cone
+     *
+     * @param moduleType The type of the original module.
+     * @param name The name the cone was started at.
+     * @param depth The number of levels of the cone.
+     * @return QString The type of the module of the cone.
+     */
+    static QString generateConeType(const QString& moduleType, const QString& name, unsigned int depth);
+
+private:
+    /**
+     * @brief Collects the nodes of the cone in one direction
+     *
+     * @param startNodes The nodes to start at with their levels.
+     * @param depth The maximum level.
+     * @param fanIn true to follow the inputs, false to follow the outputs.
+     */
+    void collectNodes(const std::vector<std::pair<std::shared_ptr<Node>, unsigned int>>& startNodes, unsigned int depth, bool fanIn);
+
+    /**
+     * @brief Adds a node to the cone if it was not added yet
+     *
+     * @param node The node to add.
+     */
+    void addConeNode(const std::shared_ptr<Node>& node);
+
+    /**
+     * @brief Copies the collected nodes and their paths into a new module
+     *
+     * @param type The type of the new module.
+     * @return std::shared_ptr<Module> The new module.
+     */
+    std::shared_ptr<Module> buildModule(const QString& type);
+
+    /**
+     * @brief Copies a port of the original module into the new module
+     *
+     * @param port The port of the original module.
+     * @param coneModule The new module.
+     * @return std::shared_ptr<Port> The copied port.
+     */
+    std::shared_ptr<Port> copyModulePort(const std::shared_ptr<Port>& port, const std::shared_ptr<Module>& coneModule);
+
+    /**
+     * @brief Generates the name of a port of a net crossing the border of the cone
+     *
+     * The name is the name of the net with the suffix of the direction. If that
+     * name is already used by a port a number is appended.
+     *
+     * @param netName The name of the net.
+     * @param input true for a net driven from outside of the cone.
+     * @return QString The unique name of the port.
+     */
+    QString generateBoundaryPortName(const QString& netName, bool input);
+
+    /**
+     * @brief Checks if a node is a split or join node
+     *
+     * @param node The node to check.
+     * @return true if the node only splits or joins bits
+     */
+    static bool isSplitJoin(const std::shared_ptr<Node>& node);
+
+    std::shared_ptr<Module> module;                     ///< The module the cones are extracted from.
+    std::vector<std::shared_ptr<Node>> coneNodes;       ///< The nodes of the current cone in the order they were found.
+    std::set<Node*> coneNodeSet;                        ///< The nodes of the current cone for lookups.
+    std::vector<std::shared_ptr<Path>> seedPaths;       ///< The paths the current cone was started at.
+    std::map<Port*, std::shared_ptr<Port>> copiedPorts; ///< The copies of the ports of the original module by original port.
+    std::set<QString> portNames;                        ///< The names of the ports of the original module and the current cone.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __CONEEXTRACTOR_H__
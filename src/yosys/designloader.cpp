@@ -0,0 +1,161 @@
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+
+#include <memory>
+#include <map>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include <scheduler/taskscheduler.h>
+
+#include "parser.h"
+#include "diagram.h"
+#include "module.h"
+#include "layoutbundle.h"
+#include "rtlilreader.h"
+#include "netlistsimplifier.h"
+
+#include "designloader.h"
+
+namespace OpenNetlistView::Yosys {
+
+DesignLoader::DesignLoader() = default;
+
+DesignLoader::~DesignLoader() = default;
+
+void DesignLoader::setSliceFolding(bool enabled)
+{
+    this->sliceFolding = enabled;
+}
+
+void DesignLoader::setSimplificationPasses(const QStringList& passNames)
+{
+    const QStringList knownPasses = NetlistSimplifier::getPassNames();
+
+    for(const auto& passName : passNames)
+    {
+        if(!knownPasses.contains(passName))
+        {
+            throw std::runtime_error("Unknown simplification pass: " + passName.toStdString());
+        }
+    }
+
+    this->simplificationPasses = passNames;
+}
+
+QStringList DesignLoader::getSimplificationPasses() const
+{
+    return this->simplificationPasses;
+}
+
+std::unique_ptr<DesignLoader::Result> DesignLoader::load(const QString& fileName,
+    const QByteArray& fileContent,
+    const Scheduler::CancellationToken& token,
+    const std::function<void(EStage)>& stageStarted) const
+{
+    auto result = std::make_unique<Result>();
+
+    startStage(EStage::READ, token, stageStarted);
+
+    QByteArray content = fileContent;
+
+    if(content.isEmpty())
+    {
+        QFile file(fileName);
+
+        if(!file.open(QIODevice::ReadOnly))
+        {
+            throw std::runtime_error("Could not open file: " + fileName.toStdString());
+        }
+
+        content = file.readAll();
+    }
+
+    // every loading uses its own parser so the settings of the
+    // loader can be changed while a design is loaded
+    Parser parser;
+    parser.setSliceFolding(this->sliceFolding);
+    parser.setSimplificationPasses(this->simplificationPasses);
+
+    // a layout bundle contains the netlist and the routed geometry of the modules
+    if(LayoutBundle::isLayoutBundle(content))
+    {
+        result->layoutBundle = std::make_unique<LayoutBundle>(content);
+        result->layoutBundle->readHeader();
+
+        // the layout only matches the netlist parsed the same way
+        parser.setYosysJsonObject(result->layoutBundle->getNetlist());
+        parser.setSliceFolding(result->layoutBundle->getFoldSlices());
+        parser.setSimplificationPasses(result->layoutBundle->getSimplificationPasses());
+    }
+    // the bit arrays of a netlist are decoded by the parser before the json is read
+    else if(RtlilReader::isRtlil(content))
+    {
+        parser.setRtlilData(content);
+    }
+    else
+    {
+        parser.setYosysJsonData(content);
+    }
+
+    startStage(EStage::PARSE, token, stageStarted);
+
+    parser.parse(token);
+
+    result->diagram = parser.getDiagram();
+    result->foldSlices = parser.getSliceFolding();
+    result->simplificationPasses = parser.getSimplificationPasses();
+    result->simplificationStatistics = parser.getSimplificationStatistics();
+
+    const auto topModule = result->diagram->getTopModule();
+
+    if(topModule == nullptr)
+    {
+        throw std::runtime_error("The design has no module with the \"top\" attribute.\nYou need to synthesise the design with the \"hierarchy -auto-top\" command");
+    }
+
+    startStage(EStage::LINK, token, stageStarted);
+
+    result->diagram->linkSubModules(topModule);
+
+    if(token.isCanceled())
+    {
+        throw std::runtime_error("The loading was canceled");
+    }
+
+    return result;
+}
+
+QString DesignLoader::getStageName(EStage stage)
+{
+    switch(stage)
+    {
+        case EStage::READ:
+            return "Reading";
+        case EStage::PARSE:
+            return "Parsing";
+        case EStage::LINK:
+            return "Linking";
+    }
+
+    return {};
+}
+
+void DesignLoader::startStage(EStage stage, const Scheduler::CancellationToken& token, const std::function<void(EStage)>& stageStarted)
+{
+    if(token.isCanceled())
+    {
+        throw std::runtime_error("The loading was canceled");
+    }
+
+    if(stageStarted)
+    {
+        stageStarted(stage);
+    }
+}
+
+} // namespace OpenNetlistView::Yosys
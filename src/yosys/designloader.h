@@ -0,0 +1,158 @@
+/**
+ * @file designloader.h
+ * @brief Header file for the DesignLoader class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the DesignLoader class, which runs the
+ * stages that turn the content of a netlist file into a linked and indexed diagram.
+ * It does not use any GUI classes, so a design can be loaded on a worker thread
+ * and handed to the GUI once it is finished.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __DESIGNLOADER_H__
+#define __DESIGNLOADER_H__
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+#include <memory>
+#include <map>
+#include <functional>
+#include <cstddef>
+
+#include <scheduler/taskscheduler.h>
+
+#include "diagram.h"
+#include "layoutbundle.h"
+
+namespace OpenNetlistView::Yosys {
+
+/**
+ * @class DesignLoader
+ * @brief Loads a design from a yosys JSON, RTLIL or layout bundle file.
+ *
+ * The loading is split into stages that are run one after another:
+ *
+ * - read: reads the file if no content is given, decodes the JSON or RTLIL netlist
+ *   and the header of a layout bundle
+ * - parse: parses the modules of the netlist into a diagram
+ * - link: links the submodules of the top module
+ *
+ * The net index of the diagram is not built by the loader, it binds the
+ * instances of the hierarchy lazily on the first lookup.
+ *
+ * The loader only stores the parse settings, so a copy of it can be used by
+ * another thread while the settings of the original are changed.
+ */
+class DesignLoader
+{
+public:
+    /**
+     * @enum EStage
+     * @brief The stages of the loading in the order they are run.
+     */
+    enum class EStage
+    {
+        READ,  ///< Reading and decoding the file.
+        PARSE, ///< Parsing the modules of the netlist.
+        LINK   ///< Linking the submodules.
+    };
+
+    constexpr const static int stageCount{3}; ///< The number of stages.
+
+    /**
+     * @struct Result
+     * @brief A loaded design.
+     */
+    struct Result
+    {
+        std::unique_ptr<Diagram> diagram;                   ///< The linked diagram with a top module.
+        std::unique_ptr<LayoutBundle> layoutBundle;         ///< The bundle with the read header or nullptr for a netlist.
+        bool foldSlices = false;                            ///< If the replicated cells were folded.
+        QStringList simplificationPasses;                   ///< The simplification passes that were run.
+        std::map<QString, size_t> simplificationStatistics; ///< The number of cells removed by every pass.
+    };
+
+    /**
+     * @brief Construct a new DesignLoader object without slice folding and simplification
+     *
+     */
+    DesignLoader();
+
+    /**
+     * @brief Destroy the DesignLoader object
+     *
+     */
+    ~DesignLoader();
+
+    /**
+     * @brief Enables or disables the folding of replicated cells.
+     *
+     * A layout bundle uses the setting it was written with.
+     *
+     * @param enabled true to fold the replicated cells.
+     */
+    void setSliceFolding(bool enabled);
+
+    /**
+     * @brief Sets the netlist simplification passes.
+     *
+     * A layout bundle uses the passes it was written with.
+     *
+     * @param passNames The names of the passes in the order they are run.
+     * @throws std::runtime_error if a pass name is unknown.
+     */
+    void setSimplificationPasses(const QStringList& passNames);
+
+    /**
+     * @brief Gets the netlist simplification passes.
+     *
+     * @return The names of the enabled passes.
+     */
+    QStringList getSimplificationPasses() const;
+
+    /**
+     * @brief Loads a design
+     *
+     * The token is checked between the stages and while the modules are parsed.
+     *
+     * @param fileName The name of the file, it is read if the content is empty.
+     * @param fileContent The content of the file or an empty array.
+     * @param token The token to cancel the loading with.
+     * @param stageStarted Called from the loading thread when a stage is started or nullptr.
+     * @return std::unique_ptr<Result> The loaded design.
+     * @throws std::runtime_error if the file is invalid or the loading was canceled.
+     */
+    std::unique_ptr<Result> load(const QString& fileName,
+        const QByteArray& fileContent,
+        const Scheduler::CancellationToken& token = Scheduler::CancellationToken(),
+        const std::function<void(EStage)>& stageStarted = nullptr) const;
+
+    /**
+     * @brief Get the name of a stage to show to the user
+     *
+     * @param stage The stage.
+     * @return QString The name of the stage.
+     */
+    static QString getStageName(EStage stage);
+
+private:
+    bool sliceFolding = false;        ///< If replicated cells are folded.
+    QStringList simplificationPasses; ///< The simplification passes that are run.
+
+    /**
+     * @brief Starts a stage if the loading was not canceled
+     *
+     * @param stage The stage to start.
+     * @param token The token of the loading.
+     * @param stageStarted The callback of the loading or nullptr.
+     * @throws std::runtime_error if the loading was canceled.
+     */
+    static void startStage(EStage stage, const Scheduler::CancellationToken& token, const std::function<void(EStage)>& stageStarted);
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __DESIGNLOADER_H__
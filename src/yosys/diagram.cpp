@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "module.h"
+#include "netindex.h"
 
 #include "diagram.h"
 
@@ -26,6 +27,7 @@ void Diagram::setTopModule(const std::shared_ptr<Module>& module)
     if(module != nullptr)
     {
         topModule = module;
+        netIndex.reset();
     }
 }
 
@@ -35,6 +37,7 @@ void Diagram::addTopModule(const std::shared_ptr<Module>& module)
     {
         addModule(module);
         topModule = module;
+        netIndex.reset();
     }
 }
 
@@ -75,6 +78,9 @@ void Diagram::linkSubModules(const std::shared_ptr<Module>& module)
         return;
     }
 
+    // the bindings of the instances change with the links
+    netIndex.reset();
+
     // get all the nodes of the module
     auto nodes = module->getNodes();
 
@@ -121,4 +127,14 @@ void Diagram::printSubModuleHierarchy(const std::shared_ptr<Module>& module, con
 }
 // NOLINTEND(misc-no-recursion)
 
+std::shared_ptr<NetIndex> Diagram::getNetIndex()
+{
+    if(netIndex == nullptr && topModule != nullptr)
+    {
+        netIndex = std::make_shared<NetIndex>(topModule);
+    }
+
+    return netIndex;
+}
+
 } // namespace OpenNetlistView::Yosys
@@ -14,6 +14,7 @@ namespace OpenNetlistView::Yosys {
 
 // forward declaration
 class Module;
+class NetIndex;
 
 /**
  * @class Diagram
@@ -105,9 +106,20 @@ public:
      */
     void printSubModuleHierarchy(const std::shared_ptr<Module>& module, const int depth = 0);
 
+    /**
+     * @brief Get the index of the nets across the hierarchy of the top module
+     *
+     * the index is created on the first call and reset when the top module
+     * or the links of the sub modules change
+     *
+     * @return std::shared_ptr<NetIndex> the net index or nullptr if there is no top module
+     */
+    std::shared_ptr<NetIndex> getNetIndex();
+
 private:
     std::vector<std::shared_ptr<Module>> modules; ///< Vector of shared pointers to Module objects.
     std::shared_ptr<Module> topModule;            ///< Shared pointer to the top Module object.
+    std::shared_ptr<NetIndex> netIndex;           ///< The global net index of the top module hierarchy.
 };
 
 } // namespace OpenNetlistView::Yosys
@@ -0,0 +1,386 @@
+#include <QString>
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QHash>
+#include <QStringList>
+#include <QRectF>
+#include <QPointF>
+#include <QPolygonF>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdexcept>
+#include <string>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "path.h"
+
+#include "layoutbundle.h"
+
+namespace OpenNetlistView::Yosys {
+
+QByteArray LayoutBundle::writeHeader(const QString& topModule, qsizetype moduleCount, bool foldSlices,
+                                     const QStringList& simplificationPasses)
+{
+    QJsonObject header;
+    header[LayoutJson::format] = formatName;
+    header[LayoutJson::version] = formatVersion;
+    header[LayoutJson::top] = topModule;
+    header[LayoutJson::modules] = static_cast<qint64>(moduleCount);
+    header[LayoutJson::foldSlices] = foldSlices;
+    header[LayoutJson::simplify] = QJsonArray::fromStringList(simplificationPasses);
+
+    return QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray LayoutBundle::writeNetlist(const QJsonObject& netlist)
+{
+    QJsonObject netlistObject;
+    netlistObject[LayoutJson::netlist] = netlist;
+
+    return QJsonDocument(netlistObject).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray LayoutBundle::writeModule(const std::shared_ptr<Module>& module)
+{
+    QJsonObject moduleObject;
+    moduleObject[LayoutJson::module] = module->getType();
+
+    QJsonArray nodeArray;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        nodeArray.append(writeRect(node->getName(), node->getRoutedRect()));
+    }
+
+    QJsonArray portArray;
+
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        portArray.append(writeRect(port->getName(), port->getRoutedRect()));
+    }
+
+    QJsonArray pathArray;
+
+    const auto paths = module->getPaths();
+
+    for(const auto& path : *paths)
+    {
+        QJsonObject pathObject;
+        pathObject[LayoutJson::name] = path->getName();
+        pathObject[LayoutJson::label] = path->generateLabelText();
+
+        // the destinations are stored by their index in the path
+        const auto destinations = path->getSigDestinations();
+        std::map<Port*, int> destinationIdxs;
+
+        for(size_t destinationIdx = 0; destinationIdx < destinations->size(); destinationIdx++)
+        {
+            destinationIdxs.emplace(destinations->at(destinationIdx).get(), static_cast<int>(destinationIdx));
+        }
+
+        QJsonArray lineArray;
+
+        for(const auto& routedLine : path->getRoutedLines())
+        {
+            auto destinationIt = destinationIdxs.find(routedLine.destination.get());
+
+            QJsonObject lineObject;
+            lineObject[LayoutJson::destination] = destinationIt != destinationIdxs.end() ? destinationIt->second : -1;
+            lineObject[LayoutJson::label] = path->generateLabelText(routedLine.destination);
+            lineObject[LayoutJson::points] = writePoints(routedLine.points);
+
+            lineArray.append(lineObject);
+        }
+
+        const auto junctions = path->getJunctions();
+
+        pathObject[LayoutJson::lines] = lineArray;
+        pathObject[LayoutJson::junctions] = writePoints(QPolygonF(QList<QPointF>(junctions.begin(), junctions.end())));
+
+        pathArray.append(pathObject);
+    }
+
+    moduleObject[LayoutJson::nodes] = nodeArray;
+    moduleObject[LayoutJson::ports] = portArray;
+    moduleObject[LayoutJson::paths] = pathArray;
+
+    return QJsonDocument(moduleObject).toJson(QJsonDocument::Compact) + '\n';
+}
+
+bool LayoutBundle::isLayoutBundle(const QByteArray& data)
+{
+    const qsizetype lineEnd = data.indexOf('\n');
+    const QJsonDocument headerDoc = QJsonDocument::fromJson(lineEnd < 0 ? data : data.left(lineEnd));
+
+    return headerDoc.isObject() && headerDoc.object().value(LayoutJson::format).toString() == formatName;
+}
+
+LayoutBundle::LayoutBundle(QByteArray data)
+    : data(std::move(data))
+{
+}
+
+LayoutBundle::~LayoutBundle() = default;
+
+void LayoutBundle::readHeader()
+{
+    readPos = 0;
+
+    const QJsonDocument headerDoc = QJsonDocument::fromJson(readLine());
+    const QJsonObject header = headerDoc.object();
+
+    if(!headerDoc.isObject() || header.value(LayoutJson::format).toString() != formatName)
+    {
+        throw std::runtime_error("The file is not a layout bundle");
+    }
+
+    if(header.value(LayoutJson::version).toInt() > formatVersion)
+    {
+        throw std::runtime_error("The layout bundle was written by a newer version (format version " +
+                                 std::to_string(header.value(LayoutJson::version).toInt()) + ")");
+    }
+
+    foldSlices = header.value(LayoutJson::foldSlices).toBool();
+    simplificationPasses.clear();
+
+    for(const auto& passName : header.value(LayoutJson::simplify).toArray())
+    {
+        simplificationPasses.append(passName.toString());
+    }
+    moduleCount = header.value(LayoutJson::modules).toInteger();
+
+    const QJsonDocument netlistDoc = QJsonDocument::fromJson(readLine());
+
+    if(!netlistDoc.isObject() || !netlistDoc.object().value(LayoutJson::netlist).isObject())
+    {
+        throw std::runtime_error("The layout bundle contains no valid netlist");
+    }
+
+    netlist = netlistDoc.object().value(LayoutJson::netlist).toObject();
+}
+
+const QJsonObject& LayoutBundle::getNetlist() const
+{
+    return netlist;
+}
+
+bool LayoutBundle::getFoldSlices() const
+{
+    return foldSlices;
+}
+
+QStringList LayoutBundle::getSimplificationPasses() const
+{
+    return simplificationPasses;
+}
+
+qsizetype LayoutBundle::getModuleCount() const
+{
+    return moduleCount;
+}
+
+void LayoutBundle::setModules(const std::vector<std::shared_ptr<Module>>& modules)
+{
+    this->modules.clear();
+
+    for(const auto& module : modules)
+    {
+        this->modules.insert(module->getType(), module);
+    }
+}
+
+bool LayoutBundle::atEnd() const
+{
+    // trailing line breaks are no modules
+    for(qsizetype pos = readPos; pos < data.size(); pos++)
+    {
+        if(data.at(pos) != '\n' && data.at(pos) != '\r')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::shared_ptr<Module> LayoutBundle::readModule()
+{
+    if(atEnd())
+    {
+        return nullptr;
+    }
+
+    const QJsonDocument moduleDoc = QJsonDocument::fromJson(readLine());
+
+    if(!moduleDoc.isObject())
+    {
+        throw std::runtime_error("The layout bundle contains an invalid module");
+    }
+
+    const QJsonObject moduleObject = moduleDoc.object();
+    auto moduleIt = modules.constFind(moduleObject.value(LayoutJson::module).toString());
+
+    // a module that is shown already keeps its layout
+    if(moduleIt == modules.constEnd() || (*moduleIt)->getIsRouted())
+    {
+        return nullptr;
+    }
+
+    if(!applyModule(moduleObject, *moduleIt))
+    {
+        return nullptr;
+    }
+
+    return *moduleIt;
+}
+
+QByteArray LayoutBundle::readLine()
+{
+    qsizetype lineEnd = data.indexOf('\n', readPos);
+
+    if(lineEnd < 0)
+    {
+        lineEnd = data.size();
+    }
+
+    QByteArray line = data.mid(readPos, lineEnd - readPos);
+    readPos = lineEnd + 1;
+
+    return line;
+}
+
+bool LayoutBundle::applyModule(const QJsonObject& moduleObject, const std::shared_ptr<Module>& module)
+{
+    const QJsonArray nodeArray = moduleObject.value(LayoutJson::nodes).toArray();
+    const QJsonArray portArray = moduleObject.value(LayoutJson::ports).toArray();
+    const QJsonArray pathArray = moduleObject.value(LayoutJson::paths).toArray();
+
+    const auto nodes = module->getNodes();
+    const auto ports = module->getPorts();
+    const auto paths = module->getPaths();
+
+    if(nodeArray.size() != static_cast<qsizetype>(nodes->size()) ||
+        portArray.size() != static_cast<qsizetype>(ports->size()) ||
+        pathArray.size() != static_cast<qsizetype>(paths->size()))
+    {
+        return false;
+    }
+
+    // the layout has to be created from the same netlist
+    for(qsizetype nodeIdx = 0; nodeIdx < nodeArray.size(); nodeIdx++)
+    {
+        if(nodeArray.at(nodeIdx).toArray().at(0).toString() != nodes->at(nodeIdx)->getName())
+        {
+            return false;
+        }
+    }
+
+    for(qsizetype portIdx = 0; portIdx < portArray.size(); portIdx++)
+    {
+        if(portArray.at(portIdx).toArray().at(0).toString() != ports->at(portIdx)->getName())
+        {
+            return false;
+        }
+    }
+
+    for(qsizetype pathIdx = 0; pathIdx < pathArray.size(); pathIdx++)
+    {
+        if(pathArray.at(pathIdx).toObject().value(LayoutJson::name).toString() != paths->at(pathIdx)->getName())
+        {
+            return false;
+        }
+    }
+
+    for(qsizetype nodeIdx = 0; nodeIdx < nodeArray.size(); nodeIdx++)
+    {
+        nodes->at(nodeIdx)->setLayoutRect(readRect(nodeArray.at(nodeIdx).toArray()));
+    }
+
+    for(qsizetype portIdx = 0; portIdx < portArray.size(); portIdx++)
+    {
+        ports->at(portIdx)->setLayoutRect(readRect(portArray.at(portIdx).toArray()));
+    }
+
+    for(qsizetype pathIdx = 0; pathIdx < pathArray.size(); pathIdx++)
+    {
+        const QJsonObject pathObject = pathArray.at(pathIdx).toObject();
+        const auto& path = paths->at(pathIdx);
+        const auto destinations = path->getSigDestinations();
+
+        std::vector<Path::RoutedLine> routedLines;
+
+        for(const auto& lineValue : pathObject.value(LayoutJson::lines).toArray())
+        {
+            const QJsonObject lineObject = lineValue.toObject();
+            const int destinationIdx = lineObject.value(LayoutJson::destination).toInt(-1);
+
+            Path::RoutedLine routedLine;
+            routedLine.points = readPoints(lineObject.value(LayoutJson::points).toArray());
+
+            if(destinationIdx >= 0 && destinationIdx < static_cast<int>(destinations->size()))
+            {
+                routedLine.destination = destinations->at(destinationIdx);
+            }
+
+            routedLines.push_back(std::move(routedLine));
+        }
+
+        const QPolygonF junctions = readPoints(pathObject.value(LayoutJson::junctions).toArray());
+
+        path->setLayoutLines(std::move(routedLines), std::vector<QPointF>(junctions.begin(), junctions.end()));
+    }
+
+    module->setLayoutLoaded();
+
+    return true;
+}
+
+QJsonArray LayoutBundle::writeRect(const QString& name, const QRectF& rect)
+{
+    return {name, rect.x(), rect.y(), rect.width(), rect.height()};
+}
+
+QRectF LayoutBundle::readRect(const QJsonArray& rectArray)
+{
+    return {rectArray.at(1).toDouble(), rectArray.at(2).toDouble(), rectArray.at(3).toDouble(), rectArray.at(4).toDouble()};
+}
+
+QJsonArray LayoutBundle::writePoints(const QPolygonF& points)
+{
+    QJsonArray pointArray;
+
+    for(const auto& point : points)
+    {
+        pointArray.append(point.x());
+        pointArray.append(point.y());
+    }
+
+    return pointArray;
+}
+
+QPolygonF LayoutBundle::readPoints(const QJsonArray& pointArray)
+{
+    QPolygonF points;
+    points.reserve(pointArray.size() / 2);
+
+    for(qsizetype coordIdx = 0; coordIdx + 1 < pointArray.size(); coordIdx += 2)
+    {
+        points.append(QPointF(pointArray.at(coordIdx).toDouble(), pointArray.at(coordIdx + 1).toDouble()));
+    }
+
+    return points;
+}
+
+} // namespace OpenNetlistView::Yosys
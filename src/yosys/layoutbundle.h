@@ -0,0 +1,263 @@
+/**
+ * @file layoutbundle.h
+ * @brief Header file for the LayoutBundle class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the LayoutBundle class, which writes the
+ * routed geometry of modules into a portable layout bundle and applies the geometry
+ * of a bundle to the modules of a parsed netlist, so the modules can be displayed
+ * without routing them again.
+ *
+ * It also defines a namespace LayoutJson that contains the keys of the JSON objects
+ * in a layout bundle.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __LAYOUTBUNDLE_H__
+#define __LAYOUTBUNDLE_H__
+
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QStringList>
+#include <QRectF>
+#include <QPolygonF>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @namespace LayoutJson
+ * @brief This namespace contains key value constants for the JSON fields of a layout bundle.
+ */
+namespace LayoutJson {
+
+constexpr const char* format{"format"};         ///< Key for the format name in the header.
+constexpr const char* version{"version"};       ///< Key for the format version in the header.
+constexpr const char* top{"top"};               ///< Key for the type of the top module in the header.
+constexpr const char* modules{"modules"};       ///< Key for the number of modules in the header.
+constexpr const char* foldSlices{"foldSlices"}; ///< Key for the slice folding of the netlist in the header.
+constexpr const char* simplify{"simplify"};     ///< Key for the simplification passes of the netlist in the header.
+constexpr const char* netlist{"netlist"};       ///< Key for the yosys netlist.
+
+constexpr const char* module{"module"}; ///< Key for the type of a module.
+constexpr const char* nodes{"nodes"};   ///< Key for the nodes of a module.
+constexpr const char* ports{"ports"};   ///< Key for the ports of a module.
+constexpr const char* paths{"paths"};   ///< Key for the paths of a module.
+
+constexpr const char* name{"name"};           ///< Key for the name of a path.
+constexpr const char* label{"label"};         ///< Key for the label of a path or line.
+constexpr const char* lines{"lines"};         ///< Key for the routed lines of a path.
+constexpr const char* junctions{"junctions"}; ///< Key for the junctions of a path.
+constexpr const char* destination{"dst"};     ///< Key for the index of the destination of a line.
+constexpr const char* points{"points"};       ///< Key for the points of a line.
+
+} // namespace LayoutJson
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+
+/**
+ * @class LayoutBundle
+ * @brief Writes and reads the routed geometry of modules.
+ *
+ * A layout bundle is a UTF-8 file with one compact JSON object per line. The first
+ * line is the header, the second line contains the yosys netlist and every following
+ * line contains the geometry of one module, starting with the top module:
+ *
+ * - the nodes and ports as [name, x, y, width, height]
+ * - the paths with their labels, their routed lines as flat point lists with the
+ *   index of the destination they end at and the junctions of the lines
+ *
+ * The nodes, ports and paths are stored in the order of the parsed module, so
+ * reading a module only compares the names and copies the geometry. A module is
+ * decoded on its own, so the first module can be displayed before the rest of
+ * the bundle is read.
+ */
+class LayoutBundle
+{
+public:
+    constexpr const static char* formatName{"OpenNetlistView-layout"}; ///< The name of the format in the header.
+    constexpr const static int formatVersion{1};                       ///< The version of the format that is written.
+    constexpr const static char* fileSuffix{"onvl"};                   ///< The suffix of layout bundle files.
+
+    /**
+     * @brief Writes the header line of a layout bundle
+     *
+     * @param topModule The type of the top module.
+     * @param moduleCount The number of module lines following the netlist.
+     * @param foldSlices If the netlist was parsed with slice folding.
+     * @param simplificationPasses The simplification passes the netlist was parsed with.
+     * @return QByteArray The header line.
+     */
+    static QByteArray writeHeader(const QString& topModule, qsizetype moduleCount, bool foldSlices,
+                                  const QStringList& simplificationPasses = {});
+
+    /**
+     * @brief Writes the netlist line of a layout bundle
+     *
+     * @param netlist The yosys netlist the layout was created from.
+     * @return QByteArray The netlist line.
+     */
+    static QByteArray writeNetlist(const QJsonObject& netlist);
+
+    /**
+     * @brief Writes the geometry of a routed module
+     *
+     * @param module The routed module.
+     * @return QByteArray The module line.
+     */
+    static QByteArray writeModule(const std::shared_ptr<Module>& module);
+
+    /**
+     * @brief Checks if the data starts with the header of a layout bundle
+     *
+     * Only the first line is parsed.
+     *
+     * @param data The data to check.
+     * @return true if the data is a layout bundle
+     */
+    static bool isLayoutBundle(const QByteArray& data);
+
+    /**
+     * @brief Construct a new LayoutBundle object to read a bundle
+     *
+     * @param data The content of the layout bundle.
+     */
+    explicit LayoutBundle(QByteArray data);
+
+    /**
+     * @brief Destroy the LayoutBundle object
+     *
+     */
+    ~LayoutBundle();
+
+    /**
+     * @brief Reads the header and the netlist of the bundle
+     *
+     * @throw std::runtime_error if the header or the netlist is invalid
+     */
+    void readHeader();
+
+    /**
+     * @brief Gets the yosys netlist of the bundle
+     *
+     * @return const QJsonObject& The netlist, empty before readHeader() was called.
+     */
+    const QJsonObject& getNetlist() const;
+
+    /**
+     * @brief Gets if the netlist has to be parsed with slice folding
+     *
+     * @return true if the layout was created with folded slices
+     */
+    bool getFoldSlices() const;
+
+    /**
+     * @brief Gets the simplification passes the netlist has to be parsed with
+     *
+     * @return QStringList The names of the passes the layout was created with.
+     */
+    QStringList getSimplificationPasses() const;
+
+    /**
+     * @brief Gets the number of modules in the bundle
+     *
+     * @return qsizetype The number of modules given in the header.
+     */
+    qsizetype getModuleCount() const;
+
+    /**
+     * @brief Sets the modules of the parsed netlist the layout is applied to
+     *
+     * @param modules The modules of the diagram.
+     */
+    void setModules(const std::vector<std::shared_ptr<Module>>& modules);
+
+    /**
+     * @brief Checks if all modules were read
+     *
+     * @return true if there is no line left
+     */
+    bool atEnd() const;
+
+    /**
+     * @brief Reads the next module and applies its geometry
+     *
+     * Modules that are unknown, already routed or do not match the
+     * netlist are skipped, they are routed when they are displayed.
+     *
+     * @throw std::runtime_error if the line is not a valid module
+     *
+     * @return std::shared_ptr<Module> The module the layout was applied to or nullptr if it was skipped.
+     */
+    std::shared_ptr<Module> readModule();
+
+private:
+    /**
+     * @brief Reads the next line of the bundle
+     *
+     * @return QByteArray The line without the line break.
+     */
+    QByteArray readLine();
+
+    /**
+     * @brief Applies the geometry of a module line to a module
+     *
+     * The names of all items are checked before anything is changed.
+     *
+     * @param moduleObject The module line.
+     * @param module The module to apply the geometry to.
+     * @return true if the geometry matches the module and was applied
+     */
+    static bool applyModule(const QJsonObject& moduleObject, const std::shared_ptr<Module>& module);
+
+    /**
+     * @brief Creates the entry of a node or port
+     *
+     * @param name The name of the item.
+     * @param rect The routed area of the item.
+     * @return QJsonArray The entry [name, x, y, width, height].
+     */
+    static QJsonArray writeRect(const QString& name, const QRectF& rect);
+
+    /**
+     * @brief Reads the area of a node or port entry
+     *
+     * @param rectArray The entry [name, x, y, width, height].
+     * @return QRectF The area of the item.
+     */
+    static QRectF readRect(const QJsonArray& rectArray);
+
+    /**
+     * @brief Creates a flat list of coordinates
+     *
+     * @param points The points to write.
+     * @return QJsonArray The coordinates [x0, y0, x1, y1, ...].
+     */
+    static QJsonArray writePoints(const QPolygonF& points);
+
+    /**
+     * @brief Reads a flat list of coordinates
+     *
+     * @param pointArray The coordinates [x0, y0, x1, y1, ...].
+     * @return QPolygonF The points.
+     */
+    static QPolygonF readPoints(const QJsonArray& pointArray);
+
+    QByteArray data;                                 ///< The content of the layout bundle.
+    qsizetype readPos = 0;                           ///< The position of the next line in the data.
+    QJsonObject netlist;                             ///< The yosys netlist of the bundle.
+    bool foldSlices = false;                         ///< If the netlist was parsed with slice folding.
+    QStringList simplificationPasses;                ///< The simplification passes the netlist was parsed with.
+    qsizetype moduleCount = 0;                       ///< The number of modules given in the header.
+    QHash<QString, std::shared_ptr<Module>> modules; ///< The modules of the netlist by type.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __LAYOUTBUNDLE_H__
@@ -1,6 +1,10 @@
-#include <QGraphicsItem>
 #include <QString>
 #include <QStringList>
+#include <QRectF>
+#include <QPointF>
+#include <third_party/libavoid/shape.h>
+#include <third_party/libavoid/connector.h>
+#include <third_party/libavoid/geomtypes.h>
 
 #include <memory>
 #include <vector>
@@ -9,11 +13,11 @@
 #include <algorithm>
 #include <utility>
 #include <map>
+#include <set>
 #include <cmath>
 #include <cstdint>
 
-#include <qnetlistgraphicsnode.h>
-#include <qnetlistgraphicspath.h>
+#include <scheduler/taskscheduler.h>
 
 #include "node.h"
 #include "port.h"
@@ -57,6 +61,16 @@ bool Module::getIsRouted() const
     return isRouted;
 }
 
+void Module::setLayoutLoaded()
+{
+    layoutLoaded = true;
+}
+
+bool Module::getLayoutLoaded() const
+{
+    return layoutLoaded;
+}
+
 void Module::addSubModule(const QString& instName, const std::shared_ptr<Module>& module)
 {
     subModules[instName] = module;
@@ -118,6 +132,167 @@ void Module::removePath(const std::shared_ptr<Path>& path)
     }
 }
 
+void Module::removeNodes(const std::vector<std::shared_ptr<Node>>& nodesToRemove)
+{
+    if(nodesToRemove.empty())
+    {
+        return;
+    }
+
+    // remove all nodes in one pass so large numbers of nodes can be removed
+    std::set<Node*> removeSet;
+
+    for(const auto& node : nodesToRemove)
+    {
+        removeSet.insert(node.get());
+    }
+
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [&removeSet](const std::shared_ptr<Node>& node) {
+        return removeSet.count(node.get()) != 0;
+    }),
+        nodes.end());
+}
+
+void Module::addSimplifiedCell(const QString& cellName, const QString& representative)
+{
+    simplifiedCells[cellName] = representative;
+}
+
+QString Module::getSimplifiedCellRepresentative(const QString& cellName) const
+{
+    auto cellIt = simplifiedCells.find(cellName);
+
+    if(cellIt == simplifiedCells.end())
+    {
+        return {};
+    }
+
+    QString representative = cellIt->second;
+
+    // every cell is recorded once, so a chain is never longer than the records
+    for(size_t step = 0; step < simplifiedCells.size(); step++)
+    {
+        cellIt = simplifiedCells.find(representative);
+
+        if(cellIt == simplifiedCells.end())
+        {
+            break;
+        }
+
+        representative = cellIt->second;
+    }
+
+    return representative;
+}
+
+std::shared_ptr<Module> Module::clone() const
+{
+    auto moduleCopy = std::make_shared<Module>(type);
+    std::map<const Port*, std::shared_ptr<Port>> copiedPorts;
+
+    auto copyPort = [&copiedPorts](const std::shared_ptr<Port>& port) {
+        auto portCopy = std::make_shared<Port>(port->getName(), port->getDirection(), port->getBits());
+        portCopy->setSymbolNameAlias(port->getSymbolNameAlias());
+
+        if(port->getDirection() == Port::EDirection::CONST)
+        {
+            portCopy->setConstPortValue(port->getConstPortValue());
+        }
+
+        copiedPorts[port.get()] = portCopy;
+
+        return portCopy;
+    };
+
+    for(const auto& port : ports)
+    {
+        moduleCopy->addPort(copyPort(port));
+    }
+
+    for(const auto& node : nodes)
+    {
+        std::vector<std::shared_ptr<Port>> nodePorts;
+
+        for(const auto& port : node->getPorts())
+        {
+            nodePorts.push_back(copyPort(port));
+        }
+
+        auto nodeCopy = std::make_shared<Node>(node->getName(), node->getType(), nodePorts);
+        nodeCopy->setFoldedNames(node->getFoldedNames());
+
+        for(const auto& portCopy : nodePorts)
+        {
+            portCopy->setParentNode(nodeCopy);
+        }
+
+        moduleCopy->addNode(nodeCopy);
+    }
+
+    // the ends of the paths are the copied ports
+    auto findCopy = [&copiedPorts](const std::shared_ptr<Port>& port) -> std::shared_ptr<Port> {
+        auto copiedIt = copiedPorts.find(port.get());
+
+        return copiedIt != copiedPorts.end() ? copiedIt->second : nullptr;
+    };
+
+    for(const auto& path : paths)
+    {
+        auto pathCopy = std::make_shared<Path>(path->getName(), path->getBits(), path->isNameHidden());
+        pathCopy->setAllowSplit(path->getAllowSplit());
+
+        for(const auto& alternativeName : path->getAlternativeNames())
+        {
+            pathCopy->addAlternativeName(*alternativeName);
+        }
+
+        const auto source = path->getSigSource();
+
+        if(source != nullptr)
+        {
+            auto sourceCopy = findCopy(source);
+
+            if(sourceCopy != nullptr)
+            {
+                pathCopy->setSigSource(sourceCopy);
+                sourceCopy->setPath(pathCopy);
+            }
+        }
+
+        const auto destinations = path->getSigDestinations();
+
+        for(const auto& destination : *destinations)
+        {
+            auto destinationCopy = findCopy(destination);
+
+            if(destinationCopy != nullptr)
+            {
+                pathCopy->addSigDestination(destinationCopy);
+                destinationCopy->setPath(pathCopy);
+            }
+        }
+
+        moduleCopy->addPath(pathCopy);
+    }
+
+    for(const auto& netname : netnames)
+    {
+        auto netnameCopy = std::make_shared<Netname>(netname->getName(), netname->getBits(), netname->getIsHidden());
+
+        for(const auto& alternativeName : netname->getAlternativeNetnames())
+        {
+            netnameCopy->addAlternativeName(alternativeName);
+        }
+
+        moduleCopy->addNetname(netnameCopy);
+    }
+
+    moduleCopy->subModules = subModules;
+    moduleCopy->simplifiedCells = simplifiedCells;
+
+    return moduleCopy;
+}
+
 std::shared_ptr<Node> Module::getNodeByColaRectID(const int colaRectID) const
 {
     // find the node that matches the given colaRectID and return it
@@ -167,47 +342,55 @@ std::shared_ptr<Path> Module::getPathByColaSrcDstIDs(const int srcID, const int
     return (iterator != paths.end()) ? *iterator : nullptr;
 }
 
-std::vector<QGraphicsItem*> Module::convertToQt()
+std::vector<Path::Geometry> Module::createPathGeometries()
 {
+    std::vector<Path::Geometry> pathGeometries(paths.size());
 
-    // converts all the paths, nodes and ports to QGraphicsItems
-    std::vector<QGraphicsItem*> qItems;
-
-    for(const auto& path : paths)
-    {
-        auto* qtPath = path->convertToQt();
+    // every path only reads its own routing data, so the chunks do not share any state
+    Scheduler::TaskScheduler::getShared().parallelFor(
+        0, paths.size(), [this, &pathGeometries](size_t pathBegin, size_t pathEnd) {
+            for(size_t pathIdx = pathBegin; pathIdx < pathEnd; pathIdx++)
+            {
+                pathGeometries[pathIdx] = paths[pathIdx]->createGeometry();
+            }
+        },
+        Scheduler::TaskScheduler::EPriority::INTERACTIVE, Scheduler::CancellationToken(), parallelGeometryPaths);
 
-        qtPath->setYosysPath(path);
+    return pathGeometries;
+}
 
-        qItems.emplace_back(qtPath);
-    }
+QRectF Module::getRoutedBoundingRect() const
+{
+    QRectF boundingRect;
 
+    // add the area of all routed shapes
     for(const auto& node : nodes)
     {
-        auto* qtNode = node->convertToQt();
-        auto component = std::dynamic_pointer_cast<Yosys::Component>(node);
-        if(component)
-        {
-            qtNode->setComponent(component);
-        }
-
-        qItems.emplace_back(qtNode);
+        boundingRect = boundingRect.united(node->getRoutedRect());
     }
 
     for(const auto& port : ports)
     {
-        auto* qtPort = port->convertToQt();
-        auto component = std::dynamic_pointer_cast<Yosys::Component>(port);
+        boundingRect = boundingRect.united(port->getRoutedRect());
+    }
 
-        if(component)
+    // the lines can leave the area of the shapes
+    for(const auto& path : paths)
+    {
+        for(const auto& routedLine : path->getRoutedLines())
         {
-            qtPort->setComponent(component);
+            for(const auto& point : routedLine.points)
+            {
+                // united ignores empty rectangles so extend it by hand
+                boundingRect.setLeft(std::min(boundingRect.left(), point.x()));
+                boundingRect.setRight(std::max(boundingRect.right(), point.x()));
+                boundingRect.setTop(std::min(boundingRect.top(), point.y()));
+                boundingRect.setBottom(std::max(boundingRect.bottom(), point.y()));
+            }
         }
-
-        qItems.emplace_back(qtPort);
     }
 
-    return qItems;
+    return boundingRect;
 }
 
 void Module::clearRoutingData()
@@ -228,6 +411,8 @@ void Module::clearRoutingData()
     {
         port->clearRoutingData();
     }
+
+    layoutLoaded = false;
 }
 
 bool Module::hasConnection() const
@@ -13,13 +13,12 @@
 #define __YOSYS_MODULE_H__
 
 #include <QString>
-#include <QGraphicsItem>
 #include <QVariant>
+#include <QRectF>
 
 #include <vector>
 #include <memory>
 #include <map>
-#include <QString>
 
 #include "component.h"
 #include "path.h"
@@ -77,6 +76,21 @@ public:
      */
     bool getIsRouted() const;
 
+    /**
+     * @brief Sets the layoutLoaded flag.
+     *
+     * A module with a loaded layout is not routed by the router,
+     * the nodes, ports and paths use the geometry of the layout bundle.
+     */
+    void setLayoutLoaded();
+
+    /**
+     * @brief Retrieves the layoutLoaded flag.
+     *
+     * @return The layoutLoaded flag.
+     */
+    bool getLayoutLoaded() const;
+
     /**
      * @brief Adds a submodule to the module.
      *
@@ -156,6 +170,43 @@ public:
      */
     void removePath(const std::shared_ptr<Path>& path);
 
+    /**
+     * @brief Removes nodes from the module.
+     *
+     * @param nodesToRemove The nodes to be removed.
+     */
+    void removeNodes(const std::vector<std::shared_ptr<Node>>& nodesToRemove);
+
+    /**
+     * @brief Records a cell that was removed by the netlist simplification.
+     *
+     * @param cellName The name of the removed cell.
+     * @param representative The name of the component the cell was merged into.
+     */
+    void addSimplifiedCell(const QString& cellName, const QString& representative);
+
+    /**
+     * @brief Retrieves the component a removed cell is shown as.
+     *
+     * The representative of a cell can be removed as well,
+     * so the records are followed to a component of the module.
+     *
+     * @param cellName The name of the removed cell.
+     * @return The name of the component or an empty string if the cell was not removed.
+     */
+    QString getSimplifiedCellRepresentative(const QString& cellName) const;
+
+    /**
+     * @brief Creates a copy of the module without routing data.
+     *
+     * The nodes, ports, paths and netnames are copied, so the copy can be
+     * routed by its own router without changing the layout of this module.
+     * The submodules are shared with this module.
+     *
+     * @return std::shared_ptr<Module> The copy of the module.
+     */
+    std::shared_ptr<Module> clone() const;
+
     /**
      * @brief Get the Node By ColaRectID object
      *
@@ -189,16 +240,29 @@ public:
     std::shared_ptr<Path> getPathByColaSrcDstIDs(const int srcID, const int dstID) const;
 
     /**
-     * @brief converts all paths, nodes and ports to QGraphicsItems
+     * @brief creates the drawing geometry of all paths
+     *
+     * Large modules split the paths into one chunk per worker thread.
+     * No graphics items are created, they are built from the geometry
+     * by the QNetlistItemFactory of the gui.
+     *
+     * @return std::vector<Path::Geometry> the geometry of every path in the order of the paths
+     */
+    std::vector<Path::Geometry> createPathGeometries();
+
+    /**
+     * @brief get the area covered by the routed nodes, ports and paths
      *
-     * @return std::vector<QGraphicsItem*>
+     * the module has to be routed before calling this
+     *
+     * @return QRectF the bounding rectangle of the routed module
      */
-    std::vector<QGraphicsItem*> convertToQt();
+    QRectF getRoutedBoundingRect() const;
 
     /**
      * @brief clears the routing data from all paths and ports and nodes
      *
-     * This resets the cola and avoid routing data
+     * This resets the cola and avoid routing data and the loaded layout
      */
     void clearRoutingData();
 
@@ -260,6 +324,8 @@ public:
     operator<<(std::ostream& outputStream, const Module& module);
 
 private:
+    constexpr const static size_t parallelGeometryPaths{256}; ///< The minimum number of paths whose geometry is created by one task.
+
     QString type;                                   ///< The type of the module.
     std::vector<std::shared_ptr<Path>> paths;       ///< Vector of shared pointers to Path objects.
     std::vector<std::shared_ptr<Node>> nodes;       ///< Vector of shared pointers to Node objects.
@@ -267,8 +333,10 @@ private:
     std::vector<std::shared_ptr<Netname>> netnames; ///< Vector of shared pointers to Netnames objects.
 
     std::map<QString, std::shared_ptr<Module>> subModules; ///< Vector of shared pointers to submodules.
+    std::map<QString, QString> simplifiedCells;            ///< The removed cells with the component they were merged into.
 
-    bool isRouted = false; ///< Flag indicating if the module has been routed.
+    bool isRouted = false;     ///< Flag indicating if the module has been routed.
+    bool layoutLoaded = false; ///< Flag indicating if the geometry of the module was loaded from a layout bundle.
 };
 
 } // namespace OpenNetlistView::Yosys
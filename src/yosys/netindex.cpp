@@ -0,0 +1,560 @@
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "netname.h"
+
+#include "netindex.h"
+
+namespace OpenNetlistView::Yosys {
+
+NetIndex::NetIndex(std::shared_ptr<Module> topModule)
+    : topModule(std::move(topModule))
+{
+}
+
+NetIndex::~NetIndex() = default;
+
+int64_t NetIndex::getNetId(const QString& instancePath, const QString& bit)
+{
+    const int64_t instanceIdx = getInstance(normalizePath(instancePath));
+
+    if(instanceIdx < 0)
+    {
+        return -1;
+    }
+
+    const auto& bitElements = instances[instanceIdx].bitElements;
+    auto elementIt = bitElements.constFind(bit);
+
+    if(elementIt == bitElements.constEnd())
+    {
+        return -1;
+    }
+
+    return findRoot(elementIt.value());
+}
+
+bool NetIndex::isSameNet(const QString& instancePathA, const QString& bitA, const QString& instancePathB, const QString& bitB)
+{
+    // bind both instances before comparing so the second
+    // binding can not change the ID of the first bit
+    getInstance(normalizePath(instancePathA));
+    getInstance(normalizePath(instancePathB));
+
+    const int64_t netA = getNetId(instancePathA, bitA);
+
+    return netA >= 0 && netA == getNetId(instancePathB, bitB);
+}
+
+std::vector<NetBit> NetIndex::getNetMembers(int64_t netId)
+{
+    std::vector<NetBit> members;
+
+    if(netId < 0 || netId >= static_cast<int64_t>(parents.size()))
+    {
+        return members;
+    }
+
+    if(!membersValid)
+    {
+        buildMembers();
+    }
+
+    auto memberIt = netMembers.constFind(findRoot(netId));
+
+    if(memberIt == netMembers.constEnd())
+    {
+        return members;
+    }
+
+    members.reserve(memberIt->size());
+
+    for(const int64_t element : *memberIt)
+    {
+        const auto& [instanceIdx, bit] = elementBits[element];
+        members.push_back({instances[instanceIdx].path, bit});
+    }
+
+    return members;
+}
+
+std::vector<NetBit> NetIndex::traceNet(const QString& instancePath, const QString& bit)
+{
+    return getNetMembers(getNetId(instancePath, bit));
+}
+
+std::shared_ptr<Module> NetIndex::getModuleByInstancePath(const QString& instancePath)
+{
+    const int64_t instanceIdx = getInstance(normalizePath(instancePath));
+
+    if(instanceIdx < 0)
+    {
+        return nullptr;
+    }
+
+    return instances[instanceIdx].module;
+}
+
+void NetIndex::bindAll()
+{
+    // breadth first over the instance tree, the vector grows while iterating
+    getInstance("/");
+
+    for(size_t instanceIdx = 0; instanceIdx < instances.size(); instanceIdx++)
+    {
+        const QString path = instances[instanceIdx].path;
+        const auto subModules = instances[instanceIdx].module->getSubModules();
+
+        for(const auto& [instanceName, subModule] : subModules)
+        {
+            getInstance(path + instanceName + "/");
+        }
+    }
+}
+
+QString NetIndex::normalizePath(const QString& instancePath)
+{
+    QString path = instancePath;
+
+    if(!path.startsWith('/'))
+    {
+        path.prepend('/');
+    }
+
+    if(!path.endsWith('/'))
+    {
+        path.append('/');
+    }
+
+    return path;
+}
+
+// NOLINTBEGIN(misc-no-recursion)
+int64_t NetIndex::getInstance(const QString& instancePath)
+{
+    auto instanceIt = instanceIndices.constFind(instancePath);
+
+    if(instanceIt != instanceIndices.constEnd())
+    {
+        return instanceIt.value();
+    }
+
+    std::shared_ptr<Module> module;
+    int64_t parentIdx = -1;
+    QString instanceName;
+
+    if(instancePath == "/")
+    {
+        module = topModule;
+    }
+    else
+    {
+        // split "/a/b/" into the parent "/a/" and the instance "b"
+        const auto lastSep = instancePath.lastIndexOf('/', -2);
+        const QString parentPath = instancePath.left(lastSep + 1);
+        instanceName = instancePath.mid(lastSep + 1, instancePath.size() - lastSep - 2);
+
+        // the parents are bound first so the instance can be connected to them
+        parentIdx = getInstance(parentPath);
+
+        if(parentIdx < 0)
+        {
+            return -1;
+        }
+
+        const auto subModules = instances[parentIdx].module->getSubModules();
+        auto subModuleIt = subModules.find(instanceName);
+
+        if(subModuleIt != subModules.end())
+        {
+            module = subModuleIt->second;
+        }
+    }
+
+    if(module == nullptr)
+    {
+        return -1;
+    }
+
+    const auto instanceIdx = static_cast<int64_t>(instances.size());
+    instances.push_back({instancePath, module, {}});
+    instanceIndices.insert(instancePath, instanceIdx);
+
+    // register all bits used inside the module
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        for(const auto& bit : port->getBits())
+        {
+            getElement(instanceIdx, bit);
+        }
+    }
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        for(const auto& port : node->getPorts())
+        {
+            for(const auto& bit : port->getBits())
+            {
+                getElement(instanceIdx, bit);
+            }
+        }
+    }
+
+    const auto netnames = module->getNetnames();
+
+    for(const auto& netname : *netnames)
+    {
+        for(const auto& bit : netname->getBits())
+        {
+            getElement(instanceIdx, bit);
+        }
+    }
+
+    // nets connected through a submodule are one net even if the submodule is never bound
+    bindFeedThroughs(instanceIdx);
+
+    if(parentIdx >= 0)
+    {
+        bindInstance(parentIdx, instanceName, instanceIdx);
+    }
+
+    return instanceIdx;
+}
+// NOLINTEND(misc-no-recursion)
+
+void NetIndex::bindFeedThroughs(int64_t instanceIdx)
+{
+    const auto module = instances[instanceIdx].module;
+    const auto subModules = module->getSubModules();
+
+    if(subModules.empty())
+    {
+        return;
+    }
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        auto subModuleIt = subModules.find(node->getName());
+
+        if(subModuleIt == subModules.end())
+        {
+            continue;
+        }
+
+        QHash<QString, QStringList> nodePortBits;
+
+        for(const auto& port : node->getPorts())
+        {
+            nodePortBits.insert(port->getName(), port->getBits());
+        }
+
+        for(const auto& group : getFeedThroughs(subModuleIt->second))
+        {
+            int64_t firstElement = -1;
+
+            for(const auto& [portName, bitIdx] : group)
+            {
+                auto portIt = nodePortBits.constFind(portName);
+
+                if(portIt == nodePortBits.constEnd() || bitIdx >= portIt->size())
+                {
+                    continue;
+                }
+
+                const int64_t element = getElement(instanceIdx, portIt->at(bitIdx));
+
+                if(element < 0)
+                {
+                    continue;
+                }
+
+                if(firstElement < 0)
+                {
+                    firstElement = element;
+                }
+                else
+                {
+                    unite(firstElement, element);
+                }
+            }
+        }
+    }
+}
+
+// NOLINTBEGIN(misc-no-recursion)
+const NetIndex::FeedThroughs& NetIndex::getFeedThroughs(const std::shared_ptr<Module>& module)
+{
+    auto feedThroughIt = feedThroughs.constFind(module.get());
+
+    if(feedThroughIt != feedThroughs.constEnd())
+    {
+        return feedThroughIt.value();
+    }
+
+    // local union-find over the bits of the module, the bits are only unique inside it
+    QHash<QString, int64_t> bitIds;
+    std::vector<int64_t> bitParents;
+
+    auto getBitId = [&bitIds, &bitParents](const QString& bit) -> int64_t {
+        if(Port::isConstantBit(bit))
+        {
+            return -1;
+        }
+
+        auto bitIt = bitIds.constFind(bit);
+
+        if(bitIt != bitIds.constEnd())
+        {
+            return bitIt.value();
+        }
+
+        const auto bitId = static_cast<int64_t>(bitParents.size());
+        bitParents.push_back(bitId);
+        bitIds.insert(bit, bitId);
+
+        return bitId;
+    };
+
+    auto findBitRoot = [&bitParents](int64_t bitId) -> int64_t {
+        while(bitParents[bitId] != bitId)
+        {
+            bitParents[bitId] = bitParents[bitParents[bitId]];
+            bitId = bitParents[bitId];
+        }
+
+        return bitId;
+    };
+
+    // connect the bits that are connected through the submodules
+    const auto subModules = module->getSubModules();
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        auto subModuleIt = subModules.find(node->getName());
+
+        if(subModuleIt == subModules.end())
+        {
+            continue;
+        }
+
+        QHash<QString, QStringList> nodePortBits;
+
+        for(const auto& port : node->getPorts())
+        {
+            nodePortBits.insert(port->getName(), port->getBits());
+        }
+
+        for(const auto& group : getFeedThroughs(subModuleIt->second))
+        {
+            int64_t firstRoot = -1;
+
+            for(const auto& [portName, bitIdx] : group)
+            {
+                auto portIt = nodePortBits.constFind(portName);
+
+                if(portIt == nodePortBits.constEnd() || bitIdx >= portIt->size())
+                {
+                    continue;
+                }
+
+                const int64_t bitId = getBitId(portIt->at(bitIdx));
+
+                if(bitId < 0)
+                {
+                    continue;
+                }
+
+                if(firstRoot < 0)
+                {
+                    firstRoot = findBitRoot(bitId);
+                }
+                else
+                {
+                    bitParents[findBitRoot(bitId)] = firstRoot;
+                }
+            }
+        }
+    }
+
+    // group the port bits of the module by their net
+    QHash<int64_t, std::vector<std::pair<QString, qsizetype>>> portGroups;
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        const QStringList bits = port->getBits();
+
+        for(qsizetype bitIdx = 0; bitIdx < bits.size(); bitIdx++)
+        {
+            const int64_t bitId = getBitId(bits[bitIdx]);
+
+            if(bitId >= 0)
+            {
+                portGroups[findBitRoot(bitId)].emplace_back(port->getName(), bitIdx);
+            }
+        }
+    }
+
+    FeedThroughs moduleFeedThroughs;
+
+    for(const auto& group : std::as_const(portGroups))
+    {
+        if(group.size() > 1)
+        {
+            moduleFeedThroughs.push_back(group);
+        }
+    }
+
+    return feedThroughs.insert(module.get(), std::move(moduleFeedThroughs)).value();
+}
+// NOLINTEND(misc-no-recursion)
+
+void NetIndex::bindInstance(int64_t parentIdx, const QString& instanceName, int64_t childIdx)
+{
+    const auto parentNodes = instances[parentIdx].module->getNodes();
+
+    auto nodeIt = std::find_if(parentNodes->begin(), parentNodes->end(), [&instanceName](const std::shared_ptr<Node>& node) {
+        return node->getName() == instanceName;
+    });
+
+    if(nodeIt == parentNodes->end())
+    {
+        return;
+    }
+
+    // the ports of the module have the same names as the ports of the node
+    QHash<QString, QStringList> childPortBits;
+
+    const auto modulePorts = instances[childIdx].module->getPorts();
+
+    for(const auto& port : *modulePorts)
+    {
+        childPortBits.insert(port->getName(), port->getBits());
+    }
+
+    for(const auto& nodePort : (*nodeIt)->getPorts())
+    {
+        auto childPortIt = childPortBits.constFind(nodePort->getName());
+
+        if(childPortIt == childPortBits.constEnd())
+        {
+            continue;
+        }
+
+        const QStringList parentBits = nodePort->getBits();
+        const auto bitCount = std::min(parentBits.size(), childPortIt->size());
+
+        for(qsizetype bitIdx = 0; bitIdx < bitCount; bitIdx++)
+        {
+            const int64_t parentElement = getElement(parentIdx, parentBits[bitIdx]);
+            const int64_t childElement = getElement(childIdx, childPortIt->at(bitIdx));
+
+            if(parentElement >= 0 && childElement >= 0)
+            {
+                unite(parentElement, childElement);
+            }
+        }
+    }
+}
+
+int64_t NetIndex::getElement(int64_t instanceIdx, const QString& bit)
+{
+    if(Port::isConstantBit(bit))
+    {
+        return -1;
+    }
+
+    auto& bitElements = instances[instanceIdx].bitElements;
+    auto elementIt = bitElements.constFind(bit);
+
+    if(elementIt != bitElements.constEnd())
+    {
+        return elementIt.value();
+    }
+
+    const auto element = static_cast<int64_t>(parents.size());
+    parents.push_back(element);
+    ranks.push_back(0);
+    elementBits.emplace_back(instanceIdx, bit);
+    bitElements.insert(bit, element);
+
+    membersValid = false;
+
+    return element;
+}
+
+int64_t NetIndex::findRoot(int64_t element)
+{
+    int64_t root = element;
+
+    while(parents[root] != root)
+    {
+        root = parents[root];
+    }
+
+    // point all elements on the way directly to the root
+    while(parents[element] != root)
+    {
+        const int64_t next = parents[element];
+        parents[element] = root;
+        element = next;
+    }
+
+    return root;
+}
+
+void NetIndex::unite(int64_t elementA, int64_t elementB)
+{
+    int64_t rootA = findRoot(elementA);
+    int64_t rootB = findRoot(elementB);
+
+    if(rootA == rootB)
+    {
+        return;
+    }
+
+    if(ranks[rootA] < ranks[rootB])
+    {
+        std::swap(rootA, rootB);
+    }
+
+    parents[rootB] = rootA;
+
+    if(ranks[rootA] == ranks[rootB])
+    {
+        ranks[rootA]++;
+    }
+
+    membersValid = false;
+}
+
+void NetIndex::buildMembers()
+{
+    netMembers.clear();
+
+    for(int64_t element = 0; element < static_cast<int64_t>(parents.size()); element++)
+    {
+        netMembers[findRoot(element)].push_back(element);
+    }
+
+    membersValid = true;
+}
+
+} // namespace OpenNetlistView::Yosys
@@ -0,0 +1,238 @@
+/**
+ * @file netindex.h
+ * @brief Header file for the NetIndex class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the NetIndex class, which assigns design wide
+ * IDs to the nets of a module hierarchy so that nets can be identified across the
+ * boundaries of submodule instances.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __NETINDEX_H__
+#define __NETINDEX_H__
+
+#include <QString>
+#include <QHash>
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+
+/**
+ * @struct NetBit
+ * @brief A single bit of a net inside a module instance.
+ */
+struct NetBit
+{
+    QString instancePath; ///< The path of the instance the bit belongs to, e.g. "/" or "/u1/".
+    QString bit;          ///< The bit number inside the module of the instance.
+};
+
+/**
+ * @class NetIndex
+ * @brief Assigns global net IDs to the bits of all module instances of a design.
+ *
+ * The bits of a module are only unique inside the module. The index connects the
+ * bits of a node port in the parent with the bits of the port with the same name
+ * in the module of the instance using a union-find structure. The bindings of an
+ * instance are created lazily when a bit of the instance or of one of its children
+ * is looked up for the first time. Nets that are only connected inside a submodule
+ * (feed-throughs) are merged in the parent when the parent is bound, using a summary
+ * of the connected ports of every module, so the net IDs do not depend on the order
+ * of the queries. The member lists only contain the bits of bound instances,
+ * bindAll() binds the whole hierarchy.
+ *
+ * The instance paths use the same format as the module paths of the tabs,
+ * "/" for the top module and "/u1/u2/" for nested instances.
+ */
+class NetIndex
+{
+public:
+    /**
+     * @brief Construct a new NetIndex object
+     *
+     * @param topModule The top module of the design with linked submodules.
+     */
+    explicit NetIndex(std::shared_ptr<Module> topModule);
+
+    /**
+     * @brief Destroy the NetIndex object
+     *
+     */
+    ~NetIndex();
+
+    /**
+     * @brief Get the global ID of the net a bit belongs to
+     *
+     * binds the instance and its parents if they are not bound yet.
+     * The ID is stable until a further instance is bound.
+     *
+     * @param instancePath The path of the instance.
+     * @param bit The bit inside the module of the instance.
+     * @return int64_t The ID of the net or -1 if the instance or bit does not exist.
+     */
+    int64_t getNetId(const QString& instancePath, const QString& bit);
+
+    /**
+     * @brief Check if two bits belong to the same net
+     *
+     * @param instancePathA The instance path of the first bit.
+     * @param bitA The first bit.
+     * @param instancePathB The instance path of the second bit.
+     * @param bitB The second bit.
+     * @return true if both bits are part of the same net
+     */
+    bool isSameNet(const QString& instancePathA, const QString& bitA, const QString& instancePathB, const QString& bitB);
+
+    /**
+     * @brief Get all bound bits of a net
+     *
+     * only instances that are already bound are listed, call bindAll()
+     * first to get the bits of all instances.
+     *
+     * @param netId The ID of the net.
+     * @return std::vector<NetBit> The bits of the net in all bound instances.
+     */
+    std::vector<NetBit> getNetMembers(int64_t netId);
+
+    /**
+     * @brief Get all bits connected to a bit across the hierarchy
+     *
+     * like getNetMembers() only the bits of bound instances are listed.
+     *
+     * @param instancePath The path of the instance.
+     * @param bit The bit inside the module of the instance.
+     * @return std::vector<NetBit> The bits of the net or an empty list if the bit does not exist.
+     */
+    std::vector<NetBit> traceNet(const QString& instancePath, const QString& bit);
+
+    /**
+     * @brief Get the module of an instance
+     *
+     * @param instancePath The path of the instance.
+     * @return std::shared_ptr<Module> The module or nullptr if the path does not exist.
+     */
+    std::shared_ptr<Module> getModuleByInstancePath(const QString& instancePath);
+
+    /**
+     * @brief Binds all instances of the hierarchy
+     *
+     * after this all net IDs are final.
+     *
+     */
+    void bindAll();
+
+private:
+    /**
+     * @brief groups of port bits of a module that are connected inside the module
+     *
+     * every group is a list of port names and bit positions in the port.
+     */
+    using FeedThroughs = std::vector<std::vector<std::pair<QString, qsizetype>>>;
+
+    /**
+     * @struct Instance
+     * @brief A bound instance of a module in the hierarchy.
+     */
+    struct Instance
+    {
+        QString path;                        ///< The path of the instance.
+        std::shared_ptr<Module> module;      ///< The module of the instance.
+        QHash<QString, int64_t> bitElements; ///< The union-find elements of the bits of the instance.
+    };
+
+    /**
+     * @brief normalizes an instance path to start and end with a slash
+     *
+     * @param instancePath The path to normalize.
+     * @return QString The normalized path.
+     */
+    static QString normalizePath(const QString& instancePath);
+
+    /**
+     * @brief get the index of an instance and bind it if needed
+     *
+     * @param instancePath The normalized path of the instance.
+     * @return int64_t The index of the instance or -1 if it does not exist.
+     */
+    int64_t getInstance(const QString& instancePath);
+
+    /**
+     * @brief connects the node ports in the parent to the ports of the module of the instance
+     *
+     * @param parentIdx The index of the parent instance.
+     * @param instanceName The name of the node of the instance in the parent module.
+     * @param childIdx The index of the instance.
+     */
+    void bindInstance(int64_t parentIdx, const QString& instanceName, int64_t childIdx);
+
+    /**
+     * @brief merges the nets of an instance that are connected through its submodules
+     *
+     * @param instanceIdx The index of the instance.
+     */
+    void bindFeedThroughs(int64_t instanceIdx);
+
+    /**
+     * @brief get the port bits of a module that are connected inside the module
+     *
+     * the result is computed once per module and includes the connections
+     * through the submodules of the module.
+     *
+     * @param module The module.
+     * @return const FeedThroughs& The connected port bits of the module.
+     */
+    const FeedThroughs& getFeedThroughs(const std::shared_ptr<Module>& module);
+
+    /**
+     * @brief get the union-find element of a bit and create it if needed
+     *
+     * @param instanceIdx The index of the instance.
+     * @param bit The bit inside the module of the instance.
+     * @return int64_t The index of the element.
+     */
+    int64_t getElement(int64_t instanceIdx, const QString& bit);
+
+    /**
+     * @brief finds the representative of an element and compresses the path
+     *
+     * @param element The element.
+     * @return int64_t The representative of the set of the element.
+     */
+    int64_t findRoot(int64_t element);
+
+    /**
+     * @brief merges the sets of two elements
+     *
+     * @param elementA The first element.
+     * @param elementB The second element.
+     */
+    void unite(int64_t elementA, int64_t elementB);
+
+    /**
+     * @brief builds the lists of elements of every net
+     *
+     */
+    void buildMembers();
+
+    std::shared_ptr<Module> topModule;                    ///< The top module of the design.
+    std::vector<Instance> instances;                      ///< The bound instances.
+    QHash<QString, int64_t> instanceIndices;              ///< The index of every bound instance by path.
+    std::vector<int64_t> parents;                         ///< The parent of every union-find element.
+    std::vector<uint32_t> ranks;                          ///< The rank of every union-find element.
+    std::vector<std::pair<int64_t, QString>> elementBits; ///< The instance and bit of every element.
+    QHash<int64_t, std::vector<int64_t>> netMembers;      ///< The elements of every net by root.
+    QHash<const Module*, FeedThroughs> feedThroughs;      ///< The connected port bits of every module.
+    bool membersValid = false;                            ///< Flag if the member lists are up to date.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __NETINDEX_H__
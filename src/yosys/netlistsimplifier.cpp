@@ -0,0 +1,607 @@
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "netname.h"
+
+#include "netlistsimplifier.h"
+
+namespace OpenNetlistView::Yosys {
+
+namespace {
+
+/**
+ * @brief Get the input and output port of a cell with exactly one of each
+ *
+ * @param node The cell.
+ * @param inputPort The input port of the cell.
+ * @param outputPort The output port of the cell.
+ * @return true if the cell has exactly one input and one output port
+ */
+bool getUnaryPorts(const std::shared_ptr<Node>& node, std::shared_ptr<Port>& inputPort, std::shared_ptr<Port>& outputPort)
+{
+    inputPort = nullptr;
+    outputPort = nullptr;
+
+    for(const auto& port : node->getPorts())
+    {
+        auto& unaryPort = port->getDirection() == Port::EDirection::INPUT ? inputPort : outputPort;
+
+        if(unaryPort != nullptr)
+        {
+            return false;
+        }
+
+        unaryPort = port;
+    }
+
+    return inputPort != nullptr && outputPort != nullptr;
+}
+
+} // namespace
+
+QString BufferChainPass::getName() const
+{
+    return NetlistSimplifier::bufferChains;
+}
+
+size_t BufferChainPass::run(NetlistSimplifier& simplifier)
+{
+    size_t removedCells = 0;
+
+    for(const auto& node : simplifier.getCells())
+    {
+        // $pos of the same width passes its input through unchanged
+        const QString type = node->getType();
+
+        if(type != "$_BUF_" && type != "$buf" && type != "$pos")
+        {
+            continue;
+        }
+
+        std::shared_ptr<Port> inputPort;
+        std::shared_ptr<Port> outputPort;
+
+        if(!getUnaryPorts(node, inputPort, outputPort))
+        {
+            continue;
+        }
+
+        const QStringList inputBits = simplifier.getBits(inputPort);
+        const QStringList outputBits = simplifier.getBits(outputPort);
+
+        if(!simplifier.canBypass(inputBits, outputBits))
+        {
+            continue;
+        }
+
+        simplifier.bypass(inputBits, outputBits);
+        simplifier.removeCell(node, inputBits);
+        removedCells++;
+    }
+
+    return removedCells;
+}
+
+QString DoubleInverterPass::getName() const
+{
+    return NetlistSimplifier::doubleInverters;
+}
+
+size_t DoubleInverterPass::run(NetlistSimplifier& simplifier)
+{
+    auto isInverter = [](const std::shared_ptr<Node>& node) {
+        const QString type = node->getType();
+        return type == "$_NOT_" || type == "$not";
+    };
+
+    size_t removedCells = 0;
+
+    for(const auto& node : simplifier.getCells())
+    {
+        std::shared_ptr<Port> inputPort;
+        std::shared_ptr<Port> outputPort;
+
+        // the first inverter of a pair is removed with the second one
+        if(simplifier.isRemoved(node) || !isInverter(node) || !getUnaryPorts(node, inputPort, outputPort))
+        {
+            continue;
+        }
+
+        const QStringList middleBits = simplifier.getBits(inputPort);
+
+        if(middleBits.isEmpty() || Port::isConstantBit(middleBits.front()))
+        {
+            continue;
+        }
+
+        auto firstInverter = simplifier.getDriverCell(middleBits.front());
+
+        std::shared_ptr<Port> firstInputPort;
+        std::shared_ptr<Port> firstOutputPort;
+
+        if(firstInverter == nullptr || firstInverter == node || !isInverter(firstInverter) ||
+           !getUnaryPorts(firstInverter, firstInputPort, firstOutputPort) || simplifier.getBits(firstOutputPort) != middleBits)
+        {
+            continue;
+        }
+
+        // the inverted signal between the inverters must not be used anywhere else
+        bool onlyReadByNode = true;
+
+        for(const auto& bit : middleBits)
+        {
+            if(simplifier.getReaderCount(bit) != 1)
+            {
+                onlyReadByNode = false;
+                break;
+            }
+        }
+
+        const QStringList inputBits = simplifier.getBits(firstInputPort);
+        const QStringList outputBits = simplifier.getBits(outputPort);
+
+        if(!onlyReadByNode || !simplifier.canBypass(inputBits, outputBits))
+        {
+            continue;
+        }
+
+        simplifier.bypass(inputBits, outputBits);
+        simplifier.removeCell(node, inputBits);
+        simplifier.removeCell(firstInverter, inputBits);
+        removedCells += 2;
+    }
+
+    return removedCells;
+}
+
+QString DeadLogicPass::getName() const
+{
+    return NetlistSimplifier::deadLogic;
+}
+
+size_t DeadLogicPass::run(NetlistSimplifier& simplifier)
+{
+    if(!simplifier.hasModuleOutputs())
+    {
+        return 0;
+    }
+
+    std::vector<std::shared_ptr<Node>> candidates = simplifier.getCells();
+    size_t removedCells = 0;
+
+    while(!candidates.empty())
+    {
+        const auto node = candidates.back();
+        candidates.pop_back();
+
+        if(simplifier.isRemoved(node))
+        {
+            continue;
+        }
+
+        bool hasOutput = false;
+        bool isUsed = false;
+        QStringList inputBits;
+
+        for(const auto& port : node->getPorts())
+        {
+            const QStringList bits = simplifier.getBits(port);
+
+            if(port->getDirection() == Port::EDirection::INPUT)
+            {
+                inputBits.append(bits);
+                continue;
+            }
+
+            hasOutput = true;
+
+            for(const auto& bit : bits)
+            {
+                if(!Port::isConstantBit(bit) && simplifier.getReaderCount(bit) > 0)
+                {
+                    isUsed = true;
+                }
+            }
+        }
+
+        if(!hasOutput || isUsed)
+        {
+            continue;
+        }
+
+        simplifier.removeCell(node, inputBits);
+        removedCells++;
+
+        // the drivers of the cell may have lost their last reader
+        for(const auto& bit : inputBits)
+        {
+            auto driver = simplifier.getDriverCell(bit);
+
+            if(driver != nullptr && !simplifier.isRemoved(driver))
+            {
+                candidates.push_back(driver);
+            }
+        }
+    }
+
+    return removedCells;
+}
+
+NetlistSimplifier::NetlistSimplifier(std::shared_ptr<Module> module)
+    : module(std::move(module))
+{
+}
+
+NetlistSimplifier::~NetlistSimplifier() = default;
+
+QStringList NetlistSimplifier::getPassNames()
+{
+    return {bufferChains, doubleInverters, deadLogic};
+}
+
+std::unique_ptr<SimplificationPass> NetlistSimplifier::createPass(const QString& passName)
+{
+    if(passName == bufferChains)
+    {
+        return std::make_unique<BufferChainPass>();
+    }
+
+    if(passName == doubleInverters)
+    {
+        return std::make_unique<DoubleInverterPass>();
+    }
+
+    if(passName == deadLogic)
+    {
+        return std::make_unique<DeadLogicPass>();
+    }
+
+    throw std::runtime_error("Unknown simplification pass: " + passName.toStdString());
+}
+
+void NetlistSimplifier::addPass(std::unique_ptr<SimplificationPass> pass)
+{
+    passes.push_back(std::move(pass));
+}
+
+std::map<QString, size_t> NetlistSimplifier::simplify()
+{
+    std::map<QString, size_t> removedCellsByPass;
+
+    for(const auto& pass : passes)
+    {
+        removedCellsByPass[pass->getName()] = 0;
+    }
+
+    if(module == nullptr || passes.empty())
+    {
+        return removedCellsByPass;
+    }
+
+    buildBitIndex();
+
+    // a pass can create work for the passes before it, like a pruned
+    // reader that leaves a single reader for an inverter pair
+    for(size_t round = 0; round < maxRounds; round++)
+    {
+        size_t removedCells = 0;
+
+        for(const auto& pass : passes)
+        {
+            const size_t passRemovedCells = pass->run(*this);
+            removedCellsByPass[pass->getName()] += passRemovedCells;
+            removedCells += passRemovedCells;
+        }
+
+        if(removedCells == 0)
+        {
+            break;
+        }
+    }
+
+    applyChanges();
+
+    return removedCellsByPass;
+}
+
+std::vector<std::shared_ptr<Node>> NetlistSimplifier::getCells() const
+{
+    std::vector<std::shared_ptr<Node>> cells;
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        if(!removedCells.contains(node.get()))
+        {
+            cells.push_back(node);
+        }
+    }
+
+    return cells;
+}
+
+bool NetlistSimplifier::isRemoved(const std::shared_ptr<Node>& node) const
+{
+    return removedCells.contains(node.get());
+}
+
+QStringList NetlistSimplifier::getBits(const std::shared_ptr<Port>& port) const
+{
+    QStringList bits = port->getBits();
+
+    for(auto& bit : bits)
+    {
+        bit = resolveBit(bit);
+    }
+
+    return bits;
+}
+
+size_t NetlistSimplifier::getReaderCount(const QString& bit) const
+{
+    return bitReaderCounts.value(bit, 0);
+}
+
+std::shared_ptr<Node> NetlistSimplifier::getDriverCell(const QString& bit) const
+{
+    const auto driver = bitDrivers.value(bit);
+
+    return driver != nullptr ? driver->getParentNode() : nullptr;
+}
+
+bool NetlistSimplifier::hasModuleOutputs() const
+{
+    return moduleOutputs;
+}
+
+bool NetlistSimplifier::canBypass(const QStringList& inputBits, const QStringList& outputBits) const
+{
+    if(inputBits.size() != outputBits.size() || inputBits.isEmpty())
+    {
+        return false;
+    }
+
+    bool hasConstantInput = false;
+    bool drivesModulePort = false;
+
+    for(const auto& bit : outputBits)
+    {
+        // a loop through the cell or an output tied to a constant cannot be bypassed
+        if(Port::isConstantBit(bit) || inputBits.contains(bit))
+        {
+            return false;
+        }
+
+        drivesModulePort = drivesModulePort || modulePortBits.contains(bit);
+    }
+
+    for(const auto& bit : inputBits)
+    {
+        hasConstantInput = hasConstantInput || Port::isConstantBit(bit);
+    }
+
+    // the constants of module ports are not replaced by the parser
+    return !(hasConstantInput && drivesModulePort);
+}
+
+void NetlistSimplifier::bypass(const QStringList& inputBits, const QStringList& outputBits)
+{
+    for(qsizetype bitIdx = 0; bitIdx < outputBits.size(); bitIdx++)
+    {
+        const QString& outputBit = outputBits[bitIdx];
+        const QString& inputBit = inputBits[bitIdx];
+
+        renamedBits.insert(outputBit, inputBit);
+
+        // the readers of the output now read the input
+        if(!Port::isConstantBit(inputBit))
+        {
+            bitReaderCounts[inputBit] += bitReaderCounts.value(outputBit, 0);
+
+            if(modulePortBits.contains(outputBit))
+            {
+                modulePortBits.insert(inputBit);
+            }
+        }
+
+        bitReaderCounts.remove(outputBit);
+        bitDrivers.remove(outputBit);
+    }
+}
+
+void NetlistSimplifier::removeCell(const std::shared_ptr<Node>& node, const QStringList& inputBits)
+{
+    removedCells.insert(node.get());
+
+    for(const auto& port : node->getPorts())
+    {
+        const QStringList bits = getBits(port);
+
+        for(const auto& bit : bits)
+        {
+            if(port->getDirection() == Port::EDirection::INPUT)
+            {
+                auto readerCount = bitReaderCounts.find(bit);
+
+                if(readerCount != bitReaderCounts.end() && readerCount.value() > 0)
+                {
+                    readerCount.value()--;
+                }
+            }
+            else if(bitDrivers.value(bit) == port)
+            {
+                bitDrivers.remove(bit);
+            }
+        }
+    }
+
+    // the cell is traced to the component driving its first input
+    QString representative;
+
+    for(const auto& bit : inputBits)
+    {
+        representative = getDriverName(bit);
+
+        if(!representative.isEmpty())
+        {
+            break;
+        }
+    }
+
+    cellTraces.emplace_back(node->getName(), representative);
+}
+
+void NetlistSimplifier::buildBitIndex()
+{
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        for(const auto& bit : port->getBits())
+        {
+            if(Port::isConstantBit(bit))
+            {
+                continue;
+            }
+
+            modulePortBits.insert(bit);
+
+            if(port->getDirection() == Port::EDirection::OUTPUT)
+            {
+                bitReaderCounts[bit]++;
+                moduleOutputs = true;
+            }
+            else
+            {
+                bitDrivers.insert(bit, port);
+            }
+        }
+    }
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        for(const auto& port : node->getPorts())
+        {
+            for(const auto& bit : port->getBits())
+            {
+                if(Port::isConstantBit(bit))
+                {
+                    continue;
+                }
+
+                if(port->getDirection() == Port::EDirection::INPUT)
+                {
+                    bitReaderCounts[bit]++;
+                }
+                else
+                {
+                    bitDrivers.insert(bit, port);
+                }
+            }
+        }
+    }
+}
+
+QString NetlistSimplifier::resolveBit(const QString& bit) const
+{
+    QString resolvedBit = bit;
+
+    // a bypassed input can be the output of another bypassed cell
+    for(auto renamedIt = renamedBits.find(resolvedBit); renamedIt != renamedBits.end(); renamedIt = renamedBits.find(resolvedBit))
+    {
+        resolvedBit = renamedIt.value();
+    }
+
+    return resolvedBit;
+}
+
+QString NetlistSimplifier::getDriverName(const QString& bit) const
+{
+    const auto driver = bitDrivers.value(bit);
+
+    if(driver == nullptr)
+    {
+        return {};
+    }
+
+    return driver->getParentNode() != nullptr ? driver->getParentNode()->getName() : driver->getName();
+}
+
+void NetlistSimplifier::applyChanges()
+{
+    if(!renamedBits.isEmpty())
+    {
+        auto renamePort = [this](const std::shared_ptr<Port>& port) {
+            const QStringList bits = getBits(port);
+
+            if(bits != port->getBits())
+            {
+                port->replaceBits({0, bits.size() - 1}, bits);
+            }
+        };
+
+        const auto ports = module->getPorts();
+
+        for(const auto& port : *ports)
+        {
+            renamePort(port);
+        }
+
+        for(const auto& node : getCells())
+        {
+            for(const auto& port : node->getPorts())
+            {
+                renamePort(port);
+            }
+        }
+
+        // the name of a bypassed net stays as a name of the net it was connected to
+        const auto netnames = module->getNetnames();
+
+        for(const auto& netname : *netnames)
+        {
+            QStringList bits = netname->getBits();
+
+            for(auto& bit : bits)
+            {
+                bit = resolveBit(bit);
+            }
+
+            netname->setBits(bits);
+        }
+    }
+
+    std::vector<std::shared_ptr<Node>> nodesToRemove;
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        if(removedCells.contains(node.get()))
+        {
+            nodesToRemove.push_back(node);
+        }
+    }
+
+    module->removeNodes(nodesToRemove);
+
+    for(const auto& [cellName, representative] : cellTraces)
+    {
+        module->addSimplifiedCell(cellName, representative);
+    }
+}
+
+} // namespace OpenNetlistView::Yosys
@@ -0,0 +1,281 @@
+/**
+ * @file netlistsimplifier.h
+ * @brief Header file for the NetlistSimplifier class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the NetlistSimplifier class and its passes,
+ * which remove cells that add nothing to the diagram, like buffer chains, pairs of
+ * inverters and logic whose outputs are not used, before the module is routed.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __NETLISTSIMPLIFIER_H__
+#define __NETLISTSIMPLIFIER_H__
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstddef>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+class Node;
+class Port;
+class NetlistSimplifier;
+
+/**
+ * @class SimplificationPass
+ * @brief The interface of a pass that removes cells from a module.
+ *
+ * A pass only changes the module through the simplifier, so the connections
+ * stay consistent and the removed cells can be traced back.
+ */
+class SimplificationPass
+{
+public:
+    /**
+     * @brief Destroy the SimplificationPass object
+     *
+     */
+    virtual ~SimplificationPass() = default;
+
+    /**
+     * @brief Get the name of the pass
+     *
+     * @return QString The name the pass is enabled and reported with.
+     */
+    virtual QString getName() const = 0;
+
+    /**
+     * @brief Removes the cells of the pass from the module of the simplifier
+     *
+     * @param simplifier The simplifier holding the module.
+     * @return size_t The number of removed cells.
+     */
+    virtual size_t run(NetlistSimplifier& simplifier) = 0;
+};
+
+/**
+ * @class BufferChainPass
+ * @brief Removes buffers and connects their readers to the driver of the buffer.
+ */
+class BufferChainPass : public SimplificationPass
+{
+public:
+    QString getName() const override;
+    size_t run(NetlistSimplifier& simplifier) override;
+};
+
+/**
+ * @class DoubleInverterPass
+ * @brief Removes an inverter driving only another inverter together with the second inverter.
+ */
+class DoubleInverterPass : public SimplificationPass
+{
+public:
+    QString getName() const override;
+    size_t run(NetlistSimplifier& simplifier) override;
+};
+
+/**
+ * @class DeadLogicPass
+ * @brief Removes cells whose outputs are neither read by a cell nor by a module port.
+ *
+ * Removing a cell can leave its drivers without readers, so the drivers are
+ * checked again until no more cells are removed. Cells without outputs are kept
+ * and a module without outputs is not pruned, as all of its logic would be removed.
+ */
+class DeadLogicPass : public SimplificationPass
+{
+public:
+    QString getName() const override;
+    size_t run(NetlistSimplifier& simplifier) override;
+};
+
+/**
+ * @class NetlistSimplifier
+ * @brief Runs simplification passes on a module before its connections are created.
+ *
+ * The simplifier works on the bits of the ports like the SliceFolder, so the
+ * paths of the simplified module are built by the parser as usual. Bypassing
+ * a cell renames the bits of its output to the bits of its input. The renames
+ * are applied to the ports and netnames of the module when the passes are done,
+ * so every rename takes constant time.
+ *
+ * The passes are run in the order they were added until no pass removes a cell.
+ * Every removed cell is recorded in the module with the component it was merged
+ * into, so a search for the cell can show that component instead.
+ */
+class NetlistSimplifier
+{
+public:
+    constexpr const static char* bufferChains{"bufferChains"};       ///< The name of the pass collapsing buffer chains.
+    constexpr const static char* doubleInverters{"doubleInverters"}; ///< The name of the pass removing double inverters.
+    constexpr const static char* deadLogic{"deadLogic"};             ///< The name of the pass pruning unused logic.
+    constexpr const static size_t maxRounds{8};                      ///< The maximum number of times all passes are run.
+
+    /**
+     * @brief Construct a new NetlistSimplifier object
+     *
+     * @param module The module to simplify, the paths must not be created yet.
+     */
+    explicit NetlistSimplifier(std::shared_ptr<Module> module);
+
+    /**
+     * @brief Destroy the NetlistSimplifier object
+     *
+     */
+    ~NetlistSimplifier();
+
+    /**
+     * @brief Get the names of the passes that can be created by name
+     *
+     * @return QStringList The names of the built in passes in the order they are run.
+     */
+    static QStringList getPassNames();
+
+    /**
+     * @brief Creates a built in pass
+     *
+     * @param passName The name of the pass.
+     * @throw std::runtime_error if there is no pass with the name
+     * @return std::unique_ptr<SimplificationPass> The created pass.
+     */
+    static std::unique_ptr<SimplificationPass> createPass(const QString& passName);
+
+    /**
+     * @brief Adds a pass that is run by simplify
+     *
+     * @param pass The pass to add.
+     */
+    void addPass(std::unique_ptr<SimplificationPass> pass);
+
+    /**
+     * @brief Runs the passes and applies the changes to the module
+     *
+     * @return std::map<QString, size_t> The number of removed cells by the name of the pass.
+     */
+    std::map<QString, size_t> simplify();
+
+    /**
+     * @brief Get the cells of the module that were not removed
+     *
+     * @return std::vector<std::shared_ptr<Node>> The remaining cells.
+     */
+    std::vector<std::shared_ptr<Node>> getCells() const;
+
+    /**
+     * @brief Checks if a cell was removed by a pass
+     *
+     * @param node The cell to check.
+     * @return true if the cell was removed
+     */
+    bool isRemoved(const std::shared_ptr<Node>& node) const;
+
+    /**
+     * @brief Get the current bits of a port with all renames applied
+     *
+     * @param port The port of a cell or of the module.
+     * @return QStringList The bits the port is connected to.
+     */
+    QStringList getBits(const std::shared_ptr<Port>& port) const;
+
+    /**
+     * @brief Get the number of cell and module ports reading a bit
+     *
+     * @param bit The current bit.
+     * @return size_t The number of times the bit is read.
+     */
+    size_t getReaderCount(const QString& bit) const;
+
+    /**
+     * @brief Get the cell driving a bit
+     *
+     * @param bit The current bit.
+     * @return std::shared_ptr<Node> The driving cell or nullptr if the bit is driven by a module port or not at all.
+     */
+    std::shared_ptr<Node> getDriverCell(const QString& bit) const;
+
+    /**
+     * @brief Checks if the module has an output port that reads a net
+     *
+     * @return true if a net is read by an output port of the module
+     */
+    bool hasModuleOutputs() const;
+
+    /**
+     * @brief Checks if a cell can be bypassed by connecting its output to its input
+     *
+     * @param inputBits The current bits of the input.
+     * @param outputBits The current bits of the output.
+     * @return true if the bits have the same width, do not overlap and a module port is not driven by a constant
+     */
+    bool canBypass(const QStringList& inputBits, const QStringList& outputBits) const;
+
+    /**
+     * @brief Connects the readers of the output bits to the input bits
+     *
+     * @param inputBits The current bits of the input.
+     * @param outputBits The current bits of the output.
+     */
+    void bypass(const QStringList& inputBits, const QStringList& outputBits);
+
+    /**
+     * @brief Removes a cell from the module
+     *
+     * @param node The cell to remove.
+     * @param inputBits The current bits the cell read, its driver is the component the cell is traced to.
+     */
+    void removeCell(const std::shared_ptr<Node>& node, const QStringList& inputBits);
+
+private:
+    /**
+     * @brief Collects the drivers and readers of every bit
+     *
+     */
+    void buildBitIndex();
+
+    /**
+     * @brief Get the current name of a bit
+     *
+     * @param bit The bit as it is stored in a port.
+     * @return QString The bit with all renames applied.
+     */
+    QString resolveBit(const QString& bit) const;
+
+    /**
+     * @brief Get the name of the component driving a bit
+     *
+     * @param bit The current bit.
+     * @return QString The name of the driving cell or module port or an empty string.
+     */
+    QString getDriverName(const QString& bit) const;
+
+    /**
+     * @brief Applies the renamed bits and removed cells to the module
+     *
+     */
+    void applyChanges();
+
+    std::shared_ptr<Module> module;                           ///< The module to simplify.
+    std::vector<std::unique_ptr<SimplificationPass>> passes;  ///< The passes in the order they are run.
+    QHash<QString, QString> renamedBits;                      ///< The bit every bypassed bit is connected to.
+    QHash<QString, std::shared_ptr<Port>> bitDrivers;         ///< The port driving every bit.
+    QHash<QString, size_t> bitReaderCounts;                   ///< The number of ports reading every bit.
+    QSet<QString> modulePortBits;                             ///< The bits connected to a port of the module.
+    bool moduleOutputs = false;                               ///< Flag if a net is read by an output port of the module.
+    QSet<const Node*> removedCells;                           ///< The cells removed by the passes.
+    std::vector<std::pair<QString, QString>> cellTraces;      ///< The removed cells with the component they were merged into.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __NETLISTSIMPLIFIER_H__
@@ -29,6 +29,11 @@ QStringList Netname::getBits() const
     return this->bits;
 }
 
+void Netname::setBits(QStringList bits)
+{
+    this->bits = std::move(bits);
+}
+
 bool Netname::getIsHidden() const
 {
     return this->isHidden;
@@ -55,6 +55,13 @@ public:
      */
     QStringList getBits() const;
 
+    /**
+     * @brief Sets the bits of the net name.
+     *
+     * @param bits A list containing the new bits of the net name.
+     */
+    void setBits(QStringList bits);
+
     /**
      * @brief Gets the visibility of the net name.
      *
@@ -1,6 +1,8 @@
 #include <QString>
+#include <QStringList>
+#include <QRectF>
+#include <QPointF>
 #include <QRegularExpression>
-#include <QGraphicsSvgItem>
 #include <third_party/libavoid/shape.h>
 #include <third_party/libavoid/geomtypes.h>
 
@@ -17,7 +19,6 @@
 #include <iterator>
 
 #include <symbol/symbol.h>
-#include <qnetlistgraphicsnode.h>
 
 #include "port.h"
 #include "component.h"
@@ -95,6 +96,23 @@ Avoid::ShapeRef* Node::getAvoidRectReference()
     return this->avoidRectReference;
 }
 
+void Node::setLayoutRect(const QRectF& layoutRect)
+{
+    this->layoutRect = layoutRect;
+}
+
+QRectF Node::getRoutedRect()
+{
+    if(this->avoidRectReference == nullptr)
+    {
+        return this->layoutRect;
+    }
+
+    const Avoid::Box box = this->avoidRectReference->polygon().offsetBoundingBox(0.0);
+
+    return {QPointF(box.min.x, box.min.y), QPointF(box.max.x, box.max.y)};
+}
+
 std::vector<std::shared_ptr<Port>>& Node::getPorts()
 {
     return ports;
@@ -110,6 +128,21 @@ void Node::setType(QString type)
     this->type = std::move(type);
 }
 
+void Node::setFoldedNames(const QStringList& foldedNames)
+{
+    this->foldedNames = foldedNames;
+}
+
+QStringList Node::getFoldedNames() const
+{
+    return this->foldedNames;
+}
+
+int Node::getSliceCount() const
+{
+    return this->foldedNames.isEmpty() ? 1 : static_cast<int>(this->foldedNames.size());
+}
+
 std::tuple<int, int> Node::getSplitJoinBitPositions(const std::shared_ptr<Port>& labelPort)
 {
 
@@ -164,37 +197,11 @@ bool Node::hasConnection() const
     });
 }
 
-QNetlistGraphicsNode* Node::convertToQt()
-{
-
-    auto* svgItem = new QNetlistGraphicsNode();
-
-    // get the renderer if it is not null set it to the svg item
-    auto* qRenderer = symbol->getQRenderer();
-
-    if(qRenderer != nullptr)
-    {
-        svgItem->setSharedRenderer(qRenderer);
-    }
-
-    // set the position of the symbol
-    const Avoid::Point centerPoint = this->avoidRectReference->position();
-
-    const auto boundingBox = symbol->getBoundingBox();
-
-    svgItem->setPos(centerPoint.x - (boundingBox.first / 2),
-        centerPoint.y - (boundingBox.second / 2));
-
-    // set this nodes qtitem to the one created
-    this->setGraphicsItem(svgItem);
-
-    return svgItem;
-}
-
 void Node::clearRoutingData()
 {
     this->colaRectID = -1;
     this->avoidRectReference = nullptr;
+    this->layoutRect = QRectF();
 }
 
 std::ostream&
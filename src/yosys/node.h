@@ -11,13 +11,13 @@
 #define __NODE_H__
 
 #include <QString>
-#include <QGraphicsSvgItem>
+#include <QStringList>
+#include <QRectF>
 #include <third_party/libavoid/shape.h>
 
 #include <tuple>
 
 #include <symbol/symbol.h>
-#include <qnetlistgraphicsnode.h>
 
 #include "component.h"
 #include "port.h"
@@ -113,6 +113,23 @@ public:
      */
     Avoid::ShapeRef* getAvoidRectReference();
 
+    /**
+     * @brief Sets the area of the node loaded from a layout bundle
+     *
+     * The area is used instead of the avoid layout when the
+     * module is not routed by the router.
+     *
+     * @param layoutRect the rectangle of the node
+     */
+    void setLayoutRect(const QRectF& layoutRect);
+
+    /**
+     * @brief Gets the area of the node in the avoid layout or the loaded layout.
+     *
+     * @return the rectangle of the node or an empty rectangle if the node is not routed.
+     */
+    QRectF getRoutedRect();
+
     /**
      * @brief Gets the ports of the node.
      *
@@ -134,6 +151,27 @@ public:
      */
     void setType(QString type);
 
+    /**
+     * @brief Sets the names of the cells folded into this node.
+     *
+     * @param foldedNames The names of the per bit cells in bus order.
+     */
+    void setFoldedNames(const QStringList& foldedNames);
+
+    /**
+     * @brief Gets the names of the cells folded into this node.
+     *
+     * @return The names of the per bit cells or an empty list if the node is a single cell.
+     */
+    QStringList getFoldedNames() const;
+
+    /**
+     * @brief Gets the number of cells represented by the node.
+     *
+     * @return The number of folded cells or 1 if the node is a single cell.
+     */
+    int getSliceCount() const;
+
     /**
      * @brief Calculates the positions of the bits of one of the
      * split or join ports within the ports of the split or join node.
@@ -152,13 +190,6 @@ public:
      */
     bool hasConnection() const;
 
-    /**
-     * @brief Converts the node to a QGraphicsSvgItem.
-     *
-     * @return A vector of QGraphicsSvgItem representing the node.
-     */
-    QNetlistGraphicsNode* convertToQt();
-
     /**
      * @brief clear the routing data from the node
      *
@@ -182,6 +213,8 @@ private:
     std::shared_ptr<Symbol::Symbol> symbol;   ///< The symbol that the node uses.
     int colaRectID;                           ///< The ID of the node's rectangle in the cola layout.
     Avoid::ShapeRef* avoidRectReference;      ///< The rectangle that represents the node in the avoid layout.
+    QRectF layoutRect;                        ///< The area of the node loaded from a layout bundle.
+    QStringList foldedNames;                  ///< The names of the cells folded into the node.
 };
 
 } // namespace OpenNetlistView::Yosys
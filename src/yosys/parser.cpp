@@ -20,8 +20,10 @@
 #include <stack>
 #include <map>
 #include <tuple>
+#include <string>
 
 #include <symbol/symbol.h>
+#include <scheduler/taskscheduler.h>
 
 #include "port.h"
 #include "node.h"
@@ -29,12 +31,16 @@
 #include "diagram.h"
 #include "module.h"
 #include "netname.h"
+#include "slicefolder.h"
+#include "netlistsimplifier.h"
+#include "rtlilreader.h"
 
 #include "parser.h"
 
 namespace OpenNetlistView::Yosys {
 
 Parser::Parser()
+    : bitsScanner(std::make_shared<BitsScanner>())
 {
     this->diagram = Diagram();
     this->yosysJsonObject = QJsonObject();
@@ -44,9 +50,42 @@ Parser::~Parser() = default;
 
 void Parser::setYosysJsonObject(const QJsonObject& yosysJsonObject)
 {
+    this->bitsScanner->clear();
     this->yosysJsonObject = yosysJsonObject;
 }
 
+void Parser::setYosysJsonData(const QByteArray& yosysJsonData)
+{
+    this->bitsScanner->clear();
+
+    // the bit arrays are replaced by their index before the json is parsed
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(this->bitsScanner->scan(yosysJsonData));
+
+    if(!jsonDoc.isObject())
+    {
+        this->bitsScanner->clear();
+        throw std::runtime_error("Invalid JSON file");
+    }
+
+    this->yosysJsonObject = jsonDoc.object();
+}
+
+void Parser::setRtlilData(const QByteArray& rtlilData)
+{
+    this->bitsScanner->clear();
+
+    // the bits of the rtlil netlist are stored in the bits scanner as well
+    try
+    {
+        this->yosysJsonObject = RtlilReader::read(rtlilData, this->bitsScanner.get());
+    }
+    catch(const std::runtime_error&)
+    {
+        this->bitsScanner->clear();
+        throw;
+    }
+}
+
 std::unique_ptr<Diagram> Parser::getDiagram()
 {
     return std::make_unique<Diagram>(this->diagram);
@@ -57,8 +96,9 @@ void Parser::clearDiagram()
     this->diagram = Diagram();
 }
 
-void Parser::parse()
+void Parser::parse(const Scheduler::CancellationToken& token)
 {
+    this->simplificationStatistics.clear();
 
     // get the modules out of the json data
     const QJsonObject yosysModules = this->yosysJsonObject[YosysJson::modules].toObject();
@@ -69,7 +109,9 @@ void Parser::parse()
         throw std::runtime_error("No modules found in Yosys JSON object");
     }
 
-    // iterate over all modules
+    // collect the modules that are not part of the library
+    std::vector<std::pair<QString, QJsonObject>> moduleJsons;
+
     for(auto [name, module] : yosysModules.toVariantMap().asKeyValueRange())
     {
 
@@ -81,59 +123,172 @@ void Parser::parse()
             continue;
         }
 
-        this->currentModule = std::make_shared<Module>(name);
+        moduleJsons.emplace_back(name, module.toJsonObject());
+    }
 
-        // create path objects for the module
-        const QJsonObject moduleNetnames = module.toJsonObject()[YosysJson::netnames].toObject();
-        this->parseNetnames(moduleNetnames);
+    std::vector<std::shared_ptr<Module>> modules(moduleJsons.size());
+    std::vector<std::string> errors(moduleJsons.size());
+    std::vector<std::map<QString, size_t>> statistics(moduleJsons.size());
 
-        // create port objects for the module
-        const QJsonObject modulePorts = module.toJsonObject()[YosysJson::ports].toObject();
-        this->parsePorts(modulePorts);
+    // the modules do not share any data so every module is parsed by its own parser
+    Scheduler::TaskScheduler::getShared().parallelFor(0, moduleJsons.size(), [this, &moduleJsons, &modules, &errors, &statistics](size_t moduleBegin, size_t moduleEnd) {
+        for(size_t moduleIdx = moduleBegin; moduleIdx < moduleEnd; moduleIdx++)
+        {
+            Parser moduleParser;
+            moduleParser.bitsScanner = this->bitsScanner;
+            moduleParser.sliceFolding = this->sliceFolding;
+            moduleParser.simplificationPasses = this->simplificationPasses;
 
-        // create cell objects for the module
-        const QJsonObject moduleCells = module.toJsonObject()[YosysJson::cells].toObject();
-        this->parseCells(moduleCells);
+            try
+            {
+                modules[moduleIdx] = moduleParser.parseModule(moduleJsons[moduleIdx].first, moduleJsons[moduleIdx].second);
+                statistics[moduleIdx] = std::move(moduleParser.simplificationStatistics);
+            }
+            catch(const std::exception& e)
+            {
+                errors[moduleIdx] = e.what();
+            }
+        }
+    },
+        Scheduler::TaskScheduler::EPriority::NORMAL, token);
 
-        auto ports = *this->currentModule->getPorts();
-        auto nodes = *this->currentModule->getNodes();
+    // the chunks of a canceled token are dropped so the modules are incomplete
+    if(token.isCanceled())
+    {
+        throw std::runtime_error("The parsing was canceled");
+    }
 
-        // if ports or nodes are empty this means the module is invalid
-        if(ports.empty() && nodes.empty())
+    // add the modules in the order of the file so the first error is reported
+    for(size_t moduleIdx = 0; moduleIdx < modules.size(); moduleIdx++)
+    {
+        if(!errors[moduleIdx].empty())
         {
-            throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no Ports or Nodes");
+            throw std::runtime_error(errors[moduleIdx]);
         }
 
-        // replace the constant bits in the ports with generated bits
-        this->replaceConstBits();
-
-        // create connections between all the components
-        this->connectDiagramConnections();
+        for(const auto& [passName, removedCells] : statistics[moduleIdx])
+        {
+            this->simplificationStatistics[passName] += removedCells;
+        }
 
-        // remove all unconnected paths
-        this->removeUnconnectedPaths();
+        // add the diagram to the module
+        this->diagram.addModule(modules[moduleIdx]);
 
-        // check if all components have a connection
-        if(this->currentModule->hasModuleInvalidPaths())
+        // check if the module is the top module
+        if(!moduleJsons[moduleIdx].second[YosysJson::attributes].toObject()["top"].isNull())
         {
-            throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no Paths or Nodes");
+            this->diagram.setTopModule(modules[moduleIdx]);
         }
+    }
+}
+
+std::shared_ptr<Module> Parser::parseModule(const QString& name, const QJsonObject& module)
+{
+    this->currentModule = std::make_shared<Module>(name);
+
+    // create path objects for the module
+    const QJsonObject moduleNetnames = module[YosysJson::netnames].toObject();
+    this->parseNetnames(moduleNetnames);
+
+    // create port objects for the module
+    const QJsonObject modulePorts = module[YosysJson::ports].toObject();
+    this->parsePorts(modulePorts);
+
+    // create cell objects for the module
+    const QJsonObject moduleCells = module[YosysJson::cells].toObject();
+    this->parseCells(moduleCells);
+
+    auto ports = *this->currentModule->getPorts();
+    auto nodes = *this->currentModule->getNodes();
 
-        // check if diagram is empty
-        if(this->currentModule->isEmpty())
+    // if ports or nodes are empty this means the module is invalid
+    if(ports.empty() && nodes.empty())
+    {
+        throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no Ports or Nodes");
+    }
+
+    // merge replicated per bit cells into arrayed nodes
+    // before the connections are created from the bits
+    if(this->sliceFolding)
+    {
+        SliceFolder sliceFolder(this->currentModule);
+        sliceFolder.setCellParameters(std::move(this->cellParameters));
+        sliceFolder.fold();
+    }
+
+    this->cellParameters.clear();
+
+    // remove the cells that add nothing to the diagram, the removed
+    // cells are recorded in the module so a search can still find them
+    if(!this->simplificationPasses.isEmpty())
+    {
+        NetlistSimplifier simplifier(this->currentModule);
+
+        for(const auto& passName : this->simplificationPasses)
         {
-            throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no components");
+            simplifier.addPass(NetlistSimplifier::createPass(passName));
         }
 
-        // add the diagram to the module
-        this->diagram.addModule(this->currentModule);
+        this->simplificationStatistics = simplifier.simplify();
+    }
 
-        // check if the module is the top module
-        if(!module.toJsonObject()[YosysJson::attributes].toObject()["top"].isNull())
+    // replace the constant bits in the ports with generated bits
+    this->replaceConstBits();
+
+    // create connections between all the components
+    this->connectDiagramConnections();
+
+    // remove all unconnected paths
+    this->removeUnconnectedPaths();
+
+    // check if all components have a connection
+    if(this->currentModule->hasModuleInvalidPaths())
+    {
+        throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no Paths or Nodes");
+    }
+
+    // check if diagram is empty
+    if(this->currentModule->isEmpty())
+    {
+        throw std::runtime_error("Error while parsing " + name.toStdString() + ": Module has no components");
+    }
+
+    return this->currentModule;
+}
+
+void Parser::setSliceFolding(bool enabled)
+{
+    this->sliceFolding = enabled;
+}
+
+bool Parser::getSliceFolding() const
+{
+    return this->sliceFolding;
+}
+
+void Parser::setSimplificationPasses(const QStringList& passNames)
+{
+    const QStringList knownPasses = NetlistSimplifier::getPassNames();
+
+    for(const auto& passName : passNames)
+    {
+        if(!knownPasses.contains(passName))
         {
-            this->diagram.setTopModule(this->currentModule);
+            throw std::runtime_error("Unknown simplification pass: " + passName.toStdString());
         }
     }
+
+    this->simplificationPasses = passNames;
+}
+
+QStringList Parser::getSimplificationPasses() const
+{
+    return this->simplificationPasses;
+}
+
+std::map<QString, size_t> Parser::getSimplificationStatistics() const
+{
+    return this->simplificationStatistics;
 }
 
 void Parser::connectDiagramConnections()
@@ -220,7 +375,7 @@ void Parser::parsePorts(const QJsonObject& ports)
 
         // create a port object
         QJsonObject portData = value.toJsonObject();
-        const auto portInstance = Parser::createPort(name, portData[YosysJson::bits], portData[YosysJson::direction]);
+        const auto portInstance = this->createPort(name, portData[YosysJson::bits], portData[YosysJson::direction]);
 
         // add the port to the diagram
         this->currentModule->addPort(portInstance);
@@ -267,7 +422,7 @@ void Parser::parseCells(const QJsonObject& cells)
         for(const auto& portName : portDirections.toVariantMap().keys())
         {
 
-            auto port = Parser::createPort(portName, portConnections[portName], portDirections[portName]);
+            auto port = this->createPort(portName, portConnections[portName], portDirections[portName]);
 
             QString symbolNameAlias = "";
             if(portDirections[portName].toString() == "input" && !SymbolTypes::isValidSymbolType(cellType.toString()))
@@ -290,6 +445,12 @@ void Parser::parseCells(const QJsonObject& cells)
             throw std::runtime_error("Error while parsing " + name.toStdString() + ": Not all ports could be created successfully");
         }
 
+        // only cells with equal parameters can be folded
+        if(this->sliceFolding)
+        {
+            this->cellParameters[name] = QJsonDocument(cellData[YosysJson::parameters].toObject()).toJson(QJsonDocument::Compact);
+        }
+
         // add the finished cell to the diagram
         auto cellNode = std::make_shared<Node>(name, cellType.toString(), ports);
         this->currentModule->addNode(cellNode);
@@ -318,13 +479,14 @@ void Parser::parseNetnames(const QJsonObject& paths)
         }
 
         // get the bits of the netname if they are not present abort parsing
-        auto bitsArray = netnameDataObject[YosysJson::bits].toArray();
-        if(bitsArray.isEmpty())
+        QStringList bitStrings = this->readBits(netnameDataObject[YosysJson::bits]);
+        if(bitStrings.isEmpty())
         {
             throw std::runtime_error("Error while parsing the netname " + pathName.toStdString() + ": No bits found");
         }
 
-        if(std::all_of(bitsArray.begin(), bitsArray.end(), [](const QJsonValue& bit) { return bit.isString() || bit.toString() == "x"; }))
+        // skip netnames that only contain constants
+        if(std::all_of(bitStrings.begin(), bitStrings.end(), Port::isConstantBit))
         {
             continue;
         }
@@ -338,21 +500,16 @@ void Parser::parseNetnames(const QJsonObject& paths)
             // parse the string and split it at the spaces
             const auto unusedBitsArray = unusedBits.toString().split(" ");
 
-            // convert it to integers and remove the index from the bitsArray do it from the back to the front
+            // convert it to integers and remove the index from the bits do it from the back to the front
             // to not mess up the index
             std::for_each(unusedBitsArray.rbegin(), unusedBitsArray.rend(), [&](const QString& bit) {
-                bitsArray.removeAt(bit.toInt());
-            });
-        }
-
-        // convert the bits to integers
-        const QVariantList bits = QVariantList(bitsArray.toVariantList());
-
-        QStringList bitStrings = {};
+                const int bitIdx = bit.toInt();
 
-        for(const auto& bit : bits)
-        {
-            bitStrings.push_back(bit.toString());
+                if(bitIdx >= 0 && bitIdx < bitStrings.size())
+                {
+                    bitStrings.removeAt(bitIdx);
+                }
+            });
         }
 
         // check if the path is already in the diagram if it is skip it
@@ -376,7 +533,7 @@ void Parser::parseNetnames(const QJsonObject& paths)
     }
 }
 
-std::shared_ptr<Port> Parser::createPort(const QString& name, const QJsonValue& bitData, const QJsonValue& directionData)
+std::shared_ptr<Port> Parser::createPort(const QString& name, const QJsonValue& bitData, const QJsonValue& directionData) const
 {
 
     // get the correct direction value
@@ -397,24 +554,39 @@ std::shared_ptr<Port> Parser::createPort(const QString& name, const QJsonValue&
     }
 
     // get the bits values
-    auto bitDataArray = bitData.toArray();
+    const QStringList bitValueStrings = this->readBits(bitData);
 
-    if(bitDataArray.isEmpty())
+    if(bitValueStrings.isEmpty())
     {
         throw std::runtime_error("Error while parsing the port " + name.toStdString() + ": No bits found");
     }
 
-    const QVariantList bitValues = QVariantList(bitDataArray.toVariantList());
+    std::shared_ptr<Port> portInstance = std::make_shared<Port>(name, direction, bitValueStrings);
+
+    return portInstance;
+}
+
+QStringList Parser::readBits(const QJsonValue& bitData) const
+{
+
+    // the array was decoded by the bits scanner
+    if(bitData.isDouble() && this->bitsScanner->hasBits(bitData.toInteger(-1)))
+    {
+        return this->bitsScanner->getBits(bitData.toInteger());
+    }
+
+    const QJsonArray bitDataArray = bitData.toArray();
+
     // convert bits to strings
     QStringList bitValueStrings;
-    for(const auto& bit : bitValues)
+    bitValueStrings.reserve(bitDataArray.size());
+
+    for(const auto& bit : bitDataArray)
     {
-        bitValueStrings.push_back(bit.toString());
+        bitValueStrings.push_back(bit.isString() ? bit.toString() : QString::number(bit.toInteger()));
     }
 
-    std::shared_ptr<Port> portInstance = std::make_shared<Port>(name, direction, bitValueStrings);
-
-    return portInstance;
+    return bitValueStrings;
 }
 
 std::shared_ptr<Port> Parser::createConstantPort(const QString& name, const QStringList& bits, const QStringList& constValue)
@@ -15,6 +15,7 @@
 #ifndef __PARSER_H__
 #define __PARSER_H__
 
+#include <QByteArray>
 #include <QJsonObject>
 #include <QString>
 #include <QStringList>
@@ -22,9 +23,14 @@
 #include <QList>
 
 #include <cstdint>
+#include <memory>
+#include <map>
+
+#include <scheduler/taskscheduler.h>
 
 #include "diagram.h"
 #include "port.h"
+#include "bitsscanner.h"
 
 /**
  * @namespace YosysJson
@@ -50,6 +56,7 @@ constexpr const char* inout_dir{"inout"};   ///< Key for inout direction in Yosy
 constexpr const char* type{"type"};                       ///< Key for type field in Yosys JSON.
 constexpr const char* port_directions{"port_directions"}; ///< Key for port directions field in Yosys JSON.
 constexpr const char* connections{"connections"};         ///< Key for connections field in Yosys JSON.
+constexpr const char* parameters{"parameters"};           ///< Key for parameters field in Yosys JSON.
 
 constexpr const char* netnames{"netnames"};   ///< Key for netnames field in Yosys JSON.
 constexpr const char* hide_name{"hide_name"}; ///< Key for hide name field in Yosys JSON.
@@ -93,6 +100,28 @@ public:
      */
     void setYosysJsonObject(const QJsonObject& yosysJsonObject);
 
+    /**
+     * @brief Sets the content of a Yosys JSON file to be parsed.
+     *
+     * The bit arrays are decoded by a BitsScanner before the rest
+     * of the file is read into the Yosys JSON object.
+     *
+     * @param yosysJsonData The content of the Yosys JSON file.
+     * @throws std::runtime_error if the content is no JSON object.
+     */
+    void setYosysJsonData(const QByteArray& yosysJsonData);
+
+    /**
+     * @brief Sets the content of an RTLIL file to be parsed.
+     *
+     * The netlist is read by a RtlilReader into the structure of a
+     * Yosys JSON object, so it is parsed like a Yosys JSON file.
+     *
+     * @param rtlilData The content of the RTLIL file.
+     * @throws std::runtime_error if the RTLIL netlist can not be read.
+     */
+    void setRtlilData(const QByteArray& rtlilData);
+
     /**
      * @brief Retrieves a shared pointer to a Diagram object.
      *
@@ -119,14 +148,59 @@ public:
      * data to populate the internal Diagram representation.
      *
      * If the parsing fails, an exception is thrown with an appropriate error message.
+     * The modules that are not parsed yet are skipped when the token is canceled.
      *
-     * @throws std::runtime_error if parsing fails.
+     * @param token The token to cancel the parsing with.
+     * @throws std::runtime_error if parsing fails or was canceled.
+     */
+    void parse(const Scheduler::CancellationToken& token = Scheduler::CancellationToken());
+
+    /**
+     * @brief Enables or disables the folding of replicated cells.
+     *
+     * If enabled, structurally identical per bit cells of a module are
+     * merged into one arrayed node with bus ports while parsing.
+     *
+     * @param enabled true to fold the replicated cells.
+     */
+    void setSliceFolding(bool enabled);
+
+    /**
+     * @brief Checks if replicated cells are folded while parsing.
+     *
+     * @return true if the cells are folded
+     */
+    bool getSliceFolding() const;
+
+    /**
+     * @brief Sets the netlist simplification passes run on every module.
+     *
+     * The passes are run in the given order after the folding of the
+     * replicated cells and before the connections are created.
+     *
+     * @param passNames The names of the passes, an empty list disables the simplification.
+     * @throws std::runtime_error if a name is not the name of a pass.
+     */
+    void setSimplificationPasses(const QStringList& passNames);
+
+    /**
+     * @brief Gets the netlist simplification passes run on every module.
+     *
+     * @return QStringList The names of the enabled passes.
      */
-    void parse();
+    QStringList getSimplificationPasses() const;
+
+    /**
+     * @brief Gets the number of cells removed by the simplification of the last parse.
+     *
+     * @return std::map<QString, size_t> The removed cells of all modules by the name of the pass.
+     */
+    std::map<QString, size_t> getSimplificationStatistics() const;
 
 private:
-    QJsonObject yosysJsonObject; ///< The QJsonObject containing Yosys data.
-    Diagram diagram;             ///< The internal representation of the diagram.
+    QJsonObject yosysJsonObject;              ///< The QJsonObject containing Yosys data.
+    std::shared_ptr<BitsScanner> bitsScanner; ///< The decoded bit arrays shared with the parsers of the modules.
+    Diagram diagram;                          ///< The internal representation of the diagram.
 
     std::shared_ptr<Module> currentModule; ///< The current module being processed.
 
@@ -134,6 +208,25 @@ private:
 
     int constCounter = 0; ///< Counter for constant ports.
 
+    bool sliceFolding = false;                 ///< Flag if replicated cells are folded.
+    std::map<QString, QString> cellParameters; ///< The parameters of the cells of the current module for folding.
+
+    QStringList simplificationPasses;                   ///< The names of the enabled simplification passes.
+    std::map<QString, size_t> simplificationStatistics; ///< The number of cells removed by every pass.
+
+    /**
+     * @brief Parses one module of the Yosys JSON object.
+     *
+     * Every module is parsed by its own parser on the task scheduler,
+     * so the parser only holds the state of the module it parses.
+     *
+     * @param name The name of the module.
+     * @param module The JSON object of the module.
+     * @throws std::runtime_error if parsing fails.
+     * @return std::shared_ptr<Module> The parsed module.
+     */
+    std::shared_ptr<Module> parseModule(const QString& name, const QJsonObject& module);
+
     /**
      * @brief connects the ports of the components of diagram
      *
@@ -188,7 +281,18 @@ private:
      *
      * @return A shared pointer to the created Port object.
      */
-    static std::shared_ptr<Port> createPort(const QString& name, const QJsonValue& bitData, const QJsonValue& directionData);
+    std::shared_ptr<Port> createPort(const QString& name, const QJsonValue& bitData, const QJsonValue& directionData) const;
+
+    /**
+     * @brief Reads the bits of a port, connection or netname.
+     *
+     * The bits are either the index of an array decoded by the
+     * bits scanner or a JSON array of integers and constants.
+     *
+     * @param bitData The JSON value containing bit data.
+     * @return The bits as strings, empty if no bits are found.
+     */
+    QStringList readBits(const QJsonValue& bitData) const;
 
     /**
      * @brief creates a constant port
@@ -1,12 +1,11 @@
 #include <QString>
 #include <QStringList>
 #include <QList>
-#include <QGraphicsPathItem>
-#include <QPen>
-#include <QFont>
-#include <QtCore/Qt>
 #include <QSet>
 #include <QPainterPath>
+#include <QPolygonF>
+#include <QPointF>
+#include <QLineF>
 #include <QVariantList>
 #include <qmetatype.h>
 
@@ -20,11 +19,10 @@
 #include <ostream>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 #include <tuple>
 #include <cstdint>
 
-#include <qnetlistgraphicspath.h>
-
 #include "port.h"
 #include "component.h"
 #include "node.h"
@@ -129,6 +127,146 @@ std::vector<Avoid::ConnRef*> Path::getAvoidConnRefs()
     return this->avoidConnRefs;
 }
 
+void Path::addBundledLine(std::shared_ptr<BundledLine> bundledLine, const int colaDestID)
+{
+    std::shared_ptr<Port> destination = nullptr;
+
+    for(const auto& port : *this->sigDestinations)
+    {
+        if(port->getPortConRectID() == colaDestID)
+        {
+            destination = port;
+        }
+    }
+
+    this->bundledLines.emplace_back(std::move(bundledLine), destination);
+}
+
+void Path::removeBundledLine(const std::shared_ptr<BundledLine>& bundledLine)
+{
+    this->bundledLines.erase(std::remove_if(this->bundledLines.begin(), this->bundledLines.end(), [&bundledLine](const auto& line) {
+        return line.first == bundledLine;
+    }),
+        this->bundledLines.end());
+}
+
+QPolygonF Path::deriveBundledRoute(const QPolygonF& route, const QPointF& srcPin, const QPointF& dstPin)
+{
+    auto isSame = [](double first, double second) {
+        return std::abs(first - second) < coordinateEpsilon;
+    };
+
+    // drop repeated and collinear points so every inner point is a turn
+    QPolygonF corners;
+
+    for(const auto& point : route)
+    {
+        if(!corners.isEmpty() && isSame(corners.back().x(), point.x()) && isSame(corners.back().y(), point.y()))
+        {
+            continue;
+        }
+
+        if(corners.size() >= 2)
+        {
+            const QPointF& before = corners[corners.size() - 2];
+            const QPointF& last = corners.back();
+
+            if((isSame(before.x(), last.x()) && isSame(last.x(), point.x())) ||
+               (isSame(before.y(), last.y()) && isSame(last.y(), point.y())))
+            {
+                corners.back() = point;
+                continue;
+            }
+        }
+
+        corners.append(point);
+    }
+
+    if(corners.size() < 2)
+    {
+        return {};
+    }
+
+    // the unit direction and the normal of every segment
+    std::vector<QPointF> directions;
+    std::vector<QPointF> normals;
+
+    for(qsizetype pointIdx = 1; pointIdx < corners.size(); pointIdx++)
+    {
+        const QPointF delta = corners[pointIdx] - corners[pointIdx - 1];
+
+        if(!isSame(delta.x(), 0.0) && !isSame(delta.y(), 0.0))
+        {
+            return {};
+        }
+
+        const QPointF direction = delta / std::hypot(delta.x(), delta.y());
+        directions.push_back(direction);
+        normals.emplace_back(-direction.y(), direction.x());
+    }
+
+    // the distance to the route is kept on the same side in all segments
+    const double offset = QPointF::dotProduct(srcPin - corners.front(), normals.front());
+
+    QPolygonF bundledRoute;
+    bundledRoute.append(srcPin);
+
+    for(size_t segmentIdx = 1; segmentIdx < directions.size(); segmentIdx++)
+    {
+        const QPointF prevLinePoint = corners[static_cast<qsizetype>(segmentIdx)] + normals[segmentIdx - 1] * offset;
+        const QPointF linePoint = corners[static_cast<qsizetype>(segmentIdx)] + normals[segmentIdx] * offset;
+
+        // the turn is where the moved lines of both segments cross
+        if(isSame(directions[segmentIdx - 1].y(), 0.0))
+        {
+            bundledRoute.append(QPointF(linePoint.x(), prevLinePoint.y()));
+        }
+        else
+        {
+            bundledRoute.append(QPointF(prevLinePoint.x(), linePoint.y()));
+        }
+    }
+
+    const QPointF lastDirection = directions.back();
+    const QPointF routeEnd = corners.back() + normals.back() * offset;
+    bundledRoute.append(routeEnd);
+
+    // a segment that is shorter than the offset in a turn would be reversed
+    for(size_t segmentIdx = 0; segmentIdx < directions.size(); segmentIdx++)
+    {
+        const QPointF delta = bundledRoute[static_cast<qsizetype>(segmentIdx) + 1] - bundledRoute[static_cast<qsizetype>(segmentIdx)];
+
+        if(QPointF::dotProduct(delta, directions[segmentIdx]) < coordinateEpsilon)
+        {
+            return {};
+        }
+    }
+
+    const QPointF endDelta = dstPin - routeEnd;
+
+    if(isSame(endDelta.x(), 0.0) && isSame(endDelta.y(), 0.0))
+    {
+        return bundledRoute;
+    }
+
+    // the line moves to the destination pin shortly before the end
+    const double lastLength = QPointF::dotProduct(routeEnd - bundledRoute[bundledRoute.size() - 2], lastDirection);
+    const double jogLength = std::min(bundleJogDistance, lastLength / 2.0);
+    const QPointF jogStart = routeEnd - lastDirection * jogLength;
+    const QPointF jogEnd = jogStart + QPointF(lastDirection.y(), -lastDirection.x()) * QPointF::dotProduct(endDelta, QPointF(lastDirection.y(), -lastDirection.x()));
+
+    if(QPointF::dotProduct(dstPin - jogEnd, lastDirection) < coordinateEpsilon)
+    {
+        return {};
+    }
+
+    bundledRoute.back() = jogStart;
+    bundledRoute.append(jogEnd);
+    bundledRoute.append(dstPin);
+
+    return bundledRoute;
+}
+
 bool Path::hasConnection() const
 {
     // has a connection if the sigSource is present and the sigDestinations are not empty
@@ -168,92 +306,165 @@ bool Path::partialBitsMatch(const QStringList& bits) const
     return iter != this->bits.end();
 }
 
-QNetlistGraphicsPath* Path::convertToQt()
+void Path::setLayoutLines(std::vector<RoutedLine> layoutLines, std::vector<QPointF> layoutJunctions)
 {
+    this->layoutLines = std::move(layoutLines);
+    this->layoutJunctions = std::move(layoutJunctions);
+}
 
-    auto* qPathItem = new QNetlistGraphicsPath();
-
-    if(avoidConnRefs.empty())
+std::vector<Path::RoutedLine> Path::getRoutedLines()
+{
+    if(this->avoidConnRefs.empty() && this->bundledLines.empty())
     {
-        return qPathItem;
+        return this->layoutLines;
     }
 
-    QPainterPath completePainterPath;
+    std::vector<RoutedLine> routedLines;
+    routedLines.reserve(this->avoidConnRefs.size() + this->bundledLines.size());
 
     for(auto* avoidConnRef : this->avoidConnRefs)
     {
+        RoutedLine routedLine;
 
-        // create the path object if it is the first nothing additional needs to be done
-        //  else we need to find the point where the paths diverge
-        const QPainterPath qSubPainterPath = createPainterPath(*avoidConnRef, qPathItem);
+        for(const auto& point : avoidConnRef->displayRoute().ps)
+        {
+            routedLine.points.append(QPointF(point.x, point.y));
+        }
+
+        // the destination is used to create the label of the line
+        auto port = this->avoidPortRefs.find(avoidConnRef);
 
-        if(avoidConnRef == avoidConnRefs.front())
+        if(port != this->avoidPortRefs.end())
         {
-            completePainterPath = qSubPainterPath;
+            routedLine.destination = port->second;
         }
-        else
+
+        routedLines.push_back(std::move(routedLine));
+    }
+
+    // the bundled lines are derived from the current route, so they follow a rerouting
+    for(const auto& [bundledLine, destination] : this->bundledLines)
+    {
+        QPolygonF route;
+
+        for(const auto& point : bundledLine->representative->displayRoute().ps)
         {
+            route.append(QPointF(point.x, point.y));
+        }
 
-            const QPointF endOfIntersection = findEndOfIntersection(completePainterPath,
-                qSubPainterPath);
+        if(route.isEmpty())
+        {
+            continue;
+        }
 
-            qPathItem->addDivergingPoint(endOfIntersection);
+        const QPointF srcPin = route.front() + bundledLine->srcOffset;
+        const QPointF dstPin = route.back() + bundledLine->dstOffset;
 
-            completePainterPath.addPath(qSubPainterPath);
+        RoutedLine routedLine;
+        routedLine.points = deriveBundledRoute(route, srcPin, dstPin);
+        routedLine.destination = destination;
+
+        // the router checks the lines after every routing and routes a line on its own
+        // if it can not be derived, so an empty route is never drawn across the diagram
+        if(routedLine.points.isEmpty())
+        {
+            continue;
         }
+
+        routedLines.push_back(std::move(routedLine));
     }
 
-    qPathItem->setPath(completePainterPath);
+    return routedLines;
+}
 
-    // set the pen strength
-    double lineSize = lineStrength;
+std::vector<QPointF> Path::getJunctions()
+{
+    // the loaded junctions do not need to be searched again
+    if(this->avoidConnRefs.empty() && this->bundledLines.empty())
+    {
+        return this->layoutJunctions;
+    }
 
-    if(this->isBus())
+    std::vector<QPointF> junctions;
+    QPainterPath completePainterPath;
+
+    for(const auto& routedLine : this->getRoutedLines())
     {
-        lineSize = busLineStrength;
+        const QPainterPath qSubPainterPath = createPainterPath(routedLine.points);
+
+        // the first line has nothing to diverge from
+        if(completePainterPath.elementCount() == 0)
+        {
+            completePainterPath = qSubPainterPath;
+            continue;
+        }
+
+        junctions.push_back(findEndOfIntersection(completePainterPath, qSubPainterPath));
+
+        completePainterPath.addPath(qSubPainterPath);
     }
 
-    qPathItem->setPen(QPen(Qt::black,
-        lineSize,
-        Qt::SolidLine,
-        Qt::SquareCap,
-        Qt::RoundJoin));
+    return junctions;
+}
+
+Path::Geometry Path::createGeometry()
+{
+
+    Geometry geometry;
+
+    for(const auto& routedLine : this->getRoutedLines())
+    {
+        if(routedLine.points.isEmpty())
+        {
+            continue;
+        }
+
+        // the start of the line is the source text position and
+        // the end of every line should have the name of the destination
+        geometry.srcTextPos = routedLine.points.front();
+
+        if(routedLine.points.size() > 1)
+        {
+            geometry.dstTextPorts.emplace_back(routedLine.points.back(), routedLine.destination);
+        }
 
-    // set this nodes qtitem to the one created
-    this->setGraphicsItem(qPathItem);
+        geometry.painterPath.addPath(createPainterPath(routedLine.points));
+    }
+
+    if(!geometry.painterPath.isEmpty())
+    {
+        geometry.junctions = this->getJunctions();
+    }
 
-    return qPathItem;
+    return geometry;
 }
 
 void Path::clearRoutingData()
 {
     this->avoidConnRefs.clear();
+    this->bundledLines.clear();
+    this->layoutLines.clear();
+    this->layoutJunctions.clear();
 }
 
-QString Path::generateLabelText(Avoid::ConnRef* avoidRef) const
+QString Path::generateLabelText(const std::shared_ptr<Port>& destination) const
 {
 
     std::tuple<int, int> portRange = std::make_tuple(-1, -1);
 
     // check if the source of the path is a split or the destination is a join
     // if it is get the bit range of the split or join
-    // it uses the avoidRef to identify the destination that needs to be checked
-    if(avoidRef == nullptr && this->sigSource != nullptr &&
+    if(destination == nullptr && this->sigSource != nullptr &&
         this->sigSource->getParentNode() != nullptr &&
         this->sigSource->getParentNode()->getType() == "split")
     {
         portRange = this->sigSource->getParentNode()->getSplitJoinBitPositions(this->sigSource);
     }
-    else if(avoidRef != nullptr)
+    else if(destination != nullptr &&
+        destination->getParentNode() != nullptr &&
+        destination->getParentNode()->getType() == "join")
     {
-        auto port = this->avoidPortRefs.find(avoidRef);
-
-        if(port != this->avoidPortRefs.end() &&
-            port->second->getParentNode() != nullptr &&
-            port->second->getParentNode()->getType() == "join")
-        {
-            portRange = port->second->getParentNode()->getSplitJoinBitPositions(port->second);
-        }
+        portRange = destination->getParentNode()->getSplitJoinBitPositions(destination);
     }
 
     // create the port if a range is found
@@ -266,22 +477,17 @@ QString Path::generateLabelText(Avoid::ConnRef* avoidRef) const
     // check if it is a real generic symbol that is not just
     // a unknown normal symbol if it is don't print a name
     const QRegularExpression regularExpr("[/\\\\.$]");
-    if(avoidRef == nullptr && this->sigSource != nullptr && this->sigSource->getParentNode() != nullptr &&
+    if(destination == nullptr && this->sigSource != nullptr && this->sigSource->getParentNode() != nullptr &&
         this->sigSource->getParentNode()->getSymbol() != nullptr && this->sigSource->getParentNode()->getSymbol()->isGenericSymbol() &&
         !this->sigSource->getParentNode()->getName().contains(regularExpr))
     {
         return "";
     }
-    else if(avoidRef != nullptr)
+    else if(destination != nullptr && destination->getParentNode() != nullptr &&
+        destination->getParentNode()->getSymbol() != nullptr && destination->getParentNode()->getSymbol()->isGenericSymbol() &&
+        !destination->getParentNode()->getName().contains(regularExpr))
     {
-        auto port = this->avoidPortRefs.find(avoidRef);
-
-        if(port != this->avoidPortRefs.end() && port->second->getParentNode() != nullptr &&
-            port->second->getParentNode()->getSymbol() != nullptr && port->second->getParentNode()->getSymbol()->isGenericSymbol() &&
-            !port->second->getParentNode()->getName().contains(regularExpr))
-        {
-            return "";
-        }
+        return "";
     }
 
     // if the name is hidden return an empty string
@@ -355,34 +561,22 @@ std::ostream& operator<<(std::ostream& outputStream, const Path& path)
     return outputStream << sStream.str();
 }
 
-QPainterPath Path::createPainterPath(Avoid::ConnRef& connRef, QNetlistGraphicsPath* qPathItem)
+QPainterPath Path::createPainterPath(const QPolygonF& points)
 {
 
     QPainterPath qPathPainter;
 
-    Avoid::PolyLine avoidPath = connRef.displayRoute();
-
-    for(const auto& point : avoidPath.ps)
+    if(points.isEmpty())
     {
+        return qPathPainter;
+    }
 
-        // move to the first point add the position  as the source text position
-        // then move to the next point
-        if(point == avoidPath.ps.front())
-        {
-
-            qPathPainter.moveTo(point.x, point.y);
-            qPathItem->setSrcTextPort(QPointF(point.x, point.y));
-            continue;
-        }
-
-        // the end of the line should have the name of the destination so
-        // we need to add the position to the list of destination text positions
-        if(point == avoidPath.ps.back())
-        {
-            qPathItem->addDstTextPort(QPointF(point.x, point.y), &connRef);
-        }
+    // move to the first point then draw a line to the next points
+    qPathPainter.moveTo(points.front());
 
-        qPathPainter.lineTo(point.x, point.y);
+    for(qsizetype pointIdx = 1; pointIdx < points.size(); pointIdx++)
+    {
+        qPathPainter.lineTo(points[pointIdx]);
     }
 
     return qPathPainter;
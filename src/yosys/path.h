@@ -13,16 +13,21 @@
 
 #include <QString>
 #include <QStringList>
-#include <QGraphicsPathItem>
 #include <QPainterPath>
+#include <QPolygonF>
+#include <QPointF>
 #include <QVariantList>
 #include <third_party/libavoid/connector.h>
 #include <third_party/libavoid/geomtypes.h>
 
 #include <vector>
+#include <memory>
+#include <map>
+#include <utility>
+#include <tuple>
 #include <cstdint>
+#include <optional>
 
-#include <qnetlistgraphicspath.h>
 #include "component.h"
 
 namespace OpenNetlistView::Yosys {
@@ -39,10 +44,48 @@ class Port;
 class Path : public Component
 {
 private:
-    constexpr const static double lineStrength{0.5F};    ///< the strength of the line (not a bus)
-    constexpr const static double busLineStrength{2.0F}; ///< the strength of the line (bus)
+    constexpr const static double bundleJogDistance{10.0F}; ///< the maximum distance from the end a bundled line moves to its destination pin
+    constexpr const static double coordinateEpsilon{1e-6};  ///< the tolerance when coordinates of routes are compared
 
 public:
+    /**
+     * @struct RoutedLine
+     * @brief A routed line from the source of the path to one of its destinations.
+     */
+    struct RoutedLine
+    {
+        QPolygonF points;                  ///< The points of the line starting at the source.
+        std::shared_ptr<Port> destination; ///< The destination the line ends at or nullptr if it is unknown.
+    };
+
+    /**
+     * @struct BundledLine
+     * @brief A line that runs parallel to the routed connection of its bundle.
+     *
+     * The offsets are the distances of the pins of the line to the pins of the
+     * routed connection, so the line follows the connection when it is rerouted.
+     */
+    struct BundledLine
+    {
+        Avoid::ConnRef* representative; ///< The routed connection of the bundle.
+        QPointF srcOffset;              ///< The offset of the source pin to the start of the representative.
+        QPointF dstOffset;              ///< The offset of the destination pin to the end of the representative.
+    };
+
+    /**
+     * @struct Geometry
+     * @brief The drawing geometry of a routed path.
+     *
+     * It does not contain any graphics items, so it can be created on a worker thread.
+     */
+    struct Geometry
+    {
+        QPainterPath painterPath;                                             ///< The routed lines of the path.
+        std::optional<QPointF> srcTextPos;                                    ///< The position of the source label, unset if no line is routed.
+        std::vector<std::tuple<QPointF, std::shared_ptr<Port>>> dstTextPorts; ///< The positions of the destination labels with their destinations.
+        std::vector<QPointF> junctions;                                       ///< The points where the lines diverge.
+    };
+
     /**
      * @brief Constructs a Path object with the specified name, width, bits, and neighboring nodes.
      *
@@ -181,6 +224,67 @@ public:
      */
     std::vector<Avoid::ConnRef*> getAvoidConnRefs();
 
+    /**
+     * @brief adds a line that follows the route of another connection
+     *
+     * @param bundledLine the line, it is shared with the router that updates its offsets
+     * @param colaDestID the cola rectangle ID of the destination pin of the line
+     */
+    void addBundledLine(std::shared_ptr<BundledLine> bundledLine, const int colaDestID);
+
+    /**
+     * @brief removes a line that follows the route of another connection
+     *
+     * the router removes the line when it routes the connection on its own
+     *
+     * @param bundledLine the line to remove
+     */
+    void removeBundledLine(const std::shared_ptr<BundledLine>& bundledLine);
+
+    /**
+     * @brief derives the route of a bundled line from the route of its representative
+     *
+     * Every segment of the orthogonal route is moved sideways by the distance of the
+     * source pin to the start of the route, so the line keeps its distance in the turns.
+     * If the destination pin is not at the same distance the line moves to it
+     * shortly before the end.
+     *
+     * @param route the orthogonal route of the representative
+     * @param srcPin the source pin of the bundled line
+     * @param dstPin the destination pin of the bundled line
+     * @return QPolygonF the route of the bundled line or an empty polygon if a segment
+     *         would be reversed or the route is not orthogonal
+     */
+    static QPolygonF deriveBundledRoute(const QPolygonF& route, const QPointF& srcPin, const QPointF& dstPin);
+
+    /**
+     * @brief sets the lines and junctions loaded from a layout bundle
+     *
+     * they are used instead of the connection references when
+     * the module is not routed by the router
+     *
+     * @param layoutLines the routed lines of the path
+     * @param layoutJunctions the points where the lines diverge
+     */
+    void setLayoutLines(std::vector<RoutedLine> layoutLines, std::vector<QPointF> layoutJunctions);
+
+    /**
+     * @brief gets the routed lines of the path
+     *
+     * the lines are taken from the connection references and the bundled
+     * lines or from the loaded layout if the path has neither of them
+     *
+     * @return std::vector<RoutedLine> the routed lines, empty if the path is not routed
+     */
+    std::vector<RoutedLine> getRoutedLines();
+
+    /**
+     * @brief gets the points where the routed lines diverge
+     *
+     * @return std::vector<QPointF> one point for every line after the first
+     */
+    std::vector<QPointF> getJunctions();
+
     /**
      * @brief checks if the path has connections
      *
@@ -226,11 +330,14 @@ public:
     bool partialBitsMatch(const QStringList& bits) const;
 
     /**
-     * @brief Converts the path to a Qt path.
+     * @brief Creates the drawing geometry of the routed path.
+     *
+     * No graphics items are created and only the routing data of this path
+     * is read, so the geometry of different paths can be created in parallel.
      *
-     * @return A pointer to the Qt path.
+     * @return The geometry of the path, empty if the path is not routed.
      */
-    QNetlistGraphicsPath* convertToQt();
+    Geometry createGeometry();
 
     /**
      * @brief remove the routing data from the path
@@ -247,10 +354,10 @@ public:
      * Otherwise the name of the path plus it's width is returned if the
      * name is not hidden.
      *
-     * @param avoidRef The connection reference for the path.
+     * @param destination The destination the label is placed at or nullptr for the source.
      * @return The label text for the path.
      */
-    QString generateLabelText(Avoid::ConnRef* avoidRef = nullptr) const;
+    QString generateLabelText(const std::shared_ptr<Port>& destination = nullptr) const;
 
     /**
      * @brief Overloaded stream insertion operator for the Path class.
@@ -270,16 +377,17 @@ private:
     std::vector<std::shared_ptr<QString>> alternativeNames;              ///< A vector of alternative names for the path.
     std::vector<Avoid::ConnRef*> avoidConnRefs;                          ///< The connection reference for the path.
     std::map<Avoid::ConnRef*, std::shared_ptr<Port>> avoidPortRefs;      ///< Contains a relationship between the connections begin and end and the connected ports of the path.
+    std::vector<std::pair<std::shared_ptr<BundledLine>, std::shared_ptr<Port>>> bundledLines; ///< The lines following other connections with their destinations.
+    std::vector<RoutedLine> layoutLines;                                 ///< The routed lines loaded from a layout bundle.
+    std::vector<QPointF> layoutJunctions;                                ///< The junctions loaded from a layout bundle.
 
     /**
-     * @brief Creates a QPainterPath from an Avoid PolyLine.
+     * @brief Creates a QPainterPath from the points of a routed line.
      *
-     * @param avoidPath The Avoid PolyLine to be converted.
-     * @param qPathItem The QNetlistGraphicsPath item to be used for the conversion.
-     * @return The QPainterPath created from the Avoid PolyLine.
+     * @param points The points of the routed line.
+     * @return The QPainterPath created from the points.
      */
-    static QPainterPath createPainterPath(Avoid::ConnRef& connRef,
-        QNetlistGraphicsPath* qPathItem);
+    static QPainterPath createPainterPath(const QPolygonF& points);
 
     /**
      * @brief Finds the end of the intersection of two QPainterPaths.
@@ -2,9 +2,10 @@
 #include <QList>
 #include <QStringList>
 #include <QDebug>
-#include <QGraphicsSvgItem>
 #include <QVariantList>
 #include <QVariant>
+#include <QRectF>
+#include <QPointF>
 #include <third_party/libavoid/shape.h>
 #include <third_party/libavoid/geomtypes.h>
 
@@ -19,7 +20,6 @@
 #include <map>
 #include <tuple>
 
-#include <qnetlistgraphicsnode.h>
 #include <symbol/symbol.h>
 
 #include "component.h"
@@ -123,6 +123,23 @@ Avoid::ShapeRef* Port::getAvoidRectReference()
     return this->avoidRectReference;
 }
 
+void Port::setLayoutRect(const QRectF& layoutRect)
+{
+    this->layoutRect = layoutRect;
+}
+
+QRectF Port::getRoutedRect()
+{
+    if(this->avoidRectReference == nullptr)
+    {
+        return this->layoutRect;
+    }
+
+    const Avoid::Box box = this->avoidRectReference->polygon().offsetBoundingBox(0.0);
+
+    return {QPointF(box.min.x, box.min.y), QPointF(box.max.x, box.max.y)};
+}
+
 Port::EDirection Port::getDirection() const
 {
     return direction;
@@ -179,6 +196,11 @@ bool Port::hasNoConnectBitsConnection() const
     return std::any_of(bits.begin(), bits.end(), [](const QString& bit) { return bit == "x"; });
 }
 
+bool Port::isConstantBit(const QString& bit)
+{
+    return bit == "0" || bit == "1" || bit == "x" || bit == "z";
+}
+
 QStringList Port::getBits()
 {
     return bits;
@@ -224,38 +246,11 @@ std::shared_ptr<Node> Port::getParentNode()
     return this->parentNode;
 }
 
-QNetlistGraphicsNode* Port::convertToQt()
-{
-
-    auto* svgItem = new QNetlistGraphicsNode();
-
-    auto* qRenderer = symbol->getQRenderer();
-
-    if(qRenderer == nullptr || avoidRectReference == nullptr)
-    {
-        return svgItem;
-    }
-
-    // set the symbols renderer
-    svgItem->setSharedRenderer(qRenderer);
-
-    // set the position of the symbol
-    const Avoid::Point centerPoint = this->avoidRectReference->position();
-
-    const auto boundingBox = symbol->getBoundingBox();
-
-    svgItem->setPos(centerPoint.x - (boundingBox.first / 2), centerPoint.y - (boundingBox.second / 2));
-
-    // set the qtitem as the paths item
-    this->setGraphicsItem(svgItem);
-
-    return svgItem;
-}
-
 void Port::clearRoutingData()
 {
     this->colaPortIDs.clear();
     this->avoidRectReference = nullptr;
+    this->layoutRect = QRectF();
 }
 
 std::ostream& operator<<(std::ostream& outputStream, const Port& port)
@@ -12,12 +12,11 @@
 #define __PORT_H__
 
 #include <third_party/libavoid/geomtypes.h>
-#include <QGraphicsSvgItem>
 #include <QStringList>
 #include <QVariantList>
+#include <QRectF>
 
 #include <symbol/symbol.h>
-#include <qnetlistgraphicsnode.h>
 #include <cstdint>
 
 #include "component.h"
@@ -170,6 +169,23 @@ public:
      */
     Avoid::ShapeRef* getAvoidRectReference();
 
+    /**
+     * @brief Sets the area of the port loaded from a layout bundle.
+     *
+     * The area is used instead of the avoid layout when the
+     * module is not routed by the router.
+     *
+     * @param layoutRect the rectangle of the port.
+     */
+    void setLayoutRect(const QRectF& layoutRect);
+
+    /**
+     * @brief Gets the area of the port in the avoid layout or the loaded layout.
+     *
+     * @return the rectangle of the port or an empty rectangle if the port is not routed.
+     */
+    QRectF getRoutedRect();
+
     /**
      * @brief Gets the width of the port.
      *
@@ -232,6 +248,14 @@ public:
      */
     bool hasNoConnectBitsConnection() const;
 
+    /**
+     * @brief checks if a bit is a constant value and not a net
+     *
+     * @param bit The bit to check.
+     * @return true if the bit is one of the constants "0", "1", "x" or "z"
+     */
+    static bool isConstantBit(const QString& bit);
+
     /**
      * @brief Gets the bits of the port.
      *
@@ -274,15 +298,6 @@ public:
      */
     std::shared_ptr<Node> getParentNode();
 
-    /**
-     * @brief Converts the port to a QGraphicsSvgItem.
-     *
-     * Converts the port to a QGraphicsSvgItem for display in the Qt application.
-     *
-     * @return The QGraphicsSvgItem representing the port.
-     */
-    QNetlistGraphicsNode* convertToQt();
-
     /**
      * @brief remove the routing data from the port
      *
@@ -308,6 +323,7 @@ private:
     std::shared_ptr<Symbol::Symbol> symbol; ///< The symbol the the port uses.
     std::map<QString, int> colaPortIDs;     ///< The IDs needed for Ports cola rectangles
     Avoid::ShapeRef* avoidRectReference;    ///< The reference to the rectangle in the avoid layout.
+    QRectF layoutRect;                      ///< The area of the port loaded from a layout bundle.
     std::shared_ptr<Node> parentNode;       ///< The node the port is part of.
     QString symbolNameAlias = "";           ///< The alias for the port name that can be used for the svg symbol
     uint64_t constValue;                    ///< The constant value of the port
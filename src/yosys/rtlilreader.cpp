@@ -0,0 +1,830 @@
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QHash>
+#include <QStringList>
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+#include <scheduler/taskscheduler.h>
+
+#include "parser.h"
+#include "bitsscanner.h"
+
+#include "rtlilreader.h"
+
+namespace OpenNetlistView::Yosys {
+
+bool RtlilReader::isRtlil(const QByteArray& data)
+{
+    qsizetype lineStart = 0;
+
+    while(lineStart < data.size())
+    {
+        qsizetype lineEnd = data.indexOf('\n', lineStart);
+
+        if(lineEnd < 0)
+        {
+            lineEnd = data.size();
+        }
+
+        const QByteArrayView line = QByteArrayView(data.constData() + lineStart, lineEnd - lineStart).trimmed();
+
+        // the first statement decides, comments and empty lines are skipped
+        if(!line.isEmpty() && !line.startsWith('#'))
+        {
+            return line.startsWith("autoidx ") || line.startsWith("attribute ") || line.startsWith("module ");
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    return false;
+}
+
+QJsonObject RtlilReader::read(const QByteArray& rtlilData, BitsScanner* bitsScanner)
+{
+    const char* data = rtlilData.constData();
+
+    // find the modules with their attributes in one pass over the lines
+    std::vector<QByteArrayView> moduleTexts;
+
+    qsizetype lineStart = 0;
+    qsizetype attributeStart = -1;
+    qsizetype moduleStart = -1;
+    int depth = 0;
+
+    while(lineStart < rtlilData.size())
+    {
+        qsizetype lineEnd = rtlilData.indexOf('\n', lineStart);
+
+        if(lineEnd < 0)
+        {
+            lineEnd = rtlilData.size();
+        }
+
+        const QByteArrayView line = QByteArrayView(data + lineStart, lineEnd - lineStart).trimmed();
+        const qsizetype keywordEnd = line.indexOf(' ');
+        const QByteArrayView keyword = keywordEnd < 0 ? line : line.first(keywordEnd);
+
+        if(depth == 0)
+        {
+            if(keyword == "attribute")
+            {
+                attributeStart = attributeStart < 0 ? lineStart : attributeStart;
+            }
+            else if(keyword == "module")
+            {
+                moduleStart = attributeStart < 0 ? lineStart : attributeStart;
+                attributeStart = -1;
+                depth = 1;
+            }
+            else if(!line.isEmpty() && !line.startsWith('#'))
+            {
+                attributeStart = -1;
+            }
+        }
+        else if(keyword == "cell" || keyword == "process" || keyword == "switch")
+        {
+            depth++;
+        }
+        else if(keyword == "end" && --depth == 0)
+        {
+            moduleTexts.emplace_back(data + moduleStart, lineEnd - moduleStart);
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    if(depth != 0)
+    {
+        throw std::runtime_error("The RTLIL netlist ends inside of a module");
+    }
+
+    // the modules do not share any data so they are read in parallel
+    std::vector<ModuleData> modules(moduleTexts.size());
+    std::vector<std::string> errors(moduleTexts.size());
+
+    Scheduler::TaskScheduler::getShared().parallelFor(0, moduleTexts.size(), [&moduleTexts, &modules, &errors](size_t moduleBegin, size_t moduleEnd) {
+        for(size_t moduleIdx = moduleBegin; moduleIdx < moduleEnd; moduleIdx++)
+        {
+            try
+            {
+                RtlilReader reader(moduleTexts[moduleIdx]);
+                reader.readModule();
+                modules[moduleIdx] = std::move(reader.moduleData);
+            }
+            catch(const std::exception& e)
+            {
+                errors[moduleIdx] = e.what();
+            }
+        }
+    });
+
+    for(const auto& error : errors)
+    {
+        if(!error.empty())
+        {
+            throw std::runtime_error(error);
+        }
+    }
+
+    // the cells of the modules of the netlist get the directions of the module ports
+    QHash<QString, QHash<QString, QString>> moduleDirections;
+
+    for(const auto& module : modules)
+    {
+        auto& directions = moduleDirections[module.name];
+
+        for(const auto& wire : module.wires)
+        {
+            if(!wire.direction.isEmpty())
+            {
+                directions.insert(wire.name, wire.direction);
+            }
+        }
+    }
+
+    QJsonObject modulesObject;
+
+    for(const auto& module : modules)
+    {
+        QJsonObject portsObject;
+        QJsonObject netnamesObject;
+
+        for(const auto& wire : module.wires)
+        {
+            const QJsonValue bits = writeBits(wire.bits, bitsScanner);
+
+            if(!wire.direction.isEmpty())
+            {
+                QJsonObject portObject;
+                portObject[YosysJson::direction] = wire.direction;
+                portObject[YosysJson::bits] = bits;
+
+                portsObject[wire.name] = portObject;
+            }
+
+            QJsonObject netnameObject;
+            netnameObject[YosysJson::hide_name] = wire.name.startsWith('$') ? 1 : 0;
+            netnameObject[YosysJson::bits] = bits;
+            netnameObject[YosysJson::attributes] = wire.attributes;
+
+            netnamesObject[wire.name] = netnameObject;
+        }
+
+        QJsonObject cellsObject;
+
+        for(const auto& cell : module.cells)
+        {
+            const auto directionsIt = moduleDirections.constFind(cell.type);
+
+            QJsonObject portDirections;
+            QJsonObject connections;
+
+            for(const auto& [portName, bits] : cell.ports)
+            {
+                if(directionsIt != moduleDirections.constEnd())
+                {
+                    portDirections[portName] = directionsIt->value(portName, YosysJson::input_dir);
+                }
+                else
+                {
+                    portDirections[portName] = getInternalDirection(cell.type, portName);
+                }
+
+                connections[portName] = writeBits(bits, bitsScanner);
+            }
+
+            QJsonObject cellObject;
+            cellObject[YosysJson::hide_name] = cell.name.startsWith('$') ? 1 : 0;
+            cellObject[YosysJson::type] = cell.type;
+            cellObject[YosysJson::parameters] = cell.parameters;
+            cellObject[YosysJson::attributes] = cell.attributes;
+            cellObject[YosysJson::port_directions] = portDirections;
+            cellObject[YosysJson::connections] = connections;
+
+            cellsObject[cell.name] = cellObject;
+        }
+
+        QJsonObject moduleObject;
+        moduleObject[YosysJson::attributes] = module.attributes;
+        moduleObject[YosysJson::ports] = portsObject;
+        moduleObject[YosysJson::cells] = cellsObject;
+        moduleObject[YosysJson::netnames] = netnamesObject;
+
+        modulesObject[module.name] = moduleObject;
+    }
+
+    QJsonObject netlist;
+    netlist[YosysJson::modules] = modulesObject;
+
+    return netlist;
+}
+
+RtlilReader::RtlilReader(QByteArrayView moduleText)
+    : moduleText(moduleText)
+    , bitParents(constantCount)
+{
+    // the constants are the first bits so they are found first
+    for(size_t constantIdx = 0; constantIdx < constantCount; constantIdx++)
+    {
+        bitParents[constantIdx] = constantIdx;
+    }
+}
+
+void RtlilReader::readModule()
+{
+    QJsonObject attributes;
+    bool inCell = false;
+
+    qsizetype lineStart = 0;
+
+    while(lineStart < moduleText.size())
+    {
+        qsizetype lineEnd = moduleText.indexOf('\n', lineStart);
+
+        if(lineEnd < 0)
+        {
+            lineEnd = moduleText.size();
+        }
+
+        const std::vector<QByteArrayView> tokens = tokenize(moduleText.sliced(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+
+        if(tokens.empty())
+        {
+            continue;
+        }
+
+        const QByteArrayView keyword = tokens.front();
+
+        if(keyword == "attribute" && tokens.size() == 3)
+        {
+            attributes[unescapeId(tokens[1])] = readValue(tokens[2]);
+        }
+        else if(keyword == "module" && tokens.size() == 2)
+        {
+            moduleData.name = unescapeId(tokens[1]);
+            moduleData.attributes = std::exchange(attributes, QJsonObject());
+        }
+        else if(keyword == "wire" && tokens.size() >= 2)
+        {
+            Wire wire;
+            wire.name = unescapeId(tokens.back());
+            wire.attributes = std::exchange(attributes, QJsonObject());
+
+            int width = 1;
+
+            for(size_t tokenIdx = 1; tokenIdx + 1 < tokens.size(); tokenIdx++)
+            {
+                const QByteArrayView option = tokens[tokenIdx];
+
+                if(option == "upto")
+                {
+                    wire.upto = true;
+                }
+                else if(option == "signed")
+                {
+                    continue;
+                }
+                else if(tokenIdx + 2 < tokens.size())
+                {
+                    const int value = tokens[++tokenIdx].toInt();
+
+                    if(option == "width")
+                    {
+                        width = value;
+                    }
+                    else if(option == "offset")
+                    {
+                        wire.offset = value;
+                    }
+                    else if(option == YosysJson::input_dir || option == YosysJson::output_dir || option == YosysJson::inout_dir)
+                    {
+                        wire.direction = QString::fromUtf8(option);
+                    }
+                }
+            }
+
+            if(width < 0)
+            {
+                throw std::runtime_error("Error while reading the wire " + wire.name.toStdString() + ": Invalid width");
+            }
+
+            // every bit of the wire starts as its own net
+            for(int bitIdx = 0; bitIdx < width; bitIdx++)
+            {
+                wire.bits.push_back(static_cast<int64_t>(bitParents.size()));
+                bitParents.push_back(bitParents.size());
+            }
+
+            wireIdxs.insert(tokens.back().toByteArray(), moduleData.wires.size());
+            moduleData.wires.push_back(std::move(wire));
+        }
+        else if(keyword == "cell" && tokens.size() == 3 && !inCell)
+        {
+            Cell cell;
+            cell.type = unescapeId(tokens[1]);
+            cell.name = unescapeId(tokens[2]);
+            cell.attributes = std::exchange(attributes, QJsonObject());
+
+            moduleData.cells.push_back(std::move(cell));
+            inCell = true;
+        }
+        else if(keyword == "parameter" && tokens.size() >= 3)
+        {
+            // the parameters of the module itself are not needed
+            if(inCell)
+            {
+                moduleData.cells.back().parameters[unescapeId(tokens[tokens.size() - 2])] = readValue(tokens.back());
+            }
+        }
+        else if(keyword == "connect" && inCell && tokens.size() >= 3)
+        {
+            size_t tokenIdx = 2;
+            moduleData.cells.back().ports.emplace_back(unescapeId(tokens[1]), readSigSpec(tokens, tokenIdx));
+        }
+        else if(keyword == "connect" && tokens.size() >= 3)
+        {
+            size_t tokenIdx = 1;
+            const auto lhs = readSigSpec(tokens, tokenIdx);
+            const auto rhs = readSigSpec(tokens, tokenIdx);
+
+            if(lhs.size() != rhs.size())
+            {
+                throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Connected signals differ in width");
+            }
+
+            for(size_t bitIdx = 0; bitIdx < lhs.size(); bitIdx++)
+            {
+                connectBits(lhs[bitIdx], rhs[bitIdx]);
+            }
+        }
+        else if(keyword == "end")
+        {
+            if(!inCell)
+            {
+                break;
+            }
+
+            inCell = false;
+        }
+        else if(keyword == "memory" || keyword == "autoidx")
+        {
+            // memories are accessed by cells and not shown on their own
+            attributes = QJsonObject();
+        }
+        else if(keyword == "process")
+        {
+            throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() +
+                                     ": Processes are not supported, run proc before write_rtlil");
+        }
+        else
+        {
+            throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Invalid statement " +
+                                     keyword.toByteArray().toStdString());
+        }
+    }
+
+    resolveBits();
+}
+
+std::vector<int64_t> RtlilReader::readSigSpec(const std::vector<QByteArrayView>& tokens, size_t& tokenIdx) const
+{
+    if(tokenIdx >= tokens.size())
+    {
+        throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Missing signal");
+    }
+
+    const QByteArrayView token = tokens[tokenIdx++];
+
+    // a concatenation lists the most significant part first
+    if(token == "{")
+    {
+        std::vector<std::vector<int64_t>> parts;
+
+        while(tokenIdx < tokens.size() && tokens[tokenIdx] != "}")
+        {
+            parts.push_back(readSigSpec(tokens, tokenIdx));
+        }
+
+        if(tokenIdx >= tokens.size())
+        {
+            throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Unterminated concatenation");
+        }
+
+        tokenIdx++;
+
+        std::vector<int64_t> bits;
+
+        for(auto partIt = parts.rbegin(); partIt != parts.rend(); partIt++)
+        {
+            bits.insert(bits.end(), partIt->begin(), partIt->end());
+        }
+
+        return bits;
+    }
+
+    if(!token.startsWith('\\') && !token.startsWith('$'))
+    {
+        return readConstant(token);
+    }
+
+    const auto wireIt = wireIdxs.constFind(token.toByteArray());
+
+    if(wireIt == wireIdxs.constEnd())
+    {
+        throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Unknown wire " +
+                                 token.toByteArray().toStdString());
+    }
+
+    const Wire& wire = moduleData.wires[*wireIt];
+
+    if(tokenIdx >= tokens.size() || !tokens[tokenIdx].startsWith('[') || !tokens[tokenIdx].endsWith(']'))
+    {
+        return wire.bits;
+    }
+
+    // a slice names the most significant and the least significant index
+    const QByteArrayView slice = tokens[tokenIdx++].chopped(1).sliced(1);
+    const qsizetype colonPos = slice.indexOf(':');
+
+    const int width = static_cast<int>(wire.bits.size());
+    const auto bitPos = [&wire, width](int index) {
+        return wire.upto ? wire.offset + width - 1 - index : index - wire.offset;
+    };
+
+    int msbPos = bitPos(colonPos < 0 ? slice.toInt() : slice.first(colonPos).toInt());
+    int lsbPos = colonPos < 0 ? msbPos : bitPos(slice.sliced(colonPos + 1).toInt());
+
+    if(lsbPos > msbPos)
+    {
+        std::swap(lsbPos, msbPos);
+    }
+
+    if(lsbPos < 0 || msbPos >= width)
+    {
+        throw std::runtime_error("Error while reading the module " + moduleData.name.toStdString() + ": Slice out of range of the wire " +
+                                 wire.name.toStdString());
+    }
+
+    return {wire.bits.begin() + lsbPos, wire.bits.begin() + msbPos + 1};
+}
+
+size_t RtlilReader::findBit(size_t bit)
+{
+    while(bitParents[bit] != bit)
+    {
+        bitParents[bit] = bitParents[bitParents[bit]];
+        bit = bitParents[bit];
+    }
+
+    return bit;
+}
+
+void RtlilReader::connectBits(size_t lhs, size_t rhs)
+{
+    const size_t lhsRoot = findBit(lhs);
+    const size_t rhsRoot = findBit(rhs);
+
+    if(lhsRoot == rhsRoot || (lhsRoot < constantCount && rhsRoot < constantCount))
+    {
+        return;
+    }
+
+    // a net driven by a constant is the constant
+    if(rhsRoot < constantCount)
+    {
+        bitParents[lhsRoot] = rhsRoot;
+    }
+    else
+    {
+        bitParents[rhsRoot] = lhsRoot;
+    }
+}
+
+void RtlilReader::resolveBits()
+{
+    // yosys starts the bit ids after the constants 0 and 1
+    int64_t nextBitId = 2;
+    std::vector<int64_t> bitIds(bitParents.size(), 0);
+
+    const auto resolveBit = [this, &nextBitId, &bitIds](int64_t& bit) {
+        const size_t root = findBit(static_cast<size_t>(bit));
+
+        if(root < constantCount)
+        {
+            bit = BitsScanner::constZero - static_cast<int64_t>(root);
+            return;
+        }
+
+        if(bitIds[root] == 0)
+        {
+            bitIds[root] = nextBitId++;
+        }
+
+        bit = bitIds[root];
+    };
+
+    for(auto& wire : moduleData.wires)
+    {
+        std::for_each(wire.bits.begin(), wire.bits.end(), resolveBit);
+    }
+
+    for(auto& cell : moduleData.cells)
+    {
+        for(auto& [portName, bits] : cell.ports)
+        {
+            std::for_each(bits.begin(), bits.end(), resolveBit);
+        }
+    }
+}
+
+std::vector<QByteArrayView> RtlilReader::tokenize(QByteArrayView line)
+{
+    std::vector<QByteArrayView> tokens;
+    qsizetype pos = 0;
+
+    while(pos < line.size())
+    {
+        while(pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+        {
+            pos++;
+        }
+
+        if(pos >= line.size() || line[pos] == '#')
+        {
+            break;
+        }
+
+        const qsizetype tokenStart = pos;
+
+        // strings may contain spaces
+        if(line[pos] == '"')
+        {
+            pos++;
+
+            while(pos < line.size() && line[pos] != '"')
+            {
+                pos += line[pos] == '\\' ? 2 : 1;
+            }
+
+            pos = std::min(pos + 1, line.size());
+        }
+        else
+        {
+            while(pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r')
+            {
+                pos++;
+            }
+        }
+
+        tokens.push_back(line.sliced(tokenStart, pos - tokenStart));
+    }
+
+    return tokens;
+}
+
+QString RtlilReader::unescapeId(QByteArrayView id)
+{
+    // public names lose the backslash like in the json backend of yosys
+    if(id.size() < 2 || id[0] != '\\' || id[1] == '$' || id[1] == '\\' || (id[1] >= '0' && id[1] <= '9'))
+    {
+        return QString::fromUtf8(id);
+    }
+
+    return QString::fromUtf8(id.sliced(1));
+}
+
+QJsonValue RtlilReader::readValue(QByteArrayView value)
+{
+    if(value.startsWith('"'))
+    {
+        QByteArray string;
+        string.reserve(value.size());
+
+        for(qsizetype pos = 1; pos < value.size() - 1; pos++)
+        {
+            if(value[pos] != '\\' || pos + 1 >= value.size() - 1)
+            {
+                string.append(value[pos]);
+                continue;
+            }
+
+            const char escaped = value[++pos];
+
+            if(escaped == 'n')
+            {
+                string.append('\n');
+            }
+            else if(escaped == 't')
+            {
+                string.append('\t');
+            }
+            else if(escaped >= '0' && escaped <= '7')
+            {
+                // octal escapes have up to three digits
+                int code = escaped - '0';
+
+                for(int digitIdx = 1; digitIdx < 3 && pos + 1 < value.size() - 1 && value[pos + 1] >= '0' && value[pos + 1] <= '7'; digitIdx++)
+                {
+                    code = code * 8 + (value[++pos] - '0');
+                }
+
+                string.append(static_cast<char>(code));
+            }
+            else
+            {
+                string.append(escaped);
+            }
+        }
+
+        return QString::fromUtf8(string);
+    }
+
+    // the json backend writes constants as their binary digits
+    const qsizetype quotePos = value.indexOf('\'');
+
+    if(quotePos >= 0)
+    {
+        return QString::fromUtf8(value.sliced(quotePos + 1));
+    }
+
+    return QString::number(static_cast<quint32>(value.toLongLong()), 2).rightJustified(32, '0');
+}
+
+std::vector<int64_t> RtlilReader::readConstant(QByteArrayView constant)
+{
+    const qsizetype quotePos = constant.indexOf('\'');
+    std::vector<int64_t> bits;
+
+    // a plain integer is a 32 bit constant
+    if(quotePos < 0)
+    {
+        bool isNumber = false;
+        const auto value = static_cast<uint32_t>(constant.toLongLong(&isNumber));
+
+        if(!isNumber)
+        {
+            throw std::runtime_error("Invalid RTLIL constant " + constant.toByteArray().toStdString());
+        }
+
+        for(int bitIdx = 0; bitIdx < 32; bitIdx++)
+        {
+            bits.push_back((value >> bitIdx) & 1U);
+        }
+
+        return bits;
+    }
+
+    bool isWidth = false;
+    const int width = constant.first(quotePos).toInt(&isWidth);
+    const QByteArrayView digits = constant.sliced(quotePos + 1);
+
+    if(!isWidth || width < 0)
+    {
+        throw std::runtime_error("Invalid RTLIL constant " + constant.toByteArray().toStdString());
+    }
+
+    // the digits start with the most significant bit
+    for(qsizetype digitIdx = digits.size() - 1; digitIdx >= 0 && static_cast<int>(bits.size()) < width; digitIdx--)
+    {
+        switch(digits[digitIdx])
+        {
+        case '0':
+            bits.push_back(0);
+            break;
+        case '1':
+            bits.push_back(1);
+            break;
+        case 'z':
+            bits.push_back(3);
+            break;
+        default:
+            bits.push_back(2);
+            break;
+        }
+    }
+
+    bits.resize(width, 0);
+
+    return bits;
+}
+
+QString RtlilReader::getInternalDirection(const QString& cellType, const QString& portName)
+{
+    // the output ports of the word level cells, the cells without outputs have an empty list
+    static const QHash<QString, QStringList> cellOutputs = []() {
+        QHash<QString, QStringList> outputs;
+
+        for(const char* type : {"$not", "$pos", "$neg", "$buf", "$reduce_and", "$reduce_or", "$reduce_xor", "$reduce_xnor", "$reduce_bool",
+                "$logic_not", "$and", "$or", "$xor", "$xnor", "$shl", "$shr", "$sshl", "$sshr", "$shift", "$shiftx", "$lt", "$le", "$eq",
+                "$ne", "$eqx", "$nex", "$ge", "$gt", "$add", "$sub", "$mul", "$div", "$mod", "$divfloor", "$modfloor", "$pow",
+                "$logic_and", "$logic_or", "$bweqx", "$mux", "$pmux", "$bmux", "$demux", "$bwmux", "$tribuf", "$slice", "$concat",
+                "$lut", "$sop", "$macc", "$macc_v2", "$equiv", "$initstate", "$anyconst", "$anyseq", "$allconst", "$allseq",
+                "$get_tag", "$set_tag", "$overwrite_tag", "$original_tag", "$future_ff", "$input_port"})
+        {
+            outputs.insert(type, {"Y"});
+        }
+
+        for(const char* type : {"$dff", "$dffe", "$adff", "$adffe", "$aldff", "$aldffe", "$sdff", "$sdffe", "$sdffce", "$dffsr",
+                "$dffsre", "$dlatch", "$adlatch", "$dlatchsr", "$sr", "$ff", "$anyinit"})
+        {
+            outputs.insert(type, {"Q"});
+        }
+
+        for(const char* type : {"$memwr", "$memwr_v2", "$meminit", "$meminit_v2", "$assert", "$assume", "$live", "$fair", "$cover",
+                "$check", "$print", "$specify2", "$specify3", "$specrule", "$scopeinfo", "$connect"})
+        {
+            outputs.insert(type, {});
+        }
+
+        outputs.insert("$alu", {"X", "Y", "CO"});
+        outputs.insert("$lcu", {"CO"});
+        outputs.insert("$fa", {"X", "Y"});
+        outputs.insert("$mem", {"RD_DATA"});
+        outputs.insert("$mem_v2", {"RD_DATA"});
+        outputs.insert("$memrd", {"DATA"});
+        outputs.insert("$memrd_v2", {"DATA"});
+        outputs.insert("$fsm", {"CTRL_OUT"});
+
+        // the combinational gate level cells
+        for(const char* type : {"$_BUF_", "$_NOT_", "$_AND_", "$_NAND_", "$_OR_", "$_NOR_", "$_XOR_", "$_XNOR_", "$_ANDNOT_",
+                "$_ORNOT_", "$_MUX_", "$_NMUX_", "$_MUX4_", "$_MUX8_", "$_MUX16_", "$_AOI3_", "$_OAI3_", "$_AOI4_", "$_OAI4_",
+                "$_TBUF_"})
+        {
+            outputs.insert(type, {"Y"});
+        }
+
+        return outputs;
+    }();
+
+    // the gate level flip-flops and latches exist for every combination of polarities
+    static const QStringList flipFlopPrefixes = {"$_SR_", "$_FF_", "$_DFF", "$_ALDFF", "$_SDFF", "$_DLATCH"};
+
+    const auto outputsIt = cellOutputs.constFind(cellType);
+
+    if(outputsIt != cellOutputs.constEnd())
+    {
+        return outputsIt->contains(portName) ? YosysJson::output_dir : YosysJson::input_dir;
+    }
+
+    const bool isFlipFlop = std::any_of(flipFlopPrefixes.begin(), flipFlopPrefixes.end(), [&cellType](const QString& prefix) {
+        return cellType.startsWith(prefix);
+    });
+
+    if(isFlipFlop)
+    {
+        return portName == "Q" ? YosysJson::output_dir : YosysJson::input_dir;
+    }
+
+    throw std::runtime_error("The directions of the ports of the cell type \"" + cellType.toStdString() +
+                             "\" are unknown, it is neither a module of the netlist nor an internal cell of Yosys");
+}
+
+QJsonValue RtlilReader::writeBits(const std::vector<int64_t>& bits, BitsScanner* bitsScanner)
+{
+    if(bitsScanner != nullptr)
+    {
+        return static_cast<qint64>(bitsScanner->addBits(bits));
+    }
+
+    QJsonArray bitArray;
+
+    for(const auto bit : bits)
+    {
+        switch(bit)
+        {
+        case BitsScanner::constZero:
+            bitArray.append("0");
+            break;
+        case BitsScanner::constOne:
+            bitArray.append("1");
+            break;
+        case BitsScanner::constX:
+            bitArray.append("x");
+            break;
+        case BitsScanner::constZ:
+            bitArray.append("z");
+            break;
+        default:
+            bitArray.append(static_cast<qint64>(bit));
+            break;
+        }
+    }
+
+    return bitArray;
+}
+
+} // namespace OpenNetlistView::Yosys
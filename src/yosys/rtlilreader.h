@@ -0,0 +1,227 @@
+/**
+ * @file rtlilreader.h
+ * @brief Header file for the RtlilReader class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the RtlilReader class, which reads netlists
+ * in the RTLIL text format written by the write_rtlil command of Yosys and converts
+ * them into the structure of a Yosys JSON netlist, so they are parsed into the same
+ * diagram by the Parser.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __RTLILREADER_H__
+#define __RTLILREADER_H__
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QHash>
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class BitsScanner;
+
+/**
+ * @class RtlilReader
+ * @brief Reads RTLIL netlists into the structure of a Yosys JSON netlist.
+ *
+ * RTLIL stores buses as slices and concatenations of wires, so a netlist is a
+ * fraction of the size of the JSON netlist of the same design. The reader walks
+ * over the lines of the file once to find the modules and reads the modules in
+ * parallel on the task scheduler. Every module resolves the connections between its
+ * wires and the constants to the bit ids that Yosys writes into the JSON netlist.
+ *
+ * The ports, cells and netnames are created like write_json creates them, so the
+ * Parser handles the constants, splits and joins of the netlist like the ones of
+ * a JSON file. The direction of the cell ports is taken from the module of the
+ * cell type if it is part of the netlist, otherwise from the ports of the internal
+ * cells of Yosys. A cell of any other type can not be read, because RTLIL does not
+ * store the directions of its ports.
+ */
+class RtlilReader
+{
+public:
+    constexpr const static char* fileSuffix{"il"}; ///< The suffix of RTLIL files.
+
+    /**
+     * @brief Checks if data is an RTLIL netlist
+     *
+     * @param data The content of the file.
+     * @return true if the first statement of the data is an RTLIL statement
+     */
+    static bool isRtlil(const QByteArray& data);
+
+    /**
+     * @brief Reads an RTLIL netlist
+     *
+     * If a bits scanner is given the bits are stored in it and the returned object
+     * contains the index of the bits instead of the bit arrays.
+     *
+     * @param rtlilData The content of the RTLIL file.
+     * @param bitsScanner The bits scanner to store the bits in or nullptr.
+     * @throw std::runtime_error if the netlist can not be read
+     * @return QJsonObject The netlist in the structure of a Yosys JSON netlist.
+     */
+    static QJsonObject read(const QByteArray& rtlilData, BitsScanner* bitsScanner = nullptr);
+
+private:
+    constexpr const static size_t constantCount{4}; ///< The number of constant bits "0", "1", "x" and "z".
+
+    /**
+     * @struct Wire
+     * @brief The data of a wire of a module.
+     */
+    struct Wire
+    {
+        QString name;              ///< The name of the wire.
+        QString direction;         ///< The direction if the wire is a port, empty otherwise.
+        int offset = 0;            ///< The index of the first bit.
+        bool upto = false;         ///< If the bits are indexed from the most significant bit.
+        QJsonObject attributes;    ///< The attributes of the wire.
+        std::vector<int64_t> bits; ///< The bits of the wire, the least significant bit first.
+    };
+
+    /**
+     * @struct Cell
+     * @brief The data of a cell of a module.
+     */
+    struct Cell
+    {
+        QString name;                                                ///< The name of the cell.
+        QString type;                                                ///< The type of the cell.
+        QJsonObject parameters;                                      ///< The parameters of the cell.
+        QJsonObject attributes;                                      ///< The attributes of the cell.
+        std::vector<std::pair<QString, std::vector<int64_t>>> ports; ///< The connected bits of every port.
+    };
+
+    /**
+     * @struct ModuleData
+     * @brief The data of a module read from its part of the file.
+     */
+    struct ModuleData
+    {
+        QString name;            ///< The name of the module.
+        QJsonObject attributes;  ///< The attributes of the module.
+        std::vector<Wire> wires; ///< The wires of the module in the order of the file.
+        std::vector<Cell> cells; ///< The cells of the module in the order of the file.
+    };
+
+    QByteArrayView moduleText;          ///< The part of the file containing the module.
+    ModuleData moduleData;              ///< The data of the module that is read.
+    QHash<QByteArray, size_t> wireIdxs; ///< The index of every wire by its RTLIL name.
+    std::vector<size_t> bitParents;     ///< The union find parents of the constants and wire bits.
+
+    /**
+     * @brief Construct a new RtlilReader object for one module
+     *
+     * @param moduleText The part of the file containing the module and its attributes.
+     */
+    explicit RtlilReader(QByteArrayView moduleText);
+
+    /**
+     * @brief Reads the module
+     *
+     * @throw std::runtime_error if the module contains an invalid statement
+     */
+    void readModule();
+
+    /**
+     * @brief Reads a signal of a statement
+     *
+     * @param tokens The tokens of the statement.
+     * @param tokenIdx The index of the first token of the signal, moved behind the signal.
+     * @throw std::runtime_error if the signal is invalid
+     * @return std::vector<int64_t> The bits of the signal, the least significant bit first.
+     */
+    std::vector<int64_t> readSigSpec(const std::vector<QByteArrayView>& tokens, size_t& tokenIdx) const;
+
+    /**
+     * @brief Finds the representative of a bit
+     *
+     * @param bit The bit to find the representative of.
+     * @return size_t The representative, a constant if the bit is driven by one.
+     */
+    size_t findBit(size_t bit);
+
+    /**
+     * @brief Connects two bits
+     *
+     * @param lhs The first bit.
+     * @param rhs The second bit.
+     */
+    void connectBits(size_t lhs, size_t rhs);
+
+    /**
+     * @brief Replaces the bits of the wires and cells with the bit ids of Yosys
+     *
+     */
+    void resolveBits();
+
+    /**
+     * @brief Splits a line into its tokens
+     *
+     * @param line The line to split.
+     * @return std::vector<QByteArrayView> The tokens, strings keep their quotes.
+     */
+    static std::vector<QByteArrayView> tokenize(QByteArrayView line);
+
+    /**
+     * @brief Converts an RTLIL identifier into the name used in Yosys JSON netlists
+     *
+     * @param id The identifier.
+     * @return QString The name of the identifier.
+     */
+    static QString unescapeId(QByteArrayView id);
+
+    /**
+     * @brief Converts the value of an attribute or parameter
+     *
+     * @param value The token of the value.
+     * @return QJsonValue The value, strings without quotes and escapes.
+     */
+    static QJsonValue readValue(QByteArrayView value);
+
+    /**
+     * @brief Reads a constant signal
+     *
+     * @param constant The token of the constant, a sized constant or an integer.
+     * @throw std::runtime_error if the constant is invalid
+     * @return std::vector<int64_t> The constant bits, the least significant bit first.
+     */
+    static std::vector<int64_t> readConstant(QByteArrayView constant);
+
+    /**
+     * @brief Gets the direction of a port of an internal cell of Yosys
+     *
+     * The output ports are looked up in a table of the word level and gate level
+     * cells of Yosys, all other ports of a known cell are inputs.
+     *
+     * @param cellType The type of the cell.
+     * @param portName The name of the port.
+     * @throw std::runtime_error if the type is not an internal cell of Yosys
+     * @return QString The direction of the port in the format of the JSON netlist.
+     */
+    static QString getInternalDirection(const QString& cellType, const QString& portName);
+
+    /**
+     * @brief Converts the bits into the value of a bits field
+     *
+     * @param bits The bit ids.
+     * @param bitsScanner The bits scanner to store the bits in or nullptr.
+     * @return QJsonValue The index of the bits in the scanner or the bit array.
+     */
+    static QJsonValue writeBits(const std::vector<int64_t>& bits, BitsScanner* bitsScanner);
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __RTLILREADER_H__
@@ -0,0 +1,650 @@
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <cstddef>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "path.h"
+
+#include "sheetpartitioner.h"
+
+namespace OpenNetlistView::Yosys {
+
+SheetPartitioner::SheetPartitioner(std::shared_ptr<Module> module)
+    : module(std::move(module))
+{
+}
+
+SheetPartitioner::~SheetPartitioner() = default;
+
+std::vector<std::shared_ptr<Module>> SheetPartitioner::partition(size_t maxSheetNodes)
+{
+    if(maxSheetNodes == 0)
+    {
+        throw std::runtime_error("A sheet must hold at least one cell");
+    }
+
+    cutNetCount = 0;
+    copiedPorts.clear();
+
+    if(module == nullptr)
+    {
+        return {};
+    }
+
+    buildHypergraph();
+
+    const size_t vertexCount = nodes.size();
+    const size_t sheetCount = std::max<size_t>(1, (vertexCount + maxSheetNodes - 1) / maxSheetNodes);
+
+    sheetOfVertex.assign(vertexCount, 0);
+    side.assign(vertexCount, 0);
+    activeMark.assign(vertexCount, 0);
+    activeBisection = 0;
+    netSideCounts.assign(paths.size(), {0, 0});
+
+    std::vector<size_t> vertices(vertexCount);
+    std::iota(vertices.begin(), vertices.end(), 0);
+
+    bisect(vertices, 0, sheetCount, maxSheetNodes);
+
+    std::vector<std::vector<size_t>> sheetVertices(sheetCount);
+
+    for(size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        sheetVertices[sheetOfVertex[vertex]].push_back(vertex);
+    }
+
+    // a path is copied to every sheet with one of its cells,
+    // paths without cells are kept on the first sheet
+    std::vector<std::vector<size_t>> sheetPaths(sheetCount);
+    std::vector<size_t> lastPathOfSheet(sheetCount, std::numeric_limits<size_t>::max());
+
+    for(size_t pathIdx = 0; pathIdx < paths.size(); pathIdx++)
+    {
+        size_t pathSheetCount = 0;
+
+        for(const size_t vertex : netVertices[pathIdx])
+        {
+            const size_t sheetIdx = sheetOfVertex[vertex];
+
+            if(lastPathOfSheet[sheetIdx] != pathIdx)
+            {
+                lastPathOfSheet[sheetIdx] = pathIdx;
+                sheetPaths[sheetIdx].push_back(pathIdx);
+                pathSheetCount++;
+            }
+        }
+
+        if(pathSheetCount == 0)
+        {
+            sheetPaths[0].push_back(pathIdx);
+        }
+        else if(pathSheetCount > 1)
+        {
+            cutNetCount++;
+        }
+    }
+
+    std::vector<std::shared_ptr<Module>> sheets;
+    sheets.reserve(sheetCount);
+
+    for(size_t sheetIdx = 0; sheetIdx < sheetCount; sheetIdx++)
+    {
+        sheets.push_back(buildSheet(sheetIdx, sheetCount, sheetVertices[sheetIdx], sheetPaths[sheetIdx]));
+    }
+
+    return sheets;
+}
+
+size_t SheetPartitioner::getCutNetCount() const
+{
+    return cutNetCount;
+}
+
+QString SheetPartitioner::generateSheetType(const QString& moduleType, size_t sheetIdx, size_t sheetCount)
+{
+    return QString("%1 (sheet %2/%3)").arg(moduleType, QString::number(sheetIdx + 1), QString::number(sheetCount));
+}
+
+void SheetPartitioner::buildHypergraph()
+{
+    nodes = *module->getNodes();
+    paths = *module->getPaths();
+
+    vertexByNode.clear();
+
+    for(size_t vertex = 0; vertex < nodes.size(); vertex++)
+    {
+        vertexByNode[nodes[vertex].get()] = vertex;
+    }
+
+    netVertices.assign(paths.size(), {});
+    vertexNets.assign(nodes.size(), {});
+
+    std::vector<size_t> lastPathOfVertex(nodes.size(), std::numeric_limits<size_t>::max());
+
+    for(size_t pathIdx = 0; pathIdx < paths.size(); pathIdx++)
+    {
+        const auto& path = paths[pathIdx];
+        auto& vertices = netVertices[pathIdx];
+
+        auto addPort = [this, pathIdx, &vertices, &lastPathOfVertex](const std::shared_ptr<Port>& port) {
+            if(port == nullptr || port->getParentNode() == nullptr)
+            {
+                return;
+            }
+
+            auto vertexIt = vertexByNode.find(port->getParentNode().get());
+
+            // a cell is counted once even if several of its ports use the path
+            if(vertexIt != vertexByNode.end() && lastPathOfVertex[vertexIt->second] != pathIdx)
+            {
+                lastPathOfVertex[vertexIt->second] = pathIdx;
+                vertices.push_back(vertexIt->second);
+            }
+        };
+
+        addPort(path->getSigSource());
+
+        for(const auto& destination : *path->getSigDestinations())
+        {
+            addPort(destination);
+        }
+
+        // a path within one cell can never be cut
+        if(vertices.size() > 1)
+        {
+            for(const size_t vertex : vertices)
+            {
+                vertexNets[vertex].push_back(pathIdx);
+            }
+        }
+    }
+}
+
+void SheetPartitioner::bisect(const std::vector<size_t>& vertices, size_t firstSheet, size_t sheetCount, size_t maxSheetNodes)
+{
+    if(sheetCount <= 1)
+    {
+        for(const size_t vertex : vertices)
+        {
+            sheetOfVertex[vertex] = firstSheet;
+        }
+
+        return;
+    }
+
+    // the sides get cells in the ratio of their sheets
+    const size_t leftSheets = sheetCount / 2;
+    const size_t rightSheets = sheetCount - leftSheets;
+    const size_t vertexCount = vertices.size();
+    const size_t leftTarget = vertexCount * leftSheets / sheetCount;
+    const size_t slack = std::max<size_t>(1, leftTarget * balanceTolerancePct / 100);
+
+    const size_t minLeft = std::max(vertexCount - std::min(vertexCount, rightSheets * maxSheetNodes), leftTarget - std::min(leftTarget, slack));
+    const size_t maxLeft = std::min(leftSheets * maxSheetNodes, leftTarget + slack);
+
+    activeBisection++;
+
+    for(const size_t vertex : vertices)
+    {
+        activeMark[vertex] = activeBisection;
+    }
+
+    const auto order = orderVertices(vertices);
+
+    for(size_t orderIdx = 0; orderIdx < order.size(); orderIdx++)
+    {
+        side[order[orderIdx]] = orderIdx < leftTarget ? 0 : 1;
+    }
+
+    refine(vertices, minLeft, maxLeft);
+
+    std::vector<size_t> leftVertices;
+    std::vector<size_t> rightVertices;
+
+    for(const size_t vertex : vertices)
+    {
+        (side[vertex] == 0 ? leftVertices : rightVertices).push_back(vertex);
+    }
+
+    bisect(leftVertices, firstSheet, leftSheets, maxSheetNodes);
+    bisect(rightVertices, firstSheet + leftSheets, rightSheets, maxSheetNodes);
+}
+
+std::vector<size_t> SheetPartitioner::orderVertices(const std::vector<size_t>& vertices) const
+{
+    std::vector<bool> visited(nodes.size(), false);
+
+    if(vertices.empty())
+    {
+        return {};
+    }
+
+    // the cell found last from any cell is far away from the others
+    std::vector<size_t> probe;
+    visitVertices(vertices.front(), visited, probe);
+
+    const size_t start = probe.back();
+
+    for(const size_t vertex : probe)
+    {
+        visited[vertex] = false;
+    }
+
+    std::vector<size_t> order;
+    order.reserve(vertices.size());
+
+    visitVertices(start, visited, order);
+
+    // the unconnected parts follow each other
+    for(const size_t vertex : vertices)
+    {
+        if(!visited[vertex])
+        {
+            visitVertices(vertex, visited, order);
+        }
+    }
+
+    return order;
+}
+
+void SheetPartitioner::visitVertices(size_t start, std::vector<bool>& visited, std::vector<size_t>& order) const
+{
+    size_t queueIdx = order.size();
+
+    visited[start] = true;
+    order.push_back(start);
+
+    // the order itself is the queue of the search
+    while(queueIdx < order.size())
+    {
+        const size_t vertex = order[queueIdx++];
+
+        for(const size_t netIdx : vertexNets[vertex])
+        {
+            const auto& vertices = netVertices[netIdx];
+
+            if(vertices.size() > maxRefinedNetPins)
+            {
+                continue;
+            }
+
+            for(const size_t neighbour : vertices)
+            {
+                if(activeMark[neighbour] == activeBisection && !visited[neighbour])
+                {
+                    visited[neighbour] = true;
+                    order.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+void SheetPartitioner::refine(const std::vector<size_t>& vertices, size_t minLeft, size_t maxLeft)
+{
+    size_t leftCount = std::count_if(vertices.begin(), vertices.end(), [this](size_t vertex) { return side[vertex] == 0; });
+
+    std::vector<int> gains(nodes.size(), 0);
+    std::vector<bool> locked(nodes.size(), false);
+
+    for(size_t pass = 0; pass < refinementPasses; pass++)
+    {
+        // only the cells of the bisection are counted, the nets
+        // to other cells were cut by an earlier bisection
+        for(const size_t vertex : vertices)
+        {
+            for(const size_t netIdx : vertexNets[vertex])
+            {
+                netSideCounts[netIdx] = {0, 0};
+            }
+        }
+
+        for(const size_t vertex : vertices)
+        {
+            for(const size_t netIdx : vertexNets[vertex])
+            {
+                netSideCounts[netIdx][side[vertex]]++;
+            }
+        }
+
+        // the cells that can be moved by gain for both sides
+        std::array<std::set<std::pair<int, size_t>>, 2> candidates;
+
+        for(const size_t vertex : vertices)
+        {
+            gains[vertex] = computeGain(vertex);
+            locked[vertex] = false;
+            candidates[side[vertex]].emplace(gains[vertex], vertex);
+        }
+
+        std::vector<size_t> moves;
+        int totalGain = 0;
+        int bestGain = 0;
+        size_t bestMoveCount = 0;
+
+        while(true)
+        {
+            const bool leftCanShrink = leftCount > minLeft && !candidates[0].empty();
+            const bool rightCanShrink = leftCount < maxLeft && !candidates[1].empty();
+
+            if(!leftCanShrink && !rightCanShrink)
+            {
+                break;
+            }
+
+            // the best move, on equal gains the larger side gives a cell
+            size_t fromSide = leftCanShrink ? 0 : 1;
+
+            if(leftCanShrink && rightCanShrink)
+            {
+                const int leftGain = candidates[0].rbegin()->first;
+                const int rightGain = candidates[1].rbegin()->first;
+
+                if(rightGain > leftGain || (rightGain == leftGain && vertices.size() - leftCount > leftCount))
+                {
+                    fromSide = 1;
+                }
+            }
+
+            const auto candidateIt = std::prev(candidates[fromSide].end());
+            const size_t vertex = candidateIt->second;
+
+            totalGain += candidateIt->first;
+            candidates[fromSide].erase(candidateIt);
+            locked[vertex] = true;
+
+            for(const size_t netIdx : vertexNets[vertex])
+            {
+                netSideCounts[netIdx][fromSide]--;
+                netSideCounts[netIdx][1 - fromSide]++;
+            }
+
+            side[vertex] = static_cast<unsigned char>(1 - fromSide);
+            leftCount = fromSide == 0 ? leftCount - 1 : leftCount + 1;
+            moves.push_back(vertex);
+
+            if(totalGain > bestGain)
+            {
+                bestGain = totalGain;
+                bestMoveCount = moves.size();
+            }
+            else if(moves.size() - bestMoveCount >= fruitlessMoves)
+            {
+                break;
+            }
+
+            // only the cells sharing a net with the moved one change their gain
+            for(const size_t netIdx : vertexNets[vertex])
+            {
+                if(netVertices[netIdx].size() > maxRefinedNetPins)
+                {
+                    continue;
+                }
+
+                for(const size_t neighbour : netVertices[netIdx])
+                {
+                    if(activeMark[neighbour] != activeBisection || locked[neighbour])
+                    {
+                        continue;
+                    }
+
+                    const int gain = computeGain(neighbour);
+
+                    if(gain != gains[neighbour])
+                    {
+                        candidates[side[neighbour]].erase({gains[neighbour], neighbour});
+                        gains[neighbour] = gain;
+                        candidates[side[neighbour]].emplace(gain, neighbour);
+                    }
+                }
+            }
+        }
+
+        // the moves after the best cut are taken back
+        for(size_t moveIdx = moves.size(); moveIdx > bestMoveCount; moveIdx--)
+        {
+            const size_t vertex = moves[moveIdx - 1];
+
+            side[vertex] = static_cast<unsigned char>(1 - side[vertex]);
+            leftCount = side[vertex] == 0 ? leftCount + 1 : leftCount - 1;
+        }
+
+        if(bestGain <= 0)
+        {
+            break;
+        }
+    }
+}
+
+int SheetPartitioner::computeGain(size_t vertex) const
+{
+    const size_t fromSide = side[vertex];
+    int gain = 0;
+
+    for(const size_t netIdx : vertexNets[vertex])
+    {
+        if(netVertices[netIdx].size() > maxRefinedNetPins)
+        {
+            continue;
+        }
+
+        // the net is no longer cut if the cell is the last one on its side
+        if(netSideCounts[netIdx][fromSide] == 1)
+        {
+            gain++;
+        }
+
+        // the net is newly cut if no cell is on the other side
+        if(netSideCounts[netIdx][1 - fromSide] == 0)
+        {
+            gain--;
+        }
+    }
+
+    return gain;
+}
+
+std::shared_ptr<Module> SheetPartitioner::buildSheet(size_t sheetIdx, size_t sheetCount, const std::vector<size_t>& sheetVertices, const std::vector<size_t>& sheetPaths)
+{
+    copiedPorts.clear();
+
+    auto sheetModule = std::make_shared<Module>(generateSheetType(module->getType(), sheetIdx, sheetCount));
+    const auto subModules = module->getSubModules();
+
+    // copy the cells with new ports
+    for(const size_t vertex : sheetVertices)
+    {
+        const auto& node = nodes[vertex];
+        std::vector<std::shared_ptr<Port>> ports;
+
+        for(const auto& port : node->getPorts())
+        {
+            auto portCopy = std::make_shared<Port>(port->getName(), port->getDirection(), port->getBits());
+            portCopy->setSymbolNameAlias(port->getSymbolNameAlias());
+
+            copiedPorts[port.get()] = portCopy;
+            ports.push_back(portCopy);
+        }
+
+        auto nodeCopy = std::make_shared<Node>(node->getName(), node->getType(), ports);
+        nodeCopy->setFoldedNames(node->getFoldedNames());
+
+        for(const auto& portCopy : ports)
+        {
+            portCopy->setParentNode(nodeCopy);
+        }
+
+        sheetModule->addNode(nodeCopy);
+
+        auto subModuleIt = subModules.find(node->getName());
+
+        if(subModuleIt != subModules.end())
+        {
+            sheetModule->addSubModule(subModuleIt->first, subModuleIt->second);
+        }
+    }
+
+    for(const size_t pathIdx : sheetPaths)
+    {
+        const auto& path = paths[pathIdx];
+
+        auto pathCopy = std::make_shared<Path>(path->getName(), path->getBits(), path->isNameHidden());
+
+        for(const auto& alternativeName : path->getAlternativeNames())
+        {
+            pathCopy->addAlternativeName(*alternativeName);
+        }
+
+        const auto source = path->getSigSource();
+        const int sourceSheet = getPortSheet(source);
+        std::shared_ptr<Port> sourceCopy;
+
+        if(source != nullptr && sourceSheet == static_cast<int>(sheetIdx))
+        {
+            sourceCopy = copiedPorts[source.get()];
+        }
+        else if(source != nullptr && source->getParentNode() == nullptr)
+        {
+            sourceCopy = copyModulePort(source, sheetModule);
+        }
+
+        // a net driven on another sheet enters through an input connector
+        if(sourceCopy == nullptr)
+        {
+            sourceCopy = std::make_shared<Port>(path->getName(), Port::EDirection::INPUT, path->getBits());
+            sheetModule->addPort(sourceCopy);
+        }
+
+        pathCopy->setSigSource(sourceCopy);
+        sourceCopy->setPath(pathCopy);
+
+        // the ports of the module driven by the path are placed on the sheet of its driver
+        size_t homeSheet = sourceSheet >= 0 ? static_cast<size_t>(sourceSheet) : sheetCount;
+
+        if(sourceSheet < 0)
+        {
+            for(const size_t vertex : netVertices[pathIdx])
+            {
+                homeSheet = std::min(homeSheet, sheetOfVertex[vertex]);
+            }
+
+            if(homeSheet == sheetCount)
+            {
+                homeSheet = 0;
+            }
+        }
+
+        bool leavesSheet = false;
+        bool drivesNamedPort = false;
+
+        for(const auto& destination : *path->getSigDestinations())
+        {
+            const int destinationSheet = getPortSheet(destination);
+            std::shared_ptr<Port> destinationCopy;
+
+            if(destinationSheet == static_cast<int>(sheetIdx))
+            {
+                destinationCopy = copiedPorts[destination.get()];
+            }
+            else if(destinationSheet < 0 && homeSheet == sheetIdx)
+            {
+                destinationCopy = copyModulePort(destination, sheetModule);
+                drivesNamedPort = drivesNamedPort || destination->getName() == path->getName();
+            }
+            else
+            {
+                leavesSheet = leavesSheet || destinationSheet >= 0;
+                continue;
+            }
+
+            pathCopy->addSigDestination(destinationCopy);
+            destinationCopy->setPath(pathCopy);
+        }
+
+        // the sheet of the driver passes the net on through an output connector,
+        // a port of the module with the name of the net already leads to it
+        if(leavesSheet && sourceSheet == static_cast<int>(sheetIdx) && !drivesNamedPort)
+        {
+            auto outputPort = std::make_shared<Port>(path->getName(), Port::EDirection::OUTPUT, path->getBits());
+            sheetModule->addPort(outputPort);
+
+            pathCopy->addSigDestination(outputPort);
+            outputPort->setPath(pathCopy);
+        }
+
+        sheetModule->addPath(pathCopy);
+    }
+
+    // unconnected ports of the module are kept on the first sheet
+    if(sheetIdx == 0)
+    {
+        const auto ports = module->getPorts();
+
+        for(const auto& port : *ports)
+        {
+            if(port->getPath() == nullptr)
+            {
+                copyModulePort(port, sheetModule);
+            }
+        }
+    }
+
+    return sheetModule;
+}
+
+std::shared_ptr<Port> SheetPartitioner::copyModulePort(const std::shared_ptr<Port>& port, const std::shared_ptr<Module>& sheetModule)
+{
+    auto copiedIt = copiedPorts.find(port.get());
+
+    if(copiedIt != copiedPorts.end())
+    {
+        return copiedIt->second;
+    }
+
+    auto portCopy = std::make_shared<Port>(port->getName(), port->getDirection(), port->getBits());
+
+    if(port->getDirection() == Port::EDirection::CONST)
+    {
+        portCopy->setConstPortValue(port->getConstPortValue());
+    }
+
+    copiedPorts[port.get()] = portCopy;
+    sheetModule->addPort(portCopy);
+
+    return portCopy;
+}
+
+int SheetPartitioner::getPortSheet(const std::shared_ptr<Port>& port) const
+{
+    if(port == nullptr || port->getParentNode() == nullptr)
+    {
+        return -1;
+    }
+
+    auto vertexIt = vertexByNode.find(port->getParentNode().get());
+
+    if(vertexIt == vertexByNode.end())
+    {
+        return -1;
+    }
+
+    return static_cast<int>(sheetOfVertex[vertexIt->second]);
+}
+
+} // namespace OpenNetlistView::Yosys
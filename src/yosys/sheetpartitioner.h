@@ -0,0 +1,198 @@
+/**
+ * @file sheetpartitioner.h
+ * @brief Header file for the SheetPartitioner class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the SheetPartitioner class, which splits
+ * a large module into sheets of bounded size that are connected by named off-sheet
+ * connector ports, so every sheet can be routed and shown on its own.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __SHEETPARTITIONER_H__
+#define __SHEETPARTITIONER_H__
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <array>
+#include <cstddef>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+class Node;
+class Port;
+class Path;
+
+/**
+ * @class SheetPartitioner
+ * @brief Partitions the cells of a module into sheets with few nets between them.
+ *
+ * The cells are the vertices and the paths the nets of a hypergraph. The graph is
+ * split by recursive bisection, every bisection starts with the cells in breadth
+ * first order from a peripheral cell and is improved with Fiduccia-Mattheyses
+ * passes that move single cells to lower the number of cut nets while keeping the
+ * sides within the size of their sheets. Nets with many pins, like clocks and
+ * resets, are cut anyway and are left out of the refinement.
+ *
+ * Every sheet is a new module with copies of its cells. A net that crosses sheets
+ * is connected to an output connector on the sheet of its driver and an input
+ * connector on every other sheet using it. Both are module ports named like the
+ * net, so the sheets of a net can be found by the name of the port. Ports of the
+ * original module are copied into every sheet using their net.
+ */
+class SheetPartitioner
+{
+public:
+    constexpr const static size_t defaultSheetSize{100};   ///< The default maximum number of cells on a sheet.
+    constexpr const static size_t refinementPasses{8};     ///< The maximum number of refinement passes of a bisection.
+    constexpr const static size_t fruitlessMoves{256};     ///< The moves after the best cut before a pass is stopped.
+    constexpr const static size_t maxRefinedNetPins{64};   ///< The maximum number of cells of a net considered by the refinement.
+    constexpr const static size_t balanceTolerancePct{10}; ///< The allowed difference of a side from its share in percent.
+
+    /**
+     * @brief Construct a new SheetPartitioner object
+     *
+     * @param module The module to split into sheets.
+     */
+    explicit SheetPartitioner(std::shared_ptr<Module> module);
+
+    /**
+     * @brief Destroy the SheetPartitioner object
+     *
+     */
+    ~SheetPartitioner();
+
+    /**
+     * @brief Splits the module into sheets
+     *
+     * The number of sheets is the smallest one that holds all cells, a module
+     * that fits on one sheet is copied into a single sheet.
+     *
+     * @param maxSheetNodes The maximum number of cells on a sheet.
+     * @throw std::runtime_error if the maximum number of cells is zero
+     * @return std::vector<std::shared_ptr<Module>> The modules of the sheets in order.
+     */
+    std::vector<std::shared_ptr<Module>> partition(size_t maxSheetNodes = defaultSheetSize);
+
+    /**
+     * @brief Get the number of nets connected to cells on more than one sheet
+     *
+     * @return size_t The number of cut nets of the last partition.
+     */
+    size_t getCutNetCount() const;
+
+    /**
+     * @brief Generates the type of the module of a sheet
+     *
+     * @param moduleType The type of the original module.
+     * @param sheetIdx The index of the sheet starting at zero.
+     * @param sheetCount The number of sheets.
+     * @return QString The type of the module of the sheet.
+     */
+    static QString generateSheetType(const QString& moduleType, size_t sheetIdx, size_t sheetCount);
+
+private:
+    /**
+     * @brief Collects the cells and the nets connecting them
+     *
+     */
+    void buildHypergraph();
+
+    /**
+     * @brief Splits cells into a number of sheets
+     *
+     * @param vertices The cells to split.
+     * @param firstSheet The index of the first sheet of the cells.
+     * @param sheetCount The number of sheets to split the cells into.
+     * @param maxSheetNodes The maximum number of cells on a sheet.
+     */
+    void bisect(const std::vector<size_t>& vertices, size_t firstSheet, size_t sheetCount, size_t maxSheetNodes);
+
+    /**
+     * @brief Orders cells by a breadth first search from a peripheral cell
+     *
+     * Connected cells end up next to each other, so cutting the order in two
+     * is a good start for the refinement.
+     *
+     * @param vertices The cells to order, all of them must be active.
+     * @return std::vector<size_t> The cells in breadth first order.
+     */
+    std::vector<size_t> orderVertices(const std::vector<size_t>& vertices) const;
+
+    /**
+     * @brief Visits the active cells in breadth first order
+     *
+     * @param start The cell to start at.
+     * @param visited The cells that were visited before.
+     * @param order The visited cells are appended to the order.
+     */
+    void visitVertices(size_t start, std::vector<bool>& visited, std::vector<size_t>& order) const;
+
+    /**
+     * @brief Moves cells between the sides of a bisection to lower the number of cut nets
+     *
+     * @param vertices The cells of the bisection, all of them must be active.
+     * @param minLeft The minimum number of cells on the left side.
+     * @param maxLeft The maximum number of cells on the left side.
+     */
+    void refine(const std::vector<size_t>& vertices, size_t minLeft, size_t maxLeft);
+
+    /**
+     * @brief Computes the decrease of the cut nets if a cell changes its side
+     *
+     * @param vertex The cell to move.
+     * @return int The number of nets that are no longer cut minus the newly cut ones.
+     */
+    int computeGain(size_t vertex) const;
+
+    /**
+     * @brief Copies the cells of a sheet and their nets into a new module
+     *
+     * @param sheetIdx The index of the sheet.
+     * @param sheetCount The number of sheets.
+     * @param sheetVertices The cells on the sheet.
+     * @param sheetPaths The indexes of the paths on the sheet.
+     * @return std::shared_ptr<Module> The module of the sheet.
+     */
+    std::shared_ptr<Module> buildSheet(size_t sheetIdx, size_t sheetCount, const std::vector<size_t>& sheetVertices, const std::vector<size_t>& sheetPaths);
+
+    /**
+     * @brief Copies a port of the original module into the module of a sheet
+     *
+     * @param port The port of the original module.
+     * @param sheetModule The module of the sheet.
+     * @return std::shared_ptr<Port> The copied port.
+     */
+    std::shared_ptr<Port> copyModulePort(const std::shared_ptr<Port>& port, const std::shared_ptr<Module>& sheetModule);
+
+    /**
+     * @brief Get the sheet of the cell a port belongs to
+     *
+     * @param port The port to check.
+     * @return int The sheet of the parent cell or -1 if the port is a module port.
+     */
+    int getPortSheet(const std::shared_ptr<Port>& port) const;
+
+    std::shared_ptr<Module> module;                    ///< The module that is split.
+    std::vector<std::shared_ptr<Node>> nodes;          ///< The cells of the module, the vertices of the hypergraph.
+    std::vector<std::shared_ptr<Path>> paths;          ///< The paths of the module.
+    std::map<Node*, size_t> vertexByNode;              ///< The vertex of every cell.
+    std::vector<std::vector<size_t>> netVertices;      ///< The distinct cells of every path.
+    std::vector<std::vector<size_t>> vertexNets;       ///< The paths with two or more cells of every cell.
+    std::vector<size_t> sheetOfVertex;                 ///< The sheet every cell is placed on.
+    std::vector<unsigned char> side;                   ///< The side of every cell in the current bisection.
+    std::vector<size_t> activeMark;                    ///< The bisection every cell took part in last.
+    size_t activeBisection = 0;                        ///< The number of the current bisection.
+    std::vector<std::array<size_t, 2>> netSideCounts;  ///< The number of cells of every net on both sides.
+    std::map<Port*, std::shared_ptr<Port>> copiedPorts; ///< The copies of the ports on the current sheet by original port.
+    size_t cutNetCount = 0;                            ///< The number of cut nets of the last partition.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __SHEETPARTITIONER_H__
@@ -0,0 +1,346 @@
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+
+#include "module.h"
+#include "node.h"
+#include "port.h"
+#include "netname.h"
+
+#include "slicefolder.h"
+
+namespace OpenNetlistView::Yosys {
+
+SliceFolder::SliceFolder(std::shared_ptr<Module> module)
+    : module(std::move(module))
+{
+}
+
+SliceFolder::~SliceFolder() = default;
+
+void SliceFolder::setCellParameters(std::map<QString, QString> cellParameters)
+{
+    this->cellParameters = std::move(cellParameters);
+}
+
+size_t SliceFolder::fold()
+{
+    if(module == nullptr)
+    {
+        return 0;
+    }
+
+    buildBusIndex();
+
+    // group the cells that could be slices of the same array
+    std::map<QString, std::vector<Slice>> slicesBySignature;
+    std::map<QString, size_t> anchorBySignature;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        const auto& ports = node->getPorts();
+
+        // the slices are ordered by the bits of their first output
+        auto anchorIt = std::find_if(ports.begin(), ports.end(), [](const std::shared_ptr<Port>& port) {
+            return port->getDirection() == Port::EDirection::OUTPUT;
+        });
+
+        if(anchorIt == ports.end())
+        {
+            continue;
+        }
+
+        const auto [busIdx, busPos] = findBusPosition((*anchorIt)->getBits());
+
+        if(busIdx < 0)
+        {
+            continue;
+        }
+
+        const QString signature = createSignature(node);
+
+        slicesBySignature[signature].push_back({node, busIdx, busPos});
+        anchorBySignature[signature] = static_cast<size_t>(std::distance(ports.begin(), anchorIt));
+    }
+
+    std::vector<std::shared_ptr<Node>> removedNodes;
+    size_t foldedNodes = 0;
+
+    for(auto& [signature, slices] : slicesBySignature)
+    {
+        if(slices.size() >= minSliceCount)
+        {
+            foldedNodes += foldSlices(slices, anchorBySignature[signature], removedNodes);
+        }
+    }
+
+    module->removeNodes(removedNodes);
+
+    return removedNodes.size() - foldedNodes;
+}
+
+void SliceFolder::buildBusIndex()
+{
+    buses.clear();
+    bitBuses.clear();
+
+    auto addBus = [this](const QStringList& bits) {
+        if(bits.size() < 2)
+        {
+            return;
+        }
+
+        const auto busIdx = static_cast<int64_t>(buses.size());
+        buses.push_back(bits);
+
+        for(qsizetype bitIdx = 0; bitIdx < bits.size(); bitIdx++)
+        {
+            if(!Port::isConstantBit(bits[bitIdx]))
+            {
+                bitBuses[bits[bitIdx]].emplace_back(busIdx, bitIdx);
+            }
+        }
+    };
+
+    const auto netnames = module->getNetnames();
+
+    for(const auto& netname : *netnames)
+    {
+        addBus(netname->getBits());
+    }
+
+    const auto ports = module->getPorts();
+
+    for(const auto& port : *ports)
+    {
+        addBus(port->getBits());
+    }
+}
+
+QString SliceFolder::createSignature(const std::shared_ptr<Node>& node) const
+{
+    QString signature = node->getType();
+
+    auto parameterIt = cellParameters.find(node->getName());
+
+    if(parameterIt != cellParameters.end())
+    {
+        signature += "\n" + parameterIt->second;
+    }
+
+    for(const auto& port : node->getPorts())
+    {
+        signature += "\n" + port->getName() + ":" + QString::number(static_cast<int>(port->getDirection())) + ":" +
+                     QString::number(port->getBits().size());
+    }
+
+    return signature;
+}
+
+std::pair<int64_t, int64_t> SliceFolder::findBusPosition(const QStringList& bits) const
+{
+    if(bits.isEmpty())
+    {
+        return {-1, -1};
+    }
+
+    auto candidatesIt = bitBuses.constFind(bits.front());
+
+    if(candidatesIt == bitBuses.constEnd())
+    {
+        return {-1, -1};
+    }
+
+    std::pair<int64_t, int64_t> bestPosition{-1, -1};
+    qsizetype bestWidth = 0;
+
+    for(const auto& [busIdx, busPos] : *candidatesIt)
+    {
+        const QStringList& busBits = buses[busIdx];
+
+        // a single slice must not be the whole bus
+        if(busBits.size() <= bits.size() || busBits.size() <= bestWidth ||
+            busPos + bits.size() > busBits.size())
+        {
+            continue;
+        }
+
+        if(std::equal(bits.begin(), bits.end(), busBits.begin() + busPos))
+        {
+            bestPosition = {busIdx, busPos};
+            bestWidth = busBits.size();
+        }
+    }
+
+    return bestPosition;
+}
+
+size_t SliceFolder::foldSlices(std::vector<Slice>& slices, size_t anchorIdx, std::vector<std::shared_ptr<Node>>& removedNodes)
+{
+    std::sort(slices.begin(), slices.end(), [](const Slice& sliceA, const Slice& sliceB) {
+        return std::tie(sliceA.busIdx, sliceA.busPos) < std::tie(sliceB.busIdx, sliceB.busPos);
+    });
+
+    const size_t portCount = slices.front().node->getPorts().size();
+    const auto anchorWidth = static_cast<int64_t>(slices.front().node->getPorts()[anchorIdx]->getBits().size());
+
+    size_t foldedNodes = 0;
+    std::vector<std::shared_ptr<Node>> run;
+    std::vector<bool> sharedPorts(portCount, false);
+    std::vector<std::set<QString>> runBits(portCount);
+
+    auto finishRun = [&]() {
+        if(run.size() >= minSliceCount)
+        {
+            addFoldedNode(run, sharedPorts);
+            removedNodes.insert(removedNodes.end(), run.begin(), run.end());
+            foldedNodes++;
+        }
+
+        run.clear();
+        std::fill(sharedPorts.begin(), sharedPorts.end(), false);
+
+        for(auto& bits : runBits)
+        {
+            bits.clear();
+        }
+    };
+
+    // checks if every port of a node is shared with or disjoint to the run
+    auto fitsRun = [&](const std::shared_ptr<Node>& node) {
+        const auto& firstPorts = run.front()->getPorts();
+        const auto& ports = node->getPorts();
+
+        for(size_t portIdx = 0; portIdx < portCount; portIdx++)
+        {
+            const QStringList bits = ports[portIdx]->getBits();
+            const bool sameBits = bits == firstPorts[portIdx]->getBits();
+            const bool disjointBits = std::none_of(bits.begin(), bits.end(), [&runBits, portIdx](const QString& bit) {
+                return runBits[portIdx].count(bit) != 0;
+            });
+
+            // the second slice decides which ports are shared
+            if(run.size() == 1 && portIdx != anchorIdx)
+            {
+                if(!sameBits && !disjointBits)
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if(sharedPorts[portIdx] ? !sameBits : !disjointBits)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto addToRun = [&](const std::shared_ptr<Node>& node) {
+        const auto& ports = node->getPorts();
+
+        if(run.size() == 1)
+        {
+            const auto& firstPorts = run.front()->getPorts();
+
+            for(size_t portIdx = 0; portIdx < portCount; portIdx++)
+            {
+                sharedPorts[portIdx] = portIdx != anchorIdx && ports[portIdx]->getBits() == firstPorts[portIdx]->getBits();
+            }
+        }
+
+        for(size_t portIdx = 0; portIdx < portCount; portIdx++)
+        {
+            for(const auto& bit : ports[portIdx]->getBits())
+            {
+                if(!Port::isConstantBit(bit))
+                {
+                    runBits[portIdx].insert(bit);
+                }
+            }
+        }
+
+        run.push_back(node);
+    };
+
+    const Slice* previous = nullptr;
+
+    for(const auto& slice : slices)
+    {
+        const bool consecutive = previous != nullptr && slice.busIdx == previous->busIdx &&
+                                 slice.busPos == previous->busPos + anchorWidth;
+
+        if(!run.empty() && (!consecutive || !fitsRun(slice.node)))
+        {
+            finishRun();
+        }
+
+        addToRun(slice.node);
+        previous = &slice;
+    }
+
+    finishRun();
+
+    return foldedNodes;
+}
+
+void SliceFolder::addFoldedNode(const std::vector<std::shared_ptr<Node>>& run, const std::vector<bool>& sharedPorts)
+{
+    const auto& firstPorts = run.front()->getPorts();
+    std::vector<std::shared_ptr<Port>> ports;
+
+    for(size_t portIdx = 0; portIdx < firstPorts.size(); portIdx++)
+    {
+        QStringList bits;
+
+        // the per slice bits are concatenated in bus order
+        if(sharedPorts[portIdx])
+        {
+            bits = firstPorts[portIdx]->getBits();
+        }
+        else
+        {
+            for(const auto& node : run)
+            {
+                bits.append(node->getPorts()[portIdx]->getBits());
+            }
+        }
+
+        auto port = std::make_shared<Port>(firstPorts[portIdx]->getName(), firstPorts[portIdx]->getDirection(), bits);
+        port->setSymbolNameAlias(firstPorts[portIdx]->getSymbolNameAlias());
+        ports.push_back(port);
+    }
+
+    QStringList foldedNames;
+
+    for(const auto& node : run)
+    {
+        foldedNames.append(node->getName());
+    }
+
+    auto foldedNode = std::make_shared<Node>(run.front()->getName(), run.front()->getType(), ports);
+    foldedNode->setFoldedNames(foldedNames);
+
+    for(const auto& port : ports)
+    {
+        port->setParentNode(foldedNode);
+    }
+
+    module->addNode(foldedNode);
+}
+
+} // namespace OpenNetlistView::Yosys
@@ -0,0 +1,140 @@
+/**
+ * @file slicefolder.h
+ * @brief Header file for the SliceFolder class in the OpenNetlistView::Yosys namespace.
+ *
+ * This file contains the declaration of the SliceFolder class, which merges
+ * replicated single bit cells of tech-mapped netlists into one arrayed node
+ * with bus ports.
+ *
+ * @author Lukas Bauer
+ */
+
+#ifndef __SLICEFOLDER_H__
+#define __SLICEFOLDER_H__
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+
+#include <memory>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+namespace OpenNetlistView::Yosys {
+
+// forward declaration
+class Module;
+class Node;
+
+/**
+ * @class SliceFolder
+ * @brief Folds structurally identical per-bit cells into arrayed nodes.
+ *
+ * Cells are slices of the same array if they have the same type, parameters and
+ * ports, their first output drives consecutive bits of the same bus and every
+ * other port is either connected to the same bits in all slices (like a clock or
+ * enable) or to different bits in every slice. The slices are replaced by one node
+ * whose per slice ports contain the bits of all slices in bus order.
+ *
+ * The folder works on the bits of the ports before the paths are created, so the
+ * connections of the folded nodes are built by the parser like the connections of
+ * any other multi bit cell.
+ */
+class SliceFolder
+{
+public:
+    constexpr const static size_t minSliceCount{2}; ///< The minimum number of slices that are folded.
+
+    /**
+     * @brief Construct a new SliceFolder object
+     *
+     * @param module The module to fold the cells of, the paths must not be created yet.
+     */
+    explicit SliceFolder(std::shared_ptr<Module> module);
+
+    /**
+     * @brief Destroy the SliceFolder object
+     *
+     */
+    ~SliceFolder();
+
+    /**
+     * @brief Set the parameters of the cells
+     *
+     * Cells are only folded if their parameters are equal. Cells
+     * without an entry are treated as cells without parameters.
+     *
+     * @param cellParameters The parameters of the cells as comparable string by cell name.
+     */
+    void setCellParameters(std::map<QString, QString> cellParameters);
+
+    /**
+     * @brief Folds the replicated cells of the module
+     *
+     * @return size_t The number of nodes removed from the module.
+     */
+    size_t fold();
+
+private:
+    /**
+     * @struct Slice
+     * @brief A cell that can be part of an array with the position of its output in a bus.
+     */
+    struct Slice
+    {
+        std::shared_ptr<Node> node; ///< The node of the cell.
+        int64_t busIdx;             ///< The index of the bus driven by the cell.
+        int64_t busPos;             ///< The position of the first output bit in the bus.
+    };
+
+    /**
+     * @brief Collects the multi bit netnames and ports of the module as buses
+     *
+     */
+    void buildBusIndex();
+
+    /**
+     * @brief Creates the key of a cell that is equal for all slices of an array
+     *
+     * @param node The node of the cell.
+     * @return QString The key containing the type, parameters and ports.
+     */
+    QString createSignature(const std::shared_ptr<Node>& node) const;
+
+    /**
+     * @brief Finds the widest bus containing the bits in order
+     *
+     * @param bits The bits to find.
+     * @return std::pair<int64_t, int64_t> The index of the bus and the position of the first bit or -1, -1.
+     */
+    std::pair<int64_t, int64_t> findBusPosition(const QStringList& bits) const;
+
+    /**
+     * @brief Folds the runs of consecutive slices of one signature
+     *
+     * @param slices The slices with the same signature.
+     * @param anchorIdx The index of the port the slices are ordered by.
+     * @param removedNodes The folded nodes that have to be removed from the module.
+     * @return size_t The number of arrayed nodes added to the module.
+     */
+    size_t foldSlices(std::vector<Slice>& slices, size_t anchorIdx, std::vector<std::shared_ptr<Node>>& removedNodes);
+
+    /**
+     * @brief Creates the arrayed node of a run of slices and adds it to the module
+     *
+     * @param run The nodes of the slices in bus order.
+     * @param sharedPorts Flag for every port if it is shared by all slices.
+     */
+    void addFoldedNode(const std::vector<std::shared_ptr<Node>>& run, const std::vector<bool>& sharedPorts);
+
+    std::shared_ptr<Module> module;                                    ///< The module to fold.
+    std::map<QString, QString> cellParameters;                         ///< The parameters of the cells by name.
+    std::vector<QStringList> buses;                                    ///< The bits of the multi bit signals of the module.
+    QHash<QString, std::vector<std::pair<int64_t, int64_t>>> bitBuses; ///< The buses and positions of every bit.
+};
+
+} // namespace OpenNetlistView::Yosys
+
+#endif // __SLICEFOLDER_H__
@@ -8,8 +8,40 @@
 #include <QtTest/QTest>
 #include <QString>
 #include <QDomElement>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRectF>
+#include <QLineF>
+#include <QPolygonF>
+
+#include <third_party/libavoid/libavoid.h>
+#include <third_party/libavoid/orthogonal.h>
+#include <third_party/libcola/cola.h>
+
+#include <memory>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
 
 #include <symbol/symbol_parser.h>
+#include <yosys/parser.h>
+#include <yosys/diagram.h>
+#include <yosys/module.h>
+#include <yosys/node.h>
+#include <yosys/path.h>
+#include <yosys/layoutbundle.h>
+#include <yosys/port.h>
+#include <routing/router.h>
+#include <routing/layout_metrics.h>
+#include <routing/grid_snapper.h>
+#include <scheduler/taskscheduler.h>
+#include <qnetlistgraphicspath.h>
+#include <qnetlistitemfactory.h>
 
 using namespace OpenNetlistView;
 
@@ -19,11 +51,24 @@ class tst_routing : public QObject
     Q_OBJECT
 
     static QDomElement loadSVG(const QString& filename);
+    static std::unique_ptr<Yosys::Diagram> loadDiagram(const QString& filename);
 
 private slots:
 
     void test_case1();
     void test_case2();
+    void test_case3();
+    void test_case4();
+    void test_case5();
+    void test_case6();
+    void test_case7();
+    void test_case8();
+    void test_case9();
+    void test_case10();
+    void test_case11();
+    void test_case12();
+    void test_case13();
+    void test_case14();
 };
 
 // helper that loads in symbol files
@@ -43,6 +88,22 @@ QDomElement tst_routing::loadSVG(const QString& filename)
     return symbolDom.documentElement();
 }
 
+// helper that parses a yosys netlist file
+std::unique_ptr<Yosys::Diagram> tst_routing::loadDiagram(const QString& filename)
+{
+
+    QString verifiedFilename = QFINDTESTDATA(filename);
+
+    QFile jsonFile = QFile(verifiedFilename);
+    jsonFile.open(QIODevice::ReadOnly | QIODevice::Text);
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(QJsonDocument::fromJson(jsonFile.readAll()).object());
+    parser.parse();
+
+    return parser.getDiagram();
+}
+
 // checks if a symbol file with an missing default type is rejected
 void tst_routing::test_case1()
 {
@@ -69,5 +130,876 @@ void tst_routing::test_case2()
     QVERIFY(symbols.find("MAdderCore") != symbols.end());
 }
 
+// checks if the routing run in steps gives the same layout as the blocking routing
+// and if a canceled routing can be routed again
+void tst_routing::test_case3()
+{
+    QDomElement symbolRoot = loadSVG("data/routing/test2.svg");
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolRoot);
+    symbolParser.parse();
+
+    auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+
+    const Routing::ColaRoutingParameters routingParameters{75.0, 75.0, 1E-4, 100, 10.0};
+
+    auto blockingDiagram = loadDiagram("data/yosys/test39.json");
+    auto steppedDiagram = loadDiagram("data/yosys/test39.json");
+    auto canceledDiagram = loadDiagram("data/yosys/test39.json");
+
+    auto blockingModule = blockingDiagram->getModuleByName("m_byteselector");
+    auto steppedModule = steppedDiagram->getModuleByName("m_byteselector");
+    auto canceledModule = canceledDiagram->getModuleByName("m_byteselector");
+
+    QVERIFY(blockingModule != nullptr && steppedModule != nullptr && canceledModule != nullptr);
+
+    Routing::Router blockingRouter;
+    blockingRouter.setRoutingParameters(routingParameters);
+    blockingRouter.setModule(blockingModule);
+    blockingRouter.setSymbols(symbols);
+    blockingRouter.runRouter();
+
+    QVERIFY(blockingModule->getIsRouted());
+
+    // route in steps and check the progress
+    Routing::Router steppedRouter;
+    steppedRouter.setRoutingParameters(routingParameters);
+    steppedRouter.setModule(steppedModule);
+    steppedRouter.setSymbols(symbols);
+
+    QVERIFY(steppedRouter.beginRouting());
+    QVERIFY(steppedRouter.isRouting());
+
+    int steps = 0;
+    bool progressValid = true;
+
+    while(!steppedRouter.runRoutingStep())
+    {
+        const double progress = steppedRouter.getRoutingProgress();
+        progressValid = progressValid && progress >= 0.0 && progress <= 1.0;
+        steps++;
+    }
+
+    QVERIFY(steps > 1);
+    QVERIFY(progressValid);
+    QVERIFY(!steppedRouter.isRouting());
+    QVERIFY(steppedModule->getIsRouted());
+    QVERIFY(steppedRouter.getRoutingProgress() == 1.0);
+
+    // an already routed module is not routed again
+    QVERIFY(!steppedRouter.beginRouting());
+
+    // cancel a routing and route the module again
+    Routing::Router canceledRouter;
+    canceledRouter.setRoutingParameters(routingParameters);
+    canceledRouter.setModule(canceledModule);
+    canceledRouter.setSymbols(symbols);
+
+    QVERIFY(canceledRouter.beginRouting());
+    canceledRouter.runRoutingStep();
+    canceledRouter.runRoutingStep();
+    canceledRouter.cancelRouting();
+
+    QVERIFY(!canceledRouter.isRouting());
+    QVERIFY(!canceledModule->getIsRouted());
+
+    canceledRouter.runRouter();
+    QVERIFY(canceledModule->getIsRouted());
+
+    // all routings have to result in the same layout
+    const auto blockingNodes = blockingModule->getNodes();
+    const auto steppedNodes = steppedModule->getNodes();
+    const auto canceledNodes = canceledModule->getNodes();
+
+    QVERIFY(blockingNodes->size() == steppedNodes->size());
+    QVERIFY(blockingNodes->size() == canceledNodes->size());
+
+    for(size_t nodeIdx = 0; nodeIdx < blockingNodes->size(); nodeIdx++)
+    {
+        QVERIFY(blockingNodes->at(nodeIdx)->getRoutedRect() == steppedNodes->at(nodeIdx)->getRoutedRect());
+        QVERIFY(blockingNodes->at(nodeIdx)->getRoutedRect() == canceledNodes->at(nodeIdx)->getRoutedRect());
+    }
+}
+
+// checks if a module of a layout bundle is displayed with the routed layout
+// without running the router
+void tst_routing::test_case4()
+{
+    QDomElement symbolRoot = loadSVG("data/routing/test2.svg");
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolRoot);
+    symbolParser.parse();
+
+    auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+
+    const Routing::ColaRoutingParameters routingParameters{75.0, 75.0, 1E-4, 100, 10.0};
+
+    QFile jsonFile = QFile(QFINDTESTDATA("data/yosys/test39.json"));
+    jsonFile.open(QIODevice::ReadOnly | QIODevice::Text);
+    const QJsonObject netlist = QJsonDocument::fromJson(jsonFile.readAll()).object();
+
+    auto routedDiagram = loadDiagram("data/yosys/test39.json");
+    auto routedModule = routedDiagram->getModuleByName("m_byteselector");
+
+    QVERIFY(routedModule != nullptr);
+
+    Routing::Router routedRouter;
+    routedRouter.setRoutingParameters(routingParameters);
+    routedRouter.setModule(routedModule);
+    routedRouter.setSymbols(symbols);
+    routedRouter.runRouter();
+
+    QVERIFY(routedModule->getIsRouted());
+
+    const QByteArray bundleData = Yosys::LayoutBundle::writeHeader(routedModule->getType(), 1, false) +
+                                  Yosys::LayoutBundle::writeNetlist(netlist) +
+                                  Yosys::LayoutBundle::writeModule(routedModule);
+
+    QVERIFY(Yosys::LayoutBundle::isLayoutBundle(bundleData));
+    QVERIFY(!Yosys::LayoutBundle::isLayoutBundle(QJsonDocument(netlist).toJson()));
+
+    // read the bundle into a freshly parsed diagram
+    Yosys::LayoutBundle bundle(bundleData);
+    bundle.readHeader();
+
+    QVERIFY(bundle.getModuleCount() == 1);
+    QVERIFY(!bundle.getFoldSlices());
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(bundle.getNetlist());
+    parser.parse();
+
+    auto loadedDiagram = parser.getDiagram();
+    bundle.setModules(*loadedDiagram->getModules());
+
+    auto loadedModule = bundle.readModule();
+
+    QVERIFY(loadedModule != nullptr);
+    QVERIFY(loadedModule->getType() == routedModule->getType());
+    QVERIFY(loadedModule->getLayoutLoaded());
+    QVERIFY(bundle.atEnd());
+
+    // the router only assigns the symbols and does not route
+    Routing::Router loadedRouter;
+    loadedRouter.setRoutingParameters(routingParameters);
+    loadedRouter.setModule(loadedModule);
+    loadedRouter.setSymbols(symbols);
+
+    QVERIFY(!loadedRouter.beginRouting());
+    QVERIFY(loadedModule->getIsRouted());
+
+    const auto routedNodes = routedModule->getNodes();
+    const auto loadedNodes = loadedModule->getNodes();
+
+    QVERIFY(routedNodes->size() == loadedNodes->size());
+
+    for(size_t nodeIdx = 0; nodeIdx < routedNodes->size(); nodeIdx++)
+    {
+        QVERIFY(routedNodes->at(nodeIdx)->getRoutedRect() == loadedNodes->at(nodeIdx)->getRoutedRect());
+    }
+
+    const auto routedPaths = routedModule->getPaths();
+    const auto loadedPaths = loadedModule->getPaths();
+
+    QVERIFY(routedPaths->size() == loadedPaths->size());
+
+    for(size_t pathIdx = 0; pathIdx < routedPaths->size(); pathIdx++)
+    {
+        const auto routedLines = routedPaths->at(pathIdx)->getRoutedLines();
+        const auto loadedLines = loadedPaths->at(pathIdx)->getRoutedLines();
+
+        QVERIFY(routedLines.size() == loadedLines.size());
+
+        for(size_t lineIdx = 0; lineIdx < routedLines.size(); lineIdx++)
+        {
+            QVERIFY(routedLines[lineIdx].points == loadedLines[lineIdx].points);
+        }
+
+        QVERIFY(routedPaths->at(pathIdx)->getJunctions() == loadedPaths->at(pathIdx)->getJunctions());
+    }
+
+    // a module of another netlist is skipped
+    Yosys::LayoutBundle otherBundle(bundleData);
+    otherBundle.readHeader();
+    otherBundle.setModules(*loadDiagram("data/yosys/test1.json")->getModules());
+
+    QVERIFY(otherBundle.readModule() == nullptr);
+}
+
+// checks the layout metrics on a layout with known crossings, bends and overlaps
+// and that a routed module has valid metrics
+void tst_routing::test_case5()
+{
+    auto module = std::make_shared<Yosys::Module>("metrics");
+
+    // two nodes connected by a horizontal path and two connected by a path with one bend
+    std::vector<std::shared_ptr<Yosys::Node>> nodes;
+    const std::vector<QRectF> nodeRects{{-20, 40, 20, 20}, {100, 40, 20, 20}, {40, -20, 20, 20}, {80, 90, 20, 20}};
+
+    for(size_t nodeIdx = 0; nodeIdx < nodeRects.size(); nodeIdx++)
+    {
+        const auto direction = nodeIdx % 2 == 0 ? Yosys::Port::EDirection::OUTPUT : Yosys::Port::EDirection::INPUT;
+        std::vector<std::shared_ptr<Yosys::Port>> ports{std::make_shared<Yosys::Port>(nodeIdx % 2 == 0 ? "Y" : "A", direction, QStringList{"2"})};
+
+        auto node = std::make_shared<Yosys::Node>(QString("n%1").arg(nodeIdx), "$not", ports);
+        ports.front()->setParentNode(node);
+        node->setLayoutRect(nodeRects[nodeIdx]);
+
+        module->addNode(node);
+        nodes.push_back(node);
+    }
+
+    const std::vector<QPolygonF> lines{QPolygonF(QList<QPointF>{{0, 50}, {100, 50}}), QPolygonF(QList<QPointF>{{50, 0}, {50, 100}, {80, 100}})};
+
+    for(size_t pathIdx = 0; pathIdx < lines.size(); pathIdx++)
+    {
+        auto path = std::make_shared<Yosys::Path>(QString("p%1").arg(pathIdx), QStringList{"2"});
+        auto source = nodes[pathIdx * 2]->getPorts().front();
+        auto destination = nodes[pathIdx * 2 + 1]->getPorts().front();
+
+        path->setSigSource(source);
+        path->addSigDestination(destination);
+        source->setPath(path);
+        destination->setPath(path);
+
+        Yosys::Path::RoutedLine routedLine;
+        routedLine.points = lines[pathIdx];
+        routedLine.destination = destination;
+
+        // the second line repeats the first, shared segments are only counted once
+        path->setLayoutLines({routedLine, routedLine}, {});
+
+        module->addPath(path);
+    }
+
+    module->setLayoutLoaded();
+    module->setIsRouted();
+
+    const auto quality = Routing::LayoutMetrics::measure(module);
+
+    QVERIFY(quality.crossings == 1);
+    QVERIFY(quality.bends == 2);
+    QVERIFY(qFuzzyCompare(quality.wireLength, 230.0));
+    QVERIFY(quality.nodeOverlaps == 0);
+    QVERIFY(quality.aspectRatio > 0.0);
+    QVERIFY(quality.stress >= 0.0 && quality.stress <= 1.0);
+
+    // touching areas do not overlap
+    QVERIFY(Routing::LayoutMetrics::countOverlaps({{0, 0, 10, 10}, {10, 0, 10, 10}, {5, 5, 10, 10}, {100, 100, 1, 1}}) == 2);
+
+    // segments of the same group and shared end points are no crossings
+    const std::vector<QLineF> segments{{0, 5, 10, 5}, {5, 0, 5, 10}, {10, 5, 10, 20}, {0, 0, 10, 10}};
+    QVERIFY(Routing::LayoutMetrics::countCrossings(segments, {0, 1, 2, 3}) == 3);
+    QVERIFY(Routing::LayoutMetrics::countCrossings(segments, {0, 0, 0, 0}) == 0);
+
+    // a routed module has valid metrics
+    QDomElement symbolRoot = loadSVG("data/routing/test2.svg");
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolRoot);
+    symbolParser.parse();
+
+    auto diagram = loadDiagram("data/yosys/test39.json");
+    auto routedModule = diagram->getModuleByName("m_byteselector");
+
+    QVERIFY(routedModule != nullptr);
+    QVERIFY(Routing::LayoutMetrics::measure(routedModule).wireLength == 0.0);
+
+    Routing::Router router;
+    router.setRoutingParameters({75.0, 75.0, 1E-4, 100, 10.0});
+    router.setModule(routedModule);
+    router.setSymbols(std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols()));
+    router.runRouter();
+
+    const auto routedQuality = Routing::LayoutMetrics::measure(routedModule);
+
+    QVERIFY(routedQuality.wireLength > 0.0);
+    QVERIFY(routedQuality.aspectRatio > 0.0);
+    QVERIFY(routedQuality.stress >= 0.0 && routedQuality.stress <= 1.0);
+}
+
+// checks if a routed module keeps its layout when symbols with the same geometry are set
+// and has to be routed again when the geometry of a used symbol changed
+void tst_routing::test_case6()
+{
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(loadSVG("data/routing/test2.svg"));
+    symbolParser.parse();
+
+    Symbol::SymbolParser reloadedParser;
+    reloadedParser.setRootElement(loadSVG("data/routing/test2.svg"));
+    reloadedParser.parse();
+
+    auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+    auto reloadedSymbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(reloadedParser.getSymbols());
+
+    auto diagram = loadDiagram("data/yosys/test39.json");
+    auto module = diagram->getModuleByName("m_byteselector");
+
+    QVERIFY(module != nullptr);
+
+    Routing::Router router;
+    router.setRoutingParameters({75.0, 75.0, 1E-4, 100, 10.0});
+    router.setModule(module);
+    router.setSymbols(symbols);
+    router.runRouter();
+
+    QVERIFY(module->getIsRouted());
+
+    const QRectF routedRect = module->getRoutedBoundingRect();
+
+    // the same skin loaded again keeps the layout
+    QVERIFY(router.replaceSymbols(reloadedSymbols));
+    QVERIFY(module->getIsRouted());
+    QVERIFY(module->getRoutedBoundingRect() == routedRect);
+
+    // a bigger symbol for an used node type invalidates the layout
+    std::shared_ptr<Yosys::Node> symbolNode;
+
+    const auto nodes = module->getNodes();
+
+    for(const auto& node : *nodes)
+    {
+        auto symbolIt = reloadedSymbols->find(node->getType());
+
+        // split and join symbols are created from the base symbol
+        if(symbolIt != reloadedSymbols->end() && symbolIt->second == node->getSymbol())
+        {
+            symbolNode = node;
+            break;
+        }
+    }
+
+    QVERIFY(symbolNode != nullptr);
+
+    const auto oldSymbol = reloadedSymbols->at(symbolNode->getType());
+    const auto boundingBox = oldSymbol->getBoundingBox();
+
+    auto biggerSymbol = std::make_shared<Symbol::Symbol>(oldSymbol->getName(), boundingBox.first + 10.0, boundingBox.second);
+    biggerSymbol->setPorts(oldSymbol->getPorts());
+
+    QVERIFY(oldSymbol->hasSameGeometry(*symbolParser.getSymbols().at(symbolNode->getType())));
+    QVERIFY(!oldSymbol->hasSameGeometry(*biggerSymbol));
+
+    auto changedSymbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(*reloadedSymbols);
+    (*changedSymbols)[symbolNode->getType()] = biggerSymbol;
+
+    QVERIFY(!router.replaceSymbols(changedSymbols));
+}
+
+// checks if the path geometry created on worker threads matches the geometry of the single paths
+void tst_routing::test_case7()
+{
+    auto module = std::make_shared<Yosys::Module>("geometry");
+
+    const size_t pathCount = 1000;
+
+    for(size_t pathIdx = 0; pathIdx < pathCount; pathIdx++)
+    {
+        const double yPos = static_cast<double>(pathIdx) * 10.0;
+        auto path = std::make_shared<Yosys::Path>(QString("p%1").arg(pathIdx), QStringList{QString::number(pathIdx + 2)});
+
+        Yosys::Path::RoutedLine firstLine;
+        firstLine.points = QPolygonF(QList<QPointF>{{0, yPos}, {50, yPos}, {50, yPos + 5}});
+
+        Yosys::Path::RoutedLine secondLine;
+        secondLine.points = QPolygonF(QList<QPointF>{{0, yPos}, {50, yPos}, {100, yPos}});
+
+        path->setLayoutLines({firstLine, secondLine}, {QPointF(50, yPos)});
+        module->addPath(path);
+    }
+
+    QNetlistItemFactory::Renderers renderers;
+    const auto items = QNetlistItemFactory::createItems(module, renderers);
+
+    QVERIFY(items.size() == pathCount);
+
+    for(size_t pathIdx = 0; pathIdx < pathCount; pathIdx++)
+    {
+        auto* pathItem = dynamic_cast<QNetlistGraphicsPath*>(items[pathIdx]);
+
+        QVERIFY(pathItem != nullptr);
+        QVERIFY(pathItem->path() == module->getPaths()->at(pathIdx)->createGeometry().painterPath);
+    }
+
+    qDeleteAll(items);
+}
+
+// checks if modules routed in parallel are all routed
+// and if the symbols given to the routers stay unchanged
+void tst_routing::test_case8()
+{
+    QDomElement symbolRoot = loadSVG("data/routing/test2.svg");
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolRoot);
+    symbolParser.parse();
+
+    auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+    const size_t symbolCount = symbols->size();
+
+    const Routing::ColaRoutingParameters routingParameters{75.0, 75.0, 1E-4, 100, 10.0};
+
+    auto diagram = loadDiagram("data/yosys/test39.json");
+    const auto diagramModules = diagram->getModules();
+    const std::vector<std::shared_ptr<Yosys::Module>> modules(diagramModules->begin(), diagramModules->end());
+
+    QVERIFY(modules.size() > 1);
+
+    std::vector<std::atomic<bool>> routed(modules.size());
+
+    const auto errors = Routing::Router::routeModules(
+        modules,
+        symbols,
+        [&routingParameters](const std::shared_ptr<Yosys::Module>&) { return routingParameters; },
+        [&modules, &routed](size_t moduleIdx) { routed[moduleIdx] = modules[moduleIdx]->getIsRouted(); });
+
+    QVERIFY(errors.size() == modules.size());
+
+    for(size_t moduleIdx = 0; moduleIdx < modules.size(); moduleIdx++)
+    {
+        QVERIFY(errors[moduleIdx].empty());
+        QVERIFY(routed[moduleIdx]);
+    }
+
+    QVERIFY(symbols->size() == symbolCount);
+}
+
+// checks the priorities, the cancellation, the errors and the nested loops of the task scheduler
+void tst_routing::test_case9()
+{
+    // a single worker that is kept busy runs the queued tasks by their priority
+    {
+        Scheduler::TaskScheduler scheduler(1);
+        Scheduler::TaskGroup group;
+
+        std::atomic<bool> started = false;
+        std::atomic<bool> released = false;
+
+        scheduler.submit([&started, &released]() {
+            started = true;
+
+            while(!released)
+            {
+                std::this_thread::yield();
+            }
+        },
+            Scheduler::TaskScheduler::EPriority::NORMAL, &group);
+
+        while(!started)
+        {
+            std::this_thread::yield();
+        }
+
+        std::mutex orderMutex;
+        std::vector<int> order;
+
+        scheduler.submit([&orderMutex, &order]() { std::lock_guard<std::mutex> lock(orderMutex); order.push_back(2); },
+            Scheduler::TaskScheduler::EPriority::SPECULATIVE, &group);
+        scheduler.submit([&orderMutex, &order]() { std::lock_guard<std::mutex> lock(orderMutex); order.push_back(1); },
+            Scheduler::TaskScheduler::EPriority::NORMAL, &group);
+        scheduler.submit([&orderMutex, &order]() { std::lock_guard<std::mutex> lock(orderMutex); order.push_back(0); },
+            Scheduler::TaskScheduler::EPriority::INTERACTIVE, &group);
+
+        released = true;
+
+        // only the worker runs the queued tasks, a waiting thread would help
+        while(!group.isDone())
+        {
+            std::this_thread::yield();
+        }
+
+        scheduler.wait(group);
+
+        QVERIFY(group.isDone());
+        QVERIFY((order == std::vector<int>{0, 1, 2}));
+    }
+
+    Scheduler::TaskScheduler scheduler(3);
+
+    // the tasks of a canceled token are not run
+    Scheduler::CancellationToken token;
+    token.cancel();
+
+    std::atomic<int> canceledRuns = 0;
+    Scheduler::TaskGroup canceledGroup;
+
+    for(int taskIdx = 0; taskIdx < 16; taskIdx++)
+    {
+        scheduler.submit([&canceledRuns]() { canceledRuns++; }, Scheduler::TaskScheduler::EPriority::NORMAL, &canceledGroup, token);
+    }
+
+    scheduler.wait(canceledGroup);
+
+    QVERIFY(canceledRuns == 0);
+
+    // nested loops run every index once
+    std::atomic<size_t> visited = 0;
+
+    scheduler.parallelFor(0, 64, [&scheduler, &visited](size_t outerBegin, size_t outerEnd) {
+        for(size_t outerIdx = outerBegin; outerIdx < outerEnd; outerIdx++)
+        {
+            scheduler.parallelFor(0, 100, [&visited](size_t innerBegin, size_t innerEnd) { visited += innerEnd - innerBegin; });
+        }
+    });
+
+    QVERIFY(visited == 6400);
+
+    // an exception of a chunk is rethrown by the loop
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error,
+        scheduler.parallelFor(0, 64, [](size_t begin, size_t) {
+            if(begin > 0)
+            {
+                throw std::runtime_error("chunk failed");
+            }
+        }));
+}
+
+// test the snapping of a cola placement to the routing grid
+void tst_routing::test_case10()
+{
+    // a shape with a pin on its left side and two shapes with a shape between them
+    // that has no free grid point, the rectangles are given as minX, maxX, minY, maxY
+    std::vector<vpsc::Rectangle*> rectangles = {new vpsc::Rectangle(3, 43, 4, 34),
+                                                new vpsc::Rectangle(1, 3, 8, 10),
+                                                new vpsc::Rectangle(100, 140, 200, 230),
+                                                new vpsc::Rectangle(145, 185, 200, 230),
+                                                new vpsc::Rectangle(190, 230, 200, 230)};
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, Routing::GridSnapper::snapRectangles(rectangles, 0.0));
+
+    QVERIFY(Routing::GridSnapper::isShapeRectangle(rectangles[0]));
+    QVERIFY(!Routing::GridSnapper::isShapeRectangle(rectangles[1]));
+
+    QVERIFY(Routing::GridSnapper::snapRectangles(rectangles, 10.0, 4.0) == 3);
+
+    // the shape moves to the nearest grid point and takes its pin along
+    QVERIFY(qFuzzyCompare(rectangles[0]->getMinX() + 1.0, 1.0));
+    QVERIFY(qFuzzyCompare(rectangles[0]->getMinY() + 1.0, 1.0));
+    QVERIFY(qFuzzyCompare(rectangles[1]->getMinX(), -2.0));
+    QVERIFY(qFuzzyCompare(rectangles[1]->getMinY(), 4.0));
+    QVERIFY(qFuzzyCompare(rectangles[0]->width(), 40.0));
+
+    // the blocked shape stays where the layout placed it
+    QVERIFY(qFuzzyCompare(rectangles[2]->getMinX(), 100.0));
+    QVERIFY(qFuzzyCompare(rectangles[3]->getMinX(), 145.0));
+    QVERIFY(qFuzzyCompare(rectangles[4]->getMinX(), 190.0));
+
+    for(auto* rectangle : rectangles)
+    {
+        delete rectangle;
+    }
+}
+
+// checks if the line of a bundle member runs parallel to the route of the representative
+void tst_routing::test_case11()
+{
+    const QPolygonF route({QPointF(0, 0), QPointF(50, 0), QPointF(50, 40), QPointF(100, 40)});
+
+    // the distance of the pins is kept in the turns
+    const QPolygonF parallelRoute = Yosys::Path::deriveBundledRoute(route, QPointF(0, 10), QPointF(100, 50));
+    QVERIFY(parallelRoute == QPolygonF({QPointF(0, 10), QPointF(40, 10), QPointF(40, 50), QPointF(100, 50)}));
+
+    // a destination pin at another distance is reached shortly before the end
+    const QPolygonF jogRoute = Yosys::Path::deriveBundledRoute(route, QPointF(0, -10), QPointF(100, 40));
+    QVERIFY(jogRoute.front() == QPointF(0, -10));
+    QVERIFY(jogRoute.back() == QPointF(100, 40));
+    QVERIFY(jogRoute.size() == 6);
+
+    for(qsizetype pointIdx = 1; pointIdx < jogRoute.size(); pointIdx++)
+    {
+        QVERIFY(jogRoute[pointIdx - 1].x() == jogRoute[pointIdx].x() || jogRoute[pointIdx - 1].y() == jogRoute[pointIdx].y());
+    }
+
+    // the inner line of a turn can not be further away than the length of the segment
+    QVERIFY(Yosys::Path::deriveBundledRoute(route, QPointF(0, 50), QPointF(100, 90)).isEmpty());
+
+    // a route that is not orthogonal can not be followed
+    QVERIFY(Yosys::Path::deriveBundledRoute(QPolygonF({QPointF(0, 0), QPointF(10, 10)}), QPointF(0, 10), QPointF(10, 20)).isEmpty());
+}
+
+// checks if an expanded instance is routed on its own copy of the submodule
+// and if the neighbours of the grown node are moved out of its way
+void tst_routing::test_case12()
+{
+    QDomElement symbolRoot = loadSVG("data/routing/test2.svg");
+
+    Symbol::SymbolParser symbolParser;
+    symbolParser.setRootElement(symbolRoot);
+    symbolParser.parse();
+
+    auto symbols = std::make_shared<std::map<QString, std::shared_ptr<Symbol::Symbol>>>(symbolParser.getSymbols());
+
+    const Routing::ColaRoutingParameters routingParameters{75.0, 75.0, 1E-4, 100, 10.0};
+
+    auto diagram = loadDiagram("data/yosys/test39.json");
+    auto parentModule = diagram->getModuleByName("m_nucleus");
+    auto subModule = diagram->getModuleByName("m_byteselector");
+
+    QVERIFY(parentModule != nullptr && subModule != nullptr);
+
+    Routing::Router parentRouter;
+    parentRouter.setRoutingParameters(routingParameters);
+    parentRouter.setModule(parentModule);
+    parentRouter.setSymbols(symbols);
+    parentRouter.runRouter();
+
+    QVERIFY(parentModule->getIsRouted());
+
+    // the copy of the submodule is routed without changing the shared module
+    auto instanceModule = subModule->clone();
+
+    const auto subNodes = subModule->getNodes();
+    const auto instanceNodes = instanceModule->getNodes();
+
+    QVERIFY(instanceNodes->size() == subNodes->size());
+    QVERIFY(instanceModule->getPorts()->size() == subModule->getPorts()->size());
+    QVERIFY(instanceModule->getPaths()->size() == subModule->getPaths()->size());
+    QVERIFY(instanceNodes->front() != subNodes->front());
+    QVERIFY(instanceNodes->front()->getName() == subNodes->front()->getName());
+
+    Routing::Router instanceRouter;
+    instanceRouter.setRoutingParameters(routingParameters);
+    instanceRouter.setModule(instanceModule);
+    instanceRouter.setSymbols(symbols);
+    instanceRouter.runRouter();
+
+    QVERIFY(instanceModule->getIsRouted());
+    QVERIFY(!subModule->getIsRouted());
+
+    // grow the node of the instance to the size of its contents
+    const auto parentNodes = parentModule->getNodes();
+    const auto parentPorts = parentModule->getPorts();
+
+    std::shared_ptr<Yosys::Node> instanceNode;
+
+    for(const auto& node : *parentNodes)
+    {
+        if(node->getName() == "byteselector")
+        {
+            instanceNode = node;
+        }
+    }
+
+    QVERIFY(instanceNode != nullptr);
+
+    const QRectF contentRect = instanceModule->getRoutedBoundingRect();
+    const QRectF oldRect = instanceNode->getRoutedRect();
+
+    QVERIFY(contentRect.width() > oldRect.width() && contentRect.height() > oldRect.height());
+
+    parentRouter.resizeNode(instanceNode, contentRect.width(), contentRect.height());
+
+    const QRectF newRect = instanceNode->getRoutedRect();
+
+    QVERIFY(parentModule->getIsRouted());
+    QVERIFY(qFuzzyCompare(newRect.width(), contentRect.width()));
+    QVERIFY(qFuzzyCompare(newRect.height(), contentRect.height()));
+    QVERIFY(qFuzzyCompare(newRect.center().x(), oldRect.center().x()));
+
+    // no node or port overlaps another one
+    std::vector<QRectF> rects;
+
+    for(const auto& node : *parentNodes)
+    {
+        rects.push_back(node->getRoutedRect());
+    }
+
+    for(const auto& port : *parentPorts)
+    {
+        rects.push_back(port->getRoutedRect());
+    }
+
+    for(size_t rectIdx = 0; rectIdx < rects.size(); rectIdx++)
+    {
+        for(size_t otherIdx = rectIdx + 1; otherIdx < rects.size(); otherIdx++)
+        {
+            const QRectF overlap = rects[rectIdx].intersected(rects[otherIdx]);
+            QVERIFY(overlap.width() <= 0.0 || overlap.height() <= 0.0);
+        }
+    }
+
+    // the connections of the moved ports are routed again
+    const auto parentPaths = parentModule->getPaths();
+
+    for(const auto& path : *parentPaths)
+    {
+        for(auto* connRef : path->getAvoidConnRefs())
+        {
+            QVERIFY(connRef->displayRoute().size() >= 2);
+        }
+    }
+}
+
+// a cola layout that only tests the stress every few iterations converges like one that tests every iteration
+void tst_routing::test_case13()
+{
+    constexpr const static size_t nodeCount{25};
+    constexpr const static unsigned maxIterations{1000};
+
+    auto runLayout = [](unsigned interval, unsigned& iterations) -> double {
+        vpsc::Rectangles rectangles;
+        std::vector<cola::Edge> edges;
+
+        // a ladder of nodes that starts scrambled
+        for(size_t nodeIdx = 0; nodeIdx < nodeCount; nodeIdx++)
+        {
+            const double xPos = static_cast<double>((nodeIdx * 37) % nodeCount) * 9.0;
+            const double yPos = static_cast<double>((nodeIdx * 11) % 7) * 13.0;
+            rectangles.push_back(new vpsc::Rectangle(xPos, xPos + 20.0, yPos, yPos + 10.0));
+
+            if(nodeIdx + 1 < nodeCount)
+            {
+                edges.emplace_back(nodeIdx, nodeIdx + 1);
+            }
+
+            if(nodeIdx + 5 < nodeCount)
+            {
+                edges.emplace_back(nodeIdx, nodeIdx + 5);
+            }
+        }
+
+        cola::TestConvergence testConvergence(1E-5, maxIterations);
+        cola::ConstrainedFDLayout layout(rectangles, edges, 60.0, cola::StandardEdgeLengths, &testConvergence);
+        layout.setStressTestInterval(interval);
+
+        layout.beginRun();
+
+        iterations = 1;
+        while(!layout.runStep())
+        {
+            iterations++;
+        }
+
+        layout.endRun();
+
+        const double stress = layout.computeStress();
+
+        for(auto* rectangle : rectangles)
+        {
+            delete rectangle;
+        }
+
+        return stress;
+    };
+
+    unsigned testedIterations = 0;
+    const double testedStress = runLayout(1, testedIterations);
+
+    QVERIFY(testedIterations < maxIterations);
+
+    // the layout has to converge on its own and not run into the iteration limit
+    for(const unsigned interval : {2U, 4U, 8U})
+    {
+        unsigned iterations = 0;
+        const double stress = runLayout(interval, iterations);
+
+        QVERIFY(iterations < maxIterations);
+        QVERIFY(std::abs(stress - testedStress) <= testedStress * 0.01);
+    }
+}
+
+// the broad phase of the nudging finds the same connectors as checking all pairs of connectors
+void tst_routing::test_case14()
+{
+    constexpr const static size_t shapeCount{30};
+    constexpr const static size_t connectorCount{90};
+
+    Avoid::Router router(Avoid::OrthogonalRouting);
+    router.setRoutingParameter(Avoid::shapeBufferDistance, 4.0);
+    router.setRoutingParameter(Avoid::idealNudgingDistance, 4.0);
+
+    // a grid of shapes with connectors from the right to the left side of other shapes
+    std::vector<Avoid::ShapeRef*> shapes;
+
+    for(size_t shapeIdx = 0; shapeIdx < shapeCount; shapeIdx++)
+    {
+        const double xPos = static_cast<double>(shapeIdx % 8) * 120.0 + static_cast<double>((shapeIdx * 7) % 20);
+        const double yPos = static_cast<double>(shapeIdx / 8) * 120.0 + static_cast<double>((shapeIdx * 13) % 20);
+
+        Avoid::Polygon rectangle = Avoid::Rectangle(Avoid::Point(xPos, yPos), Avoid::Point(xPos + 50.0, yPos + 40.0));
+        shapes.push_back(new Avoid::ShapeRef(&router, rectangle));
+    }
+
+    for(size_t connIdx = 0; connIdx < connectorCount; connIdx++)
+    {
+        const size_t srcIdx = (connIdx * 7) % shapeCount;
+        const size_t dstIdx = (connIdx * 11 + 3) % shapeCount;
+
+        if(srcIdx == dstIdx)
+        {
+            continue;
+        }
+
+        const Avoid::Box srcBox = shapes[srcIdx]->polygon().offsetBoundingBox(0.0);
+        const Avoid::Box dstBox = shapes[dstIdx]->polygon().offsetBoundingBox(0.0);
+
+        const Avoid::Point srcPoint(srcBox.max.x, srcBox.min.y + 5.0 + static_cast<double>(connIdx % 6) * 5.0);
+        const Avoid::Point dstPoint(dstBox.min.x, dstBox.min.y + 5.0 + static_cast<double>((connIdx / 6) % 6) * 5.0);
+
+        new Avoid::ConnRef(&router, Avoid::ConnEnd(srcPoint, Avoid::ConnDirRight), Avoid::ConnEnd(dstPoint, Avoid::ConnDirLeft));
+    }
+
+    router.processTransaction();
+
+    const std::vector<Avoid::ConnRef*> connRefs(router.connRefs.begin(), router.connRefs.end());
+    std::vector<Avoid::Polygon> connRoutes;
+
+    for(auto* connRef : connRefs)
+    {
+        connRoutes.push_back(connRef->displayRoute());
+    }
+
+    const auto touching = Avoid::findTouchingConnectors(connRefs, connRoutes);
+
+    QVERIFY(touching.size() == connRefs.size());
+
+    // two connectors touch if the boxes of any of their segments overlap
+    auto routesTouch = [](const Avoid::Polygon& routeA, const Avoid::Polygon& routeB) {
+        for(size_t pointA = 1; pointA < routeA.size(); pointA++)
+        {
+            for(size_t pointB = 1; pointB < routeB.size(); pointB++)
+            {
+                const Avoid::Point& startA = routeA.ps[pointA - 1];
+                const Avoid::Point& endA = routeA.ps[pointA];
+                const Avoid::Point& startB = routeB.ps[pointB - 1];
+                const Avoid::Point& endB = routeB.ps[pointB];
+
+                if(std::min(startA.x, endA.x) <= std::max(startB.x, endB.x) && std::min(startB.x, endB.x) <= std::max(startA.x, endA.x) &&
+                   std::min(startA.y, endA.y) <= std::max(startB.y, endB.y) && std::min(startB.y, endB.y) <= std::max(startA.y, endA.y))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    };
+
+    size_t touchingPairs = 0;
+
+    for(size_t connIdx = 0; connIdx < connRefs.size(); connIdx++)
+    {
+        std::vector<size_t> expected;
+
+        for(size_t otherIdx = 0; otherIdx < connRefs.size(); otherIdx++)
+        {
+            if(otherIdx != connIdx && routesTouch(connRoutes[connIdx], connRoutes[otherIdx]))
+            {
+                expected.push_back(otherIdx);
+            }
+        }
+
+        QVERIFY(touching[connIdx] == expected);
+        touchingPairs += expected.size();
+    }
+
+    // some pairs touch and some do not, otherwise the comparison proves nothing
+    QVERIFY(touchingPairs > 0);
+    QVERIFY(touchingPairs < connRefs.size() * (connRefs.size() - 1));
+}
+
 QTEST_MAIN(tst_routing);
 #include "tst_routing.moc"
\ No newline at end of file
@@ -9,12 +9,30 @@
 #include <QtTest/QTest>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QJsonArray>
 #include <qlogging.h>
 #include <QFile>
 #include <QString>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include <yosys/parser.h>
 #include <yosys/port.h>
+#include <yosys/diagram.h>
+#include <yosys/netindex.h>
+#include <yosys/module.h>
+#include <yosys/node.h>
+#include <yosys/path.h>
+#include <yosys/coneextractor.h>
+#include <yosys/slicefolder.h>
+#include <yosys/bitsscanner.h>
+#include <yosys/rtlilreader.h>
+#include <yosys/sheetpartitioner.h>
+#include <yosys/netlistsimplifier.h>
+#include <yosys/designloader.h>
+#include <scheduler/taskscheduler.h>
 
 using namespace OpenNetlistView;
 
@@ -64,6 +82,15 @@ private slots:
     void test_case37();
     void test_case38();
     void test_case39();
+    void test_case40();
+    void test_case41();
+    void test_case42();
+    void test_case43();
+    void test_case44();
+    void test_case45();
+    void test_case46();
+    void test_case47();
+    void test_case48();
 };
 
 // Helper functions
@@ -584,5 +611,513 @@ void tst_yosys::test_case39()
     QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
 }
 
+// global net ids across the submodule boundary
+void tst_yosys::test_case40()
+{
+
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test39.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+
+    auto diagram = parser.getDiagram();
+    diagram->linkSubModules(diagram->getTopModule());
+
+    auto netIndex = diagram->getNetIndex();
+    QVERIFY(netIndex != nullptr);
+
+    // adr_in of the parent is adr_in of the byteselector instance
+    QVERIFY(netIndex->isSameNet("/", "510", "/byteselector/", "2"));
+    QVERIFY(netIndex->isSameNet("/", "511", "/byteselector/", "3"));
+    QVERIFY(!netIndex->isSameNet("/", "510", "/byteselector/", "3"));
+    QVERIFY(!netIndex->isSameNet("/", "750", "/byteselector/", "2"));
+
+    // unknown instances and bits have no net
+    QVERIFY(netIndex->getNetId("/unknown/", "2") == -1);
+    QVERIFY(netIndex->getNetId("/", "123456") == -1);
+
+    const auto members = netIndex->traceNet("/byteselector/", "7");
+    QVERIFY(members.size() == 2);
+
+    bool foundParent = false;
+    for(const auto& member : members)
+    {
+        if(member.instancePath == "/" && member.bit == "709")
+        {
+            foundParent = true;
+        }
+    }
+    QVERIFY(foundParent);
+}
+
+// test the extraction of the fan-in and fan-out of a cell and a net
+void tst_yosys::test_case41()
+{
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test40.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+
+    auto diagram = parser.getDiagram();
+    auto module = diagram->getTopModule();
+    QVERIFY(module != nullptr);
+
+    auto findPort = [](const std::shared_ptr<Yosys::Module>& module, const QString& name) -> std::shared_ptr<Yosys::Port> {
+        const auto ports = module->getPorts();
+
+        for(const auto& port : *ports)
+        {
+            if(port->getName() == name)
+            {
+                return port;
+            }
+        }
+        return nullptr;
+    };
+
+    Yosys::ConeExtractor extractor(module);
+
+    // one level around u3 contains the driving u2 and the driven u4
+    auto cone = extractor.extract("u3", 1);
+    QVERIFY(cone != nullptr);
+    QVERIFY(cone->getType() == Yosys::ConeExtractor::generateConeType("MCone", "u3", 1));
+    QVERIFY(cone->getNodes()->size() == 3);
+    QVERIFY(cone->getPaths()->size() == 5);
+    QVERIFY(cone->getPorts()->size() == 4);
+
+    // n1 is driven by u1 outside of the cone, n2 also drives u5 outside of the cone
+    auto n1Port = findPort(cone, "n1:in");
+    auto n2Port = findPort(cone, "n2:out");
+    QVERIFY(n1Port != nullptr && n1Port->getDirection() == Yosys::Port::EDirection::INPUT);
+    QVERIFY(n2Port != nullptr && n2Port->getDirection() == Yosys::Port::EDirection::OUTPUT);
+    QVERIFY(findPort(cone, "b") != nullptr);
+    QVERIFY(findPort(cone, "y") != nullptr);
+
+    // the ports of the cone are connected to the copied paths
+    QVERIFY(n2Port->getPath() != nullptr);
+    QVERIFY(n2Port->getPath()->getSigSource()->getParentNode()->getName() == "u2");
+    QVERIFY(n2Port->getPath()->getSigDestinations()->size() == 2);
+
+    // the original module is not changed
+    QVERIFY(module->getNodes()->size() == 5);
+    QVERIFY(findPort(module, "n1") == nullptr);
+
+    // a net without levels only contains the net itself
+    auto netCone = extractor.extract("n2", 0);
+    QVERIFY(netCone != nullptr);
+    QVERIFY(netCone->getNodes()->empty());
+    QVERIFY(netCone->getPaths()->size() == 1);
+    QVERIFY(netCone->getPorts()->size() == 2);
+
+    // the input and the output of the net get different names
+    QVERIFY(findPort(netCone, "n2:in") != nullptr);
+    QVERIFY(findPort(netCone, "n2:out") != nullptr);
+
+    // the fan-in of an output port follows the drivers only
+    auto fanInCone = extractor.extract("y", 2, Yosys::ConeExtractor::EConeDirection::FANIN);
+    QVERIFY(fanInCone != nullptr);
+    QVERIFY(fanInCone->getNodes()->size() == 2);
+
+    QVERIFY(extractor.extract("unknown") == nullptr);
+}
+
+// test the folding of replicated flip-flops into one arrayed node
+void tst_yosys::test_case42()
+{
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test41.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    // without folding every flip-flop is a node
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+    QVERIFY(parser.getDiagram()->getTopModule()->getNodes()->size() == 5);
+
+    Yosys::Parser foldingParser;
+    foldingParser.setSliceFolding(true);
+    foldingParser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(foldingParser.parse());
+
+    auto module = foldingParser.getDiagram()->getTopModule();
+    const auto nodes = module->getNodes();
+
+    // the four flip-flops of q are folded, the one with another clock is not
+    QVERIFY(nodes->size() == 2);
+
+    std::shared_ptr<Yosys::Node> foldedNode;
+    for(const auto& node : *nodes)
+    {
+        if(node->getSliceCount() > 1)
+        {
+            foldedNode = node;
+        }
+    }
+
+    QVERIFY(foldedNode != nullptr);
+    QVERIFY(foldedNode->getSliceCount() == 4);
+    QVERIFY(foldedNode->getFoldedNames() == QStringList({"dff0", "dff1", "dff2", "dff3"}));
+
+    // the per bit ports are concatenated in bus order and the clock is shared
+    for(const auto& port : foldedNode->getPorts())
+    {
+        if(port->getName() == "D")
+        {
+            QVERIFY(port->getBits() == QStringList({"2", "3", "4", "5"}));
+        }
+        else if(port->getName() == "Q")
+        {
+            QVERIFY(port->getBits() == QStringList({"7", "8", "9", "10"}));
+            QVERIFY(port->getPath() != nullptr);
+            QVERIFY(port->getPath()->getName() == "q");
+        }
+        else
+        {
+            QVERIFY(port->getBits() == QStringList({"6"}));
+        }
+    }
+}
+
+// test the decoding of the bit arrays from the raw json data
+void tst_yosys::test_case43()
+{
+    Yosys::BitsScanner scanner;
+
+    // the bit arrays are replaced by their index, other arrays are kept
+    const QByteArray scanned = scanner.scan(R"({"bits": [2, 3, "0", "x"], "connections": {"A": ["1", "z", 12345678901234567]}, "src": "bits", "values": [1, 2], "bad": {"bits": [1.5]}})");
+    QVERIFY(scanned == R"({"bits": 0, "connections": {"A": 1}, "src": "bits", "values": [1, 2], "bad": {"bits": [1.5]}})");
+    QVERIFY(scanner.getBits(0) == QStringList({"2", "3", "0", "x"}));
+    QVERIFY(scanner.getBits(1) == QStringList({"1", "z", "12345678901234567"}));
+    QVERIFY(!scanner.hasBits(2));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, scanner.getBits(2));
+
+    QFile file(QFINDTESTDATA("data/yosys/test31.json"));
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QByteArray fileContent = file.readAll();
+
+    // the scanned netlist is parsed like the json object
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(QJsonDocument::fromJson(fileContent).object());
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+
+    Yosys::Parser scanningParser;
+    QVERIFY_THROWS_NO_EXCEPTION(scanningParser.setYosysJsonData(fileContent));
+    QVERIFY_THROWS_NO_EXCEPTION(scanningParser.parse());
+
+    const auto modules = parser.getDiagram()->getModules();
+    const auto scannedModules = scanningParser.getDiagram()->getModules();
+    QVERIFY(modules->size() == scannedModules->size());
+
+    for(size_t moduleIdx = 0; moduleIdx < modules->size(); moduleIdx++)
+    {
+        const auto ports = modules->at(moduleIdx)->getPorts();
+        const auto scannedPorts = scannedModules->at(moduleIdx)->getPorts();
+        QVERIFY(ports->size() == scannedPorts->size());
+
+        for(size_t portIdx = 0; portIdx < ports->size(); portIdx++)
+        {
+            QVERIFY(ports->at(portIdx)->getBits() == scannedPorts->at(portIdx)->getBits());
+        }
+
+        const auto paths = modules->at(moduleIdx)->getPaths();
+        const auto scannedPaths = scannedModules->at(moduleIdx)->getPaths();
+        QVERIFY(paths->size() == scannedPaths->size());
+
+        for(size_t pathIdx = 0; pathIdx < paths->size(); pathIdx++)
+        {
+            QVERIFY(paths->at(pathIdx)->getBits() == scannedPaths->at(pathIdx)->getBits());
+        }
+    }
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, scanningParser.setYosysJsonData("[1, 2]"));
+}
+
+// test the reading of rtlil netlists
+void tst_yosys::test_case44()
+{
+    // slices, concatenations and constants are resolved to the bits of the json backend
+    const QByteArray rtlilData = "module \\top\n"
+                                 "  wire width 4 input 1 \\a\n"
+                                 "  wire width 4 output 2 \\y\n"
+                                 "  wire width 2 offset 2 upto \\w\n"
+                                 "  connect \\y { 1'x \\a [2] \\w }\n"
+                                 "  connect \\w [2] 1'1\n"
+                                 "end\n";
+
+    QVERIFY(Yosys::RtlilReader::isRtlil(rtlilData));
+    QVERIFY(!Yosys::RtlilReader::isRtlil(R"({"modules": {}})"));
+
+    const QJsonObject netlist = Yosys::RtlilReader::read(rtlilData);
+    const QJsonObject ports = netlist[YosysJson::modules].toObject()["top"].toObject()[YosysJson::ports].toObject();
+
+    QVERIFY(ports["a"].toObject()[YosysJson::bits].toArray() == QJsonArray({2, 3, 4, 5}));
+    QVERIFY(ports["y"].toObject()[YosysJson::bits].toArray() == QJsonArray({6, "1", 4, "x"}));
+    QVERIFY(ports["y"].toObject()[YosysJson::direction].toString() == "output");
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, Yosys::RtlilReader::read("module \\top\n  connect \\a \\b\nend\n"));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, Yosys::RtlilReader::read("module \\top\n  process $proc\n  end\nend\n"));
+
+    // the port directions of the internal cells depend on the cell type
+    const QByteArray memoryData = "module \\top\n"
+                                  "  wire width 4 input 1 \\addr\n"
+                                  "  wire width 8 output 2 \\data\n"
+                                  "  cell $memrd \\rd\n"
+                                  "    connect \\ADDR \\addr\n"
+                                  "    connect \\DATA \\data\n"
+                                  "  end\n"
+                                  "end\n";
+
+    const QJsonObject memoryNetlist = Yosys::RtlilReader::read(memoryData);
+    const QJsonObject readCell = memoryNetlist[YosysJson::modules].toObject()["top"].toObject()[YosysJson::cells].toObject()["rd"].toObject();
+    const QJsonObject readDirections = readCell[YosysJson::port_directions].toObject();
+
+    QVERIFY(readDirections["DATA"].toString() == "output");
+    QVERIFY(readDirections["ADDR"].toString() == "input");
+
+    // the port directions of a cell that is neither a module nor an internal cell are unknown
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, Yosys::RtlilReader::read("module \\top\n"
+                                                                          "  wire input 1 \\a\n"
+                                                                          "  cell \\missing \\inst\n"
+                                                                          "    connect \\A \\a\n"
+                                                                          "  end\n"
+                                                                          "end\n"));
+
+    // the rtlil netlist of test41 is parsed into the same diagram as the json netlist
+    QFile file(QFINDTESTDATA("data/yosys/test42.il"));
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+
+    Yosys::Parser rtlilParser;
+    rtlilParser.setSliceFolding(true);
+    QVERIFY_THROWS_NO_EXCEPTION(rtlilParser.setRtlilData(file.readAll()));
+    QVERIFY_THROWS_NO_EXCEPTION(rtlilParser.parse());
+
+    Yosys::Parser jsonParser;
+    jsonParser.setSliceFolding(true);
+    jsonParser.setYosysJsonObject(load_json("data/yosys/test41.json"));
+    QVERIFY_THROWS_NO_EXCEPTION(jsonParser.parse());
+
+    const auto rtlilModule = rtlilParser.getDiagram()->getTopModule();
+    const auto jsonModule = jsonParser.getDiagram()->getTopModule();
+
+    QVERIFY(rtlilModule != nullptr);
+    QVERIFY(rtlilModule->getType() == jsonModule->getType());
+    QVERIFY(rtlilModule->getNodes()->size() == jsonModule->getNodes()->size());
+    QVERIFY(rtlilModule->getPaths()->size() == jsonModule->getPaths()->size());
+
+    const auto rtlilPorts = rtlilModule->getPorts();
+    const auto jsonPorts = jsonModule->getPorts();
+    QVERIFY(rtlilPorts->size() == jsonPorts->size());
+
+    for(size_t portIdx = 0; portIdx < rtlilPorts->size(); portIdx++)
+    {
+        QVERIFY(rtlilPorts->at(portIdx)->getName() == jsonPorts->at(portIdx)->getName());
+        QVERIFY(rtlilPorts->at(portIdx)->getBits() == jsonPorts->at(portIdx)->getBits());
+    }
+}
+
+// test the splitting of a module into sheets connected by off-sheet connectors
+void tst_yosys::test_case45()
+{
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test40.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+
+    auto module = parser.getDiagram()->getTopModule();
+    QVERIFY(module != nullptr);
+
+    const auto modulePorts = module->getPorts();
+    auto isModulePort = [&modulePorts](const QString& name) {
+        return std::any_of(modulePorts->begin(), modulePorts->end(), [&name](const auto& port) { return port->getName() == name; });
+    };
+
+    Yosys::SheetPartitioner partitioner(module);
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, partitioner.partition(0));
+
+    // five cells with at most two per sheet need three sheets
+    const auto sheets = partitioner.partition(2);
+    QVERIFY(sheets.size() == 3);
+    QVERIFY(partitioner.getCutNetCount() > 0);
+
+    size_t nodeCount = 0;
+    for(size_t sheetIdx = 0; sheetIdx < sheets.size(); sheetIdx++)
+    {
+        const auto& sheet = sheets[sheetIdx];
+        QVERIFY(sheet->getType() == Yosys::SheetPartitioner::generateSheetType("MCone", sheetIdx, sheets.size()));
+        QVERIFY(sheet->getNodes()->size() <= 2);
+        nodeCount += sheet->getNodes()->size();
+
+        // every input connector is driven by an output connector on another sheet
+        const auto sheetPorts = sheet->getPorts();
+        for(const auto& port : *sheetPorts)
+        {
+            if(port->getDirection() != Yosys::Port::EDirection::INPUT || isModulePort(port->getName()))
+            {
+                continue;
+            }
+
+            bool foundDriver = false;
+            for(size_t otherIdx = 0; otherIdx < sheets.size(); otherIdx++)
+            {
+                const auto otherPorts = sheets[otherIdx]->getPorts();
+                for(const auto& otherPort : *otherPorts)
+                {
+                    if(otherIdx != sheetIdx && otherPort->getName() == port->getName() &&
+                       otherPort->getDirection() == Yosys::Port::EDirection::OUTPUT)
+                    {
+                        foundDriver = true;
+                    }
+                }
+            }
+            QVERIFY(foundDriver);
+        }
+    }
+    QVERIFY(nodeCount == 5);
+
+    // the original module is not changed
+    QVERIFY(module->getNodes()->size() == 5);
+    QVERIFY(module->getPorts()->size() == 4);
+
+    // a module that fits on one sheet is not cut
+    const auto singleSheet = partitioner.partition(10);
+    QVERIFY(singleSheet.size() == 1);
+    QVERIFY(singleSheet.front()->getNodes()->size() == 5);
+    QVERIFY(partitioner.getCutNetCount() == 0);
+}
+
+// check the netlist simplification passes and the tracing of the removed cells
+void tst_yosys::test_case46()
+{
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test43.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    Yosys::Parser parser;
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, parser.setSimplificationPasses({"unknown"}));
+
+    // without passes the module is not changed
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+    QVERIFY(parser.getDiagram()->getTopModule()->getNodes()->size() == 7);
+    QVERIFY(parser.getSimplificationStatistics().empty());
+
+    Yosys::Parser simplifyingParser;
+    simplifyingParser.setSimplificationPasses(Yosys::NetlistSimplifier::getPassNames());
+    simplifyingParser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(simplifyingParser.parse());
+
+    const auto statistics = simplifyingParser.getSimplificationStatistics();
+    QVERIFY(statistics.at(Yosys::NetlistSimplifier::bufferChains) == 2);
+    QVERIFY(statistics.at(Yosys::NetlistSimplifier::doubleInverters) == 2);
+    QVERIFY(statistics.at(Yosys::NetlistSimplifier::deadLogic) == 2);
+
+    auto module = simplifyingParser.getDiagram()->getTopModule();
+    const auto nodes = module->getNodes();
+    QVERIFY(nodes->size() == 1);
+    QVERIFY(nodes->front()->getName() == "g1");
+
+    // the output y is connected to the input a
+    const auto modulePorts = module->getPorts();
+    for(const auto& port : *modulePorts)
+    {
+        if(port->getName() == "y")
+        {
+            QVERIFY(port->getBits() == QStringList({"2"}));
+        }
+    }
+
+    // the removed cells are traced to the component they were merged into
+    QVERIFY(module->getSimplifiedCellRepresentative("b2") == "a");
+    QVERIFY(module->getSimplifiedCellRepresentative("n2") == "a");
+    QVERIFY(module->getSimplifiedCellRepresentative("d2") == "b");
+    QVERIFY(module->getSimplifiedCellRepresentative("g1").isEmpty());
+}
+
+// loading a design runs the stages in order and can be canceled
+void tst_yosys::test_case47()
+{
+    const QString fileName = QFINDTESTDATA("data/yosys/test39.json");
+
+    QVERIFY(!fileName.isEmpty());
+
+    Yosys::DesignLoader designLoader;
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, designLoader.setSimplificationPasses({"unknown"}));
+
+    // the file is read by the loader if no content is given
+    std::vector<Yosys::DesignLoader::EStage> stages;
+    std::unique_ptr<Yosys::DesignLoader::Result> result;
+    QVERIFY_THROWS_NO_EXCEPTION(result = designLoader.load(fileName, QByteArray(), Scheduler::CancellationToken(), [&stages](Yosys::DesignLoader::EStage stage) {
+        stages.push_back(stage);
+    }));
+
+    QVERIFY(stages.size() == static_cast<size_t>(Yosys::DesignLoader::stageCount));
+    QVERIFY(stages[0] == Yosys::DesignLoader::EStage::READ);
+    QVERIFY(stages[1] == Yosys::DesignLoader::EStage::PARSE);
+    QVERIFY(stages[2] == Yosys::DesignLoader::EStage::LINK);
+
+    QVERIFY(result->diagram->getTopModule() != nullptr);
+    QVERIFY(result->layoutBundle == nullptr);
+    QVERIFY(result->diagram->getNetIndex()->isSameNet("/", "510", "/byteselector/", "2"));
+
+    // a canceled loading does not start any stage
+    Scheduler::CancellationToken token;
+    token.cancel();
+    stages.clear();
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, designLoader.load(fileName, QByteArray(), token, [&stages](Yosys::DesignLoader::EStage stage) {
+        stages.push_back(stage);
+    }));
+    QVERIFY(stages.empty());
+
+    // a missing file is reported as an error
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, designLoader.load("data/yosys/missing.json", QByteArray()));
+}
+
+// nets connected through unbound submodules do not depend on the query order
+void tst_yosys::test_case48()
+{
+    const QJsonObject yosysJsonObject = load_json("data/yosys/test44.json");
+
+    QVERIFY(yosysJsonObject.isEmpty() != true);
+
+    Yosys::Parser parser;
+    parser.setYosysJsonObject(yosysJsonObject);
+    QVERIFY_THROWS_NO_EXCEPTION(parser.parse());
+
+    auto diagram = parser.getDiagram();
+    diagram->linkSubModules(diagram->getTopModule());
+
+    // in and mid only meet inside u_pass of u_outer which is not bound yet
+    auto netIndex = diagram->getNetIndex();
+    QVERIFY(netIndex->isSameNet("/", "2", "/", "3"));
+    QVERIFY(!netIndex->isSameNet("/", "3", "/", "4"));
+
+    // binding the deepest instance first gives the same nets
+    diagram->linkSubModules(diagram->getTopModule());
+    netIndex = diagram->getNetIndex();
+    QVERIFY(netIndex->getNetId("/u_outer/u_pass/", "2") >= 0);
+    QVERIFY(netIndex->isSameNet("/u_outer/", "2", "/u_outer/", "3"));
+    QVERIFY(netIndex->isSameNet("/", "2", "/", "3"));
+
+    QVERIFY(netIndex->traceNet("/", "2").size() == 5);
+
+    // the member lists only contain bound instances until everything is bound
+    diagram->linkSubModules(diagram->getTopModule());
+    netIndex = diagram->getNetIndex();
+    QVERIFY(netIndex->traceNet("/", "2").size() == 2);
+    netIndex->bindAll();
+    QVERIFY(netIndex->traceNet("/", "2").size() == 5);
+}
+
 QTEST_MAIN(tst_yosys)
 #include "tst_yosys.moc"